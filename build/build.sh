@@ -1 +1 @@
-gcc -o ../build/test ../source/SignalProcessing.cpp ../test/test.cpp -I../source -lm -lrt
\ No newline at end of file
+g++ -o ../build/test ../source/SignalProcessing.cpp ../test/test.cpp -I../source -lm -lrt -pthread
\ No newline at end of file
@@ -1,3 +1,3 @@
 #!/bin/bash
-g++ -o example_complete example_complete.cpp ../source/SignalProcessing.cpp -lm -lrt
+g++ -o example_complete example_complete.cpp ../source/SignalProcessing.cpp -lm -lrt -pthread
 echo "Build complete: example_complete"
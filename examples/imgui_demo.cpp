@@ -282,26 +282,20 @@ void ApplyFilters() {
     }
     
     if (apply_median) {
-        SignalProcessing sp_temp;
-        for (size_t i = 0; i < filtered_data.size(); i++) {
-            sp_temp.AddValue(filtered_data[i]);
-        }
+        SignalView view(filtered_data.data(), (int)filtered_data.size());
         double* temp = new double[signal_length];
-        sp_temp.MedianFilter(median_window, temp);
-        for (int i = 0; i < sp_temp.GetIndex(); i++) {
+        view.MedianFilter(median_window, temp);
+        for (int i = 0; i < view.GetIndex(); i++) {
             filtered_data[i] = temp[i];
         }
         delete[] temp;
     }
     
     if (apply_wavelet) {
-        SignalProcessing sp_temp;
-        for (size_t i = 0; i < filtered_data.size(); i++) {
-            sp_temp.AddValue(filtered_data[i]);
-        }
+        SignalView view(filtered_data.data(), (int)filtered_data.size());
         double* temp = new double[signal_length];
-        sp_temp.WaveletDenoise(0.5, temp, 1);
-        for (int i = 0; i < sp_temp.GetIndex(); i++) {
+        view.WaveletDenoise(0.5, temp, 1);
+        for (int i = 0; i < view.GetIndex(); i++) {
             filtered_data[i] = temp[i];
         }
         delete[] temp;
@@ -312,10 +306,7 @@ void ApplyFilters() {
 void DetectAnomalies() {
     anomaly_indices.clear();
     
-    SignalProcessing sp_check;
-    for (size_t i = 0; i < filtered_data.size(); i++) {
-        sp_check.AddValue(filtered_data[i]);
-    }
+    SignalView sp_check(filtered_data.data(), (int)filtered_data.size());
     
     int temp_anomalies[1000];
     int count = 0;
@@ -342,10 +333,7 @@ void ComputeFFT() {
     fft_frequencies.clear();
     fft_magnitudes.clear();
     
-    SignalProcessing sp_fft;
-    for (size_t i = 0; i < filtered_data.size(); i++) {
-        sp_fft.AddValue(filtered_data[i]);
-    }
+    SignalView sp_fft(filtered_data.data(), (int)filtered_data.size());
     
     FrequencySpectrum spectrum;
     if (sp_fft.FFTAnalysis(sampling_rate, &spectrum)) {
@@ -359,10 +347,7 @@ void ComputeFFT() {
 
 // Extract ML features
 void ExtractMLFeatures() {
-    SignalProcessing sp_ml;
-    for (size_t i = 0; i < filtered_data.size(); i++) {
-        sp_ml.AddValue(filtered_data[i]);
-    }
+    SignalView sp_ml(filtered_data.data(), (int)filtered_data.size());
     sp_ml.ExtractMLFeatures(sampling_rate, &ml_features);
 }
 
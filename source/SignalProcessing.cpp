@@ -4,11 +4,25 @@
 #endif
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include <math.h>
 #include <chrono>
+#include <algorithm>
+#include <thread>
+#include <limits.h>
+#include <assert.h>
+#ifdef WINDOWS
+    #include <malloc.h>
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
 #ifndef M_PI
-#define M_PI 3.14159
+#define M_PI 3.14159265358979323846
 #endif
 
 #ifndef M_E
@@ -16,3210 +30,9639 @@
 #endif
 int CompareProbDistItem(const void *a, const void *b);
 
-/// @brief SignalProcessing constructor
-SignalProcessing::SignalProcessing()
+#define TIMESTAMP_NO_DELTA 0xFFFFFFFFu
+#define TIMESTAMP_NO_BASE (-0x7FFFFFFFFFFFFFFFLL - 1)
+
+/// @brief Converts a timespec to nanoseconds since the epoch
+static inline long long TimespecToNs(struct timespec ts)
+{
+	return (long long)ts.tv_sec * NS_PER_SECOND + ts.tv_nsec;
+}
+
+/// @brief Converts nanoseconds since the epoch to a timespec
+static inline struct timespec NsToTimespec(long long ns)
 {
-	for (int i = 0; i < NB_MAX_VALUES; i++)
+	struct timespec ts;
+	long long sec = ns / NS_PER_SECOND;
+	long long nsec = ns % NS_PER_SECOND;
+	if (nsec < 0)
 	{
-		// write the config items in file
-		this->SignalVector[i] = 0.0;
+		nsec += NS_PER_SECOND;
+		sec--;
 	}
-	this->item = 0;
-	this->index = 0;
-	this->p_d = this->NormalDistributionCreate();
-	this->threshold_crossing_flag = false;
-	this->zero_crossing_flag = false;
+	ts.tv_sec = (time_t)sec;
+	ts.tv_nsec = (long)nsec;
+	return ts;
 }
-/// @brief Clears the signal processing vector
-void SignalProcessing::ClearVector()
+
+/// @brief Allocates zeroed memory aligned to SIGNALBANK_ALIGNMENT bytes
+/// @param bytes Size in bytes
+/// @return Aligned memory, nullptr on failure (release with AlignedFree)
+static void *AlignedCalloc(size_t bytes)
 {
-	for (int i = 0; i < NB_MAX_VALUES; i++)
+	void *memory = nullptr;
+#ifdef WINDOWS
+	memory = _aligned_malloc(bytes, SIGNALBANK_ALIGNMENT);
+#else
+	if (posix_memalign(&memory, SIGNALBANK_ALIGNMENT, bytes) != 0)
 	{
-		// write the config items in file
-		this->SignalVector[i] = 0.0;
+		memory = nullptr;
 	}
-	this->index = 0;
+#endif
+	if (memory != nullptr)
+	{
+		memset(memory, 0, bytes);
+	}
+	return memory;
 }
-/// @brief Adds a value to the signal processing vector
-/// @param value Value to be saved in the signal processing vector
-/// @return this->index
-int SignalProcessing::AddValue(double value)
+
+/// @brief Releases memory allocated by AlignedCalloc
+/// @param memory Aligned memory
+static void AlignedFree(void *memory)
 {
+#ifdef WINDOWS
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
 
-	//clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &(this->signal_timestamp[this->index]));
-	#ifdef WINDOWS
-	static std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
-	#elif defined(__linux__)
-	struct timespec ts; 
-	clock_gettime(CLOCK_REALTIME, &ts);
-	#endif
-	
-	this->SignalVector[this->index] = value;
-	if ((this->index >= NB_MAX_VALUES) || (this->index < 0))
-	{
-		this->index = 0/*  */;
-	}	
-	else
+// ========== SCRATCH WORKSPACE IMPLEMENTATION ==========
+
+/// @brief Header of a fallback block allocated when the workspace is full
+typedef struct WorkspaceBlock
+{
+	void *next;
+	size_t offset;
+} WorkspaceBlock;
+
+/// @brief Rounds a size up to the workspace alignment
+static inline size_t WorkspaceRound(size_t bytes)
+{
+	return (bytes + SIGNALBANK_ALIGNMENT - 1) / SIGNALBANK_ALIGNMENT * SIGNALBANK_ALIGNMENT;
+}
+
+/// @brief Creates a workspace
+/// @param bytes Initial size in bytes (0 = allocated on first use)
+SignalWorkspace::SignalWorkspace(size_t bytes)
+{
+	this->buffer = nullptr;
+	this->size = 0;
+	this->owns_buffer = true;
+	this->used = 0;
+	this->peak = 0;
+	this->overflow = nullptr;
+	this->heap_allocations = 0;
+	this->guard = false;
+	if (bytes > 0)
 	{
-		this->index++;
+		this->Reserve(bytes);
 	}
+}
 
-	return (this->index);
+/// @brief SignalWorkspace destructor
+SignalWorkspace::~SignalWorkspace()
+{
+	this->guard = false;
+	this->Release(0);
+	if (this->owns_buffer)
+	{
+		AlignedFree(this->buffer);
+	}
 }
 
-/// @brief Adds a value with timestamp to the signal vector
-/// @param value Value to be saved in the signal processing vector
-/// @param ts Timestamp to associate with the value
-/// @return this->index
-int SignalProcessing::AddValueWithTimestamp(double value, struct timespec ts)
+/// @brief Makes the buffer at least bytes long
+/// @param bytes Size in bytes
+/// @return true on success
+bool SignalWorkspace::Reserve(size_t bytes)
 {
-	this->SignalVector[this->index] = value;
-	this->signal_timestamp[this->index].tv_sec = ts.tv_sec;
-	this->signal_timestamp[this->index].tv_nsec = ts.tv_nsec;
-	
-	if ((this->index >= NB_MAX_VALUES) || (this->index < 0))
+	if (bytes <= this->size)
 	{
-		this->index = 0;
-	}	
-	else
+		return true;
+	}
+	if (this->used > 0)
 	{
-		this->index++;
+		return false;
 	}
-
-	return (this->index);
+	bytes = WorkspaceRound(bytes);
+	if (this->buffer != nullptr)
+	{
+		// growth after the first reservation is an allocation of the hot path
+		this->heap_allocations++;
+		assert(!this->guard && "SignalWorkspace: heap allocation while the allocation guard is on");
+	}
+	void *memory = AlignedCalloc(bytes);
+	if (memory == nullptr)
+	{
+		return false;
+	}
+	if (this->owns_buffer)
+	{
+		AlignedFree(this->buffer);
+	}
+	this->buffer = (unsigned char *)memory;
+	this->size = bytes;
+	this->owns_buffer = true;
+	return true;
 }
 
-/// @brief Gets the timestamp for a value in the signal processing vector
-/// @param td Contains the timestamp of the signal value at index
-/// @param index The index of the signal value
-/// @return void
-void SignalProcessing::GetTimespec(struct timespec *td, int index)
+/// @brief Uses caller memory as the buffer
+/// @param memory Buffer, never freed by the workspace
+/// @param bytes Size of memory in bytes
+/// @return true on success
+bool SignalWorkspace::UseBuffer(void *memory, size_t bytes)
 {
-	if (td != nullptr)
+	if (memory == nullptr || this->used > 0)
+	{
+		return false;
+	}
+	size_t skip = (SIGNALBANK_ALIGNMENT - (size_t)memory % SIGNALBANK_ALIGNMENT) % SIGNALBANK_ALIGNMENT;
+	if (bytes <= skip)
+	{
+		return false;
+	}
+	if (this->owns_buffer)
 	{
-		td->tv_nsec = signal_timestamp[index].tv_nsec;
-		td->tv_sec = signal_timestamp[index].tv_sec;
+		AlignedFree(this->buffer);
 	}
+	this->buffer = (unsigned char *)memory + skip;
+	this->size = (bytes - skip) / SIGNALBANK_ALIGNMENT * SIGNALBANK_ALIGNMENT;
+	this->owns_buffer = false;
+	return true;
 }
 
-/// @brief Gets the last value of the signal processing vector
-/// @return void
-double SignalProcessing::GetLastValue()
+/// @brief Gets the size of the buffer
+/// @return Size in bytes
+size_t SignalWorkspace::GetSize()
 {
-	return this->SignalVector[this->index-1];
+	return this->size;
 }
-/// @brief Sets the item of the signal processing vector
-/// @param Item The item
-/// @return void
-void SignalProcessing::SetItem(int Item)
+
+/// @brief Gets the largest amount of scratch memory requested at once
+/// @return Size in bytes
+size_t SignalWorkspace::GetPeakUsage()
 {
-	this->item = Item;
+	return this->peak;
 }
-/// @brief Gets the max capacity of the signal processing vector
-/// @return Max capacity
-int SignalProcessing::GetMaxCapacity()
+
+/// @brief Gets the number of heap allocations made after the first Reserve()
+/// @return Number of allocations
+long long SignalWorkspace::GetHeapAllocationCount()
 {
-	return NB_MAX_VALUES;
+	return this->heap_allocations;
 }
-/// @brief Gets the current index of the signal processing vector
-/// @return Current index
-int SignalProcessing::GetIndex()
+
+/// @brief Enables the no-allocation check of the hot path
+/// @param enable true to assert on every heap allocation
+void SignalWorkspace::SetAllocationGuard(bool enable)
 {
-	return (this->index);
+	this->guard = enable;
 }
-/// @brief Gets the size of the signal processing vector
-/// @return Current index
-int SignalProcessing::GetSize()
+
+/// @brief Allocates scratch memory
+/// @param bytes Size in bytes
+/// @return 64-byte aligned block, nullptr on failure
+void *SignalWorkspace::Alloc(size_t bytes)
 {
-	return (this->GetIndex());
+	size_t rounded = WorkspaceRound(bytes > 0 ? bytes : 1);
+	size_t offset = this->used;
+	this->used += rounded;
+	if (this->used > this->peak)
+	{
+		this->peak = this->used;
+	}
+	if (this->used <= this->size)
+	{
+		return this->buffer + offset;
+	}
+
+	// buffer full: heap block released with the mark, buffer grown afterwards
+	this->heap_allocations++;
+	assert(!this->guard && "SignalWorkspace: heap allocation while the allocation guard is on");
+	unsigned char *block = (unsigned char *)AlignedCalloc(SIGNALBANK_ALIGNMENT + rounded);
+	if (block == nullptr)
+	{
+		this->used = offset;
+		return nullptr;
+	}
+	WorkspaceBlock *header = (WorkspaceBlock *)block;
+	header->next = this->overflow;
+	header->offset = offset;
+	this->overflow = block;
+	return block + SIGNALBANK_ALIGNMENT;
 }
-/// @brief Gets the item number for the signal processing vector
-/// @return Item number
-int SignalProcessing::GetItem()
+
+/// @brief Records the current allocation position
+/// @return Mark to pass to Release()
+size_t SignalWorkspace::Mark()
 {
-	return (this->item);
+	return this->used;
 }
-/// @brief Gets the signal processing vector
-/// @param signalProc_vector Contains the signal processing vector
-/// @return void
-void SignalProcessing::GetVector(double *signalProc_vector)
+
+/// @brief Frees everything allocated since a mark
+/// @param mark Value returned by Mark()
+void SignalWorkspace::Release(size_t mark)
 {
-	if(signalProc_vector != nullptr)
+	while (this->overflow != nullptr && ((WorkspaceBlock *)this->overflow)->offset >= mark)
 	{
-		for (int i = 0; i < this->index-1; i++)
-		{
-			signalProc_vector[i] = this->SignalVector[i];
-		}
+		void *next = ((WorkspaceBlock *)this->overflow)->next;
+		AlignedFree(this->overflow);
+		this->overflow = next;
 	}
-}
-/// @brief Gets the signal processing vector as int
-/// @param signalProc_vector Contains int signal processing vector
-/// @return void
-void SignalProcessing::GetVectorInt(int *signalProc_vector, int size)
-{
-	if (signalProc_vector != nullptr)
+	if (mark < this->used)
 	{
-		for (int i = 0; i < size; i++)
-		{
-			signalProc_vector[i] = (int)(this->SignalVector[i]);
-		}
+		this->used = mark;
+	}
+	if (this->used == 0 && this->peak > this->size)
+	{
+		this->Reserve(this->peak);
 	}
 }
 
-/// @brief Prints the signal processing vector
-/// @return void
-void SignalProcessing::PrintVector()
+// ========== FFT PLAN IMPLEMENTATION ==========
+
+/// @brief Process-wide plans, indexed by direction (0 = forward) and log2 of the size
+static std::atomic<FFTPlan *> fft_plans[2][31];
+
+/// @brief Process-wide plans of the other lengths, one insert-only list per direction
+static std::atomic<FFTPlan *> fft_other_plans[2];
+
+/// @brief Butterfly kernel of all plans, -1 until detected
+static std::atomic<int> fft_kernel(-1);
+
+// vector kernels use the GCC/Clang vector extensions: one kernel source,
+// compiled for each instruction set through target attributes
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define FFT_X86_KERNELS 1
+#endif
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__aarch64__))
+	#define FFT_VECTOR128_KERNELS 1
+#endif
+#if defined(__GNUC__)
+	#define FFT_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+	#define FFT_ALWAYS_INLINE inline
+#endif
+
+/// @brief Vector of W lanes of Acc (the scalar itself for W = 1)
+template <typename Acc, int W>
+struct FFTVector
+{
+#if defined(__GNUC__)
+	typedef Acc Type __attribute__((vector_size(W * sizeof(Acc))));
+#endif
+};
+
+template <typename Acc>
+struct FFTVector<Acc, 1>
+{
+	typedef Acc Type;
+};
+
+/// @brief Integer of the size of Acc, the lane type of shuffle masks
+template <typename Acc>
+struct FFTLaneIndex;
+
+template <>
+struct FFTLaneIndex<double>
+{
+	typedef long long Type;
+};
+
+template <>
+struct FFTLaneIndex<float>
+{
+	typedef int Type;
+};
+
+/// @brief Twiddles of a pass on vectors of W lanes with L values per point: W consecutive
+/// twiddles for one transform (L = 1), one twiddle for all lanes of a batch (L = W)
+template <typename Acc, int W, int L>
+struct FFTTwiddle
 {
-	for (int i = 0; i < this->GetIndex(); i++)
+	typedef typename FFTVector<Acc, W>::Type Type;
+
+	static FFT_ALWAYS_INLINE void Load(Type &t, const Acc *twiddle)
 	{
-		printf("\nSignalVector[%d] = %f", i, SignalVector[i]);
+		memcpy(&t, twiddle, sizeof(Type));
 	}
-	printf("\n------------------------------------------------");
-}	
+};
 
+template <typename Acc, int W>
+struct FFTTwiddle<Acc, W, W>
+{
+	typedef Acc Type;
 
-/// @brief Gets the signal processing vector with offset
-/// @param signalProc_vector Contains the signal processing vector
-/// @return void
-void SignalProcessing::GetVectorWithOffset(double *signalProc_vector,int size, int offset)
+	static FFT_ALWAYS_INLINE void Load(Type &t, const Acc *twiddle)
+	{
+		t = *twiddle;
+	}
+};
+
+/// @brief One radix-4 pass: the radix-2 stages of half-length half and 2 * half
+/// @param size Transform length
+/// @param half Half-length of the first merged stage, a multiple of W / L
+/// @param twiddle_real Twiddles of all stages (real parts)
+/// @param twiddle_imag Twiddles of all stages (imaginary parts)
+/// @param direction 1 = forward, -1 = inverse
+/// @param real Real parts, L values per point
+/// @param imag Imaginary parts, L values per point
+template <typename Acc, int W, int L>
+static FFT_ALWAYS_INLINE void Radix4Pass(int size, int half, const Acc *twiddle_real, const Acc *twiddle_imag,
+                                         Acc direction, Acc *real, Acc *imag)
 {
-	if (signalProc_vector != nullptr)
+	typedef typename FFTVector<Acc, W>::Type Vec;
+	typedef FFTTwiddle<Acc, W, L> Twiddle;
+	typedef typename Twiddle::Type Tw;
+	const Acc *w1r = twiddle_real + half - 1;
+	const Acc *w1i = twiddle_imag + half - 1;
+	const Acc *w2r = twiddle_real + 2 * half - 1;
+	const Acc *w2i = twiddle_imag + 2 * half - 1;
+	for (int start = 0; start < size; start += 4 * half)
 	{
-		for (int i = 0; i < size; i++)
+		Acc *r = real + (size_t)start * L;
+		Acc *i = imag + (size_t)start * L;
+		for (int k = 0; k < half; k += W / L)
 		{
-			signalProc_vector[i] = this->SignalVector[i + offset];
+			Vec a0r, a0i, a1r, a1i, a2r, a2i, a3r, a3i;
+			memcpy(&a0r, r + (size_t)k * L, sizeof(Vec));
+			memcpy(&a0i, i + (size_t)k * L, sizeof(Vec));
+			memcpy(&a1r, r + (size_t)(half + k) * L, sizeof(Vec));
+			memcpy(&a1i, i + (size_t)(half + k) * L, sizeof(Vec));
+			memcpy(&a2r, r + (size_t)(2 * half + k) * L, sizeof(Vec));
+			memcpy(&a2i, i + (size_t)(2 * half + k) * L, sizeof(Vec));
+			memcpy(&a3r, r + (size_t)(3 * half + k) * L, sizeof(Vec));
+			memcpy(&a3i, i + (size_t)(3 * half + k) * L, sizeof(Vec));
+			Tw t1r, t1i, t2r, t2i;
+			Twiddle::Load(t1r, w1r + k);
+			Twiddle::Load(t1i, w1i + k);
+			Twiddle::Load(t2r, w2r + k);
+			Twiddle::Load(t2i, w2i + k);
+
+			// first stage: pairs (0, 1) and (2, 3) with twiddle t1
+			Vec xr = t1r * a1r - t1i * a1i;
+			Vec xi = t1r * a1i + t1i * a1r;
+			Vec yr = t1r * a3r - t1i * a3i;
+			Vec yi = t1r * a3i + t1i * a3r;
+			Vec b0r = a0r + xr, b0i = a0i + xi, b1r = a0r - xr, b1i = a0i - xi;
+			Vec b2r = a2r + yr, b2i = a2i + yi, b3r = a2r - yr, b3i = a2i - yi;
+
+			// second stage: pairs (0, 2) with t2 and (1, 3) with t2 * i * direction
+			Vec ur = t2r * b2r - t2i * b2i;
+			Vec ui = t2r * b2i + t2i * b2r;
+			Vec vr = -direction * (t2r * b3i + t2i * b3r);
+			Vec vi = direction * (t2r * b3r - t2i * b3i);
+			Vec c0r = b0r + ur, c0i = b0i + ui, c2r = b0r - ur, c2i = b0i - ui;
+			Vec c1r = b1r + vr, c1i = b1i + vi, c3r = b1r - vr, c3i = b1i - vi;
+
+			memcpy(r + (size_t)k * L, &c0r, sizeof(Vec));
+			memcpy(i + (size_t)k * L, &c0i, sizeof(Vec));
+			memcpy(r + (size_t)(half + k) * L, &c1r, sizeof(Vec));
+			memcpy(i + (size_t)(half + k) * L, &c1i, sizeof(Vec));
+			memcpy(r + (size_t)(2 * half + k) * L, &c2r, sizeof(Vec));
+			memcpy(i + (size_t)(2 * half + k) * L, &c2i, sizeof(Vec));
+			memcpy(r + (size_t)(3 * half + k) * L, &c3r, sizeof(Vec));
+			memcpy(i + (size_t)(3 * half + k) * L, &c3i, sizeof(Vec));
 		}
 	}
 }
-/// @brief Initializes the signal processing vector
-/// @param values Contains signal processing vector which will be copied to SignalVector
-/// @param size Contains size of the signal processing vector which will be copied to SignalVector
-/// @return void
-void SignalProcessing::InitVector(double *values,int size)
+
+/// @brief One radix-3 pass combining sub-transforms of span points
+/// @param size Transform length
+/// @param span Length of the sub-transforms, a multiple of W / L
+/// @param twiddle_real Twiddles of all stages (real parts)
+/// @param twiddle_imag Twiddles of all stages (imaginary parts)
+/// @param direction 1 = forward, -1 = inverse
+/// @param real Real parts, L values per point
+/// @param imag Imaginary parts, L values per point
+template <typename Acc, int W, int L>
+static FFT_ALWAYS_INLINE void Radix3Pass(int size, int span, const Acc *twiddle_real, const Acc *twiddle_imag,
+                                         Acc direction, Acc *real, Acc *imag)
 {
-	if (values != nullptr)
+	typedef typename FFTVector<Acc, W>::Type Vec;
+	typedef FFTTwiddle<Acc, W, L> Twiddle;
+	typedef typename Twiddle::Type Tw;
+	const Acc *w1r = twiddle_real + span - 1;
+	const Acc *w1i = twiddle_imag + span - 1;
+	const Acc *w2r = w1r + span;
+	const Acc *w2i = w1i + span;
+	Acc sin60 = direction * (Acc)0.86602540378443864676;
+	for (int start = 0; start < size; start += 3 * span)
 	{
-		for (int i = 0; i < size; ++i)
+		Acc *r = real + (size_t)start * L;
+		Acc *i = imag + (size_t)start * L;
+		for (int k = 0; k < span; k += W / L)
 		{
-			this->SignalVector[i] = values[i];
+			Vec a0r, a0i, a1r, a1i, a2r, a2i;
+			memcpy(&a0r, r + (size_t)k * L, sizeof(Vec));
+			memcpy(&a0i, i + (size_t)k * L, sizeof(Vec));
+			memcpy(&a1r, r + (size_t)(span + k) * L, sizeof(Vec));
+			memcpy(&a1i, i + (size_t)(span + k) * L, sizeof(Vec));
+			memcpy(&a2r, r + (size_t)(2 * span + k) * L, sizeof(Vec));
+			memcpy(&a2i, i + (size_t)(2 * span + k) * L, sizeof(Vec));
+			Tw t1r, t1i, t2r, t2i;
+			Twiddle::Load(t1r, w1r + k);
+			Twiddle::Load(t1i, w1i + k);
+			Twiddle::Load(t2r, w2r + k);
+			Twiddle::Load(t2i, w2i + k);
+
+			Vec b1r = t1r * a1r - t1i * a1i;
+			Vec b1i = t1r * a1i + t1i * a1r;
+			Vec b2r = t2r * a2r - t2i * a2i;
+			Vec b2i = t2r * a2i + t2i * a2r;
+
+			// y0 = a0 + s, y1 = m + i sin60 d, y2 = m - i sin60 d
+			Vec sr = b1r + b2r, si = b1i + b2i;
+			Vec mr = a0r - (Acc)0.5 * sr, mi = a0i - (Acc)0.5 * si;
+			Vec vr = -sin60 * (b1i - b2i), vi = sin60 * (b1r - b2r);
+			Vec y0r = a0r + sr, y0i = a0i + si;
+			Vec y1r = mr + vr, y1i = mi + vi, y2r = mr - vr, y2i = mi - vi;
+
+			memcpy(r + (size_t)k * L, &y0r, sizeof(Vec));
+			memcpy(i + (size_t)k * L, &y0i, sizeof(Vec));
+			memcpy(r + (size_t)(span + k) * L, &y1r, sizeof(Vec));
+			memcpy(i + (size_t)(span + k) * L, &y1i, sizeof(Vec));
+			memcpy(r + (size_t)(2 * span + k) * L, &y2r, sizeof(Vec));
+			memcpy(i + (size_t)(2 * span + k) * L, &y2i, sizeof(Vec));
 		}
-		this->index = size + 1;
 	}
 }
-/// @brief Multiplies the signal processing vector with a scalar value
-/// @param value Value
-/// @param size Number of elements to multiply
-/// @return void
-void SignalProcessing::MultiplyWithValue(double value, int size)
+
+/// @brief One radix-5 pass combining sub-transforms of span points
+/// @param size Transform length
+/// @param span Length of the sub-transforms, a multiple of W / L
+/// @param twiddle_real Twiddles of all stages (real parts)
+/// @param twiddle_imag Twiddles of all stages (imaginary parts)
+/// @param direction 1 = forward, -1 = inverse
+/// @param real Real parts, L values per point
+/// @param imag Imaginary parts, L values per point
+template <typename Acc, int W, int L>
+static FFT_ALWAYS_INLINE void Radix5Pass(int size, int span, const Acc *twiddle_real, const Acc *twiddle_imag,
+                                         Acc direction, Acc *real, Acc *imag)
 {
-	for (int i = 0; i < size; ++i)
+	typedef typename FFTVector<Acc, W>::Type Vec;
+	typedef FFTTwiddle<Acc, W, L> Twiddle;
+	typedef typename Twiddle::Type Tw;
+	const Acc *w1r = twiddle_real + span - 1;
+	const Acc *w1i = twiddle_imag + span - 1;
+	const Acc cos72 = (Acc)0.30901699437494742410;
+	const Acc cos144 = (Acc)-0.80901699437494742410;
+	Acc sin72 = direction * (Acc)0.95105651629515357212;
+	Acc sin144 = direction * (Acc)0.58778525229247312917;
+	for (int start = 0; start < size; start += 5 * span)
 	{
-		if (i<=this->index)
+		Acc *r = real + (size_t)start * L;
+		Acc *i = imag + (size_t)start * L;
+		for (int k = 0; k < span; k += W / L)
 		{
-			this->SignalVector[i] *= value;
+			Vec a0r, a0i, ar[4], ai[4];
+			memcpy(&a0r, r + (size_t)k * L, sizeof(Vec));
+			memcpy(&a0i, i + (size_t)k * L, sizeof(Vec));
+			for (int j = 0; j < 4; ++j)
+			{
+				Vec xr, xi;
+				memcpy(&xr, r + (size_t)((j + 1) * span + k) * L, sizeof(Vec));
+				memcpy(&xi, i + (size_t)((j + 1) * span + k) * L, sizeof(Vec));
+				Tw tr, ti;
+				Twiddle::Load(tr, w1r + j * span + k);
+				Twiddle::Load(ti, w1i + j * span + k);
+				ar[j] = tr * xr - ti * xi;
+				ai[j] = tr * xi + ti * xr;
+			}
+
+			// sums and differences of the symmetric pairs (1, 4) and (2, 3)
+			Vec s1r = ar[0] + ar[3], s1i = ai[0] + ai[3], d1r = ar[0] - ar[3], d1i = ai[0] - ai[3];
+			Vec s2r = ar[1] + ar[2], s2i = ai[1] + ai[2], d2r = ar[1] - ar[2], d2i = ai[1] - ai[2];
+			Vec y0r = a0r + s1r + s2r, y0i = a0i + s1i + s2i;
+			Vec m1r = a0r + cos72 * s1r + cos144 * s2r, m1i = a0i + cos72 * s1i + cos144 * s2i;
+			Vec m2r = a0r + cos144 * s1r + cos72 * s2r, m2i = a0i + cos144 * s1i + cos72 * s2i;
+			// i times (sin72 d1 + sin144 d2) and (sin144 d1 - sin72 d2)
+			Vec v1r = -(sin72 * d1i + sin144 * d2i), v1i = sin72 * d1r + sin144 * d2r;
+			Vec v2r = -(sin144 * d1i - sin72 * d2i), v2i = sin144 * d1r - sin72 * d2r;
+			Vec y1r = m1r + v1r, y1i = m1i + v1i, y4r = m1r - v1r, y4i = m1i - v1i;
+			Vec y2r = m2r + v2r, y2i = m2i + v2i, y3r = m2r - v2r, y3i = m2i - v2i;
+
+			memcpy(r + (size_t)k * L, &y0r, sizeof(Vec));
+			memcpy(i + (size_t)k * L, &y0i, sizeof(Vec));
+			memcpy(r + (size_t)(span + k) * L, &y1r, sizeof(Vec));
+			memcpy(i + (size_t)(span + k) * L, &y1i, sizeof(Vec));
+			memcpy(r + (size_t)(2 * span + k) * L, &y2r, sizeof(Vec));
+			memcpy(i + (size_t)(2 * span + k) * L, &y2i, sizeof(Vec));
+			memcpy(r + (size_t)(3 * span + k) * L, &y3r, sizeof(Vec));
+			memcpy(i + (size_t)(3 * span + k) * L, &y3i, sizeof(Vec));
+			memcpy(r + (size_t)(4 * span + k) * L, &y4r, sizeof(Vec));
+			memcpy(i + (size_t)(4 * span + k) * L, &y4i, sizeof(Vec));
 		}
 	}
 }
-/// @brief Subtracts a scalar value from the signal processing vector
-/// @param value Value
-/// @param size Number of elements to subtract
-/// @return void
-void SignalProcessing::SubstractWithValue(double value, int size)
+
+/// @brief Passes on vectors of W lanes, or on the widest narrower vectors that fit a shorter stage
+template <typename Acc, int W>
+struct FFTWidth
 {
-	for (int i = 0; i < size; ++i)
+	/// @brief Radix-4 pass, see Radix4Pass()
+	static FFT_ALWAYS_INLINE void Radix4(int size, int half, const Acc *twiddle_real, const Acc *twiddle_imag,
+	                                     Acc direction, Acc *real, Acc *imag)
 	{
-		if (i <= this->index)
+		if (half < W)
 		{
-			this->SignalVector[i] -= value;
+			FFTWidth<Acc, W / 2>::Radix4(size, half, twiddle_real, twiddle_imag, direction, real, imag);
+		}
+		else
+		{
+			Radix4Pass<Acc, W, 1>(size, half, twiddle_real, twiddle_imag, direction, real, imag);
 		}
 	}
-}
-/// @brief Divides the signal processing vector by a scalar value
-/// @param value Value
-/// @param size Number of elements to divide
-/// @return void
-void SignalProcessing::DivideWithValue(double value, int size)
-{
-	if (value != 0)
+
+	/// @brief Radix-3 pass, see Radix3Pass(); lanes is the power-of-two factor of span
+	static FFT_ALWAYS_INLINE void Radix3(int size, int span, int lanes, const Acc *twiddle_real,
+	                                     const Acc *twiddle_imag, Acc direction, Acc *real, Acc *imag)
 	{
-		for (int i = 0; i < size; ++i)
+		if (lanes < W)
 		{
-			if (i <= this->index)
-			{
-				this->SignalVector[i] /= value;
-			}
+			FFTWidth<Acc, W / 2>::Radix3(size, span, lanes, twiddle_real, twiddle_imag, direction, real, imag);
+		}
+		else
+		{
+			Radix3Pass<Acc, W, 1>(size, span, twiddle_real, twiddle_imag, direction, real, imag);
 		}
 	}
-}
-/// @brief Adds a scalar value to the signal processing vector
-/// @param value Value
-/// @param size Number of elements to add
-/// @return void
-void SignalProcessing::AddWithValue(double value, int size)
-{
-	for (int i = 0; i < size; ++i)
+
+	/// @brief Radix-5 pass, see Radix5Pass(); lanes is the power-of-two factor of span
+	static FFT_ALWAYS_INLINE void Radix5(int size, int span, int lanes, const Acc *twiddle_real,
+	                                     const Acc *twiddle_imag, Acc direction, Acc *real, Acc *imag)
 	{
-		if (i <= this->index)
+		if (lanes < W)
+		{
+			FFTWidth<Acc, W / 2>::Radix5(size, span, lanes, twiddle_real, twiddle_imag, direction, real, imag);
+		}
+		else
 		{
-			this->SignalVector[i] += value;
+			Radix5Pass<Acc, W, 1>(size, span, twiddle_real, twiddle_imag, direction, real, imag);
 		}
 	}
-}
+};
 
-/// @brief Creates a normal distribution
-/// @return prob_dist
-prob_dist *SignalProcessing::NormalDistributionCreate()
+template <typename Acc>
+struct FFTWidth<Acc, 1>
 {
-	/* allocate memory for prob _distrib*/
-	prob_dist *pd = (prob_dist *)malloc(sizeof(prob_dist));
-
-	pd->count = 0;
-	pd->items = NULL;
+	static FFT_ALWAYS_INLINE void Radix4(int size, int half, const Acc *twiddle_real, const Acc *twiddle_imag,
+	                                     Acc direction, Acc *real, Acc *imag)
+	{
+		Radix4Pass<Acc, 1, 1>(size, half, twiddle_real, twiddle_imag, direction, real, imag);
+	}
 
-	pd->total_probability = 0;
-	pd->total_normal_probability = 0;
-	pd->total_normal_frequency = 0;
+	static FFT_ALWAYS_INLINE void Radix3(int size, int span, int, const Acc *twiddle_real, const Acc *twiddle_imag,
+	                                     Acc direction, Acc *real, Acc *imag)
+	{
+		Radix3Pass<Acc, 1, 1>(size, span, twiddle_real, twiddle_imag, direction, real, imag);
+	}
 
-	return pd;
-}
+	static FFT_ALWAYS_INLINE void Radix5(int size, int span, int, const Acc *twiddle_real, const Acc *twiddle_imag,
+	                                     Acc direction, Acc *real, Acc *imag)
+	{
+		Radix5Pass<Acc, 1, 1>(size, span, twiddle_real, twiddle_imag, direction, real, imag);
+	}
+};
 
-/// @brief Calculates the normal distribution
-/// @param data Contains values
-/// @param size Number of elements to add
-/// @param pd Probability distribution
-/// @return void
-void SignalProcessing::NormalDistributionCalculate(double *data, int size, prob_dist *pd)
+/// @brief All passes after the digit reversal, on vectors of up to W lanes
+/// @param size Transform length
+/// @param power_of_two Power-of-two factor of size
+/// @param first_half Half-length of the first radix-4 pass (1, or 2 after a lone radix-2 stage)
+/// @param num_radix3 Number of radix-3 passes
+/// @param num_radix5 Number of radix-5 passes
+/// @param twiddle_real Twiddles of all stages (real parts)
+/// @param twiddle_imag Twiddles of all stages (imaginary parts)
+/// @param direction 1 = forward, -1 = inverse
+/// @param real Real parts
+/// @param imag Imaginary parts
+template <typename Acc, int W>
+static FFT_ALWAYS_INLINE void FFTPasses(int size, int power_of_two, int first_half, int num_radix3, int num_radix5,
+                                        const Acc *twiddle_real, const Acc *twiddle_imag, Acc direction, Acc *real,
+                                        Acc *imag)
 {
-	int index;
-	double total = 0;
-	double sumofsquares = 0;
-	double mean;
-	double variance;
-	double stddev;
-	if ((pd == NULL) || (data == NULL))
+	for (int half = first_half; 4 * half <= power_of_two; half *= 4)
 	{
-		return;
+		FFTWidth<Acc, W>::Radix4(size, half, twiddle_real, twiddle_imag, direction, real, imag);
 	}
-	pd->total_frequency = size;
 
-	// CALCULATE FREQUENCIES
-	// iterate data
-	// add new values to pd
-	// or
-	// increment frequency of existing values
-	for (int i = 0; i < size; i++)
+	// spans of the odd radices are multiples of power_of_two
+	int span = power_of_two;
+	for (int s = 0; s < num_radix3; ++s, span *= 3)
 	{
-		index = this->IndexOf(data[i], pd);
+		FFTWidth<Acc, W>::Radix3(size, span, power_of_two, twiddle_real, twiddle_imag, direction, real, imag);
+	}
+	for (int s = 0; s < num_radix5; ++s, span *= 5)
+	{
+		FFTWidth<Acc, W>::Radix5(size, span, power_of_two, twiddle_real, twiddle_imag, direction, real, imag);
+	}
+}
 
-		// already exists
-		if (index >= 0)
+#ifdef FFT_X86_KERNELS
+/// @brief Passes on 256-bit vectors with FMA
+template <typename Acc>
+__attribute__((target("avx2,fma"))) static void FFTPassesAVX2(int size, int power_of_two, int first_half,
+                                                              int num_radix3, int num_radix5,
+                                                              const Acc *twiddle_real, const Acc *twiddle_imag,
+                                                              Acc direction, Acc *real, Acc *imag)
+{
+	FFTPasses<Acc, 32 / sizeof(Acc)>(size, power_of_two, first_half, num_radix3, num_radix5, twiddle_real,
+	                                  twiddle_imag, direction, real, imag);
+	__builtin_ia32_vzeroupper();   // see the kernel switch of FFTPlan::Transform()
+}
+
+/// @brief Passes on 512-bit vectors
+template <typename Acc>
+__attribute__((target("avx512f"))) static void FFTPassesAVX512(int size, int power_of_two, int first_half,
+                                                               int num_radix3, int num_radix5,
+                                                               const Acc *twiddle_real, const Acc *twiddle_imag,
+                                                               Acc direction, Acc *real, Acc *imag)
+{
+	FFTPasses<Acc, 64 / sizeof(Acc)>(size, power_of_two, first_half, num_radix3, num_radix5, twiddle_real,
+	                                  twiddle_imag, direction, real, imag);
+	__builtin_ia32_vzeroupper();   // see the kernel switch of FFTPlan::Transform()
+}
+#endif
+
+/// @brief Points transposed at a time between the channels and the vector lanes of a batch transform
+#define FFT_BATCH_BLOCK 32
+
+// GCC shuffles vectors of any width with a mask vector (Clang only with constant indices)
+#if defined(__GNUC__) && !defined(__clang__)
+	#define FFT_BATCH_TRANSPOSE 1
+#endif
+
+/// @brief Transposes W vectors of W lanes in registers: lane j of v[i] becomes lane i of v[j]
+template <typename Acc, int W>
+struct FFTTranspose
+{
+	typedef typename FFTVector<Acc, W>::Type Vec;
+
+	static FFT_ALWAYS_INLINE void Apply(Vec *v)
+	{
+#ifdef FFT_BATCH_TRANSPOSE
+		// log2(W) perfect shuffles: rows i and i + W / 2 interleaved into rows 2 i and 2 i + 1
+		typedef typename FFTVector<typename FFTLaneIndex<Acc>::Type, W>::Type Mask;
+		Mask low, high;
+		for (int j = 0; j < W; ++j)
 		{
-			pd->items[index].frequency++;
+			low[j] = (j % 2 == 0) ? j / 2 : W + j / 2;
+			high[j] = low[j] + W / 2;
 		}
-		// does not exist
-		else
+		for (int round = 1; round < W; round *= 2)
 		{
-			pd->count++;
-
-			// first item
-			if (pd->items == NULL)
+			Vec t[W];
+			for (int i = 0; i < W / 2; ++i)
 			{
-				pd->items = (prob_dist_item *)malloc(sizeof(prob_dist_item));
+				t[2 * i] = __builtin_shuffle(v[i], v[i + W / 2], low);
+				t[2 * i + 1] = __builtin_shuffle(v[i], v[i + W / 2], high);
 			}
-			else
+			for (int i = 0; i < W; ++i)
 			{
-				pd->items = (prob_dist_item *)realloc(pd->items, sizeof(prob_dist_item) * pd->count);
+				v[i] = t[i];
 			}
-
-			pd->items[pd->count - 1].value = data[i];
-			pd->items[pd->count - 1].frequency = 1;
 		}
-
-		total += data[i];
-		sumofsquares += pow(data[i], 2);
+#else
+		(void)v;
+#endif
 	}
+};
 
-	// SORT ITEMS
-	qsort(pd->items, pd->count, sizeof(prob_dist_item), CompareProbDistItem);
+template <typename Acc>
+struct FFTTranspose<Acc, 1>
+{
+	static FFT_ALWAYS_INLINE void Apply(Acc *)
+	{
+	}
+};
 
-	// CALCULATE MEAN, VARIANCE AND STANDARD DEVIATION
-	mean = total / size;
-	variance = (sumofsquares - ((pow(total, 2)) / size)) / size;
-	stddev = sqrt(variance);
+/// @brief Tables and data of a batch of real transforms, see FFTPlan::ExecuteRealBatch()
+template <typename Acc>
+struct FFTBatchJob
+{
+	int size;
+	int power_of_two;
+	int num_radix3;
+	int num_radix5;
+	const int *swaps;
+	int num_swaps;
+	const Acc *twiddle_real;
+	const Acc *twiddle_imag;
+	Acc direction;
+	const Acc *input;
+	int num_channels;
+	int channel_step;
+	int sample_step;
+	Acc *real;
+	Acc *imag;
+	/// @brief Complex transforms of a group, point n of lane l at n * W + l: real parts, then
+	/// FFT_BATCH_LANES values of padding (real and imaginary parts 4 KB apart would alias) and imaginary parts
+	Acc *group;
+};
 
-	// CALCULATE PROBABILITIES OF EACH UNIQUE VALUE
-	for (int c = 0; c < pd->count; c++)
+/// @brief Real transforms of all channels, two channels per lane of vectors of W lanes
+/// @param job Tables, input and output
+template <typename Acc, int W>
+static FFT_ALWAYS_INLINE void FFTBatch(const FFTBatchJob<Acc> &job)
+{
+	typedef typename FFTVector<Acc, W>::Type Vec;
+	int size = job.size;
+	size_t num_bins = (size_t)(size / 2 + 1);
+	Acc direction = job.direction;
+	Acc *group_real = job.group;
+	Acc *group_imag = job.group + (size_t)size * W + FFT_BATCH_LANES;
+
+	// odd number of radix-2 stages: the first one alone, as in FFTPlan::Transform()
+	int first_half = 1;
+	int log2_size = 0;
+	while ((1 << log2_size) < job.power_of_two)
 	{
-		pd->items[c].probability = (double)pd->items[c].frequency / (double)size;
-		pd->items[c].normal_probability = ((1.0 / (stddev * sqrt(2.0 * M_PI))) * (pow(M_E, -1.0 * ((pow((pd->items[c].value - mean), 2.0)) / (variance * 2.0)))));
-		pd->items[c].normal_frequency = pd->items[c].normal_probability * size;
-		pd->total_probability += pd->items[c].probability;
-		pd->total_normal_probability += pd->items[c].normal_probability;
-		pd->total_normal_frequency += pd->items[c].normal_frequency;
+		log2_size++;
+	}
+	if (log2_size % 2 == 1)
+	{
+		first_half = 2;
+	}
+
+	for (int first = 0; first < job.num_channels; first += 2 * W)
+	{
+		// lane l: channel first + 2 l as real part and first + 2 l + 1 as imaginary part; lanes past the
+		// last channel repeat it and are not written out
+		const Acc *x[2 * W];
+		for (int l = 0; l < 2 * W; ++l)
+		{
+			int channel = (first + l < job.num_channels) ? first + l : job.num_channels - 1;
+			x[l] = job.input + (size_t)channel * job.channel_step;
+		}
+		int n = 0;
+#ifdef FFT_BATCH_TRANSPOSE
+		// planar channels: W samples of each channel per vector load, turned into W points in registers
+		if (W > 1 && job.sample_step == 1)
+		{
+			for (; n + W <= size; n += W)
+			{
+				Vec vr[W], vi[W];
+				for (int l = 0; l < W; ++l)
+				{
+					memcpy(&vr[l], x[2 * l] + n, sizeof(Vec));
+					memcpy(&vi[l], x[2 * l + 1] + n, sizeof(Vec));
+				}
+				FFTTranspose<Acc, W>::Apply(vr);
+				FFTTranspose<Acc, W>::Apply(vi);
+				memcpy(group_real + (size_t)n * W, vr, sizeof(vr));
+				memcpy(group_imag + (size_t)n * W, vi, sizeof(vi));
+			}
+		}
+#endif
+		for (; n < size; ++n)
+		{
+			size_t offset = (size_t)n * job.sample_step;
+			Acc *zr = group_real + (size_t)n * W;
+			Acc *zi = group_imag + (size_t)n * W;
+			for (int l = 0; l < W; ++l)
+			{
+				zr[l] = x[2 * l][offset];
+				zi[l] = x[2 * l + 1][offset];
+			}
+		}
+
+		for (int s = 0; s < job.num_swaps; ++s)
+		{
+			size_t i = (size_t)job.swaps[2 * s] * W;
+			size_t j = (size_t)job.swaps[2 * s + 1] * W;
+			Vec ar, ai, br, bi;
+			memcpy(&ar, group_real + i, sizeof(Vec));
+			memcpy(&ai, group_imag + i, sizeof(Vec));
+			memcpy(&br, group_real + j, sizeof(Vec));
+			memcpy(&bi, group_imag + j, sizeof(Vec));
+			memcpy(group_real + i, &br, sizeof(Vec));
+			memcpy(group_imag + i, &bi, sizeof(Vec));
+			memcpy(group_real + j, &ar, sizeof(Vec));
+			memcpy(group_imag + j, &ai, sizeof(Vec));
+		}
+
+		if (first_half == 2)
+		{
+			for (size_t k = 0; k < (size_t)size * W; k += 2 * W)
+			{
+				Vec ar, ai, br, bi;
+				memcpy(&ar, group_real + k, sizeof(Vec));
+				memcpy(&ai, group_imag + k, sizeof(Vec));
+				memcpy(&br, group_real + k + W, sizeof(Vec));
+				memcpy(&bi, group_imag + k + W, sizeof(Vec));
+				Vec sr = ar + br, si = ai + bi, dr = ar - br, di = ai - bi;
+				memcpy(group_real + k, &sr, sizeof(Vec));
+				memcpy(group_imag + k, &si, sizeof(Vec));
+				memcpy(group_real + k + W, &dr, sizeof(Vec));
+				memcpy(group_imag + k + W, &di, sizeof(Vec));
+			}
+		}
+
+		// butterflies on whole vectors, one twiddle for all lanes
+		for (int half = first_half; 4 * half <= job.power_of_two; half *= 4)
+		{
+			Radix4Pass<Acc, W, W>(size, half, job.twiddle_real, job.twiddle_imag, direction, group_real, group_imag);
+		}
+		int span = job.power_of_two;
+		for (int s = 0; s < job.num_radix3; ++s, span *= 3)
+		{
+			Radix3Pass<Acc, W, W>(size, span, job.twiddle_real, job.twiddle_imag, direction, group_real, group_imag);
+		}
+		for (int s = 0; s < job.num_radix5; ++s, span *= 5)
+		{
+			Radix5Pass<Acc, W, W>(size, span, job.twiddle_real, job.twiddle_imag, direction, group_real, group_imag);
+		}
+
+		// A[k] = (Z[k] + conj(Z[size - k])) / 2 and B[k] = (Z[k] - conj(Z[size - k])) / 2i, the spectra
+		// of the real and imaginary parts (1 / size more for inverse plans); a block of bins is computed,
+		// then written channel by channel so that every output row is written sequentially
+		Acc scale = (direction < 0) ? (Acc)0.5 / (Acc)size : (Acc)0.5;
+		int lanes = (job.num_channels - first < 2 * W) ? job.num_channels - first : 2 * W;
+		Vec spectra[4][FFT_BATCH_BLOCK];
+		for (size_t start = 0; start < num_bins; start += FFT_BATCH_BLOCK)
+		{
+			int count = (num_bins - start < FFT_BATCH_BLOCK) ? (int)(num_bins - start) : FFT_BATCH_BLOCK;
+			for (int b = 0; b < count; ++b)
+			{
+				size_t k = start + b;
+				size_t m = (k == 0) ? 0 : (size_t)size - k;
+				Vec zr_k, zi_k, zr_m, zi_m;
+				memcpy(&zr_k, group_real + k * W, sizeof(Vec));
+				memcpy(&zi_k, group_imag + k * W, sizeof(Vec));
+				memcpy(&zr_m, group_real + m * W, sizeof(Vec));
+				memcpy(&zi_m, group_imag + m * W, sizeof(Vec));
+				spectra[0][b] = (zr_k + zr_m) * scale;
+				spectra[1][b] = (zi_k - zi_m) * scale;
+				spectra[2][b] = (zi_k + zi_m) * scale;
+				spectra[3][b] = (zr_m - zr_k) * scale;
+			}
+			const Acc *parts = (const Acc *)spectra;
+			for (int l = 0; l < lanes; ++l)
+			{
+				const Acc *part_real = parts + (size_t)(2 * (l % 2)) * FFT_BATCH_BLOCK * W + l / 2;
+				const Acc *part_imag = part_real + (size_t)FFT_BATCH_BLOCK * W;
+				Acc *out_real = job.real + (size_t)(first + l) * num_bins + start;
+				Acc *out_imag = job.imag + (size_t)(first + l) * num_bins + start;
+				for (int b = 0; b < count; ++b)
+				{
+					out_real[b] = part_real[(size_t)b * W];
+					out_imag[b] = part_imag[(size_t)b * W];
+				}
+			}
+		}
 	}
 }
 
-/// @brief Prints the normal distribution
-/// @param pd Probability distribution
-/// @return void
-void SignalProcessing::NormalDistributionPrint(prob_dist *pd)
+#ifdef FFT_X86_KERNELS
+/// @brief Batch of real transforms on 256-bit vectors with FMA
+template <typename Acc>
+__attribute__((target("avx2,fma"))) static void FFTBatchAVX2(const FFTBatchJob<Acc> &job)
 {
-	printf("Value | Probability | Normal Prob | Freq | Normal Freq\n------------------------------------------------------\n");
+	FFTBatch<Acc, 32 / sizeof(Acc)>(job);
+	__builtin_ia32_vzeroupper();   // see the kernel switch of FFTPlan::Transform()
+}
 
-	for (int i = 0; i < pd->count; i++)
+/// @brief Batch of real transforms on 512-bit vectors
+template <typename Acc>
+__attribute__((target("avx512f"))) static void FFTBatchAVX512(const FFTBatchJob<Acc> &job)
+{
+	FFTBatch<Acc, 64 / sizeof(Acc)>(job);
+	__builtin_ia32_vzeroupper();   // see the kernel switch of FFTPlan::Transform()
+}
+#endif
+
+/// @brief Picks the widest kernel the CPU supports
+/// @return FFT_KERNEL_* constant
+static int DetectFFTKernel()
+{
+#ifdef FFT_X86_KERNELS
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
 	{
-		printf("%f |%12.6lf |%12.4lf |%5d |%12.4lf\n", pd->items[i].value, pd->items[i].probability, pd->items[i].normal_probability, pd->items[i].frequency, pd->items[i].normal_frequency);
+		return FFT_KERNEL_AVX512;
 	}
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		return FFT_KERNEL_AVX2;
+	}
+#endif
+#if defined(FFT_VECTOR128_KERNELS) && defined(__aarch64__)
+	return FFT_KERNEL_NEON;
+#elif defined(FFT_VECTOR128_KERNELS)
+	return FFT_KERNEL_SSE2;
+#else
+	return FFT_KERNEL_SCALAR;
+#endif
+}
 
-	printf("------------------------------------------------------\n");
+/// @brief Swaps applying the digit-reversal permutation of a mixed-radix transform in place
+/// @param size Transform length
+/// @param radices Radix of each stage, first stage first
+/// @param num_stages Number of stages
+/// @param num_swaps Output number of swaps
+/// @return Index pairs (i, j), i < j, to exchange in order (nullptr on allocation failure)
+static int *DigitReversalSwaps(int size, const int *radices, int num_stages, int *num_swaps)
+{
+	*num_swaps = 0;
+	int *source = (int *)malloc(3 * (size_t)size * sizeof(int));
+	if (source == nullptr)
+	{
+		return nullptr;
+	}
+	int *position = source + size;
+	int *content = position + size;
 
-	printf("      |%12.4lf |%12.6lf |%5.0lf |%12.4lf\n", pd->total_probability, pd->total_normal_probability, pd->total_frequency, pd->total_normal_frequency);
+	// position p receives sample n whose digits are those of p in reverse order
+	for (int p = 0; p < size; ++p)
+	{
+		int rest = p;
+		int stride = size;
+		int n = 0;
+		for (int s = 0; s < num_stages; ++s)
+		{
+			stride /= radices[s];
+			n += (rest % radices[s]) * stride;
+			rest /= radices[s];
+		}
+		source[p] = n;
+	}
 
-	printf("------------------------------------------------------\n");
+	// count the swaps, then record them
+	int *swaps = nullptr;
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		for (int p = 0; p < size; ++p)
+		{
+			position[p] = p;
+			content[p] = p;
+		}
+		int count = 0;
+		for (int p = 0; p < size; ++p)
+		{
+			int q = position[source[p]];
+			if (q == p)
+			{
+				continue;
+			}
+			if (swaps != nullptr)
+			{
+				swaps[2 * count] = p;
+				swaps[2 * count + 1] = q;
+			}
+			count++;
+			int moved = content[p];
+			content[p] = source[p];
+			content[q] = moved;
+			position[source[p]] = p;
+			position[moved] = q;
+		}
+		if (pass == 0)
+		{
+			swaps = (int *)AlignedCalloc((2 * (size_t)count + 1) * sizeof(int));
+			if (swaps == nullptr)
+			{
+				break;
+			}
+		}
+		*num_swaps = count;
+	}
+	free(source);
+	return swaps;
 }
 
-/// @brief Frees memory allocated for prob_dist
-/// @param pd Probability distribution
-/// @return void
-void SignalProcessing::NormalDistributionFree()
+/// @brief Builds the tables of a transform
+/// @param size Transform length >= 2
+/// @param direction 1 = forward, -1 = inverse
+FFTPlan::FFTPlan(int size, int direction)
 {
-	free(this->p_d->items);
-	free(this->p_d);
-}
+	this->size = 0;
+	this->direction = (direction < 0) ? -1 : 1;
+	this->power_of_two = 1;
+	this->num_radix3 = 0;
+	this->num_radix5 = 0;
+	this->swaps = nullptr;
+	this->num_swaps = 0;
+	this->twiddle_real = nullptr;
+	this->twiddle_imag = nullptr;
+	this->twiddle_real_f = nullptr;
+	this->twiddle_imag_f = nullptr;
+	this->real_offset = 0;
+	this->bluestein_size = 0;
+	this->chirp_real = nullptr;
+	this->chirp_imag = nullptr;
+	this->chirp_real_f = nullptr;
+	this->chirp_imag_f = nullptr;
+	this->bluestein_forward = nullptr;
+	this->bluestein_inverse = nullptr;
+	this->scratch_size = 0;
+	this->next = nullptr;
+	if (size < 2 || size > (1 << 30))
+	{
+		return;
+	}
 
-/// @fn IndexOf
-/// @brief Returns the index of a value
-/// @param value Value
-/// @param pd Probability distribution
-/// @return int
-int SignalProcessing::IndexOf(double value, prob_dist *pd)
-{
-	if (pd == NULL)
+	// factorization: radix-2 stages first, then radix 3 and radix 5
+	int radices[32];
+	int num_stages = 0;
+	int rest = size;
+	while (rest % 2 == 0)
 	{
-		return -2;
+		this->power_of_two *= 2;
+		radices[num_stages++] = 2;
+		rest /= 2;
 	}
-	/* Search the value */
-	for (int i = 0; i < pd->count; i++)
+	while (rest % 3 == 0)
 	{
-		if (pd->items[i].value == value)
+		this->num_radix3++;
+		radices[num_stages++] = 3;
+		rest /= 3;
+	}
+	while (rest % 5 == 0)
+	{
+		this->num_radix5++;
+		radices[num_stages++] = 5;
+		rest /= 5;
+	}
+
+	// twiddles of the real transform: the last stage of a power of two, else after the stages
+	bool smooth = (rest == 1);
+	int num_real = (size % 2 == 0) ? size / 4 + 1 : 0;
+	int num_twiddles = 0;
+	if (smooth && this->power_of_two == size)
+	{
+		num_twiddles = size;
+		this->real_offset = size / 2 - 1;
+	}
+	else if (smooth)
+	{
+		num_twiddles = size + num_real;
+		this->real_offset = size - 1;
+	}
+	else
+	{
+		num_twiddles = num_real;
+		this->real_offset = 0;
+	}
+	if (num_twiddles > 0)
+	{
+		this->twiddle_real = (double *)AlignedCalloc((size_t)num_twiddles * sizeof(double));
+		this->twiddle_imag = (double *)AlignedCalloc((size_t)num_twiddles * sizeof(double));
+		this->twiddle_real_f = (float *)AlignedCalloc((size_t)num_twiddles * sizeof(float));
+		this->twiddle_imag_f = (float *)AlignedCalloc((size_t)num_twiddles * sizeof(float));
+		if (this->twiddle_real == nullptr || this->twiddle_imag == nullptr || this->twiddle_real_f == nullptr ||
+		    this->twiddle_imag_f == nullptr)
 		{
-			return i;
+			return;
 		}
 	}
-	return -1;
+	if (smooth)
+	{
+		this->swaps = DigitReversalSwaps(size, radices, num_stages, &this->num_swaps);
+		if (this->swaps == nullptr)
+		{
+			return;
+		}
+
+		// twiddles W^(j k), W = exp(i * direction * 2 pi / (r * span)), of each stage,
+		// contiguous so that the butterflies of a stage read them sequentially
+		int span = 1;
+		for (int s = 0; s < num_stages; ++s)
+		{
+			int length = radices[s] * span;
+			for (int j = 1; j < radices[s]; ++j)
+			{
+				for (int k = 0; k < span; ++k)
+				{
+					double theta = this->direction * 2.0 * M_PI * (j * k) / length;
+					int index = span - 1 + (j - 1) * span + k;
+					this->twiddle_real[index] = cos(theta);
+					this->twiddle_imag[index] = sin(theta);
+					this->twiddle_real_f[index] = (float)cos(theta);
+					this->twiddle_imag_f[index] = (float)sin(theta);
+				}
+			}
+			span = length;
+		}
+	}
+	if (num_real > 0 && !(smooth && this->power_of_two == size))
+	{
+		for (int k = 0; k < num_real; ++k)
+		{
+			double theta = this->direction * 2.0 * M_PI * k / size;
+			this->twiddle_real[this->real_offset + k] = cos(theta);
+			this->twiddle_imag[this->real_offset + k] = sin(theta);
+			this->twiddle_real_f[this->real_offset + k] = (float)cos(theta);
+			this->twiddle_imag_f[this->real_offset + k] = (float)sin(theta);
+		}
+	}
+
+	if (!smooth)
+	{
+		// Bluestein: n k = (n^2 + k^2 - (k - n)^2) / 2 turns the transform into a
+		// convolution with the chirp, done with plans of a smooth length
+		if (size > (1 << 29))
+		{
+			return;
+		}
+		int length = SignalFFTSmoothLength(2 * size - 1);
+		this->bluestein_forward = FFTPlan::Get(length, 1);
+		this->bluestein_inverse = FFTPlan::Get(length, -1);
+		size_t count = (size_t)size + length;
+		this->chirp_real = (double *)AlignedCalloc(count * sizeof(double));
+		this->chirp_imag = (double *)AlignedCalloc(count * sizeof(double));
+		this->chirp_real_f = (float *)AlignedCalloc(count * sizeof(float));
+		this->chirp_imag_f = (float *)AlignedCalloc(count * sizeof(float));
+		if (this->bluestein_forward == nullptr || this->bluestein_inverse == nullptr || this->chirp_real == nullptr ||
+		    this->chirp_imag == nullptr || this->chirp_real_f == nullptr || this->chirp_imag_f == nullptr)
+		{
+			return;
+		}
+		double *filter_real = this->chirp_real + size;
+		double *filter_imag = this->chirp_imag + size;
+		for (int n = 0; n < size; ++n)
+		{
+			// n^2 modulo 2 size keeps the angle small
+			long long square = (long long)n * n % (2LL * size);
+			double theta = this->direction * M_PI * (double)square / size;
+			this->chirp_real[n] = cos(theta);
+			this->chirp_imag[n] = sin(theta);
+			filter_real[n] = cos(theta);
+			filter_imag[n] = -sin(theta);
+			if (n > 0)
+			{
+				filter_real[length - n] = cos(theta);
+				filter_imag[length - n] = -sin(theta);
+			}
+		}
+		this->bluestein_forward->Execute(filter_real, filter_imag);
+		for (size_t i = 0; i < count; ++i)
+		{
+			this->chirp_real_f[i] = (float)this->chirp_real[i];
+			this->chirp_imag_f[i] = (float)this->chirp_imag[i];
+		}
+		this->bluestein_size = length;
+	}
+	this->scratch_size = SignalFFTScratch(size);
+	this->size = size;
 }
-/// @brief Computes the normal distribution and prints the result
-/// @return void
-void SignalProcessing::NormalDistributionRun()
+
+/// @brief FFTPlan destructor
+FFTPlan::~FFTPlan()
 {
-	this->p_d = this->NormalDistributionCreate();
-	this->NormalDistributionCalculate(this->SignalVector, this->GetIndex(), this->p_d);
-	//this->NormalDistributionPrint(this->p_d);
+	AlignedFree(this->swaps);
+	AlignedFree(this->twiddle_real);
+	AlignedFree(this->twiddle_imag);
+	AlignedFree(this->twiddle_real_f);
+	AlignedFree(this->twiddle_imag_f);
+	AlignedFree(this->chirp_real);
+	AlignedFree(this->chirp_imag);
+	AlignedFree(this->chirp_real_f);
+	AlignedFree(this->chirp_imag_f);
 }
-void SignalProcessing::BuildIndexLookupTable(int first_received)
+
+/// @brief Gets the shared plan of a size and direction
+/// @param size Transform length >= 2
+/// @param direction 1 = forward, -1 = inverse
+/// @return Plan, nullptr for an invalid size
+const FFTPlan *FFTPlan::Get(int size, int direction)
 {
-	int received_ref = first_received;
-	for (int i = 0; i < MAX_INDX; i++)
+	if (size < 2 || size > (1 << 30))
 	{
-		if ((first_received + i) >= MAX_INDX)
+		return nullptr;
+	}
+	int index = (direction < 0) ? 1 : 0;
+	if ((size & (size - 1)) == 0)
+	{
+		int log2_size = 0;
+		while ((1 << log2_size) < size)
 		{
-			index_lookup[i].received = first_received - received_ref;
-			received_ref --;
+			log2_size++;
 		}
-		else
+		std::atomic<FFTPlan *> &slot = fft_plans[index][log2_size];
+		FFTPlan *plan = slot.load(std::memory_order_acquire);
+		if (plan != nullptr)
 		{
-			index_lookup[i].received = first_received + i;
+			return plan;
 		}
-		index_lookup[i].normal = i;
-		#if DEBUG_INFO == 1
-		printf("Received = %d", index_lookup[i].received);
-		printf(" Normal = %d \n", index_lookup[i].normal);
-		#endif
+
+		// first use: two threads may build the same plan, one of them is kept
+		FFTPlan *created = new FFTPlan(size, direction);
+		if (!created->IsValid())
+		{
+			delete created;
+			return nullptr;
+		}
+		if (!slot.compare_exchange_strong(plan, created, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			delete created;
+			return plan;
+		}
+		return created;
 	}
-	
-}
-/// @brief Gets the index from the lookup table
-/// @param ReceivedIndex Received index
-/// @return Returns the normalized index
-int SignalProcessing::GetIndexLookupTable(int ReceivedIndex)
-{
-	for (int i = 0; i < MAX_INDX; i++)
+
+	std::atomic<FFTPlan *> &head = fft_other_plans[index];
+	FFTPlan *first = head.load(std::memory_order_acquire);
+	for (FFTPlan *plan = first; plan != nullptr; plan = plan->next)
 	{
-		if (index_lookup[i].received == ReceivedIndex)
+		if (plan->size == size)
 		{
-			return (index_lookup[i].normal);
+			return plan;
+		}
+	}
+	FFTPlan *created = new FFTPlan(size, direction);
+	if (!created->IsValid())
+	{
+		delete created;
+		return nullptr;
+	}
+	while (true)
+	{
+		created->next = first;
+		if (head.compare_exchange_weak(first, created, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			return created;
+		}
+		// plans added meanwhile, possibly of the same size
+		for (FFTPlan *plan = first; plan != created->next; plan = plan->next)
+		{
+			if (plan->size == size)
+			{
+				delete created;
+				return plan;
+			}
 		}
-		
 	}
-	return 0;
 }
 
-/// @brief Calculates the moving average of the last window_size values
-/// @param window_size Number of values to average
-/// @return Moving average value
-double SignalProcessing::GetMovingAverage(int window_size)
+/// @brief Checks that the tables were built
+/// @return true if the plan can be executed
+bool FFTPlan::IsValid() const
 {
-    if (window_size <= 0 || this->index == 0)
-        return 0.0;
-    int start = (this->index > window_size) ? (this->index - window_size) : 0;
-    double sum = 0.0;
-    int count = 0;
-    for (int i = start; i < this->index; ++i)
-    {
-        sum += this->SignalVector[i];
-        count++;
-    }
-    return (count > 0) ? (sum / count) : 0.0;
+	return this->size > 0;
 }
 
-/// @brief Calculates the moving average for each position and stores it in out_vector
-/// @param out_vector Destination vector
-/// @param window_size Number of values to average
-void SignalProcessing::GetMovingAverageVector(double *out_vector, int window_size)
+/// @brief Gets the transform length
+/// @return Size
+int FFTPlan::GetSize() const
 {
-    if (out_vector == nullptr || window_size <= 0)
-        return;
-    for (int i = 0; i < this->index; ++i)
-    {
-        int start = (i >= window_size - 1) ? (i - window_size + 1) : 0;
-        double sum = 0.0;
-        int count = 0;
-        for (int j = start; j <= i; ++j)
-        {
-            sum += this->SignalVector[j];
-            count++;
-        }
-        out_vector[i] = (count > 0) ? (sum / count) : 0.0;
-    }
+	return this->size;
 }
 
-/// @brief Calculates the mean (average) of the signal vector
-/// @return Mean value
-double SignalProcessing::GetMean()
+/// @brief Gets the direction of the transform
+/// @return 1 = forward, -1 = inverse
+int FFTPlan::GetDirection() const
 {
-    if (this->index == 0)
-        return 0.0;
-    double sum = 0.0;
-    for (int i = 0; i < this->index; ++i)
-        sum += this->SignalVector[i];
-    return sum / this->index;
+	return this->direction;
 }
 
-/// @brief Calculates the variance of the signal vector
-/// @return Variance value
-double SignalProcessing::GetVariance()
+/// @brief Gets the scratch memory needed by Execute() and ExecuteReal()
+/// @return Number of values of the data type
+size_t FFTPlan::GetScratchSize() const
 {
-    if (this->index == 0)
-        return 0.0;
-    double mean = GetMean();
-    double sum = 0.0;
-    for (int i = 0; i < this->index; ++i)
-        sum += (this->SignalVector[i] - mean) * (this->SignalVector[i] - mean);
-    return sum / this->index;
+	return this->scratch_size;
 }
 
-/// @brief Calculates the standard deviation of the signal vector
-/// @return Standard deviation value
-double SignalProcessing::GetStandardDeviation()
+/// @brief Gets the scratch memory needed by ExecuteRealBatch()
+/// @return Number of values of the data type
+size_t FFTPlan::GetBatchScratchSize() const
 {
-    return sqrt(GetVariance());
+	if (this->bluestein_size > 0)
+	{
+		return (size_t)this->size + this->scratch_size;
+	}
+	return (2 * (size_t)this->size + 1) * FFT_BATCH_LANES;
 }
 
-/// @brief Normalizes the signal vector to [0, 1] range
-void SignalProcessing::NormalizeVector()
+/// @brief Gets the butterfly kernel used by all plans
+/// @return FFT_KERNEL_* constant
+int FFTPlan::GetKernel()
 {
-    if (this->index == 0)
-        return;
-    double min_val = this->SignalVector[0];
-    double max_val = this->SignalVector[0];
-    for (int i = 1; i < this->index; ++i)
-    {
-        if (this->SignalVector[i] < min_val) min_val = this->SignalVector[i];
-        if (this->SignalVector[i] > max_val) max_val = this->SignalVector[i];
-    }
-    double range = max_val - min_val;
-    if (range == 0.0) return;
-    for (int i = 0; i < this->index; ++i)
-        this->SignalVector[i] = (this->SignalVector[i] - min_val) / range;
+	int kernel = fft_kernel.load(std::memory_order_relaxed);
+	if (kernel < 0)
+	{
+		// detection has no side effect: concurrent first calls store the same value
+		kernel = DetectFFTKernel();
+		fft_kernel.store(kernel, std::memory_order_relaxed);
+	}
+	return kernel;
 }
 
-/// @brief Scales the signal vector to a given range [new_min, new_max]
-/// @param new_min Minimum value of the new range
-/// @param new_max Maximum value of the new range
-void SignalProcessing::ScaleVector(double new_min, double new_max)
+/// @brief Selects the butterfly kernel used by all plans
+/// @param kernel FFT_KERNEL_* constant
+/// @return false if the kernel is not available
+bool FFTPlan::SetKernel(int kernel)
 {
-    if (this->index == 0)
-        return;
-    double min_val = this->SignalVector[0];
-    double max_val = this->SignalVector[0];
-    for (int i = 1; i < this->index; ++i)
-    {
-        if (this->SignalVector[i] < min_val) min_val = this->SignalVector[i];
-        if (this->SignalVector[i] > max_val) max_val = this->SignalVector[i];
-    }
-    double range = max_val - min_val;
-    if (range == 0.0) return;
-    for (int i = 0; i < this->index; ++i)
-    {
-        this->SignalVector[i] = new_min + ((this->SignalVector[i] - min_val) / range) * (new_max - new_min);
+	if (!FFTPlan::IsKernelSupported(kernel))
+	{
+		return false;
+	}
+	fft_kernel.store(kernel, std::memory_order_relaxed);
+	return true;
+}
+
+/// @brief Checks that a kernel can run on this CPU and build
+/// @param kernel FFT_KERNEL_* constant
+/// @return true if available
+bool FFTPlan::IsKernelSupported(int kernel)
+{
+	switch (kernel)
+	{
+	case FFT_KERNEL_SCALAR:
+		return true;
+#ifdef FFT_X86_KERNELS
+	case FFT_KERNEL_AVX512:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512f");
+	case FFT_KERNEL_AVX2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#if defined(FFT_VECTOR128_KERNELS) && defined(__aarch64__)
+	case FFT_KERNEL_NEON:
+		return true;
+#elif defined(FFT_VECTOR128_KERNELS)
+	case FFT_KERNEL_SSE2:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+/// @brief Gets the name of a kernel
+/// @param kernel FFT_KERNEL_* constant
+/// @return Name
+const char *FFTPlan::GetKernelName(int kernel)
+{
+	switch (kernel)
+	{
+	case FFT_KERNEL_SCALAR:
+		return "scalar";
+	case FFT_KERNEL_SSE2:
+		return "SSE2";
+	case FFT_KERNEL_NEON:
+		return "NEON";
+	case FFT_KERNEL_AVX2:
+		return "AVX2";
+	case FFT_KERNEL_AVX512:
+		return "AVX-512";
+	default:
+		return "unknown";
+	}
+}
+
+/// @brief Transform in place with the tables of the plan
+/// @param real Real parts
+/// @param imag Imaginary parts
+/// @param scratch Scratch values (Bluestein lengths only)
+/// @param twiddle_real Twiddles of all stages (real parts)
+/// @param twiddle_imag Twiddles of all stages (imaginary parts)
+/// @param chirp_real Bluestein chirp and filter (real parts)
+/// @param chirp_imag Bluestein chirp and filter (imaginary parts)
+template <typename Acc>
+void FFTPlan::Transform(Acc *real, Acc *imag, Acc *scratch, const Acc *twiddle_real, const Acc *twiddle_imag,
+                        const Acc *chirp_real, const Acc *chirp_imag) const
+{
+	int size = this->size;
+	if (this->bluestein_size > 0)
+	{
+		// a = x * chirp, convolved with conj(chirp) through its precomputed transform
+		int length = this->bluestein_size;
+		Acc *a_real = scratch;
+		Acc *a_imag = scratch + length;
+		for (int n = 0; n < size; ++n)
+		{
+			a_real[n] = real[n] * chirp_real[n] - imag[n] * chirp_imag[n];
+			a_imag[n] = real[n] * chirp_imag[n] + imag[n] * chirp_real[n];
+		}
+		for (int n = size; n < length; ++n)
+		{
+			a_real[n] = 0;
+			a_imag[n] = 0;
+		}
+		this->bluestein_forward->Execute(a_real, a_imag);
+		const Acc *filter_real = chirp_real + size;
+		const Acc *filter_imag = chirp_imag + size;
+		for (int k = 0; k < length; ++k)
+		{
+			Acc r = a_real[k] * filter_real[k] - a_imag[k] * filter_imag[k];
+			a_imag[k] = a_real[k] * filter_imag[k] + a_imag[k] * filter_real[k];
+			a_real[k] = r;
+		}
+		this->bluestein_inverse->Execute(a_real, a_imag);
+		Acc scale = (this->direction < 0) ? (Acc)1.0 / (Acc)size : (Acc)1.0;
+		for (int k = 0; k < size; ++k)
+		{
+			real[k] = (a_real[k] * chirp_real[k] - a_imag[k] * chirp_imag[k]) * scale;
+			imag[k] = (a_real[k] * chirp_imag[k] + a_imag[k] * chirp_real[k]) * scale;
+		}
+		return;
+	}
+
+	for (int s = 0; s < this->num_swaps; ++s)
+	{
+		int i = this->swaps[2 * s];
+		int j = this->swaps[2 * s + 1];
+		std::swap(real[i], real[j]);
+		std::swap(imag[i], imag[j]);
+	}
+
+	// odd number of radix-2 stages: the first one alone, its only twiddle is 1
+	int first_half = 1;
+	int log2_size = 0;
+	while ((1 << log2_size) < this->power_of_two)
+	{
+		log2_size++;
+	}
+	if (log2_size % 2 == 1)
+	{
+		for (int k = 0; k < size; k += 2)
+		{
+			Acc r = real[k + 1];
+			Acc i = imag[k + 1];
+			real[k + 1] = real[k] - r;
+			imag[k + 1] = imag[k] - i;
+			real[k] += r;
+			imag[k] += i;
+		}
+		first_half = 2;
+	}
+
+	Acc direction = (Acc)this->direction;
+	// every AVX2 and AVX-512 kernel (here and in the batch, window and FIR
+	// switches) ends with vzeroupper: SSE code run afterwards (libm) would
+	// otherwise pay a transition on every instruction
+	switch (FFTPlan::GetKernel())
+	{
+#ifdef FFT_X86_KERNELS
+	case FFT_KERNEL_AVX512:
+		FFTPassesAVX512<Acc>(size, this->power_of_two, first_half, this->num_radix3, this->num_radix5, twiddle_real,
+		                     twiddle_imag, direction, real, imag);
+		break;
+	case FFT_KERNEL_AVX2:
+		FFTPassesAVX2<Acc>(size, this->power_of_two, first_half, this->num_radix3, this->num_radix5, twiddle_real,
+		                   twiddle_imag, direction, real, imag);
+		break;
+#endif
+#ifdef FFT_VECTOR128_KERNELS
+	case FFT_KERNEL_SSE2:
+	case FFT_KERNEL_NEON:
+		FFTPasses<Acc, 16 / sizeof(Acc)>(size, this->power_of_two, first_half, this->num_radix3, this->num_radix5,
+		                                  twiddle_real, twiddle_imag, direction, real, imag);
+		break;
+#endif
+	default:
+		FFTPasses<Acc, 1>(size, this->power_of_two, first_half, this->num_radix3, this->num_radix5, twiddle_real,
+		                  twiddle_imag, direction, real, imag);
+		break;
+	}
+
+	if (this->direction < 0)
+	{
+		// exact product for powers of two
+		Acc scale = (Acc)1.0 / (Acc)size;
+		for (int i = 0; i < size; ++i)
+		{
+			real[i] *= scale;
+			imag[i] *= scale;
+		}
+	}
+}
+
+/// @brief Transforms complex data in place
+/// @param real Real parts
+/// @param imag Imaginary parts
+/// @param scratch Scratch values, nullptr to allocate them when needed
+void FFTPlan::Execute(double *real, double *imag, double *scratch) const
+{
+	if (this->size == 0 || real == nullptr || imag == nullptr)
+	{
+		return;
+	}
+	double *allocated = nullptr;
+	if (scratch == nullptr && this->bluestein_size > 0)
+	{
+		allocated = (double *)malloc(this->GetScratchSize() * sizeof(double));
+		if (allocated == nullptr)
+		{
+			return;
+		}
+		scratch = allocated;
+	}
+	this->Transform<double>(real, imag, scratch, this->twiddle_real, this->twiddle_imag, this->chirp_real,
+	                        this->chirp_imag);
+	free(allocated);
+}
+
+/// @brief Transforms complex data in place with float twiddles
+/// @param real Real parts
+/// @param imag Imaginary parts
+/// @param scratch Scratch values, nullptr to allocate them when needed
+void FFTPlan::Execute(float *real, float *imag, float *scratch) const
+{
+	if (this->size == 0 || real == nullptr || imag == nullptr)
+	{
+		return;
+	}
+	float *allocated = nullptr;
+	if (scratch == nullptr && this->bluestein_size > 0)
+	{
+		allocated = (float *)malloc(this->GetScratchSize() * sizeof(float));
+		if (allocated == nullptr)
+		{
+			return;
+		}
+		scratch = allocated;
+	}
+	this->Transform<float>(real, imag, scratch, this->twiddle_real_f, this->twiddle_imag_f, this->chirp_real_f,
+	                       this->chirp_imag_f);
+	free(allocated);
+}
+
+/// @brief Real-input transform of an even length through a complex transform of half the size
+/// @param half_plan Plan of size / 2 (nullptr for size 2)
+/// @param size Transform length
+/// @param twiddle_real Twiddles exp(i * direction * 2 pi * k / size), k <= size / 4 (real parts)
+/// @param twiddle_imag Same twiddles (imaginary parts)
+/// @param inverse true if the half plan normalizes by 2 / size
+/// @param input Real samples, may alias real (in-place transform)
+/// @param real Output real parts (size / 2 + 1 values)
+/// @param imag Output imaginary parts (size / 2 + 1 values)
+/// @param scratch Scratch values of the half plan
+template <typename Acc>
+static void ExecuteRealFFTPlan(const FFTPlan *half_plan, int size, const Acc *twiddle_real, const Acc *twiddle_imag,
+                               bool inverse, const Acc *input, Acc *real, Acc *imag, Acc *scratch)
+{
+	int half = size / 2;
+	// z[n] = x[2n] + i x[2n+1]; reading ahead of the write keeps input == real valid
+	for (int n = 0; n < half; ++n)
+	{
+		Acc even = input[2 * n];
+		Acc odd = input[2 * n + 1];
+		real[n] = even;
+		imag[n] = odd;
+	}
+	if (half_plan != nullptr)
+	{
+		half_plan->Execute(real, imag, scratch);
+	}
+
+	// X[k] = E[k] + W^k O[k] with E[k] = (Z[k] + conj(Z[half - k])) / 2 and
+	// O[k] = (Z[k] - conj(Z[half - k])) / 2i; X[half - k] = conj(E[k] - W^k O[k])
+	Acc scale = inverse ? (Acc)0.5 : (Acc)1.0;
+	Acc z0_real = real[0];
+	Acc z0_imag = imag[0];
+	real[0] = (z0_real + z0_imag) * scale;
+	imag[0] = 0;
+	real[half] = (z0_real - z0_imag) * scale;
+	imag[half] = 0;
+	for (int k = 1; k <= half / 2; ++k)
+	{
+		int m = half - k;
+		Acc even_real = (real[k] + real[m]) * (Acc)0.5;
+		Acc even_imag = (imag[k] - imag[m]) * (Acc)0.5;
+		Acc odd_real = (imag[k] + imag[m]) * (Acc)0.5;
+		Acc odd_imag = (real[m] - real[k]) * (Acc)0.5;
+		Acc tr = twiddle_real[k] * odd_real - twiddle_imag[k] * odd_imag;
+		Acc ti = twiddle_real[k] * odd_imag + twiddle_imag[k] * odd_real;
+		real[k] = (even_real + tr) * scale;
+		imag[k] = (even_imag + ti) * scale;
+		real[m] = (even_real - tr) * scale;
+		imag[m] = (ti - even_imag) * scale;
+	}
+}
+
+/// @brief Real-input transform with the tables of the plan
+/// @param input Real samples, may alias real (in-place transform)
+/// @param real Output real parts (size / 2 + 1 values)
+/// @param imag Output imaginary parts (size / 2 + 1 values)
+/// @param scratch GetScratchSize() values
+/// @param twiddle_real Twiddles of the plan (real parts)
+/// @param twiddle_imag Twiddles of the plan (imaginary parts)
+template <typename Acc>
+void FFTPlan::TransformReal(const Acc *input, Acc *real, Acc *imag, Acc *scratch, const Acc *twiddle_real,
+                            const Acc *twiddle_imag) const
+{
+	int size = this->size;
+	if (size % 2 == 0)
+	{
+		ExecuteRealFFTPlan<Acc>(FFTPlan::Get(size / 2, this->direction), size, twiddle_real + this->real_offset,
+		                        twiddle_imag + this->real_offset, this->direction < 0, input, real, imag, scratch);
+		return;
+	}
+
+	// odd length: complex transform of a copy, the second half mirrors the first
+	Acc *copy_real = scratch;
+	Acc *copy_imag = scratch + size;
+	for (int n = 0; n < size; ++n)
+	{
+		copy_real[n] = input[n];
+		copy_imag[n] = 0;
+	}
+	this->Execute(copy_real, copy_imag, scratch + 2 * size);
+	for (int k = 0; k <= size / 2; ++k)
+	{
+		real[k] = copy_real[k];
+		imag[k] = copy_imag[k];
+	}
+}
+
+/// @brief Transforms real data
+/// @param input Real samples, may alias real (in-place transform)
+/// @param real Output real parts (GetSize() / 2 + 1 values)
+/// @param imag Output imaginary parts (GetSize() / 2 + 1 values)
+/// @param scratch Scratch values, nullptr to allocate them when needed
+void FFTPlan::ExecuteReal(const double *input, double *real, double *imag, double *scratch) const
+{
+	if (this->size == 0 || input == nullptr || real == nullptr || imag == nullptr)
+	{
+		return;
+	}
+	double *allocated = nullptr;
+	if (scratch == nullptr && this->GetScratchSize() > 0)
+	{
+		allocated = (double *)malloc(this->GetScratchSize() * sizeof(double));
+		if (allocated == nullptr)
+		{
+			return;
+		}
+		scratch = allocated;
+	}
+	this->TransformReal<double>(input, real, imag, scratch, this->twiddle_real, this->twiddle_imag);
+	free(allocated);
+}
+
+/// @brief Transforms real data with float arithmetic
+/// @param input Real samples, may alias real (in-place transform)
+/// @param real Output real parts (GetSize() / 2 + 1 values)
+/// @param imag Output imaginary parts (GetSize() / 2 + 1 values)
+/// @param scratch Scratch values, nullptr to allocate them when needed
+void FFTPlan::ExecuteReal(const float *input, float *real, float *imag, float *scratch) const
+{
+	if (this->size == 0 || input == nullptr || real == nullptr || imag == nullptr)
+	{
+		return;
+	}
+	float *allocated = nullptr;
+	if (scratch == nullptr && this->GetScratchSize() > 0)
+	{
+		allocated = (float *)malloc(this->GetScratchSize() * sizeof(float));
+		if (allocated == nullptr)
+		{
+			return;
+		}
+		scratch = allocated;
+	}
+	this->TransformReal<float>(input, real, imag, scratch, this->twiddle_real_f, this->twiddle_imag_f);
+	free(allocated);
+}
+
+/// @brief Real-input transforms of several channels with the tables of the plan
+/// @param input Sample n of channel c at input[c * channel_step + n * sample_step]
+/// @param num_channels Number of channels
+/// @param channel_step Distance between the first samples of two channels
+/// @param sample_step Distance between two samples of a channel
+/// @param real Output real parts (size / 2 + 1 values per channel)
+/// @param imag Output imaginary parts (size / 2 + 1 values per channel)
+/// @param scratch GetBatchScratchSize() values
+/// @param twiddle_real Twiddles of the plan (real parts)
+/// @param twiddle_imag Twiddles of the plan (imaginary parts)
+template <typename Acc>
+void FFTPlan::TransformRealBatch(const Acc *input, int num_channels, int channel_step, int sample_step, Acc *real,
+                                 Acc *imag, Acc *scratch, const Acc *twiddle_real, const Acc *twiddle_imag) const
+{
+	int size = this->size;
+	size_t num_bins = (size_t)(size / 2 + 1);
+	if (this->bluestein_size > 0)
+	{
+		// Bluestein lengths: channel by channel on a contiguous copy
+		Acc *copy = scratch;
+		for (int c = 0; c < num_channels; ++c)
+		{
+			const Acc *x = input + (size_t)c * channel_step;
+			for (int n = 0; n < size; ++n)
+			{
+				copy[n] = x[(size_t)n * sample_step];
+			}
+			this->TransformReal<Acc>(copy, real + c * num_bins, imag + c * num_bins, scratch + size, twiddle_real,
+			                         twiddle_imag);
+		}
+		return;
+	}
+
+	FFTBatchJob<Acc> job;
+	job.size = size;
+	job.power_of_two = this->power_of_two;
+	job.num_radix3 = this->num_radix3;
+	job.num_radix5 = this->num_radix5;
+	job.swaps = this->swaps;
+	job.num_swaps = this->num_swaps;
+	job.twiddle_real = twiddle_real;
+	job.twiddle_imag = twiddle_imag;
+	job.direction = (Acc)this->direction;
+	job.input = input;
+	job.num_channels = num_channels;
+	job.channel_step = channel_step;
+	job.sample_step = sample_step;
+	job.real = real;
+	job.imag = imag;
+	job.group = scratch;
+	switch (FFTPlan::GetKernel())
+	{
+#ifdef FFT_X86_KERNELS
+	case FFT_KERNEL_AVX512:
+		FFTBatchAVX512<Acc>(job);
+		break;
+	case FFT_KERNEL_AVX2:
+		FFTBatchAVX2<Acc>(job);
+		break;
+#endif
+#ifdef FFT_VECTOR128_KERNELS
+	case FFT_KERNEL_SSE2:
+	case FFT_KERNEL_NEON:
+		FFTBatch<Acc, 16 / sizeof(Acc)>(job);
+		break;
+#endif
+	default:
+		FFTBatch<Acc, 1>(job);
+		break;
+	}
+}
+
+/// @brief Transforms the real data of several channels
+/// @param input Sample n of channel c at input[c * channel_step + n * sample_step]
+/// @param num_channels Number of channels
+/// @param channel_step Distance between the first samples of two channels
+/// @param sample_step Distance between two samples of a channel
+/// @param real Output real parts, bin k of channel c at real[c * (GetSize() / 2 + 1) + k]
+/// @param imag Output imaginary parts, same layout
+/// @param scratch Scratch values, nullptr to allocate them
+void FFTPlan::ExecuteRealBatch(const double *input, int num_channels, int channel_step, int sample_step, double *real,
+                               double *imag, double *scratch) const
+{
+	if (this->size == 0 || input == nullptr || real == nullptr || imag == nullptr || num_channels < 1 ||
+	    channel_step < 0 || sample_step < 0)
+	{
+		return;
+	}
+	double *allocated = nullptr;
+	if (scratch == nullptr)
+	{
+		allocated = (double *)malloc(this->GetBatchScratchSize() * sizeof(double));
+		if (allocated == nullptr)
+		{
+			return;
+		}
+		scratch = allocated;
+	}
+	this->TransformRealBatch<double>(input, num_channels, channel_step, sample_step, real, imag, scratch,
+	                                 this->twiddle_real, this->twiddle_imag);
+	free(allocated);
+}
+
+/// @brief Transforms the real data of several channels with float arithmetic
+/// @param input Sample n of channel c at input[c * channel_step + n * sample_step]
+/// @param num_channels Number of channels
+/// @param channel_step Distance between the first samples of two channels
+/// @param sample_step Distance between two samples of a channel
+/// @param real Output real parts, bin k of channel c at real[c * (GetSize() / 2 + 1) + k]
+/// @param imag Output imaginary parts, same layout
+/// @param scratch Scratch values, nullptr to allocate them
+void FFTPlan::ExecuteRealBatch(const float *input, int num_channels, int channel_step, int sample_step, float *real,
+                               float *imag, float *scratch) const
+{
+	if (this->size == 0 || input == nullptr || real == nullptr || imag == nullptr || num_channels < 1 ||
+	    channel_step < 0 || sample_step < 0)
+	{
+		return;
+	}
+	float *allocated = nullptr;
+	if (scratch == nullptr)
+	{
+		allocated = (float *)malloc(this->GetBatchScratchSize() * sizeof(float));
+		if (allocated == nullptr)
+		{
+			return;
+		}
+		scratch = allocated;
+	}
+	this->TransformRealBatch<float>(input, num_channels, channel_step, sample_step, real, imag, scratch,
+	                                this->twiddle_real_f, this->twiddle_imag_f);
+	free(allocated);
+}
+
+// ========== WINDOW FUNCTION IMPLEMENTATION ==========
+
+/// @brief Process-wide windows, one insert-only list per window type
+static std::atomic<SignalWindow *> signal_windows[SIGNAL_WINDOW_TUKEY + 1];
+
+/// @brief Modified Bessel function of the first kind, order 0 (Kaiser window)
+/// @param x Argument
+/// @return I0(x)
+static double SignalBesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	double quarter = x * x / 4.0;
+	for (int k = 1; k < 500 && term > 1e-17 * sum; ++k)
+	{
+		term *= quarter / ((double)k * k);
+		sum += term;
+	}
+	return sum;
+}
+
+/// @brief Parameter of a window after defaults
+/// @param window_type SIGNAL_WINDOW_* constant
+/// @param parameter Requested parameter, <= 0 for the default
+/// @return Kaiser beta, Tukey alpha (at most 1) or 0
+static double SignalWindowParameter(int window_type, double parameter)
+{
+	switch (window_type)
+	{
+	case SIGNAL_WINDOW_KAISER:
+		return (parameter > 0) ? parameter : SIGNAL_WINDOW_KAISER_BETA;
+	case SIGNAL_WINDOW_TUKEY:
+		return (parameter > 0) ? fmin(parameter, 1.0) : SIGNAL_WINDOW_TUKEY_ALPHA;
+	default:
+		return 0.0;
+	}
+}
+
+/// @brief Multiplies data by a window on vectors of W lanes
+/// @param size Number of values
+/// @param window Coefficients
+/// @param data Data, multiplied in place
+template <typename Acc, int W>
+static FFT_ALWAYS_INLINE void WindowMultiply(int size, const Acc *window, Acc *data)
+{
+	typedef typename FFTVector<Acc, W>::Type Vec;
+	int i = 0;
+	for (; i + W <= size; i += W)
+	{
+		Vec w, x;
+		memcpy(&w, window + i, sizeof(Vec));
+		memcpy(&x, data + i, sizeof(Vec));
+		x *= w;
+		memcpy(data + i, &x, sizeof(Vec));
+	}
+	for (; i < size; ++i)
+	{
+		data[i] *= window[i];
+	}
+}
+
+#ifdef FFT_X86_KERNELS
+/// @brief Window multiply on 256-bit vectors
+template <typename Acc>
+__attribute__((target("avx2,fma"))) static void WindowMultiplyAVX2(int size, const Acc *window, Acc *data)
+{
+	WindowMultiply<Acc, 32 / sizeof(Acc)>(size, window, data);
+	__builtin_ia32_vzeroupper();   // see the kernel switch of FFTPlan::Transform()
+}
+
+/// @brief Window multiply on 512-bit vectors
+template <typename Acc>
+__attribute__((target("avx512f"))) static void WindowMultiplyAVX512(int size, const Acc *window, Acc *data)
+{
+	WindowMultiply<Acc, 64 / sizeof(Acc)>(size, window, data);
+	__builtin_ia32_vzeroupper();   // see the kernel switch of FFTPlan::Transform()
+}
+#endif
+
+/// @brief Multiplies data by a window with the kernel of the FFT plans
+/// @param size Number of values
+/// @param window Coefficients
+/// @param data Data, multiplied in place
+template <typename Acc>
+static void WindowMultiplyKernel(int size, const Acc *window, Acc *data)
+{
+	switch (FFTPlan::GetKernel())
+	{
+#ifdef FFT_X86_KERNELS
+	case FFT_KERNEL_AVX512:
+		WindowMultiplyAVX512<Acc>(size, window, data);
+		break;
+	case FFT_KERNEL_AVX2:
+		WindowMultiplyAVX2<Acc>(size, window, data);
+		break;
+#endif
+#ifdef FFT_VECTOR128_KERNELS
+	case FFT_KERNEL_SSE2:
+	case FFT_KERNEL_NEON:
+		WindowMultiply<Acc, 16 / sizeof(Acc)>(size, window, data);
+		break;
+#endif
+	default:
+		WindowMultiply<Acc, 1>(size, window, data);
+		break;
+	}
+}
+
+/// @brief Coefficients of a window in the type of the analysis buffers
+/// @param window Window
+/// @return GetValues() or GetValuesF()
+template <typename Acc>
+static inline const Acc *SignalWindowValues(const SignalWindow *window);
+
+template <>
+inline const double *SignalWindowValues<double>(const SignalWindow *window)
+{
+	return window->GetValues();
+}
+
+template <>
+inline const float *SignalWindowValues<float>(const SignalWindow *window)
+{
+	return window->GetValuesF();
+}
+
+/// @brief Value of a window function
+/// @param window_type SIGNAL_WINDOW_* constant
+/// @param i Coefficient index
+/// @param size Number of coefficients
+/// @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+/// @return Window value at i
+double SignalWindow::Value(int window_type, int i, int size, double parameter)
+{
+	if (size < 2)
+	{
+		return 1.0;
+	}
+	double x = 2.0 * M_PI * i / (size - 1);
+	parameter = SignalWindowParameter(window_type, parameter);
+	switch (window_type)
+	{
+	case SIGNAL_WINDOW_HANN:
+		return 0.5 * (1.0 - cos(x));
+	case SIGNAL_WINDOW_HAMMING:
+		return 0.54 - 0.46 * cos(x);
+	case SIGNAL_WINDOW_BLACKMAN:
+		return 0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x);
+	case SIGNAL_WINDOW_FLATTOP:
+		return 0.21557895 - 0.41663158 * cos(x) + 0.277263158 * cos(2.0 * x) - 0.083578947 * cos(3.0 * x) +
+		       0.006947368 * cos(4.0 * x);
+	case SIGNAL_WINDOW_KAISER:
+	{
+		double r = 2.0 * i / (size - 1) - 1.0;
+		return SignalBesselI0(parameter * sqrt(fmax(0.0, 1.0 - r * r))) / SignalBesselI0(parameter);
+	}
+	case SIGNAL_WINDOW_TUKEY:
+	{
+		// cosine tapers over alpha (size - 1) / 2 samples at each end
+		double taper = parameter * (size - 1) / 2.0;
+		int j = (i < size - 1 - i) ? i : size - 1 - i;
+		if (j >= taper)
+		{
+			return 1.0;
+		}
+		return 0.5 * (1.0 - cos(M_PI * j / taper));
+	}
+	default: // Rectangular (no window)
+		return 1.0;
+	}
+}
+
+/// @brief Computes the coefficients of a window
+/// @param window_type SIGNAL_WINDOW_* constant
+/// @param size Number of coefficients
+/// @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+SignalWindow::SignalWindow(int window_type, int size, double parameter)
+{
+	this->window_type = window_type;
+	this->size = size;
+	this->parameter = SignalWindowParameter(window_type, parameter);
+	this->values = nullptr;
+	this->values_f = nullptr;
+	this->sum = 0.0;
+	this->sum_of_squares = 0.0;
+	this->next = nullptr;
+	if (window_type < SIGNAL_WINDOW_RECTANGULAR || window_type > SIGNAL_WINDOW_TUKEY || size < 1)
+	{
+		return;
+	}
+	this->values = (double *)malloc(size * sizeof(double));
+	this->values_f = (float *)malloc(size * sizeof(float));
+	if (this->values == nullptr || this->values_f == nullptr)
+	{
+		free(this->values);
+		free(this->values_f);
+		this->values = nullptr;
+		this->values_f = nullptr;
+		return;
+	}
+	for (int i = 0; i < size; ++i)
+	{
+		// symmetric: both halves from the same arguments
+		double w = (i <= (size - 1) / 2) ? SignalWindow::Value(window_type, i, size, this->parameter)
+		                                 : this->values[size - 1 - i];
+		this->values[i] = w;
+		this->values_f[i] = (float)w;
+		this->sum += w;
+		this->sum_of_squares += w * w;
+	}
+}
+
+/// @brief Releases the coefficients
+SignalWindow::~SignalWindow()
+{
+	free(this->values);
+	free(this->values_f);
+}
+
+/// @brief Gets the shared window of a type, size and parameter
+/// @param window_type SIGNAL_WINDOW_* constant
+/// @param size Number of coefficients
+/// @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+/// @return Shared window, nullptr for an unknown type or invalid size
+const SignalWindow *SignalWindow::Get(int window_type, int size, double parameter)
+{
+	if (window_type < SIGNAL_WINDOW_RECTANGULAR || window_type > SIGNAL_WINDOW_TUKEY || size < 1)
+	{
+		return nullptr;
+	}
+	parameter = SignalWindowParameter(window_type, parameter);
+	std::atomic<SignalWindow *> &head = signal_windows[window_type];
+	SignalWindow *first = head.load(std::memory_order_acquire);
+	for (SignalWindow *window = first; window != nullptr; window = window->next)
+	{
+		if (window->size == size && window->parameter == parameter)
+		{
+			return window;
+		}
+	}
+	SignalWindow *created = new SignalWindow(window_type, size, parameter);
+	if (!created->IsValid())
+	{
+		delete created;
+		return nullptr;
+	}
+	while (true)
+	{
+		created->next = first;
+		if (head.compare_exchange_weak(first, created, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			return created;
+		}
+		// windows added meanwhile, possibly the same one
+		for (SignalWindow *window = first; window != created->next; window = window->next)
+		{
+			if (window->size == size && window->parameter == parameter)
+			{
+				delete created;
+				return window;
+			}
+		}
+	}
+}
+
+/// @brief Checks that the coefficients were computed
+/// @return true if the window can be used
+bool SignalWindow::IsValid() const
+{
+	return this->values != nullptr;
+}
+
+/// @brief Gets the window function
+/// @return SIGNAL_WINDOW_* constant
+int SignalWindow::GetType() const
+{
+	return this->window_type;
+}
+
+/// @brief Gets the number of coefficients
+/// @return Size
+int SignalWindow::GetSize() const
+{
+	return this->size;
+}
+
+/// @brief Gets the parameter of the window
+/// @return Kaiser beta, Tukey alpha or 0
+double SignalWindow::GetParameter() const
+{
+	return this->parameter;
+}
+
+/// @brief Gets the coefficients
+/// @return Coefficients
+const double *SignalWindow::GetValues() const
+{
+	return this->values;
+}
+
+/// @brief Gets the coefficients rounded to float
+/// @return Coefficients
+const float *SignalWindow::GetValuesF() const
+{
+	return this->values_f;
+}
+
+/// @brief Sum of the coefficients
+/// @return Sum
+double SignalWindow::GetSum() const
+{
+	return this->sum;
+}
+
+/// @brief Sum of the squared coefficients
+/// @return Sum of squares
+double SignalWindow::GetSumOfSquares() const
+{
+	return this->sum_of_squares;
+}
+
+/// @brief Multiplies data by the window in place
+/// @param data Data
+void SignalWindow::Apply(double *data) const
+{
+	if (this->values != nullptr && data != nullptr)
+	{
+		WindowMultiplyKernel<double>(this->size, this->values, data);
+	}
+}
+
+/// @brief Multiplies data by the float coefficients in place
+/// @param data Data
+void SignalWindow::Apply(float *data) const
+{
+	if (this->values_f != nullptr && data != nullptr)
+	{
+		WindowMultiplyKernel<float>(this->size, this->values_f, data);
+	}
+}
+
+/// @brief Converts a computed value to the sample type of the buffer
+/// @param value Value to store
+/// @return value, rounded and saturated for integer sample types
+template <typename T>
+static inline T ToSample(double value)
+{
+	return (T)value;
+}
+
+template <>
+inline int16_t ToSample<int16_t>(double value)
+{
+	if (value >= 32767.0)
+	{
+		return 32767;
+	}
+	if (value <= -32768.0)
+	{
+		return -32768;
+	}
+	return (int16_t)lrint(value);
+}
+
+/// @brief SignalProcessing constructor
+/// @param capacity Number of samples kept in the ring buffer
+template <typename T, typename Acc>
+SignalProcessingT<T, Acc>::SignalProcessingT(int capacity)
+{
+	if (capacity < 1)
+	{
+		capacity = NB_MAX_VALUES;
+	}
+	this->capacity = capacity;
+	// the samples are written twice (slot and slot + capacity) so that the
+	// newest values can always be read as one contiguous block
+	this->SignalVector = (T *)calloc(2 * (size_t)capacity, sizeof(T));
+	this->owns_storage = true;
+	this->inline_storage = false;
+	this->inline_timestamps = nullptr;
+	this->writable = true;
+	this->timestamp_mode = TIMESTAMP_EXPLICIT;
+	this->timestamp_ns = (long long *)calloc((size_t)capacity, sizeof(long long));
+	this->timestamp_base = nullptr;
+	this->timestamp_delta = nullptr;
+	this->timestamp_open_block = -1;
+	this->timestamp_overflow = 0;
+	this->uniform_t0_ns = 0;
+	this->uniform_period_ns = 0;
+	this->item = 0;
+	this->head = 0;
+	this->head_lap = 0;
+	this->write_cursor.store(0, std::memory_order_relaxed);
+	this->read_cursor = 0;
+	this->count = 0;
+	this->concurrent_ingest = false;
+	this->analysis_window = 0;
+	this->stats_valid = false;
+	this->extrema_valid = false;
+	this->workspace = &this->own_workspace;
+	this->generation = 0;
+	this->quartiles_generation = -1;
+	this->noise_generation = -1;
+	this->spectrum_generation = -1;
+	this->spectrum_window_type = SIGNAL_WINDOW_HANN;
+	this->spectrum_window_parameter = 0.0;
+	this->features_generation = -1;
+	this->result_computations = 0;
+	this->cached_bins = nullptr;
+	this->cached_bins_capacity = 0;
+	this->p_d = this->NormalDistributionCreate();
+	this->threshold_crossing_flag = false;
+	this->zero_crossing_flag = false;
+	if (this->SignalVector == nullptr || this->timestamp_ns == nullptr)
+	{
+		// out of memory: an empty read-only object, reported by IsValid()
+		free(this->SignalVector);
+		free(this->timestamp_ns);
+		this->SignalVector = nullptr;
+		this->timestamp_ns = nullptr;
+		this->capacity = 0;
+		this->owns_storage = false;
+		this->writable = false;
+	}
+}
+/// @brief SignalProcessing destructor
+template <typename T, typename Acc>
+SignalProcessingT<T, Acc>::~SignalProcessingT()
+{
+	if (this->owns_storage && !this->inline_storage)
+	{
+		free(this->SignalVector);
+		free(this->timestamp_ns);
+		free(this->timestamp_base);
+		free(this->timestamp_delta);
+	}
+	if (!this->inline_storage)
+	{
+		free(this->cached_bins);
+	}
+	if (this->p_d != NULL)
+	{
+		free(this->p_d->items);
+		free(this->p_d);
+	}
+}
+/// @brief Constructor for a read-only view of external samples
+/// @param data Oldest sample
+/// @param length Number of samples
+template <typename T, typename Acc>
+SignalProcessingT<T, Acc>::SignalProcessingT(const T *data, int length)
+{
+	this->owns_storage = false;
+	this->inline_storage = false;
+	this->inline_timestamps = nullptr;
+	this->writable = false;
+	this->timestamp_mode = TIMESTAMP_UNIFORM;
+	this->timestamp_ns = nullptr;
+	this->timestamp_base = nullptr;
+	this->timestamp_delta = nullptr;
+	this->timestamp_open_block = -1;
+	this->timestamp_overflow = 0;
+	this->uniform_t0_ns = 0;
+	this->uniform_period_ns = 0;
+	this->item = 0;
+	this->head_lap = 0;
+	this->concurrent_ingest = false;
+	this->stats_valid = false;
+	this->extrema_valid = false;
+	this->workspace = &this->own_workspace;
+	this->generation = 0;
+	this->quartiles_generation = -1;
+	this->noise_generation = -1;
+	this->spectrum_generation = -1;
+	this->spectrum_window_type = SIGNAL_WINDOW_HANN;
+	this->spectrum_window_parameter = 0.0;
+	this->features_generation = -1;
+	this->result_computations = 0;
+	this->cached_bins = nullptr;
+	this->cached_bins_capacity = 0;
+	this->p_d = NULL;
+	this->threshold_crossing_flag = false;
+	this->zero_crossing_flag = false;
+	this->BindView(data, length);
+}
+/// @brief Constructor for storage provided by SignalProcessingFixed (no heap allocation)
+/// @param signal Mirrored sample storage (2 * capacity values)
+/// @param timestamps Explicit timestamps (capacity values)
+/// @param capacity Ring buffer capacity
+/// @param scratch Memory of the scratch workspace
+/// @param scratch_bytes Size of scratch in bytes
+/// @param spectrum_bins Bins of the cached spectrum (capacity / 2 + 1 values)
+template <typename T, typename Acc>
+SignalProcessingT<T, Acc>::SignalProcessingT(T *signal, long long *timestamps, int capacity, void *scratch,
+                                             size_t scratch_bytes,
+                                             FrequencyBin *spectrum_bins)
+{
+	this->capacity = capacity;
+	this->SignalVector = signal;
+	memset(signal, 0, 2 * (size_t)capacity * sizeof(T));
+	memset(timestamps, 0, (size_t)capacity * sizeof(long long));
+	this->owns_storage = true;
+	this->inline_storage = true;
+	this->inline_timestamps = timestamps;
+	this->writable = true;
+	this->timestamp_mode = TIMESTAMP_EXPLICIT;
+	this->timestamp_ns = timestamps;
+	this->timestamp_base = nullptr;
+	this->timestamp_delta = nullptr;
+	this->timestamp_open_block = -1;
+	this->timestamp_overflow = 0;
+	this->uniform_t0_ns = 0;
+	this->uniform_period_ns = 0;
+	this->item = 0;
+	this->head = 0;
+	this->head_lap = 0;
+	this->write_cursor.store(0, std::memory_order_relaxed);
+	this->read_cursor = 0;
+	this->count = 0;
+	this->concurrent_ingest = false;
+	this->analysis_window = 0;
+	this->stats_valid = false;
+	this->extrema_valid = false;
+	this->own_workspace.UseBuffer(scratch, scratch_bytes);
+	this->workspace = &this->own_workspace;
+	this->generation = 0;
+	this->quartiles_generation = -1;
+	this->noise_generation = -1;
+	this->spectrum_generation = -1;
+	this->spectrum_window_type = SIGNAL_WINDOW_HANN;
+	this->spectrum_window_parameter = 0.0;
+	this->features_generation = -1;
+	this->result_computations = 0;
+	this->cached_bins = spectrum_bins;
+	this->cached_bins_capacity = capacity / 2 + 1;
+	// created by NormalDistributionRun() if it is ever called
+	this->p_d = NULL;
+	this->threshold_crossing_flag = false;
+	this->zero_crossing_flag = false;
+}
+/// @brief Clears the signal processing vector
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::ClearVector()
+{
+	if (!this->owns_storage)
+	{
+		return;
+	}
+	this->head = 0;
+	this->head_lap = 0;
+	this->timestamp_open_block = -1;
+	this->write_cursor.store(0, std::memory_order_release);
+	this->read_cursor = 0;
+	this->count = 0;
+	this->stats_valid = false;
+	this->generation++;
+}
+/// @brief Adds a value to the signal processing vector
+/// @param value Value to be saved in the signal processing vector
+/// @return Number of values stored in the vector
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::AddValue(T value)
+{
+	if (!this->owns_storage)
+	{
+		return this->count;
+	}
+	this->UpdateRunningStats(&value, 1);
+	this->SignalVector[this->head] = value;
+	this->SignalVector[this->head + this->capacity] = value;
+	this->ClearTimestamps(this->head, 1);
+	if (++this->head == this->capacity)
+	{
+		this->head = 0;
+		this->head_lap ^= 1;
+	}
+
+	return this->Publish(1);
+}
+
+/// @brief Adds a value with timestamp to the signal vector
+/// @param value Value to be saved in the signal processing vector
+/// @param ts Timestamp to associate with the value
+/// @return Number of values stored in the vector
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::AddValueWithTimestamp(T value, struct timespec ts)
+{
+	if (!this->owns_storage)
+	{
+		return this->count;
+	}
+	this->UpdateRunningStats(&value, 1);
+	this->SignalVector[this->head] = value;
+	this->SignalVector[this->head + this->capacity] = value;
+	this->StoreTimestamp(this->head, TimespecToNs(ts));
+	
+	if (++this->head == this->capacity)
+	{
+		this->head = 0;
+		this->head_lap ^= 1;
+	}
+
+	return this->Publish(1);
+}
+
+/// @brief Appends a block of values to the signal vector
+/// @param values Values to add, oldest first
+/// @param n Number of values
+/// @return Number of values stored in the vector
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::AddValues(const T *values, int n)
+{
+	if (values == nullptr || n <= 0 || !this->owns_storage)
+	{
+		return this->Publish(0);
+	}
+	this->WriteBlock(values, nullptr, n, 0, -1);
+	return this->Publish(n);
+}
+
+/// @brief Appends a block of values with one timestamp per value
+/// @param values Values to add, oldest first
+/// @param ts Timestamps associated with the values
+/// @param n Number of values
+/// @return Number of values stored in the vector
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::AddValuesWithTimestamps(const T *values, const struct timespec *ts, int n)
+{
+	if (values == nullptr || ts == nullptr || n <= 0 || !this->owns_storage)
+	{
+		return this->Publish(0);
+	}
+	this->WriteBlock(values, ts, n, 0, -1);
+	return this->Publish(n);
+}
+
+/// @brief Appends a block of uniformly sampled values
+/// @param values Values to add, oldest first
+/// @param n Number of values
+/// @param start Timestamp of values[0]
+/// @param period_ns Sample period in nanoseconds
+/// @return Number of values stored in the vector
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::AddValuesWithTimestamps(const T *values, int n, struct timespec start, long long period_ns)
+{
+	if (values == nullptr || n <= 0 || period_ns < 0 || !this->owns_storage)
+	{
+		return this->Publish(0);
+	}
+	this->WriteBlock(values, nullptr, n, TimespecToNs(start), period_ns);
+	return this->Publish(n);
+}
+
+/// @brief Copies a block of samples at the write position (producer side)
+/// @param values Values to copy
+/// @param ts Timestamps to store, nullptr for periodic or no timestamps
+/// @param n Number of values
+/// @param start_ns Timestamp of values[0] when ts is nullptr (periodic timestamps)
+/// @param period_ns Sample period when ts is nullptr, negative for no timestamps
+/// @return Number of leading values skipped because they would be overwritten by the same block
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::WriteBlock(const T *values, const struct timespec *ts, int n,
+                                 long long start_ns, long long period_ns)
+{
+	int skipped = 0;
+	this->UpdateRunningStats(values, n);
+	if (n > this->capacity)
+	{
+		skipped = n - this->capacity;
+		long long position = this->head + (long long)skipped;
+		if ((position / this->capacity) & 1)
+		{
+			this->head_lap ^= 1;
+		}
+		this->head = (int)(position % this->capacity);
+		n = this->capacity;
+	}
+	values += skipped;
+	if (ts != nullptr)
+	{
+		ts += skipped;
+	}
+	long long ns = start_ns + (long long)skipped * period_ns;
+	bool store = (this->timestamp_mode != TIMESTAMP_UNIFORM);
+
+	// at most two segments: [head, capacity) then [0, rest)
+	int done = 0;
+	while (done < n)
+	{
+		int length = this->capacity - this->head;
+		if (length > n - done)
+		{
+			length = n - done;
+		}
+		size_t bytes = (size_t)length * sizeof(T);
+		memcpy(this->SignalVector + this->head, values + done, bytes);
+		memcpy(this->SignalVector + this->head + this->capacity, values + done, bytes);
+		if (ts != nullptr && store)
+		{
+			for (int i = 0; i < length; ++i)
+			{
+				this->StoreTimestamp(this->head + i, TimespecToNs(ts[done + i]));
+			}
+		}
+		else if (ts == nullptr && period_ns >= 0 && store)
+		{
+			for (int i = 0; i < length; ++i)
+			{
+				this->StoreTimestamp(this->head + i, ns);
+				ns += period_ns;
+			}
+		}
+		else if (ts == nullptr && period_ns < 0)
+		{
+			this->ClearTimestamps(this->head, length);
+		}
+		this->head += length;
+		if (this->head == this->capacity)
+		{
+			this->head = 0;
+			this->head_lap ^= 1;
+		}
+		done += length;
+	}
+	return skipped;
+}
+
+/// @brief Stores the timestamp of a slot (producer side)
+/// @param slot Position in the ring buffer
+/// @param ns Timestamp in nanoseconds since the epoch
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::StoreTimestamp(int slot, long long ns)
+{
+	if (this->timestamp_mode == TIMESTAMP_EXPLICIT)
+	{
+		this->timestamp_ns[slot] = ns;
+	}
+	else if (this->timestamp_mode == TIMESTAMP_DELTA)
+	{
+		// each group has one base per lap parity: while a lap rewrites a group, the
+		// older samples of that group keep the base of the previous lap. Entering a
+		// group starts a new base, so does the first timestamp of an untimed group
+		int group = (slot / TIMESTAMP_BLOCK) * 2 + this->head_lap;
+		if (group != this->timestamp_open_block || slot % TIMESTAMP_BLOCK == 0 ||
+		    this->timestamp_base[group] == TIMESTAMP_NO_BASE)
+		{
+			this->timestamp_base[group] = ns;
+			this->timestamp_open_block = group;
+		}
+		long long offset = ns - this->timestamp_base[group];
+		if (offset < 0 || offset >= (long long)TIMESTAMP_NO_DELTA)
+		{
+			offset = (offset < 0) ? 0 : (long long)TIMESTAMP_NO_DELTA - 1;
+			this->timestamp_overflow++;
+		}
+		this->timestamp_delta[slot] = (unsigned int)offset;
+	}
+	// TIMESTAMP_UNIFORM: computed from the sample number
+}
+
+/// @brief Marks consecutive slots as having no timestamp (producer side)
+/// @param slot First position in the ring buffer
+/// @param n Number of slots (must not cross the end of the buffer)
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::ClearTimestamps(int slot, int n)
+{
+	if (n <= 0)
+	{
+		return;
+	}
+	if (this->timestamp_mode == TIMESTAMP_EXPLICIT)
+	{
+		memset(this->timestamp_ns + slot, 0, (size_t)n * sizeof(long long));
+	}
+	else if (this->timestamp_mode == TIMESTAMP_DELTA)
+	{
+		memset(this->timestamp_delta + slot, 0xFF, (size_t)n * sizeof(unsigned int));
+		int first_group = (slot / TIMESTAMP_BLOCK) * 2 + this->head_lap;
+		int last_group = ((slot + n - 1) / TIMESTAMP_BLOCK) * 2 + this->head_lap;
+		if (first_group != this->timestamp_open_block || slot % TIMESTAMP_BLOCK == 0)
+		{
+			this->timestamp_base[first_group] = TIMESTAMP_NO_BASE;
+		}
+		for (int group = first_group + 2; group <= last_group; group += 2)
+		{
+			this->timestamp_base[group] = TIMESTAMP_NO_BASE;
+		}
+		this->timestamp_open_block = last_group;
+	}
+}
+
+/// @brief Reconstructs the timestamp of a sample of the analysis window
+/// @param window_index Index relative to the oldest sample of the window
+/// @param valid Set to false if the sample has no timestamp
+/// @return Timestamp in nanoseconds since the epoch
+template <typename T, typename Acc>
+long long SignalProcessingT<T, Acc>::LoadTimestamp(int window_index, bool *valid)
+{
+	*valid = true;
+	if (this->timestamp_mode == TIMESTAMP_UNIFORM)
+	{
+		long long sample = this->read_cursor - this->WindowSize() + window_index;
+		return this->uniform_t0_ns + sample * this->uniform_period_ns;
+	}
+	int slot = this->TimestampSlot(window_index);
+	if (this->timestamp_mode == TIMESTAMP_DELTA)
+	{
+		unsigned int delta = this->timestamp_delta[slot];
+		if (delta == TIMESTAMP_NO_DELTA)
+		{
+			*valid = false;
+			return 0;
+		}
+		long long sample = this->read_cursor - this->WindowSize() + window_index;
+		int lap = (int)((sample / this->capacity) & 1);
+		return this->timestamp_base[(slot / TIMESTAMP_BLOCK) * 2 + lap] + delta;
+	}
+	return this->timestamp_ns[slot];
+}
+
+/// @brief Selects how timestamps are stored (clears the signal vector)
+/// @param mode TIMESTAMP_EXPLICIT, TIMESTAMP_DELTA or TIMESTAMP_UNIFORM
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::SetTimestampMode(int mode)
+{
+	if ((mode != TIMESTAMP_EXPLICIT && mode != TIMESTAMP_DELTA && mode != TIMESTAMP_UNIFORM) ||
+	    !this->owns_storage)
+	{
+		return false;
+	}
+	long long *ns = nullptr;
+	long long *base = nullptr;
+	unsigned int *delta = nullptr;
+	if (mode == TIMESTAMP_EXPLICIT && this->inline_storage)
+	{
+		ns = this->inline_timestamps;
+		memset(ns, 0, (size_t)this->capacity * sizeof(long long));
+	}
+	else if (mode == TIMESTAMP_EXPLICIT)
+	{
+		ns = (long long *)calloc((size_t)this->capacity, sizeof(long long));
+		if (ns == nullptr)
+		{
+			return false;
+		}
+	}
+	else if (mode == TIMESTAMP_DELTA)
+	{
+		if (this->inline_storage)
+		{
+			// fixed-capacity objects never allocate
+			return false;
+		}
+		// two bases per group, one for each lap parity
+		int blocks = 2 * ((this->capacity + TIMESTAMP_BLOCK - 1) / TIMESTAMP_BLOCK);
+		base = (long long *)malloc((size_t)blocks * sizeof(long long));
+		delta = (unsigned int *)malloc((size_t)this->capacity * sizeof(unsigned int));
+		if (base == nullptr || delta == nullptr)
+		{
+			free(base);
+			free(delta);
+			return false;
+		}
+		for (int i = 0; i < blocks; ++i)
+		{
+			base[i] = TIMESTAMP_NO_BASE;
+		}
+		memset(delta, 0xFF, (size_t)this->capacity * sizeof(unsigned int));
+	}
+	if (!this->inline_storage)
+	{
+		free(this->timestamp_ns);
+		free(this->timestamp_base);
+		free(this->timestamp_delta);
+	}
+	this->timestamp_ns = ns;
+	this->timestamp_base = base;
+	this->timestamp_delta = delta;
+	this->timestamp_mode = mode;
+	this->timestamp_open_block = -1;
+	this->timestamp_overflow = 0;
+	this->ClearVector();
+	return true;
+}
+
+/// @brief Returns the timestamp storage mode
+/// @return TIMESTAMP_EXPLICIT, TIMESTAMP_DELTA or TIMESTAMP_UNIFORM
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::GetTimestampMode()
+{
+	return this->timestamp_mode;
+}
+
+/// @brief Sets the sampling grid used in TIMESTAMP_UNIFORM mode
+/// @param t0 Timestamp of the first sample added after ClearVector()
+/// @param period_ns Sample period in nanoseconds
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::SetUniformSampling(struct timespec t0, long long period_ns)
+{
+	this->uniform_t0_ns = TimespecToNs(t0);
+	this->uniform_period_ns = period_ns;
+}
+
+/// @brief Returns the number of timestamps clamped in TIMESTAMP_DELTA mode
+/// @return Number of clamped timestamps
+template <typename T, typename Acc>
+long long SignalProcessingT<T, Acc>::GetTimestampOverflowCount()
+{
+	return this->timestamp_overflow;
+}
+
+/// @brief Finds the first sample at or after a given time
+/// @param ts Time to search for
+/// @return Index of the first sample with timestamp >= ts, GetAnalysisWindow() if none
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::FindTimestampIndex(struct timespec ts)
+{
+	int length = this->WindowSize();
+	long long target = TimespecToNs(ts);
+	bool valid;
+
+	if (this->timestamp_mode == TIMESTAMP_UNIFORM)
+	{
+		if (length == 0 || this->uniform_period_ns <= 0)
+		{
+			return length;
+		}
+		long long first = this->LoadTimestamp(0, &valid);
+		if (target <= first)
+		{
+			return 0;
+		}
+		long long index = (target - first + this->uniform_period_ns - 1) / this->uniform_period_ns;
+		return (index < length) ? (int)index : length;
+	}
+
+	int low = 0;
+	int high = length;
+	while (low < high)
+	{
+		int mid = low + (high - low) / 2;
+		if (this->LoadTimestamp(mid, &valid) < target)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low;
+}
+
+/// @brief Publishes the samples written by the producer
+/// @param n Number of samples written since the last publication
+/// @return Number of values stored in the vector
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::Publish(int n)
+{
+	// only the producer writes the cursor, a relaxed load is enough here
+	long long cursor = this->write_cursor.load(std::memory_order_relaxed) + n;
+	// release: a reader acquiring this cursor also sees the samples and timestamps
+	this->write_cursor.store(cursor, std::memory_order_release);
+	int stored = (cursor < this->capacity) ? (int)cursor : this->capacity;
+	if (!this->concurrent_ingest)
+	{
+		this->read_cursor = cursor;
+		this->count = stored;
+		this->generation++;
+	}
+	return stored;
+}
+
+/// @brief Enables the single-producer/single-consumer ingest mode
+/// @param enable true to decouple readers from the producer
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::SetConcurrentIngest(bool enable)
+{
+	this->concurrent_ingest = enable;
+	this->stats_valid = false;
+	this->AcquireSnapshot();
+}
+
+/// @brief Takes a snapshot of the samples published by the producer
+/// @return Number of samples stored in the snapshot
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::AcquireSnapshot()
+{
+	long long cursor = this->write_cursor.load(std::memory_order_acquire);
+	this->read_cursor = cursor;
+	this->count = (cursor < this->capacity) ? (int)cursor : this->capacity;
+	this->generation++;
+	return this->count;
+}
+
+/// @brief Checks that the producer has not overwritten the snapshot window
+/// @return true if the results computed since AcquireSnapshot() are consistent
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::IsSnapshotValid()
+{
+	// order the sample reads of the analysis before the cursor load (seqlock validation)
+	std::atomic_thread_fence(std::memory_order_acquire);
+	long long produced = this->write_cursor.load(std::memory_order_relaxed) - this->read_cursor;
+	// sample read_cursor + k overwrites the slot of sample read_cursor + k - capacity;
+	// the sample being written (k = produced) must stay out of the window as well
+	return produced < (long long)(this->capacity - this->WindowSize());
+}
+
+/// @brief Sizes the scratch workspace up front
+/// @param bytes Size in bytes (0 = enough for an FFT of the whole capacity)
+/// @return true on success
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ReserveWorkspace(size_t bytes)
+{
+	if (bytes == 0)
+	{
+		bytes = SignalWorkspaceBytes(this->capacity, sizeof(Acc));
+	}
+	return this->workspace->Reserve(bytes);
+}
+
+/// @brief Uses another workspace for the temporary buffers
+/// @param workspace Workspace shared by objects of one thread (nullptr = own workspace)
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::SetWorkspace(SignalWorkspace *workspace)
+{
+	this->workspace = (workspace != nullptr) ? workspace : &this->own_workspace;
+}
+
+/// @brief Gets the workspace used for the temporary buffers
+/// @return Workspace
+template <typename T, typename Acc>
+SignalWorkspace *SignalProcessingT<T, Acc>::GetWorkspace()
+{
+	return this->workspace;
+}
+
+/// @brief Gets the generation of the analysis window
+/// @return Counter incremented whenever the analysed samples change
+template <typename T, typename Acc>
+long long SignalProcessingT<T, Acc>::GetGeneration()
+{
+	return this->generation;
+}
+
+/// @brief Gets the number of derived results computed and stored
+/// @return Counter incremented on every cache miss
+template <typename T, typename Acc>
+long long SignalProcessingT<T, Acc>::GetResultComputations()
+{
+	return this->result_computations;
+}
+
+/// @brief Checks whether a stored result still describes the analysis window
+/// @param result_generation Generation the result was computed for
+/// @return true if the result can be returned again
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::IsCached(long long result_generation)
+{
+	// views and bank channels read memory that can change behind them
+	return this->owns_storage && result_generation == this->generation;
+}
+
+/// @brief Allocates a temporary buffer from the workspace
+/// @param bytes Size in bytes
+/// @return Buffer valid until the workspace is released to an earlier mark
+template <typename T, typename Acc>
+void *SignalProcessingT<T, Acc>::Scratch(size_t bytes)
+{
+	if (this->workspace->GetSize() == 0)
+	{
+		// first use: room for an FFT of the analysis window
+		this->workspace->Reserve(SignalWorkspaceBytes(this->WindowSize(), sizeof(Acc)));
+	}
+	return this->workspace->Alloc(bytes);
+}
+
+/// @brief Gets the physical position of the oldest sample of the analysis window
+/// @return Position in SignalVector (0 <= position < 2 * capacity)
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::WindowStart()
+{
+	if (this->capacity == 0)
+	{
+		return 0;
+	}
+	int tail = (int)(this->read_cursor % this->capacity) - this->count;
+	if (tail < 0)
+	{
+		tail += this->capacity;
+	}
+	return tail + (this->count - this->WindowSize());
+}
+
+/// @brief Gets a pointer to the oldest sample of the analysis window
+/// @return Contiguous block of WindowSize() samples
+template <typename T, typename Acc>
+T *SignalProcessingT<T, Acc>::WindowData()
+{
+	return this->SignalVector + this->WindowStart();
+}
+
+/// @brief Gets the number of samples seen by the analysis methods
+/// @return Analysis window length
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::WindowSize()
+{
+	if (this->analysis_window > 0 && this->analysis_window < this->count)
+	{
+		return this->analysis_window;
+	}
+	return this->count;
+}
+
+/// @brief Gets the timestamp slot of a sample of the analysis window
+/// @param window_index Index relative to the oldest sample of the window
+/// @return Position in the timestamp storage
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::TimestampSlot(int window_index)
+{
+	int slot = this->WindowStart() + window_index;
+	return (slot >= this->capacity) ? (slot - this->capacity) : slot;
+}
+
+/// @brief Copies modified window values to their mirror copy
+/// @param offset First modified index (relative to the analysis window)
+/// @param length Number of modified values
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::SyncMirror(int offset, int length)
+{
+	int first = this->WindowStart() + offset;
+	int last = first + length;
+	if (length <= 0)
+	{
+		return;
+	}
+	// values changed in place: the running statistics are rebuilt on the next read
+	this->stats_valid = false;
+	this->generation++;
+	// part stored in the lower copy [0, capacity)
+	if (first < this->capacity)
+	{
+		int end = (last < this->capacity) ? last : this->capacity;
+		memcpy(this->SignalVector + first + this->capacity, this->SignalVector + first,
+		       (size_t)(end - first) * sizeof(T));
+		first = end;
+	}
+	// part stored in the upper copy [capacity, 2 * capacity)
+	if (first < last)
+	{
+		memcpy(this->SignalVector + first - this->capacity, this->SignalVector + first,
+		       (size_t)(last - first) * sizeof(T));
+	}
+}
+
+/// @brief Adds v to a Kahan-compensated sum
+static inline void KahanAdd(double *sum, double *compensation, double v)
+{
+	double y = v - *compensation;
+	double t = *sum + y;
+	*compensation = (t - *sum) - y;
+	*sum = t;
+}
+
+/// @brief Updates the running statistics with values about to be written at head
+/// @param values New values, oldest first
+/// @param n Number of values
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::UpdateRunningStats(const T *values, int n)
+{
+	if (this->concurrent_ingest)
+	{
+		// the reader owns the statistics in concurrent mode: tested first so
+		// that the producer never reads a field the reader writes
+		return;
+	}
+	if (!this->stats_valid)
+	{
+		return;
+	}
+	int limit = (this->analysis_window > 0 && this->analysis_window < this->capacity) ? this->analysis_window : this->capacity;
+	// rebuilding once per window of removed samples bounds the rounding drift;
+	// a block that replaces the whole window is cheaper to rescan as well
+	if (n >= limit || this->stats_removed + n > limit)
+	{
+		this->stats_valid = false;
+		return;
+	}
+	for (int i = 0; i < n; ++i)
+	{
+		double x = (double)values[i];
+		if (this->stats_count == limit)
+		{
+			// the oldest sample of the window has not been overwritten yet
+			int slot = this->head + i - limit;
+			if (slot < 0)
+			{
+				slot += this->capacity;
+			}
+			double old = (double)this->SignalVector[slot];
+			double d = old - this->stats_shift;
+			KahanAdd(&this->stats_sum, &this->stats_sum_c, -d);
+			KahanAdd(&this->stats_sumsq, &this->stats_sumsq_c, -d * d);
+			if (old <= this->stats_min || old >= this->stats_max)
+			{
+				this->extrema_valid = false;
+			}
+			this->stats_removed++;
+		}
+		else if (this->stats_count++ == 0)
+		{
+			this->stats_shift = x;
+			this->stats_min = x;
+			this->stats_max = x;
+			this->extrema_valid = true;
+		}
+		double d = x - this->stats_shift;
+		KahanAdd(&this->stats_sum, &this->stats_sum_c, d);
+		KahanAdd(&this->stats_sumsq, &this->stats_sumsq_c, d * d);
+		if (this->extrema_valid)
+		{
+			if (x < this->stats_min) this->stats_min = x;
+			if (x > this->stats_max) this->stats_max = x;
+		}
+	}
+}
+
+/// @brief Makes the running statistics match the analysis window
+/// @details Views, SignalBank channels and the concurrent ingest mode are not
+/// updated on ingest: their statistics are recomputed on every read, with the
+/// same summation so that both paths give identical results
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::PrepareRunningStats()
+{
+	if (!this->stats_valid || !this->owns_storage || this->concurrent_ingest)
+	{
+		this->RefreshRunningStats();
+	}
+	else if (!this->extrema_valid)
+	{
+		this->RefreshRunningExtrema();
+	}
+}
+
+/// @brief Recomputes the running statistics from the analysis window
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::RefreshRunningStats()
+{
+	T *signal = this->WindowData();
+	int length = this->WindowSize();
+	this->stats_count = length;
+	this->stats_removed = 0;
+	this->stats_shift = (length > 0) ? (double)signal[0] : 0.0;
+	this->stats_sum = 0.0;
+	this->stats_sum_c = 0.0;
+	this->stats_sumsq = 0.0;
+	this->stats_sumsq_c = 0.0;
+	for (int i = 0; i < length; ++i)
+	{
+		double d = (double)signal[i] - this->stats_shift;
+		KahanAdd(&this->stats_sum, &this->stats_sum_c, d);
+		KahanAdd(&this->stats_sumsq, &this->stats_sumsq_c, d * d);
+	}
+	this->RefreshRunningExtrema();
+	// in concurrent mode the statistics are rebuilt on every read and the
+	// flag stays false, so the reader never writes it
+	if (!this->concurrent_ingest)
+	{
+		this->stats_valid = true;
+	}
+}
+
+/// @brief Recomputes the running minimum and maximum from the analysis window
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::RefreshRunningExtrema()
+{
+	T *signal = this->WindowData();
+	int length = this->WindowSize();
+	T min_val = (length > 0) ? signal[0] : (T)0;
+	T max_val = min_val;
+	for (int i = 1; i < length; ++i)
+	{
+		if (signal[i] < min_val) min_val = signal[i];
+		if (signal[i] > max_val) max_val = signal[i];
+	}
+	this->stats_min = (double)min_val;
+	this->stats_max = (double)max_val;
+	this->extrema_valid = true;
+}
+
+/// @brief Makes the object read the ring buffer of another container (no copy)
+/// @param signal Mirrored sample storage (2 * capacity values)
+/// @param timestamps Explicit timestamps (capacity values)
+/// @param capacity Ring buffer capacity
+/// @param count Number of stored samples
+/// @param total Total number of samples added
+/// @param analysis_window Analysis window length (0 = all stored samples)
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::BindStorage(T *signal, long long *timestamps, int capacity, int count,
+                                            long long total, int analysis_window)
+{
+	if (this->owns_storage)
+	{
+		free(this->SignalVector);
+		free(this->timestamp_ns);
+		free(this->timestamp_base);
+		free(this->timestamp_delta);
+		this->timestamp_base = nullptr;
+		this->timestamp_delta = nullptr;
+		this->owns_storage = false;
+	}
+	this->SignalVector = signal;
+	this->timestamp_ns = timestamps;
+	this->timestamp_mode = TIMESTAMP_EXPLICIT;
+	this->capacity = capacity;
+	this->head = (int)(total % capacity);
+	this->write_cursor.store(total, std::memory_order_relaxed);
+	this->read_cursor = total;
+	this->count = count;
+	this->concurrent_ingest = false;
+	this->analysis_window = analysis_window;
+	this->stats_valid = false;
+	this->generation++;
+}
+
+/// @brief Makes the object read external, non-mirrored samples (no copy)
+/// @param data Oldest sample
+/// @param length Number of samples
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::BindView(const T *data, int length)
+{
+	if (data == nullptr || length < 0)
+	{
+		length = 0;
+	}
+	// never written: writable stays false for views
+	this->SignalVector = const_cast<T *>(data);
+	this->capacity = (length > 0) ? length : 1;
+	this->head = 0;
+	this->write_cursor.store(length, std::memory_order_relaxed);
+	this->read_cursor = length;
+	this->count = length;
+	this->analysis_window = 0;
+	this->stats_valid = false;
+	this->generation++;
+}
+
+/// @brief Restricts all read and analysis methods to the newest samples
+/// @param last_n Number of newest samples (0 = all stored samples)
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::SetAnalysisWindow(int last_n)
+{
+	this->analysis_window = (last_n > 0) ? last_n : 0;
+	this->stats_valid = false;
+	this->generation++;
+}
+
+/// @brief Gets the number of samples seen by the analysis methods
+/// @return Analysis window length
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::GetAnalysisWindow()
+{
+	return this->WindowSize();
+}
+
+/// @brief Gets the timestamp for a value in the signal processing vector
+/// @param td Contains the timestamp of the signal value at index
+/// @param index The index of the signal value
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::GetTimespec(struct timespec *td, int index)
+{
+	if (td != nullptr)
+	{
+		*td = this->GetTimestamp(index);
+	}
+}
+
+/// @brief Gets the last value of the signal processing vector
+/// @return void
+template <typename T, typename Acc>
+T SignalProcessingT<T, Acc>::GetLastValue()
+{
+	if (this->count == 0)
+	{
+		return 0.0;
+	}
+	return this->SignalVector[(int)(this->read_cursor % this->capacity) + this->capacity - 1];
+}
+/// @brief Sets the item of the signal processing vector
+/// @param Item The item
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::SetItem(int Item)
+{
+	this->item = Item;
+}
+/// @brief Checks that the ring buffer was allocated
+/// @return true if values can be stored or the object views external samples
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::IsValid() const
+{
+	return this->capacity > 0;
+}
+/// @brief Gets the max capacity of the signal processing vector
+/// @return Max capacity
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::GetMaxCapacity()
+{
+	return this->capacity;
+}
+/// @brief Gets the number of values stored in the signal processing vector
+/// @return Number of stored values
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::GetIndex()
+{
+	return (this->count);
+}
+/// @brief Gets the size of the signal processing vector
+/// @return Current index
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::GetSize()
+{
+	return (this->GetIndex());
+}
+/// @brief Gets the total number of values added to the signal processing vector
+/// @return Total number of values, including overwritten ones
+template <typename T, typename Acc>
+long long SignalProcessingT<T, Acc>::GetTotalCount()
+{
+	return (this->read_cursor);
+}
+/// @brief Gets the item number for the signal processing vector
+/// @return Item number
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::GetItem()
+{
+	return (this->item);
+}
+/// @brief Gets the signal processing vector
+/// @param signalProc_vector Contains the signal processing vector
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::GetVector(T *signalProc_vector)
+{
+	if(signalProc_vector != nullptr)
+	{
+		memcpy(signalProc_vector, this->WindowData(), (size_t)this->WindowSize() * sizeof(T));
+	}
+}
+/// @brief Gets the signal processing vector as int
+/// @param signalProc_vector Contains int signal processing vector
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::GetVectorInt(int *signalProc_vector, int size)
+{
+	if (signalProc_vector != nullptr)
+	{
+		T *signal = this->WindowData();
+		int length = this->WindowSize();
+		for (int i = 0; i < size && i < length; i++)
+		{
+			signalProc_vector[i] = (int)(signal[i]);
+		}
+	}
+}
+
+/// @brief Prints the signal processing vector
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::PrintVector()
+{
+	T *signal = this->WindowData();
+	for (int i = 0; i < this->WindowSize(); i++)
+	{
+		printf("\nSignalVector[%d] = %f", i, (double)signal[i]);
+	}
+	printf("\n------------------------------------------------");
+}	
+
+
+/// @brief Gets the signal processing vector with offset
+/// @param signalProc_vector Contains the signal processing vector
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::GetVectorWithOffset(T *signalProc_vector,int size, int offset)
+{
+	if (signalProc_vector != nullptr)
+	{
+		T *signal = this->WindowData();
+		int length = this->WindowSize();
+		for (int i = 0; i < size && i + offset < length; i++)
+		{
+			signalProc_vector[i] = signal[i + offset];
+		}
+	}
+}
+/// @brief Initializes the signal processing vector
+/// @param values Contains signal processing vector which will be copied to SignalVector
+/// @param size Contains size of the signal processing vector which will be copied to SignalVector
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::InitVector(const T *values,int size)
+{
+	if (values != nullptr)
+	{
+		this->ClearVector();
+		this->AddValues(values, size);
+	}
+}
+/// @brief Multiplies the signal processing vector with a scalar value
+/// @param value Value
+/// @param size Number of elements to multiply
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::MultiplyWithValue(double value, int size)
+{
+	if (!this->writable)
+	{
+		return;
+	}
+	T *signal = this->WindowData();
+	int length = (size < this->WindowSize()) ? size : this->WindowSize();
+	for (int i = 0; i < length; ++i)
+	{
+		signal[i] = ToSample<T>(signal[i] * value);
+	}
+	this->SyncMirror(0, length);
+}
+/// @brief Subtracts a scalar value from the signal processing vector
+/// @param value Value
+/// @param size Number of elements to subtract
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::SubstractWithValue(double value, int size)
+{
+	if (!this->writable)
+	{
+		return;
+	}
+	T *signal = this->WindowData();
+	int length = (size < this->WindowSize()) ? size : this->WindowSize();
+	for (int i = 0; i < length; ++i)
+	{
+		signal[i] = ToSample<T>(signal[i] - value);
+	}
+	this->SyncMirror(0, length);
+}
+/// @brief Divides the signal processing vector by a scalar value
+/// @param value Value
+/// @param size Number of elements to divide
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::DivideWithValue(double value, int size)
+{
+	if (!this->writable)
+	{
+		return;
+	}
+	if (value != 0)
+	{
+		T *signal = this->WindowData();
+		int length = (size < this->WindowSize()) ? size : this->WindowSize();
+		for (int i = 0; i < length; ++i)
+		{
+			signal[i] = ToSample<T>(signal[i] / value);
+		}
+		this->SyncMirror(0, length);
+	}
+}
+/// @brief Adds a scalar value to the signal processing vector
+/// @param value Value
+/// @param size Number of elements to add
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::AddWithValue(double value, int size)
+{
+	if (!this->writable)
+	{
+		return;
+	}
+	T *signal = this->WindowData();
+	int length = (size < this->WindowSize()) ? size : this->WindowSize();
+	for (int i = 0; i < length; ++i)
+	{
+		signal[i] = ToSample<T>(signal[i] + value);
+	}
+	this->SyncMirror(0, length);
+}
+
+/// @brief Creates a normal distribution
+/// @return prob_dist
+template <typename T, typename Acc>
+prob_dist *SignalProcessingT<T, Acc>::NormalDistributionCreate()
+{
+	/* allocate memory for prob _distrib*/
+	prob_dist *pd = (prob_dist *)malloc(sizeof(prob_dist));
+
+	pd->count = 0;
+	pd->capacity = 0;
+	pd->items = NULL;
+
+	pd->total_probability = 0;
+	pd->total_normal_probability = 0;
+	pd->total_normal_frequency = 0;
+
+	return pd;
+}
+
+/// @brief Calculates the normal distribution
+/// @param data Contains values
+/// @param size Number of elements to add
+/// @param pd Probability distribution
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::NormalDistributionCalculate(double *data, int size, prob_dist *pd)
+{
+	int index;
+	double total = 0;
+	double sumofsquares = 0;
+	double mean;
+	double variance;
+	double stddev;
+	if ((pd == NULL) || (data == NULL))
+	{
+		return;
+	}
+	pd->total_frequency = size;
+
+	// room for every value being new: one allocation instead of one per unique value
+	if (pd->count + size > pd->capacity)
+	{
+		int capacity = (2 * pd->capacity > pd->count + size) ? 2 * pd->capacity : pd->count + size;
+		prob_dist_item *items = (prob_dist_item *)realloc(pd->items, sizeof(prob_dist_item) * capacity);
+		if (items == NULL)
+		{
+			return;
+		}
+		pd->items = items;
+		pd->capacity = capacity;
+	}
+
+	// CALCULATE FREQUENCIES
+	// iterate data
+	// add new values to pd
+	// or
+	// increment frequency of existing values
+	for (int i = 0; i < size; i++)
+	{
+		index = this->IndexOf(data[i], pd);
+
+		// already exists
+		if (index >= 0)
+		{
+			pd->items[index].frequency++;
+		}
+		// does not exist
+		else
+		{
+			pd->count++;
+			pd->items[pd->count - 1].value = data[i];
+			pd->items[pd->count - 1].frequency = 1;
+		}
+
+		total += data[i];
+		sumofsquares += pow(data[i], 2);
+	}
+
+	// SORT ITEMS
+	// std::sort instead of qsort: glibc's qsort allocates a merge buffer for large tables
+	std::sort(pd->items, pd->items + pd->count, [](const prob_dist_item &a, const prob_dist_item &b)
+			  { return CompareProbDistItem(&a, &b) < 0; });
+
+	// CALCULATE MEAN, VARIANCE AND STANDARD DEVIATION
+	mean = total / size;
+	variance = (sumofsquares - ((pow(total, 2)) / size)) / size;
+	stddev = sqrt(variance);
+
+	// CALCULATE PROBABILITIES OF EACH UNIQUE VALUE
+	for (int c = 0; c < pd->count; c++)
+	{
+		pd->items[c].probability = (double)pd->items[c].frequency / (double)size;
+		pd->items[c].normal_probability = ((1.0 / (stddev * sqrt(2.0 * M_PI))) * (pow(M_E, -1.0 * ((pow((pd->items[c].value - mean), 2.0)) / (variance * 2.0)))));
+		pd->items[c].normal_frequency = pd->items[c].normal_probability * size;
+		pd->total_probability += pd->items[c].probability;
+		pd->total_normal_probability += pd->items[c].normal_probability;
+		pd->total_normal_frequency += pd->items[c].normal_frequency;
+	}
+}
+
+/// @brief Prints the normal distribution
+/// @param pd Probability distribution
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::NormalDistributionPrint(prob_dist *pd)
+{
+	printf("Value | Probability | Normal Prob | Freq | Normal Freq\n------------------------------------------------------\n");
+
+	for (int i = 0; i < pd->count; i++)
+	{
+		printf("%f |%12.6lf |%12.4lf |%5d |%12.4lf\n", pd->items[i].value, pd->items[i].probability, pd->items[i].normal_probability, pd->items[i].frequency, pd->items[i].normal_frequency);
+	}
+
+	printf("------------------------------------------------------\n");
+
+	printf("      |%12.4lf |%12.6lf |%5.0lf |%12.4lf\n", pd->total_probability, pd->total_normal_probability, pd->total_frequency, pd->total_normal_frequency);
+
+	printf("------------------------------------------------------\n");
+}
+
+/// @brief Frees memory allocated for prob_dist
+/// @param pd Probability distribution
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::NormalDistributionFree()
+{
+	if (this->p_d != NULL)
+	{
+		free(this->p_d->items);
+		free(this->p_d);
+		this->p_d = NULL;
+	}
+}
+
+/// @fn IndexOf
+/// @brief Returns the index of a value
+/// @param value Value
+/// @param pd Probability distribution
+/// @return int
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::IndexOf(double value, prob_dist *pd)
+{
+	if (pd == NULL)
+	{
+		return -2;
+	}
+	/* Search the value */
+	for (int i = 0; i < pd->count; i++)
+	{
+		if (pd->items[i].value == value)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+/// @brief Computes the normal distribution and prints the result
+/// @return void
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::NormalDistributionRun()
+{
+	// reuse the items of the previous run
+	if (this->p_d == NULL)
+	{
+		this->p_d = this->NormalDistributionCreate();
+	}
+	this->p_d->count = 0;
+	this->p_d->total_probability = 0;
+	this->p_d->total_normal_probability = 0;
+	this->p_d->total_normal_frequency = 0;
+	int length = this->WindowSize();
+	size_t mark = this->workspace->Mark();
+	double *data = (double *)this->Scratch((length > 0 ? length : 1) * sizeof(double));
+	if (data == nullptr)
+	{
+		return;
+	}
+	std::copy(this->WindowData(), this->WindowData() + length, data);
+	this->NormalDistributionCalculate(data, length, this->p_d);
+	this->workspace->Release(mark);
+	//this->NormalDistributionPrint(this->p_d);
+}
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::BuildIndexLookupTable(int first_received)
+{
+	int received_ref = first_received;
+	for (int i = 0; i < MAX_INDX; i++)
+	{
+		if ((first_received + i) >= MAX_INDX)
+		{
+			index_lookup[i].received = first_received - received_ref;
+			received_ref --;
+		}
+		else
+		{
+			index_lookup[i].received = first_received + i;
+		}
+		index_lookup[i].normal = i;
+		#if DEBUG_INFO == 1
+		printf("Received = %d", index_lookup[i].received);
+		printf(" Normal = %d \n", index_lookup[i].normal);
+		#endif
+	}
+	
+}
+/// @brief Gets the index from the lookup table
+/// @param ReceivedIndex Received index
+/// @return Returns the normalized index
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::GetIndexLookupTable(int ReceivedIndex)
+{
+	for (int i = 0; i < MAX_INDX; i++)
+	{
+		if (index_lookup[i].received == ReceivedIndex)
+		{
+			return (index_lookup[i].normal);
+		}
+		
+	}
+	return 0;
+}
+
+/// @brief Calculates the moving average of the last window_size values
+/// @param window_size Number of values to average
+/// @return Moving average value
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::GetMovingAverage(int window_size)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (window_size <= 0 || length == 0)
+        return 0.0;
+    int start = (length > window_size) ? (length - window_size) : 0;
+    Acc sum = 0;
+    int count = 0;
+    for (int i = start; i < length; ++i)
+    {
+        sum += signal[i];
+        count++;
+    }
+    return (count > 0) ? (sum / count) : 0.0;
+}
+
+/// @brief Calculates the moving average for each position and stores it in out_vector
+/// @param out_vector Destination vector
+/// @param window_size Number of values to average
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::GetMovingAverageVector(Acc *out_vector, int window_size)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (out_vector == nullptr || window_size <= 0)
+        return;
+    for (int i = 0; i < length; ++i)
+    {
+        int start = (i >= window_size - 1) ? (i - window_size + 1) : 0;
+        Acc sum = 0;
+        int count = 0;
+        for (int j = start; j <= i; ++j)
+        {
+            sum += signal[j];
+            count++;
+        }
+        out_vector[i] = (count > 0) ? (sum / count) : 0;
+    }
+}
+
+/// @brief Calculates the mean (average) of the signal vector
+/// @return Mean value
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::GetMean()
+{
+    this->PrepareRunningStats();
+    if (this->stats_count == 0)
+        return 0.0;
+    return this->stats_shift + this->stats_sum / this->stats_count;
+}
+
+/// @brief Calculates the variance of the signal vector
+/// @return Variance value
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::GetVariance()
+{
+    this->PrepareRunningStats();
+    if (this->stats_count == 0)
+        return 0.0;
+    double mean_offset = this->stats_sum / this->stats_count;
+    double variance = this->stats_sumsq / this->stats_count - mean_offset * mean_offset;
+    return (variance > 0.0) ? variance : 0.0;
+}
+
+/// @brief Calculates the standard deviation of the signal vector
+/// @return Standard deviation value
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::GetStandardDeviation()
+{
+    return sqrt(GetVariance());
+}
+
+/// @brief Gets the smallest value of the signal vector
+/// @return Minimum value
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::GetMin()
+{
+    this->PrepareRunningStats();
+    return this->stats_min;
+}
+
+/// @brief Gets the largest value of the signal vector
+/// @return Maximum value
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::GetMax()
+{
+    this->PrepareRunningStats();
+    return this->stats_max;
+}
+
+/// @brief Normalizes the signal vector to [0, 1] range
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::NormalizeVector()
+{
+    if (!this->writable)
+        return;
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (length == 0)
+        return;
+    T min_val = signal[0];
+    T max_val = signal[0];
+    for (int i = 1; i < length; ++i)
+    {
+        if (signal[i] < min_val) min_val = signal[i];
+        if (signal[i] > max_val) max_val = signal[i];
+    }
+    double range = (double)max_val - (double)min_val;
+    if (range == 0.0) return;
+    for (int i = 0; i < length; ++i)
+        signal[i] = ToSample<T>((signal[i] - (double)min_val) / range);
+    this->SyncMirror(0, length);
+}
+
+/// @brief Scales the signal vector to a given range [new_min, new_max]
+/// @param new_min Minimum value of the new range
+/// @param new_max Maximum value of the new range
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::ScaleVector(double new_min, double new_max)
+{
+    if (!this->writable)
+        return;
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (length == 0)
+        return;
+    T min_val = signal[0];
+    T max_val = signal[0];
+    for (int i = 1; i < length; ++i)
+    {
+        if (signal[i] < min_val) min_val = signal[i];
+        if (signal[i] > max_val) max_val = signal[i];
+    }
+    double range = (double)max_val - (double)min_val;
+    if (range == 0.0) return;
+    for (int i = 0; i < length; ++i)
+    {
+        signal[i] = ToSample<T>(new_min + ((signal[i] - (double)min_val) / range) * (new_max - new_min));
+    }
+    this->SyncMirror(0, length);
+}
+
+/// @brief Applies exponential smoothing to the signal vector
+/// @param alpha Smoothing factor (0 < alpha <= 1)
+/// @param out_vector Destination vector for smoothed values (size >= GetIndex())
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::ExponentialSmoothing(double alpha, Acc *out_vector)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (out_vector == nullptr || length == 0 || alpha <= 0.0 || alpha > 1.0)
+        return;
+    Acc a = (Acc)alpha;
+    Acc b = (Acc)(1.0 - alpha);
+    out_vector[0] = signal[0];
+    for (int i = 1; i < length; ++i)
+    {
+        out_vector[i] = a * signal[i] + b * out_vector[i - 1];
+    }
+}
+
+/// @brief Detects threshold crossing events in the signal vector
+/// @param threshold The threshold value to detect
+/// @param direction 1 for rising edge (below->above), -1 for falling edge (above->below), 0 for both
+/// @param events Output array to store indices where crossings occur (size >= GetIndex())
+/// @return Number of threshold crossings detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectThresholdCrossing(double threshold, int direction, int *events)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (events == nullptr || length < 2)
+        return 0;
+    
+    int event_count = 0;
+    this->threshold_crossing_flag = false;
+    
+    for (int i = 1; i < length; ++i)
+    {
+        bool rising = (signal[i - 1] < threshold) && (signal[i] >= threshold);
+        bool falling = (signal[i - 1] > threshold) && (signal[i] <= threshold);
+        
+        if ((direction == 1 && rising) || (direction == -1 && falling) || (direction == 0 && (rising || falling)))
+        {
+            events[event_count++] = i;
+            this->threshold_crossing_flag = true;
+        }
+    }
+    
+    return event_count;
+}
+
+/// @brief Detects zero-crossing events in the signal vector
+/// @param direction 1 for positive crossing (negative->positive), -1 for negative crossing (positive->negative), 0 for both
+/// @param events Output array to store indices where crossings occur (size >= GetIndex())
+/// @return Number of zero crossings detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectZeroCrossing(int direction, int *events)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (events == nullptr || length < 2)
+        return 0;
+    
+    int event_count = 0;
+    this->zero_crossing_flag = false;
+    
+    for (int i = 1; i < length; ++i)
+    {
+        bool positive_crossing = (signal[i - 1] < 0.0) && (signal[i] >= 0.0);
+        bool negative_crossing = (signal[i - 1] > 0.0) && (signal[i] <= 0.0);
+        
+        if ((direction == 1 && positive_crossing) || (direction == -1 && negative_crossing) || (direction == 0 && (positive_crossing || negative_crossing)))
+        {
+            events[event_count++] = i;
+            this->zero_crossing_flag = true;
+        }
+    }
+    
+    return event_count;
+}
+
+/// @brief Gets the threshold crossing flag status
+/// @return True if threshold crossing was detected
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::GetThresholdCrossingFlag()
+{
+    return this->threshold_crossing_flag;
+}
+
+/// @brief Gets the zero crossing flag status
+/// @return True if zero crossing was detected
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::GetZeroCrossingFlag()
+{
+    return this->zero_crossing_flag;
+}
+
+/// @brief Clears event detection flags
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::ClearEventFlags()
+{
+    this->threshold_crossing_flag = false;
+    this->zero_crossing_flag = false;
+}
+
+/// @fn CompareProbDistItem
+/// @brief Returns -1 if a<b ; 1 if a >b else returns 0
+/// @param const void *a
+/// @param const void *b
+/// @return int
+int CompareProbDistItem(const void *a, const void *b)
+{
+	if (((prob_dist_item *)a)->value < ((prob_dist_item *)b)->value)
+		return -1;
+	else if (((prob_dist_item *)a)->value > ((prob_dist_item *)b)->value)
+		return 1;
+	else
+		return 0;
+}
+
+/// @brief Detects peaks (local maxima) in the signal vector
+/// @param peaks Output array to store peak indices
+/// @param max_peaks Maximum number of peaks to detect
+/// @return Number of peaks detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectPeaks(int *peaks, int max_peaks)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (peaks == nullptr || max_peaks <= 0 || length < 3)
+        return 0;
+    
+    int peak_count = 0;
+    
+    // Check each point (excluding first and last)
+    for (int i = 1; i < length - 1 && peak_count < max_peaks; ++i)
+    {
+        // A peak is a point higher than both neighbors
+        if (signal[i] > signal[i - 1] && 
+            signal[i] > signal[i + 1])
+        {
+            peaks[peak_count++] = i;
+        }
+    }
+    
+    return peak_count;
+}
+
+/// @brief Detects peaks above a threshold value
+/// @param threshold Minimum value for peak detection
+/// @param peaks Output array to store peak indices
+/// @param max_peaks Maximum number of peaks to detect
+/// @return Number of peaks detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectPeaksWithThreshold(double threshold, int *peaks, int max_peaks)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (peaks == nullptr || max_peaks <= 0 || length < 3)
+        return 0;
+    
+    int peak_count = 0;
+    
+    // Check each point (excluding first and last)
+    for (int i = 1; i < length - 1 && peak_count < max_peaks; ++i)
+    {
+        // A peak must be higher than both neighbors AND above threshold
+        if (signal[i] > signal[i - 1] && 
+            signal[i] > signal[i + 1] &&
+            signal[i] >= threshold)
+        {
+            peaks[peak_count++] = i;
+        }
+    }
+    
+    return peak_count;
+}
+
+/// @brief Detects peaks with minimum prominence
+/// @param min_prominence Minimum prominence (height above surrounding valleys)
+/// @param peaks Output array to store peak indices
+/// @param max_peaks Maximum number of peaks to detect
+/// @return Number of peaks detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectPeaksWithProminence(double min_prominence, int *peaks, int max_peaks)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (peaks == nullptr || max_peaks <= 0 || length < 3 || min_prominence < 0)
+        return 0;
+    
+    int peak_count = 0;
+    
+    // First detect all local maxima
+    for (int i = 1; i < length - 1 && peak_count < max_peaks; ++i)
+    {
+        if (signal[i] > signal[i - 1] && 
+            signal[i] > signal[i + 1])
+        {
+            // Calculate prominence: find minimum on both sides
+            double left_min = signal[i];
+            double right_min = signal[i];
+            
+            // Search left for minimum
+            for (int j = i - 1; j >= 0; --j)
+            {
+                if (signal[j] < left_min)
+                    left_min = signal[j];
+                // Stop at higher peak
+                if (signal[j] > signal[i])
+                    break;
+            }
+            
+            // Search right for minimum
+            for (int j = i + 1; j < length; ++j)
+            {
+                if (signal[j] < right_min)
+                    right_min = signal[j];
+                // Stop at higher peak
+                if (signal[j] > signal[i])
+                    break;
+            }
+            
+            // Prominence is the minimum of the two side differences
+            double left_prominence = signal[i] - left_min;
+            double right_prominence = signal[i] - right_min;
+            double prominence = (left_prominence < right_prominence) ? left_prominence : right_prominence;
+            
+            if (prominence >= min_prominence)
+            {
+                peaks[peak_count++] = i;
+            }
+        }
+    }
+    
+    return peak_count;
+}
+
+/// @brief Detects peaks with minimum distance between them
+/// @param min_distance Minimum distance between consecutive peaks
+/// @param peaks Output array to store peak indices
+/// @param max_peaks Maximum number of peaks to detect
+/// @return Number of peaks detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectPeaksWithDistance(int min_distance, int *peaks, int max_peaks)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (peaks == nullptr || max_peaks <= 0 || length < 3 || min_distance < 1)
+        return 0;
+    
+    // First detect all local maxima with their values
+    size_t mark = this->workspace->Mark();
+    int *temp_peaks = (int *)this->Scratch(length * sizeof(int));
+    double *peak_values = (double *)this->Scratch(length * sizeof(double));
+    bool *selected = (bool *)this->Scratch(length * sizeof(bool));
+    if (temp_peaks == nullptr || peak_values == nullptr || selected == nullptr)
+    {
+        this->workspace->Release(mark);
+        return 0;
+    }
+    int temp_count = 0;
+    
+    for (int i = 1; i < length - 1; ++i)
+    {
+        if (signal[i] > signal[i - 1] && 
+            signal[i] > signal[i + 1])
+        {
+            temp_peaks[temp_count] = i;
+            peak_values[temp_count] = signal[i];
+            temp_count++;
+        }
+    }
+    
+    if (temp_count == 0)
+    {
+        this->workspace->Release(mark);
+        return 0;
+    }
+    
+    // Sort peaks by value (descending) to prioritize higher peaks
+    // Simple bubble sort for this implementation
+    for (int i = 0; i < temp_count - 1; ++i)
+    {
+        for (int j = 0; j < temp_count - i - 1; ++j)
+        {
+            if (peak_values[j] < peak_values[j + 1])
+            {
+                // Swap values
+                double temp_val = peak_values[j];
+                peak_values[j] = peak_values[j + 1];
+                peak_values[j + 1] = temp_val;
+                // Swap indices
+                int temp_idx = temp_peaks[j];
+                temp_peaks[j] = temp_peaks[j + 1];
+                temp_peaks[j + 1] = temp_idx;
+            }
+        }
+    }
+    
+    // Select peaks respecting minimum distance
+    memset(selected, 0, temp_count * sizeof(bool));
+    int peak_count = 0;
+    
+    for (int i = 0; i < temp_count && peak_count < max_peaks; ++i)
+    {
+        bool too_close = false;
+        
+        // Check distance to all already selected peaks
+        for (int j = 0; j < temp_count; ++j)
+        {
+            if (selected[j])
+            {
+                int distance = temp_peaks[i] - temp_peaks[j];
+                if (distance < 0) distance = -distance; // abs()
+                
+                if (distance < min_distance)
+                {
+                    too_close = true;
+                    break;
+                }
+            }
+        }
+        
+        if (!too_close)
+        {
+            selected[i] = true;
+            peaks[peak_count++] = temp_peaks[i];
+        }
+    }
+    
+    this->workspace->Release(mark);
+    
+    // Sort final peaks by index for easier interpretation
+    for (int i = 0; i < peak_count - 1; ++i)
+    {
+        for (int j = 0; j < peak_count - i - 1; ++j)
+        {
+            if (peaks[j] > peaks[j + 1])
+            {
+                int temp = peaks[j];
+                peaks[j] = peaks[j + 1];
+                peaks[j + 1] = temp;
+            }
+        }
+    }
+    
+    return peak_count;
+}
+
+/// @brief Gets the value at a specific peak index
+/// @param peak_index Index of the peak in the signal vector
+/// @return Value at the peak
+template <typename T, typename Acc>
+T SignalProcessingT<T, Acc>::GetPeakValue(int peak_index)
+{
+    if (peak_index < 0 || peak_index >= this->WindowSize())
+        return 0.0;
+    
+    return this->WindowData()[peak_index];
+}
+
+/// @brief Gets the signal value at a specific index
+/// @param index Index in the signal vector
+/// @return Value at the specified index
+template <typename T, typename Acc>
+T SignalProcessingT<T, Acc>::GetValue(int index)
+{
+    if (index < 0 || index >= this->WindowSize())
+        return 0.0;
+    
+    return this->WindowData()[index];
+}
+
+/// @brief Gets the timestamp at a specific index
+/// @param index Index in the signal vector
+/// @return Timestamp at the specified index
+template <typename T, typename Acc>
+struct timespec SignalProcessingT<T, Acc>::GetTimestamp(int index)
+{
+    struct timespec empty_ts = {0, 0};
+    
+    if (index < 0 || index >= this->WindowSize())
+        return empty_ts;
+    
+    bool valid;
+    long long ns = this->LoadTimestamp(index, &valid);
+    if (!valid)
+        return empty_ts;
+    
+    return NsToTimespec(ns);
+}
+
+/// @brief Applies a simple 1D Kalman filter for signal denoising
+/// @param process_noise Process noise covariance (Q)
+/// @param measurement_noise Measurement noise covariance (R)
+/// @param out_vector Output vector for filtered values
+/// @param initial_estimate Initial state estimate
+/// @param initial_error Initial error covariance
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::KalmanFilter(double process_noise, double measurement_noise, 
+                                   Acc *out_vector, double initial_estimate, double initial_error)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (out_vector == nullptr || length == 0)
+        return;
+    
+    // Kalman filter state variables
+    Acc estimate = (Acc)initial_estimate;
+    Acc error_covariance = (Acc)initial_error;
+    Acc q = (Acc)process_noise;
+    Acc r = (Acc)measurement_noise;
+    
+    for (int i = 0; i < length; ++i)
+    {
+        // Prediction step
+        Acc predicted_estimate = estimate;
+        Acc predicted_error = error_covariance + q;
+        
+        // Update step
+        Acc kalman_gain = predicted_error / (predicted_error + r);
+        estimate = predicted_estimate + kalman_gain * (signal[i] - predicted_estimate);
+        error_covariance = (1 - kalman_gain) * predicted_error;
+        
+        out_vector[i] = estimate;
+    }
+}
+
+/// @brief Soft thresholding function for wavelet denoising
+/// @param value Input value
+/// @param threshold Threshold value
+/// @return Thresholded value
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::SoftThreshold(double value, double threshold)
+{
+    if (value > threshold)
+        return value - threshold;
+    else if (value < -threshold)
+        return value + threshold;
+    else
+        return 0.0;
+}
+
+/// @brief Partition function for quicksort
+/// @param arr Array to partition
+/// @param low Starting index
+/// @param high Ending index
+/// @return Partition index
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::PartitionDouble(double *arr, int low, int high)
+{
+    double pivot = arr[high];
+    int i = low - 1;
+    
+    for (int j = low; j < high; ++j)
+    {
+        if (arr[j] <= pivot)
+        {
+            i++;
+            double temp = arr[i];
+            arr[i] = arr[j];
+            arr[j] = temp;
+        }
+    }
+    
+    double temp = arr[i + 1];
+    arr[i + 1] = arr[high];
+    arr[high] = temp;
+    
+    return i + 1;
+}
+
+/// @brief Quicksort implementation for doubles
+/// @param arr Array to sort
+/// @param low Starting index
+/// @param high Ending index
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::QuickSortDouble(double *arr, int low, int high)
+{
+    if (low < high)
+    {
+        // introsort: the recursive Lomuto version degrades to O(n^2) time and
+        // O(n) stack depth on constant or sorted windows of 64k+ samples
+        std::sort(arr + low, arr + high + 1);
+    }
+}
+
+/// @brief Haar wavelet transform (1D)
+/// @param data Data array
+/// @param size Size of data (must be power of 2)
+/// @param direction 1 for forward, -1 for inverse
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::HaarWaveletTransform(Acc *data, int size, int direction)
+{
+    if (data == nullptr || size < 2)
+        return;
+    
+    size_t mark = this->workspace->Mark();
+    Acc *temp = (Acc *)this->Scratch(size * sizeof(Acc));
+    if (temp == nullptr)
+        return;
+    const Acc sqrt2 = (Acc)1.414213562373095;
+    
+    if (direction == 1) // Forward transform
+    {
+        int half = size / 2;
+        for (int i = 0; i < half; ++i)
+        {
+            temp[i] = (data[2 * i] + data[2 * i + 1]) / sqrt2;
+            temp[half + i] = (data[2 * i] - data[2 * i + 1]) / sqrt2;
+        }
+        for (int i = 0; i < size; ++i)
+            data[i] = temp[i];
+    }
+    else // Inverse transform
+    {
+        int half = size / 2;
+        for (int i = 0; i < half; ++i)
+        {
+            temp[2 * i] = (data[i] + data[half + i]) / sqrt2;
+            temp[2 * i + 1] = (data[i] - data[half + i]) / sqrt2;
+        }
+        for (int i = 0; i < size; ++i)
+            data[i] = temp[i];
+    }
+    this->workspace->Release(mark);
+}
+
+/// @brief Applies wavelet denoising using soft thresholding
+/// @param threshold Threshold value for wavelet coefficients
+/// @param out_vector Output vector for denoised values
+/// @param level Decomposition level
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::WaveletDenoise(double threshold, Acc *out_vector, int level)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (out_vector == nullptr || length == 0)
+        return;
+    
+    // Find nearest power of 2
+    int size = length;
+    int transform_size = 1;
+    while (transform_size < size)
+        transform_size *= 2;
+    
+    // Work on a zero-padded copy so out_vector only needs GetIndex() values
+    size_t mark = this->workspace->Mark();
+    Acc *coeffs = (Acc *)this->Scratch(transform_size * sizeof(Acc));
+    if (coeffs == nullptr)
+        return;
+    for (int i = 0; i < size; ++i)
+        coeffs[i] = signal[i];
+    for (int i = size; i < transform_size; ++i)
+        coeffs[i] = 0;
+    
+    // Apply forward wavelet transform multiple times
+    int current_size = transform_size;
+    for (int l = 0; l < level && current_size >= 2; ++l)
+    {
+        HaarWaveletTransform(coeffs, current_size, 1);
+        current_size /= 2;
+    }
+    
+    // Apply soft thresholding to detail coefficients
+    // Keep approximation coefficients (first current_size elements) untouched
+    for (int i = current_size; i < transform_size; ++i)
+    {
+        coeffs[i] = SoftThreshold(coeffs[i], threshold);
+    }
+    
+    // Apply inverse wavelet transform
+    current_size *= 2;
+    for (int l = 0; l < level && current_size <= transform_size; ++l)
+    {
+        HaarWaveletTransform(coeffs, current_size, -1);
+        current_size *= 2;
+    }
+    
+    // Trim to original size
+    for (int i = 0; i < size; ++i)
+        out_vector[i] = coeffs[i];
+    this->workspace->Release(mark);
+}
+
+/// @brief Applies median filter for noise removal
+/// @param window_size Window size (must be odd)
+/// @param out_vector Output vector for filtered values
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::MedianFilter(int window_size, Acc *out_vector)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (out_vector == nullptr || length == 0 || window_size < 1)
+        return;
+    
+    // Ensure odd window size
+    if (window_size % 2 == 0)
+        window_size++;
+    
+    T window[101]; // Support up to window size 101
+    
+    if (window_size > 101)
+        window_size = 101;
+    int half_window = window_size / 2;
+    
+    for (int i = 0; i < length; ++i)
+    {
+        int count = 0;
+        
+        // Collect values in window
+        for (int j = -half_window; j <= half_window; ++j)
+        {
+            int idx = i + j;
+            if (idx >= 0 && idx < length)
+            {
+                window[count++] = signal[idx];
+            }
+        }
+        
+        // Sort window to find median
+        if (count > 0)
+        {
+            std::sort(window, window + count);
+            
+            // Get median
+            if (count % 2 == 1)
+                out_vector[i] = window[count / 2];
+            else
+                out_vector[i] = ((Acc)window[count / 2 - 1] + (Acc)window[count / 2]) / 2;
+        }
+        else
+        {
+            out_vector[i] = signal[i];
+        }
+    }
+}
+
+/// @brief Estimates noise level using Median Absolute Deviation (MAD)
+/// @return Estimated noise standard deviation
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::EstimateNoiseLevel()
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (length < 2)
+        return 0.0;
+    
+    if (this->IsCached(this->noise_generation))
+        return this->cached_noise;
+    
+    // Calculate differences (high-pass filter approximation)
+    size_t mark = this->workspace->Mark();
+    double *differences = (double *)this->Scratch((length - 1) * sizeof(double));
+    if (differences == nullptr)
+        return 0.0;
+    for (int i = 0; i < length - 1; ++i)
+    {
+        differences[i] = signal[i + 1] - signal[i];
+    }
+    int diff_size = length - 1;
+    
+    // Calculate absolute values
+    for (int i = 0; i < diff_size; ++i)
+    {
+        if (differences[i] < 0)
+            differences[i] = -differences[i];
+    }
+    
+    // Sort to find median
+    QuickSortDouble(differences, 0, diff_size - 1);
+    
+    // Get median
+    double median;
+    if (diff_size % 2 == 1)
+        median = differences[diff_size / 2];
+    else
+        median = (differences[diff_size / 2 - 1] + differences[diff_size / 2]) / 2.0;
+    this->workspace->Release(mark);
+    
+    // Estimate noise sigma using MAD
+    // sigma ≈ MAD / 0.6745
+    this->cached_noise = median / 0.6745;
+    this->noise_generation = this->generation;
+    this->result_computations++;
+    return this->cached_noise;
+}
+
+// ========== ANOMALY DETECTION IMPLEMENTATION ==========
+
+/// @brief Detects anomalies using Z-score method (statistical threshold)
+/// @param threshold_sigma Number of standard deviations for anomaly threshold
+/// @param anomaly_indices Output array for anomaly indices
+/// @param max_anomalies Maximum number of anomalies to detect
+/// @return Number of anomalies detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectAnomaliesZScore(double threshold_sigma, int *anomaly_indices, int max_anomalies)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (anomaly_indices == nullptr || length < 3 || max_anomalies <= 0)
+        return 0;
+    
+    double mean = GetMean();
+    double std_dev = GetStandardDeviation();
+    
+    if (std_dev == 0.0)
+        return 0;
+    
+    int anomaly_count = 0;
+    
+    for (int i = 0; i < length && anomaly_count < max_anomalies; ++i)
+    {
+        double z_score = (signal[i] - mean) / std_dev;
+        
+        // Check if absolute z-score exceeds threshold
+        if (z_score > threshold_sigma || z_score < -threshold_sigma)
+        {
+            anomaly_indices[anomaly_count++] = i;
+        }
+    }
+    
+    return anomaly_count;
+}
+
+/// @brief Gets the first and third quartiles of the analysis window, sorted once per generation
+/// @param q1 Output first quartile (value at length / 4 of the sorted window)
+/// @param q3 Output third quartile (value at 3 * length / 4)
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::GetQuartiles(double *q1, double *q3)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (length < 1)
+        return false;
+    
+    if (!this->IsCached(this->quartiles_generation))
+    {
+        // Copy and sort data to find quartiles
+        size_t mark = this->workspace->Mark();
+        double *sorted = (double *)this->Scratch(length * sizeof(double));
+        if (sorted == nullptr)
+            return false;
+        for (int i = 0; i < length; ++i)
+            sorted[i] = signal[i];
+        
+        QuickSortDouble(sorted, 0, length - 1);
+        
+        this->cached_q1 = sorted[length / 4];
+        this->cached_q3 = sorted[(3 * length) / 4];
+        this->workspace->Release(mark);
+        this->quartiles_generation = this->generation;
+        this->result_computations++;
+    }
+    
+    *q1 = this->cached_q1;
+    *q3 = this->cached_q3;
+    return true;
+}
+
+/// @brief Detects anomalies using Interquartile Range (IQR) method
+/// @param iqr_multiplier Multiplier for IQR (1.5 for outliers, 3.0 for extreme)
+/// @param anomaly_indices Output array for anomaly indices
+/// @param max_anomalies Maximum number of anomalies to detect
+/// @return Number of anomalies detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectAnomaliesIQR(double iqr_multiplier, int *anomaly_indices, int max_anomalies)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (anomaly_indices == nullptr || length < 4 || max_anomalies <= 0)
+        return 0;
+    
+    // Calculate Q1, Q3
+    double q1, q3;
+    if (!this->GetQuartiles(&q1, &q3))
+        return 0;
+    double iqr = q3 - q1;
+    
+    // Calculate bounds
+    double lower_bound = q1 - iqr_multiplier * iqr;
+    double upper_bound = q3 + iqr_multiplier * iqr;
+    
+    int anomaly_count = 0;
+    
+    for (int i = 0; i < length && anomaly_count < max_anomalies; ++i)
+    {
+        if (signal[i] < lower_bound || signal[i] > upper_bound)
+        {
+            anomaly_indices[anomaly_count++] = i;
+        }
+    }
+    
+    return anomaly_count;
+}
+
+/// @brief Detects anomalies using Moving Average Deviation method
+/// @param window_size Window size for moving average
+/// @param threshold_factor Multiplication factor for deviation threshold
+/// @param anomaly_indices Output array for anomaly indices
+/// @param max_anomalies Maximum number of anomalies to detect
+/// @return Number of anomalies detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectAnomaliesMAD(int window_size, double threshold_factor, int *anomaly_indices, int max_anomalies)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (anomaly_indices == nullptr || length < window_size || max_anomalies <= 0)
+        return 0;
+    
+    int anomaly_count = 0;
+    
+    for (int i = window_size; i < length && anomaly_count < max_anomalies; ++i)
+    {
+        // Calculate moving average for window before current point
+        double sum = 0.0;
+        for (int j = i - window_size; j < i; ++j)
+            sum += signal[j];
+        double moving_avg = sum / window_size;
+        
+        // Calculate standard deviation in window
+        double variance_sum = 0.0;
+        for (int j = i - window_size; j < i; ++j)
+        {
+            double diff = signal[j] - moving_avg;
+            variance_sum += diff * diff;
+        }
+        double std_dev = sqrt(variance_sum / window_size);
+        
+        // Check if current point deviates significantly
+        double deviation = signal[i] - moving_avg;
+        if (deviation < 0) deviation = -deviation;
+        
+        if (std_dev > 0 && deviation > threshold_factor * std_dev)
+        {
+            anomaly_indices[anomaly_count++] = i;
+        }
+    }
+    
+    return anomaly_count;
+}
+
+/// @brief Detects sudden changes/spikes in signal (rate of change anomaly)
+/// @param threshold_change Minimum rate of change to be considered anomalous
+/// @param anomaly_indices Output array for anomaly indices
+/// @param max_anomalies Maximum number of anomalies to detect
+/// @return Number of anomalies detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectSuddenChanges(double threshold_change, int *anomaly_indices, int max_anomalies)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (anomaly_indices == nullptr || length < 2 || max_anomalies <= 0)
+        return 0;
+    
+    int anomaly_count = 0;
+    
+    for (int i = 1; i < length && anomaly_count < max_anomalies; ++i)
+    {
+        double change = signal[i] - signal[i - 1];
+        if (change < 0) change = -change;
+        
+        if (change >= threshold_change)
+        {
+            anomaly_indices[anomaly_count++] = i;
+        }
+    }
+    
+    return anomaly_count;
+}
+
+/// @brief Segments signal by markers and calculates statistics for each segment
+/// @param marker_indices Array of indices where each segment starts
+/// @param num_markers Number of markers
+/// @param segment_stats Output array for segment statistics
+/// @return Number of segments analyzed
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::SegmentByMarkers(int *marker_indices, int num_markers, SegmentStats *segment_stats)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (marker_indices == nullptr || segment_stats == nullptr || num_markers < 1)
+        return 0;
+    
+    int segment_count = 0;
+    double global_mean = GetMean();
+    
+    for (int seg = 0; seg < num_markers; ++seg)
+    {
+        int start = marker_indices[seg];
+        int end = (seg < num_markers - 1) ? marker_indices[seg + 1] - 1 : length - 1;
+        
+        if (start >= length || start < 0 || end >= length || start > end)
+            continue;
+        
+        // Calculate statistics for this segment
+        segment_stats[segment_count].start_index = start;
+        segment_stats[segment_count].end_index = end;
+        segment_stats[segment_count].segment_id = seg;
+        segment_stats[segment_count].num_points = end - start + 1;
+        
+        // Calculate mean
+        double sum = 0.0;
+        double max_val = signal[start];
+        double min_val = signal[start];
+        
+        for (int i = start; i <= end; ++i)
+        {
+            sum += signal[i];
+            if (signal[i] > max_val) max_val = signal[i];
+            if (signal[i] < min_val) min_val = signal[i];
+        }
+        
+        segment_stats[segment_count].mean = sum / segment_stats[segment_count].num_points;
+        segment_stats[segment_count].max_value = max_val;
+        segment_stats[segment_count].min_value = min_val;
+        segment_stats[segment_count].peak_to_peak = max_val - min_val;
+        
+        // Calculate standard deviation and RMS
+        double variance_sum = 0.0;
+        double rms_sum = 0.0;
+        
+        for (int i = start; i <= end; ++i)
+        {
+            double diff = signal[i] - segment_stats[segment_count].mean;
+            variance_sum += diff * diff;
+            rms_sum += signal[i] * signal[i];
+        }
+        
+        segment_stats[segment_count].std_dev = sqrt(variance_sum / segment_stats[segment_count].num_points);
+        segment_stats[segment_count].rms = sqrt(rms_sum / segment_stats[segment_count].num_points);
+        
+        // Initial anomaly score based on deviation from global mean
+        segment_stats[segment_count].anomaly_score = segment_stats[segment_count].mean - global_mean;
+        if (segment_stats[segment_count].anomaly_score < 0)
+            segment_stats[segment_count].anomaly_score = -segment_stats[segment_count].anomaly_score;
+        
+        segment_count++;
+    }
+    
+    return segment_count;
+}
+
+/// @brief Finds the segment with highest anomaly score
+/// @param marker_indices Array of indices where each segment starts
+/// @param num_markers Number of markers
+/// @param anomaly_method Method: 0=ZScore, 1=IQR, 2=MAD, 3=MaxValue
+/// @return Index of most anomalous segment
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::FindMostAnomalousSegment(int *marker_indices, int num_markers, int anomaly_method)
+{
+    if (marker_indices == nullptr || num_markers < 1)
+        return -1;
+    
+    SegmentStats segment_stats[100];
+    int num_segments = SegmentByMarkers(marker_indices, num_markers, segment_stats);
+    
+    if (num_segments == 0)
+        return -1;
+    
+    int most_anomalous = 0;
+    double max_score = 0.0;
+    
+    // Calculate global statistics for comparison
+    double global_mean = GetMean();
+    double global_std = GetStandardDeviation();
+    
+    for (int i = 0; i < num_segments; ++i)
+    {
+        double score = 0.0;
+        
+        switch (anomaly_method)
+        {
+            case 0: // Z-Score based on mean deviation
+                if (global_std > 0)
+                {
+                    score = (segment_stats[i].mean - global_mean) / global_std;
+                    if (score < 0) score = -score;
+                }
+                break;
+                
+            case 1: // Based on standard deviation (variability)
+                score = segment_stats[i].std_dev;
+                break;
+                
+            case 2: // Based on RMS
+                score = segment_stats[i].rms;
+                break;
+                
+            case 3: // Based on max value
+                score = segment_stats[i].max_value;
+                if (score < 0) score = -score;
+                break;
+                
+            default:
+                score = segment_stats[i].anomaly_score;
+                break;
+        }
+        
+        segment_stats[i].anomaly_score = score;
+        
+        if (score > max_score)
+        {
+            max_score = score;
+            most_anomalous = i;
+        }
+    }
+    
+    return most_anomalous;
+}
+
+/// @brief Detects anomalies in periodic signals
+/// @param period Expected period length
+/// @param tolerance Tolerance for period variations (0.0 to 1.0)
+/// @param anomaly_indices Output array for anomaly indices
+/// @param max_anomalies Maximum number of anomalies to detect
+/// @return Number of anomalies detected
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::DetectPeriodicAnomalies(int period, double tolerance, int *anomaly_indices, int max_anomalies)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (anomaly_indices == nullptr || period < 1 || length < period * 2 || max_anomalies <= 0)
+        return 0;
+    
+    int anomaly_count = 0;
+    int num_cycles = length / period;
+    
+    // Calculate average pattern for one period
+    size_t mark = this->workspace->Mark();
+    double *avg_pattern = (double *)this->Scratch(period * sizeof(double));
+    double *std_pattern = (double *)this->Scratch(period * sizeof(double));
+    if (avg_pattern == nullptr || std_pattern == nullptr)
+    {
+        this->workspace->Release(mark);
+        return 0;
+    }
+    for (int i = 0; i < period; ++i)
+        avg_pattern[i] = 0.0;
+    
+    for (int cycle = 0; cycle < num_cycles; ++cycle)
+    {
+        for (int i = 0; i < period; ++i)
+        {
+            int idx = cycle * period + i;
+            if (idx < length)
+                avg_pattern[i] += signal[idx];
+        }
+    }
+    
+    for (int i = 0; i < period; ++i)
+        avg_pattern[i] /= num_cycles;
+    
+    // Calculate standard deviation for each position in period
+    for (int i = 0; i < period; ++i)
+    {
+        double variance = 0.0;
+        for (int cycle = 0; cycle < num_cycles; ++cycle)
+        {
+            int idx = cycle * period + i;
+            if (idx < length)
+            {
+                double diff = signal[idx] - avg_pattern[i];
+                variance += diff * diff;
+            }
+        }
+        std_pattern[i] = sqrt(variance / num_cycles);
+    }
+    
+    // Detect deviations
+    for (int i = 0; i < length && anomaly_count < max_anomalies; ++i)
+    {
+        int pattern_pos = i % period;
+        double expected = avg_pattern[pattern_pos];
+        double std_dev = std_pattern[pattern_pos];
+        
+        if (std_dev > 0)
+        {
+            double deviation = signal[i] - expected;
+            if (deviation < 0) deviation = -deviation;
+            
+            if (deviation > tolerance * std_dev)
+            {
+                anomaly_indices[anomaly_count++] = i;
+            }
+        }
+    }
+    
+    this->workspace->Release(mark);
+    return anomaly_count;
+}
+
+/// @brief Calculates overall anomaly score for the signal
+/// @param method Method: 0=ZScore, 1=IQR, 2=MaxDeviation
+/// @return Anomaly score
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::CalculateAnomalyScore(int method)
+{
+    int length = this->WindowSize();
+    
+    if (length < 2)
+        return 0.0;
+    
+    double score = 0.0;
+    
+    switch (method)
+    {
+        case 0: // Based on max Z-score
+        {
+            double mean = GetMean();
+            double std_dev = GetStandardDeviation();
+            if (std_dev > 0)
+            {
+                // the largest |z| is reached at the minimum or the maximum
+                double max_dev = GetMax() - mean;
+                if (mean - GetMin() > max_dev) max_dev = mean - GetMin();
+                score = max_dev / std_dev;
+            }
+            break;
+        }
+        
+        case 1: // Based on IQR ratio
+        {
+            double q1, q3;
+            if (!this->GetQuartiles(&q1, &q3))
+                break;
+            double iqr = q3 - q1;
+            double range = GetMax() - GetMin();
+            
+            if (iqr > 0)
+                score = range / iqr;
+            break;
+        }
+        
+        case 2: // Based on max deviation from mean
+        {
+            double mean = GetMean();
+            double max_dev = GetMax() - mean;
+            if (mean - GetMin() > max_dev) max_dev = mean - GetMin();
+            score = (max_dev > 0.0) ? max_dev : 0.0;
+            break;
+        }
+        
+        default:
+            score = GetStandardDeviation();
+            break;
+    }
+    
+    return score;
+}
+
+// ========== FREQUENCY ANALYSIS IMPLEMENTATION ==========
+
+/// @brief Applies window function to data, from the cached table of its size
+/// @param data Data array
+/// @param size Size of data
+/// @param window_type SIGNAL_WINDOW_* constant (unknown types leave the data unchanged)
+/// @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::ApplyWindow(Acc *data, int size, int window_type, double parameter)
+{
+    if (data == nullptr || size < 1 || window_type == SIGNAL_WINDOW_RECTANGULAR)
+        return;
+    
+    const SignalWindow *window = SignalWindow::Get(window_type, size, parameter);
+    if (window != nullptr)
+        window->Apply(data);
+}
+
+/// @brief Selects the window function of FFTAnalysis() and of the spectral ML features
+/// @param window_type SIGNAL_WINDOW_* constant
+/// @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+/// @return false for an unknown window type
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::SetSpectrumWindow(int window_type, double parameter)
+{
+    if (window_type < SIGNAL_WINDOW_RECTANGULAR || window_type > SIGNAL_WINDOW_TUKEY)
+        return false;
+    
+    this->spectrum_window_type = window_type;
+    this->spectrum_window_parameter = parameter;
+    // results of the previous window
+    this->spectrum_generation = -1;
+    this->features_generation = -1;
+    return true;
+}
+
+/// @brief Gets the window function of FFTAnalysis()
+/// @return SIGNAL_WINDOW_* constant
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::GetSpectrumWindow() const
+{
+    return this->spectrum_window_type;
+}
+
+/// @brief FFT of any length (mixed radix or Bluestein, see FFTPlan)
+/// @param real Real part of signal
+/// @param imag Imaginary part of signal
+/// @param size Size (>= 2)
+/// @param direction 1 for forward, -1 for inverse
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::FFT(Acc *real, Acc *imag, int size, int direction)
+{
+    if (size < 2 || real == nullptr || imag == nullptr)
+        return;
+    
+    // tables shared by every transform of this size, scratch from the workspace
+    const FFTPlan *plan = FFTPlan::Get(size, direction);
+    if (plan == nullptr)
+        return;
+    size_t mark = this->workspace->Mark();
+    Acc *scratch = nullptr;
+    if (plan->GetScratchSize() > 0)
+        scratch = (Acc *)this->Scratch(plan->GetScratchSize() * sizeof(Acc));
+    plan->Execute(real, imag, scratch);
+    this->workspace->Release(mark);
+}
+
+/// @brief Forward FFT of real samples
+/// @param real Samples (size values), replaced by the real parts of bins 0 to size / 2
+/// @param imag Imaginary parts of bins 0 to size / 2 (size / 2 + 1 values)
+/// @param size Size (>= 2)
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::RealFFT(Acc *real, Acc *imag, int size)
+{
+    if (size < 2 || real == nullptr || imag == nullptr)
+        return;
+    
+    const FFTPlan *plan = FFTPlan::Get(size, 1);
+    if (plan == nullptr)
+        return;
+    size_t mark = this->workspace->Mark();
+    Acc *scratch = nullptr;
+    if (plan->GetScratchSize() > 0)
+        scratch = (Acc *)this->Scratch(plan->GetScratchSize() * sizeof(Acc));
+    plan->ExecuteReal(real, real, imag, scratch);
+    this->workspace->Release(mark);
+}
+
+/// @brief Performs FFT analysis on a window of the signal
+/// @param start_index Starting index
+/// @param window_size Window size
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::FFTAnalysis(int start_index, int window_size, double sampling_rate, FrequencySpectrum *spectrum)
+{
+    if (spectrum == nullptr || window_size < 2)
+        return false;
+    
+    int num_bins = window_size / 2 + 1;
+    FrequencyBin *bins = (FrequencyBin *)malloc(num_bins * sizeof(FrequencyBin));
+    if (bins == nullptr)
+        return false;
+    
+    // whole window: copy of the spectrum computed for this generation
+    FrequencySpectrum cached;
+    if (start_index == 0 && window_size == this->WindowSize() && this->CachedSpectrum(sampling_rate, &cached))
+    {
+        memcpy(bins, cached.bins, num_bins * sizeof(FrequencyBin));
+        *spectrum = cached;
+        spectrum->bins = bins;
+        return true;
+    }
+    
+    if (!ComputeSpectrum(start_index, window_size, sampling_rate, spectrum, bins, num_bins))
+    {
+        free(bins);
+        return false;
+    }
+    return true;
+}
+
+/// @brief Performs FFT analysis on entire signal
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::FFTAnalysis(double sampling_rate, FrequencySpectrum *spectrum)
+{
+    int length = this->WindowSize();
+    
+    return FFTAnalysis(0, length, sampling_rate, spectrum);
+}
+
+/// @brief Performs FFT analysis on entire signal into caller-provided bins
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum
+/// @param bins Output bins
+/// @param max_bins Size of bins
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::FFTAnalysis(double sampling_rate, FrequencySpectrum *spectrum, FrequencyBin *bins, int max_bins)
+{
+    FrequencySpectrum cached;
+    if (spectrum != nullptr && bins != nullptr && this->CachedSpectrum(sampling_rate, &cached))
+    {
+        if (max_bins < cached.num_bins)
+            return false;
+        memcpy(bins, cached.bins, cached.num_bins * sizeof(FrequencyBin));
+        *spectrum = cached;
+        spectrum->bins = bins;
+        return true;
+    }
+    return ComputeSpectrum(0, this->WindowSize(), sampling_rate, spectrum, bins, max_bins);
+}
+
+/// @brief Copies a double spectrum into single-precision bins
+/// @param source Spectrum to convert
+/// @param spectrum Output spectrum (bins set to the bins argument)
+/// @param bins Output bins (source->num_bins entries)
+static void SignalConvertSpectrum(const FrequencySpectrum *source, FrequencySpectrumF *spectrum, FrequencyBinF *bins)
+{
+    spectrum->bins = bins;
+    spectrum->num_bins = source->num_bins;
+    spectrum->sampling_rate = source->sampling_rate;
+    spectrum->frequency_resolution = source->frequency_resolution;
+    spectrum->dominant_frequency = source->dominant_frequency;
+    spectrum->total_power = source->total_power;
+    spectrum->window_size = source->window_size;
+    for (int i = 0; i < source->num_bins; ++i)
+    {
+        bins[i].frequency = (float)source->bins[i].frequency;
+        bins[i].magnitude = (float)source->bins[i].magnitude;
+        bins[i].phase = (float)source->bins[i].phase;
+        bins[i].power = (float)source->bins[i].power;
+    }
+}
+
+/// @brief Performs single-precision FFT analysis on a window of the signal
+/// @param start_index Starting index
+/// @param window_size Window size
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::FFTAnalysis(int start_index, int window_size, double sampling_rate, FrequencySpectrumF *spectrum)
+{
+    if (spectrum == nullptr || window_size < 2)
+        return false;
+    
+    int num_bins = window_size / 2 + 1;
+    FrequencyBinF *bins = (FrequencyBinF *)malloc(num_bins * sizeof(FrequencyBinF));
+    if (bins == nullptr)
+        return false;
+    
+    if (!ComputeSpectrum(start_index, window_size, sampling_rate, spectrum, bins, num_bins))
+    {
+        free(bins);
+        return false;
+    }
+    return true;
+}
+
+/// @brief Performs single-precision FFT analysis on entire signal
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::FFTAnalysis(double sampling_rate, FrequencySpectrumF *spectrum)
+{
+    int length = this->WindowSize();
+    
+    return FFTAnalysis(0, length, sampling_rate, spectrum);
+}
+
+/// @brief Performs single-precision FFT analysis on entire signal into caller-provided bins
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum
+/// @param bins Output bins
+/// @param max_bins Size of bins
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::FFTAnalysis(double sampling_rate, FrequencySpectrumF *spectrum, FrequencyBinF *bins, int max_bins)
+{
+    return ComputeSpectrum(0, this->WindowSize(), sampling_rate, spectrum, bins, max_bins);
+}
+
+/// @brief Gets the spectrum of the whole analysis window, computed once per generation
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum, bins pointing to the cache (read only)
+/// @return true if the spectrum is available, false if the object does not keep results
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::CachedSpectrum(double sampling_rate, FrequencySpectrum *spectrum)
+{
+    if (!this->owns_storage)
+        return false;
+    
+    if (!this->IsCached(this->spectrum_generation) || this->spectrum_rate != sampling_rate)
+    {
+        int num_bins = this->WindowSize() / 2 + 1;
+        if (num_bins > this->cached_bins_capacity)
+        {
+            // allocated once, for the largest window analysed
+            if (this->inline_storage)
+                return false;
+            FrequencyBin *bins = (FrequencyBin *)realloc(this->cached_bins, num_bins * sizeof(FrequencyBin));
+            if (bins == nullptr)
+                return false;
+            this->cached_bins = bins;
+            this->cached_bins_capacity = num_bins;
+        }
+        this->spectrum_generation = -1;
+        if (!ComputeSpectrum(0, this->WindowSize(), sampling_rate, &this->cached_spectrum,
+                             this->cached_bins, this->cached_bins_capacity))
+            return false;
+        this->spectrum_generation = this->generation;
+        this->spectrum_rate = sampling_rate;
+        this->result_computations++;
+    }
+    
+    *spectrum = this->cached_spectrum;
+    return true;
+}
+
+/// @brief atan2() in float arithmetic, without a libm call
+/// @param y Imaginary part
+/// @param x Real part
+/// @return Angle in radians, within 1e-7 of atan2(y, x)
+static inline float SignalAtan2(float y, float x)
+{
+    // atan(a) on [0, 1] as a times a polynomial in a^2 (degree 7, Chebyshev nodes), then the octant
+    float ax = fabsf(x), ay = fabsf(y);
+    float big = (ax > ay) ? ax : ay;
+    float a = (big > 0.0f) ? ((ax > ay) ? ay : ax) / big : 0.0f;
+    float s = a * a;
+    float r = -0.00455979199f;
+    r = r * s + 0.0237805186f;
+    r = r * s - 0.0588297531f;
+    r = r * s + 0.0986886546f;
+    r = r * s - 0.140032902f;
+    r = r * s + 0.199669618f;
+    r = r * s - 0.333318127f;
+    r = (r * s + 0.999999882f) * a;
+    if (ay > ax)
+        r = 1.57079633f - r;
+    if (x < 0.0f)
+        r = 3.14159265f - r;
+    return (y < 0.0f) ? -r : r;
+}
+
+/// @brief Phase of a double bin, with the libm atan2() of the transform type
+template <typename Acc>
+static inline void SignalSetPhase(FrequencyBin &bin, Acc y, Acc x)
+{
+    bin.phase = atan2(y, x);
+}
+
+/// @brief Phase of a float bin: the polynomial costs a fraction of atan2f() for the same precision
+template <typename Acc>
+static inline void SignalSetPhase(FrequencyBinF &bin, Acc y, Acc x)
+{
+    bin.phase = SignalAtan2((float)y, (float)x);
+}
+
+/// @brief Fills a spectrum from the bins of a real transform
+/// @param real Real parts (fft_size / 2 + 1 values)
+/// @param imag Imaginary parts (fft_size / 2 + 1 values)
+/// @param fft_size Transform length (window size)
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum (bins set to the bins argument), FrequencySpectrum or FrequencySpectrumF
+/// @param bins Output bins (fft_size / 2 + 1 entries)
+template <typename Acc, typename Spectrum, typename Bin>
+static void SignalFillSpectrum(const Acc *real, const Acc *imag, int fft_size, double sampling_rate,
+                               Spectrum *spectrum, Bin *bins)
+{
+    int num_bins = fft_size / 2 + 1;
+    spectrum->bins = bins;
+    spectrum->num_bins = num_bins;
+    spectrum->sampling_rate = sampling_rate;
+    spectrum->frequency_resolution = sampling_rate / fft_size;
+    spectrum->window_size = fft_size;
+    spectrum->total_power = 0.0;
+    spectrum->dominant_frequency = 0.0;
+    
+    double max_magnitude = 0.0;
+    
+    for (int i = 0; i < num_bins; ++i)
+    {
+        double frequency = i * spectrum->frequency_resolution;
+        spectrum->bins[i].frequency = frequency;
+        spectrum->bins[i].magnitude = sqrt(real[i] * real[i] + imag[i] * imag[i]);
+        SignalSetPhase(spectrum->bins[i], imag[i], real[i]);
+        spectrum->bins[i].power = spectrum->bins[i].magnitude * spectrum->bins[i].magnitude;
+        
+        spectrum->total_power += spectrum->bins[i].power;
+        
+        if (i > 0 && spectrum->bins[i].magnitude > max_magnitude)
+        {
+            max_magnitude = spectrum->bins[i].magnitude;
+            spectrum->dominant_frequency = frequency;
+        }
+    }
+}
+
+/// @brief Computes the spectrum of a window of the signal into given bins
+/// @param start_index Starting index
+/// @param window_size Window size
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum (bins set to the bins argument)
+/// @param bins Output bins
+/// @param max_bins Size of bins
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ComputeSpectrum(int start_index, int window_size, double sampling_rate,
+                                                FrequencySpectrum *spectrum, FrequencyBin *bins, int max_bins)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (spectrum == nullptr || bins == nullptr || start_index < 0 || window_size < 2 || sampling_rate <= 0)
+        return false;
+    
+    int end_index = start_index + window_size;
+    if (end_index > length)
+        return false;
+    
+    // transform at the window length: resolution sampling_rate / window_size
+    int fft_size = window_size;
+    int num_bins = fft_size / 2 + 1;
+    if (max_bins < num_bins)
+        return false;
+    
+    // Temporary arrays from the workspace
+    size_t mark = this->workspace->Mark();
+    Acc *real = (Acc *)this->Scratch(fft_size * sizeof(Acc));
+    Acc *imag = (Acc *)this->Scratch(num_bins * sizeof(Acc));
+    
+    if (real == nullptr || imag == nullptr)
+    {
+        this->workspace->Release(mark);
+        return false;
     }
+    
+    // Copy data
+    for (int i = 0; i < window_size; ++i)
+        real[i] = signal[start_index + i];
+    
+    // Window against spectral leakage (Hann unless set with SetSpectrumWindow())
+    ApplyWindow(real, window_size, this->spectrum_window_type, this->spectrum_window_parameter);
+    
+    // Perform FFT (real input: half-size complex transform)
+    RealFFT(real, imag, fft_size);
+    
+    // Calculate magnitudes and phases (only first half due to symmetry)
+    SignalFillSpectrum(real, imag, fft_size, sampling_rate, spectrum, bins);
+    
+    this->workspace->Release(mark);
+    
+    return true;
 }
 
-/// @brief Applies exponential smoothing to the signal vector
-/// @param alpha Smoothing factor (0 < alpha <= 1)
-/// @param out_vector Destination vector for smoothed values (size >= GetIndex())
-void SignalProcessing::ExponentialSmoothing(double alpha, double *out_vector)
+/// @brief Computes the single-precision spectrum of a window of the signal into given bins
+/// @param start_index Starting index
+/// @param window_size Window size
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectrum Output spectrum (bins set to the bins argument)
+/// @param bins Output bins
+/// @param max_bins Size of bins
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ComputeSpectrum(int start_index, int window_size, double sampling_rate,
+                                                FrequencySpectrumF *spectrum, FrequencyBinF *bins, int max_bins)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (spectrum == nullptr || bins == nullptr || start_index < 0 || window_size < 2 || sampling_rate <= 0)
+        return false;
+    
+    int end_index = start_index + window_size;
+    if (end_index > length)
+        return false;
+    
+    int fft_size = window_size;
+    int num_bins = fft_size / 2 + 1;
+    if (max_bins < num_bins)
+        return false;
+    
+    // whole window already analysed in double for this generation: no transform
+    if (start_index == 0 && window_size == length && this->owns_storage &&
+        this->IsCached(this->spectrum_generation) && this->spectrum_rate == sampling_rate)
+    {
+        SignalConvertSpectrum(&this->cached_spectrum, spectrum, bins);
+        return true;
+    }
+    
+    const FFTPlan *plan = FFTPlan::Get(fft_size, 1);
+    if (plan == nullptr)
+        return false;
+    
+    // float arrays from the workspace, whatever the buffer type
+    size_t mark = this->workspace->Mark();
+    float *real = (float *)this->Scratch(fft_size * sizeof(float));
+    float *imag = (float *)this->Scratch(num_bins * sizeof(float));
+    float *scratch = nullptr;
+    if (plan->GetScratchSize() > 0)
+        scratch = (float *)this->Scratch(plan->GetScratchSize() * sizeof(float));
+    
+    if (real == nullptr || imag == nullptr || (plan->GetScratchSize() > 0 && scratch == nullptr))
+    {
+        this->workspace->Release(mark);
+        return false;
+    }
+    
+    for (int i = 0; i < window_size; ++i)
+        real[i] = (float)signal[start_index + i];
+    
+    if (this->spectrum_window_type != SIGNAL_WINDOW_RECTANGULAR)
+    {
+        const SignalWindow *window = SignalWindow::Get(this->spectrum_window_type, window_size,
+                                                       this->spectrum_window_parameter);
+        if (window != nullptr)
+            window->Apply(real);
+    }
+    
+    plan->ExecuteReal(real, real, imag, scratch);
+    
+    SignalFillSpectrum(real, imag, fft_size, sampling_rate, spectrum, bins);
+    
+    this->workspace->Release(mark);
+    
+    return true;
+}
+
+/// @brief Finds peaks in frequency spectrum
+/// @param spectrum Frequency spectrum
+/// @param min_magnitude Minimum magnitude threshold
+/// @param peak_frequencies Output array for frequencies
+/// @param peak_magnitudes Output array for magnitudes
+/// @param max_peaks Maximum number of peaks
+/// @return Number of peaks found
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::FindFrequencyPeaks(FrequencySpectrum *spectrum, double min_magnitude,
+                                        double *peak_frequencies, double *peak_magnitudes, int max_peaks)
+{
+    if (spectrum == nullptr || peak_frequencies == nullptr || peak_magnitudes == nullptr || max_peaks < 1)
+        return 0;
+    
+    int peak_count = 0;
+    
+    // Find local maxima
+    for (int i = 1; i < spectrum->num_bins - 1 && peak_count < max_peaks; ++i)
+    {
+        if (spectrum->bins[i].magnitude > spectrum->bins[i - 1].magnitude &&
+            spectrum->bins[i].magnitude > spectrum->bins[i + 1].magnitude &&
+            spectrum->bins[i].magnitude >= min_magnitude)
+        {
+            peak_frequencies[peak_count] = spectrum->bins[i].frequency;
+            peak_magnitudes[peak_count] = spectrum->bins[i].magnitude;
+            peak_count++;
+        }
+    }
+    
+    // Sort peaks by magnitude (descending) using bubble sort
+    for (int i = 0; i < peak_count - 1; ++i)
+    {
+        for (int j = 0; j < peak_count - i - 1; ++j)
+        {
+            if (peak_magnitudes[j] < peak_magnitudes[j + 1])
+            {
+                // Swap magnitudes
+                double temp_mag = peak_magnitudes[j];
+                peak_magnitudes[j] = peak_magnitudes[j + 1];
+                peak_magnitudes[j + 1] = temp_mag;
+                
+                // Swap frequencies
+                double temp_freq = peak_frequencies[j];
+                peak_frequencies[j] = peak_frequencies[j + 1];
+                peak_frequencies[j + 1] = temp_freq;
+            }
+        }
+    }
+    
+    return peak_count;
+}
+
+/// @brief Calculates power in a frequency band
+/// @param spectrum Frequency spectrum
+/// @param freq_low Lower frequency bound
+/// @param freq_high Upper frequency bound
+/// @return Power in band
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::GetPowerInBand(FrequencySpectrum *spectrum, double freq_low, double freq_high)
+{
+    if (spectrum == nullptr || freq_low < 0 || freq_high <= freq_low)
+        return 0.0;
+    
+    double power = 0.0;
+    
+    for (int i = 0; i < spectrum->num_bins; ++i)
+    {
+        if (spectrum->bins[i].frequency >= freq_low && spectrum->bins[i].frequency <= freq_high)
+        {
+            power += spectrum->bins[i].power;
+        }
+    }
+    
+    return power;
+}
+
+/// @brief Analyzes harmonics of a fundamental frequency
+/// @param spectrum Frequency spectrum
+/// @param fundamental Fundamental frequency
+/// @param num_harmonics Number of harmonics to analyze
+/// @param harmonic_magnitudes Output array for harmonic magnitudes
+/// @return Total harmonic distortion (THD)
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::AnalyzeHarmonics(FrequencySpectrum *spectrum, double fundamental,
+                                         int num_harmonics, double *harmonic_magnitudes)
+{
+    if (spectrum == nullptr || fundamental <= 0 || num_harmonics < 1 || harmonic_magnitudes == nullptr)
+        return 0.0;
+    
+    double fundamental_magnitude = 0.0;
+    double harmonics_sum = 0.0;
+    
+    // For each harmonic
+    for (int h = 1; h <= num_harmonics; ++h)
+    {
+        double target_freq = h * fundamental;
+        double tolerance = spectrum->frequency_resolution * 2.0;
+        
+        // Find closest bin to harmonic frequency
+        double max_mag = 0.0;
+        for (int i = 0; i < spectrum->num_bins; ++i)
+        {
+            double freq_diff = spectrum->bins[i].frequency - target_freq;
+            if (freq_diff < 0) freq_diff = -freq_diff;
+            
+            if (freq_diff < tolerance && spectrum->bins[i].magnitude > max_mag)
+            {
+                max_mag = spectrum->bins[i].magnitude;
+            }
+        }
+        
+        harmonic_magnitudes[h - 1] = max_mag;
+        
+        if (h == 1)
+        {
+            fundamental_magnitude = max_mag;
+        }
+        else
+        {
+            harmonics_sum += max_mag * max_mag;
+        }
+    }
+    
+    // Calculate THD (Total Harmonic Distortion)
+    if (fundamental_magnitude > 0)
+    {
+        return sqrt(harmonics_sum) / fundamental_magnitude;
+    }
+    
+    return 0.0;
+}
+
+/// @brief Compares frequency spectra of different segments
+/// @param marker_indices Segment start indices
+/// @param num_markers Number of segments
+/// @param sampling_rate Sampling rate
+/// @param spectra Output array of spectra
+/// @return Number of spectra computed
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::CompareSegmentSpectra(int *marker_indices, int num_markers,
+                                           double sampling_rate, FrequencySpectrum *spectra)
+{
+    int length = this->WindowSize();
+    
+    if (marker_indices == nullptr || spectra == nullptr || num_markers < 1)
+        return 0;
+    
+    int count = 0;
+    
+    for (int seg = 0; seg < num_markers; ++seg)
+    {
+        int start = marker_indices[seg];
+        int end = (seg < num_markers - 1) ? marker_indices[seg + 1] : length;
+        int size = end - start;
+        
+        if (start >= 0 && end <= length && size > 4)
+        {
+            if (FFTAnalysis(start, size, sampling_rate, &spectra[count]))
+            {
+                count++;
+            }
+        }
+    }
+    
+    return count;
+}
+
+/// @brief Frees memory allocated for spectrum
+/// @param spectrum Spectrum to free
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::FreeSpectrum(FrequencySpectrum *spectrum)
+{
+    if (spectrum != nullptr && spectrum->bins != nullptr)
+    {
+        free(spectrum->bins);
+        spectrum->bins = nullptr;
+        spectrum->num_bins = 0;
+    }
+}
+
+/// @brief Frees memory allocated for a single-precision spectrum
+/// @param spectrum Spectrum to free
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::FreeSpectrum(FrequencySpectrumF *spectrum)
+{
+    if (spectrum != nullptr && spectrum->bins != nullptr)
+    {
+        free(spectrum->bins);
+        spectrum->bins = nullptr;
+        spectrum->num_bins = 0;
+    }
+}
+
+/// @brief Adds the squared magnitudes of a range of Welch segments to sum
+/// @param signal Samples
+/// @param first First segment
+/// @param count Number of segments
+/// @param step Samples between segment starts
+/// @param segment_length Samples per segment
+/// @param window Window function, segment_length values
+/// @param plan Forward plan of segment_length
+/// @param real Buffer of segment_length values
+/// @param imag Buffer of segment_length / 2 + 1 values
+/// @param scratch Scratch of plan->GetScratchSize() values
+/// @param sum segment_length / 2 + 1 sums
+template <typename T, typename Acc>
+static void WelchAccumulate(const T *signal, int first, int count, int step, int segment_length, const Acc *window,
+                            const FFTPlan *plan, Acc *real, Acc *imag, Acc *scratch, double *sum)
+{
+    int num_bins = segment_length / 2 + 1;
+    for (int s = first; s < first + count; ++s)
+    {
+        const T *segment = signal + (size_t)s * step;
+        double mean = 0.0;
+        for (int i = 0; i < segment_length; ++i)
+        {
+            mean += segment[i];
+        }
+        Acc offset = (Acc)(mean / segment_length);
+        for (int i = 0; i < segment_length; ++i)
+        {
+            real[i] = ((Acc)segment[i] - offset) * window[i];
+        }
+        plan->ExecuteReal(real, real, imag, scratch);
+        for (int k = 0; k < num_bins; ++k)
+        {
+            sum[k] += (double)real[k] * real[k] + (double)imag[k] * imag[k];
+        }
+    }
+}
+
+/// @brief Welch segments on a worker thread, with its own buffers
+/// @param signal Samples
+/// @param first First segment
+/// @param count Number of segments
+/// @param step Samples between segment starts
+/// @param segment_length Samples per segment
+/// @param window Window function
+/// @param plan Forward plan of segment_length
+/// @param sum segment_length / 2 + 1 sums
+/// @param ok Set to false if the buffers could not be allocated
+template <typename T, typename Acc>
+static void WelchWorker(const T *signal, int first, int count, int step, int segment_length, const Acc *window,
+                        const FFTPlan *plan, double *sum, bool *ok)
+{
+    Acc *real = (Acc *)malloc((segment_length + segment_length / 2 + 1 + plan->GetScratchSize()) * sizeof(Acc));
+    *ok = (real != nullptr);
+    if (real != nullptr)
+    {
+        Acc *imag = real + segment_length;
+        WelchAccumulate(signal, first, count, step, segment_length, window, plan, real, imag,
+                        imag + segment_length / 2 + 1, sum);
+        free(real);
+    }
+}
+
+/// @brief Estimates the power spectral density with Welch's method
+/// @param segment_length Samples per segment
+/// @param overlap Samples shared by consecutive segments
+/// @param window_type Window function
+/// @param sampling_rate Sampling rate in Hz
+/// @param psd Output density (allocated)
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::WelchPSD(int segment_length, int overlap, int window_type, double sampling_rate,
+                                         PowerSpectralDensity *psd)
 {
-    if (out_vector == nullptr || this->index == 0 || alpha <= 0.0 || alpha > 1.0)
-        return;
-    out_vector[0] = this->SignalVector[0];
-    for (int i = 1; i < this->index; ++i)
+    if (psd == nullptr || segment_length < 2)
+        return false;
+    
+    int num_bins = segment_length / 2 + 1;
+    double *values = (double *)malloc(num_bins * sizeof(double));
+    if (values == nullptr)
+        return false;
+    if (!WelchPSD(segment_length, overlap, window_type, sampling_rate, psd, values, num_bins))
     {
-        out_vector[i] = alpha * this->SignalVector[i] + (1.0 - alpha) * out_vector[i - 1];
+        free(values);
+        return false;
     }
+    return true;
 }
 
-/// @brief Detects threshold crossing events in the signal vector
-/// @param threshold The threshold value to detect
-/// @param direction 1 for rising edge (below->above), -1 for falling edge (above->below), 0 for both
-/// @param events Output array to store indices where crossings occur (size >= GetIndex())
-/// @return Number of threshold crossings detected
-int SignalProcessing::DetectThresholdCrossing(double threshold, int direction, int *events)
+/// @brief Estimates the power spectral density with Welch's method into a caller array
+/// @param segment_length Samples per segment
+/// @param overlap Samples shared by consecutive segments
+/// @param window_type Window function
+/// @param sampling_rate Sampling rate in Hz
+/// @param psd Output density
+/// @param values Output array
+/// @param max_bins Size of values
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::WelchPSD(int segment_length, int overlap, int window_type, double sampling_rate,
+                                         PowerSpectralDensity *psd, double *values, int max_bins)
 {
-    if (events == nullptr || this->index < 2)
-        return 0;
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
     
-    int event_count = 0;
-    this->threshold_crossing_flag = false;
+    if (psd == nullptr || values == nullptr || segment_length < 2 || overlap < 0 || overlap >= segment_length ||
+        sampling_rate <= 0 || length < segment_length)
+        return false;
     
-    for (int i = 1; i < this->index; ++i)
+    int num_bins = segment_length / 2 + 1;
+    if (max_bins < num_bins)
+        return false;
+    const FFTPlan *plan = FFTPlan::Get(segment_length, 1);
+    const SignalWindow *table = SignalWindow::Get(window_type, segment_length);
+    if (plan == nullptr || table == nullptr)
+        return false;
+    int step = segment_length - overlap;
+    int num_segments = (length - segment_length) / step + 1;
+    
+    // one plan, window table and set of buffers for all segments
+    const Acc *window = SignalWindowValues<Acc>(table);
+    size_t mark = this->workspace->Mark();
+    Acc *real = (Acc *)this->Scratch(segment_length * sizeof(Acc));
+    Acc *imag = (Acc *)this->Scratch(num_bins * sizeof(Acc));
+    Acc *scratch = nullptr;
+    if (plan->GetScratchSize() > 0)
+        scratch = (Acc *)this->Scratch(plan->GetScratchSize() * sizeof(Acc));
+    if (real == nullptr || imag == nullptr || (scratch == nullptr && plan->GetScratchSize() > 0))
     {
-        bool rising = (this->SignalVector[i - 1] < threshold) && (this->SignalVector[i] >= threshold);
-        bool falling = (this->SignalVector[i - 1] > threshold) && (this->SignalVector[i] <= threshold);
-        
-        if ((direction == 1 && rising) || (direction == -1 && falling) || (direction == 0 && (rising || falling)))
+        this->workspace->Release(mark);
+        return false;
+    }
+    // power of the coefficients actually applied (float tables are rounded)
+    double window_power = 0.0;
+    for (int i = 0; i < segment_length; ++i)
+        window_power += (double)window[i] * window[i];
+    memset(values, 0, num_bins * sizeof(double));
+    
+    // long inputs: contiguous ranges of segments on more threads, partial sums added in order
+    long long work = (long long)num_segments * segment_length / WELCH_PARALLEL_SAMPLES;
+    int num_threads = (work < WELCH_MAX_THREADS) ? (int)work : WELCH_MAX_THREADS;
+    int cores = (int)std::thread::hardware_concurrency();
+    if (num_threads > cores)
+        num_threads = cores;
+    if (num_threads > num_segments)
+        num_threads = num_segments;
+    double *partial = nullptr;
+    if (num_threads > 1)
+        partial = (double *)calloc((size_t)(num_threads - 1) * num_bins, sizeof(double));
+    if (partial == nullptr)
+        num_threads = 1;
+    
+    std::thread threads[WELCH_MAX_THREADS];
+    bool worker_ok[WELCH_MAX_THREADS];
+    int first = num_segments / num_threads + ((num_segments % num_threads > 0) ? 1 : 0);
+    for (int t = 1, start = first; t < num_threads; ++t)
+    {
+        int count = num_segments / num_threads + ((t < num_segments % num_threads) ? 1 : 0);
+        double *sum = partial + (size_t)(t - 1) * num_bins;
+        try
         {
-            events[event_count++] = i;
-            this->threshold_crossing_flag = true;
+            threads[t] = std::thread(WelchWorker<T, Acc>, signal, start, count, step, segment_length, window, plan,
+                                     sum, &worker_ok[t]);
+        }
+        catch (...)
+        {
+            WelchWorker<T, Acc>(signal, start, count, step, segment_length, window, plan, sum, &worker_ok[t]);
         }
+        start += count;
     }
+    WelchAccumulate(signal, 0, first, step, segment_length, window, plan, real, imag, scratch, values);
+    bool ok = true;
+    for (int t = 1; t < num_threads; ++t)
+    {
+        if (threads[t].joinable())
+            threads[t].join();
+        ok = ok && worker_ok[t];
+        for (int k = 0; k < num_bins; ++k)
+            values[k] += partial[(size_t)(t - 1) * num_bins + k];
+    }
+    free(partial);
+    this->workspace->Release(mark);
+    if (!ok)
+        return false;
     
-    return event_count;
-}
-
-/// @brief Detects zero-crossing events in the signal vector
-/// @param direction 1 for positive crossing (negative->positive), -1 for negative crossing (positive->negative), 0 for both
-/// @param events Output array to store indices where crossings occur (size >= GetIndex())
-/// @return Number of zero crossings detected
-int SignalProcessing::DetectZeroCrossing(int direction, int *events)
-{
-    if (events == nullptr || this->index < 2)
-        return 0;
-    
-    int event_count = 0;
-    this->zero_crossing_flag = false;
-    
-    for (int i = 1; i < this->index; ++i)
+    // average, one-sided density: bins other than DC and Nyquist carry their negative frequency
+    psd->psd = values;
+    psd->num_bins = num_bins;
+    psd->sampling_rate = sampling_rate;
+    psd->frequency_resolution = sampling_rate / segment_length;
+    psd->segment_length = segment_length;
+    psd->num_segments = num_segments;
+    psd->total_power = 0.0;
+    psd->dominant_frequency = 0.0;
+    double scale = 1.0 / (sampling_rate * window_power * num_segments);
+    double max_density = 0.0;
+    for (int k = 0; k < num_bins; ++k)
     {
-        bool positive_crossing = (this->SignalVector[i - 1] < 0.0) && (this->SignalVector[i] >= 0.0);
-        bool negative_crossing = (this->SignalVector[i - 1] > 0.0) && (this->SignalVector[i] <= 0.0);
-        
-        if ((direction == 1 && positive_crossing) || (direction == -1 && negative_crossing) || (direction == 0 && (positive_crossing || negative_crossing)))
+        bool folded = (k > 0) && (segment_length % 2 == 1 || k < num_bins - 1);
+        values[k] *= folded ? 2.0 * scale : scale;
+        psd->total_power += values[k] * psd->frequency_resolution;
+        if (k > 0 && values[k] > max_density)
         {
-            events[event_count++] = i;
-            this->zero_crossing_flag = true;
+            max_density = values[k];
+            psd->dominant_frequency = k * psd->frequency_resolution;
         }
     }
     
-    return event_count;
-}
-
-/// @brief Gets the threshold crossing flag status
-/// @return True if threshold crossing was detected
-bool SignalProcessing::GetThresholdCrossingFlag()
-{
-    return this->threshold_crossing_flag;
-}
-
-/// @brief Gets the zero crossing flag status
-/// @return True if zero crossing was detected
-bool SignalProcessing::GetZeroCrossingFlag()
-{
-    return this->zero_crossing_flag;
-}
-
-/// @brief Clears event detection flags
-void SignalProcessing::ClearEventFlags()
-{
-    this->threshold_crossing_flag = false;
-    this->zero_crossing_flag = false;
+    return true;
 }
 
-/// @fn CompareProbDistItem
-/// @brief Returns -1 if a<b ; 1 if a >b else returns 0
-/// @param const void *a
-/// @param const void *b
-/// @return int
-int CompareProbDistItem(const void *a, const void *b)
+/// @brief Frees a power spectral density
+/// @param psd Density to free
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::FreePSD(PowerSpectralDensity *psd)
 {
-	if (((prob_dist_item *)a)->value < ((prob_dist_item *)b)->value)
-		return -1;
-	else if (((prob_dist_item *)a)->value > ((prob_dist_item *)b)->value)
-		return 1;
-	else
-		return 0;
+    if (psd != nullptr && psd->psd != nullptr)
+    {
+        free(psd->psd);
+        psd->psd = nullptr;
+        psd->num_bins = 0;
+    }
 }
 
-/// @brief Detects peaks (local maxima) in the signal vector
-/// @param peaks Output array to store peak indices
-/// @param max_peaks Maximum number of peaks to detect
-/// @return Number of peaks detected
-int SignalProcessing::DetectPeaks(int *peaks, int max_peaks)
+/// @brief Calculates power in a frequency band of a power spectral density
+/// @param psd Power spectral density
+/// @param freq_low Lower bound in Hz
+/// @param freq_high Upper bound in Hz
+/// @return Band power (units^2)
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::GetPowerInBand(PowerSpectralDensity *psd, double freq_low, double freq_high)
 {
-    if (peaks == nullptr || max_peaks <= 0 || this->index < 3)
-        return 0;
-    
-    int peak_count = 0;
+    if (psd == nullptr || psd->psd == nullptr || freq_low < 0 || freq_high <= freq_low)
+        return 0.0;
     
-    // Check each point (excluding first and last)
-    for (int i = 1; i < this->index - 1 && peak_count < max_peaks; ++i)
+    double power = 0.0;
+    for (int k = 0; k < psd->num_bins; ++k)
     {
-        // A peak is a point higher than both neighbors
-        if (this->SignalVector[i] > this->SignalVector[i - 1] && 
-            this->SignalVector[i] > this->SignalVector[i + 1])
+        double frequency = k * psd->frequency_resolution;
+        if (frequency >= freq_low && frequency <= freq_high)
         {
-            peaks[peak_count++] = i;
+            power += psd->psd[k];
         }
     }
     
-    return peak_count;
+    return power * psd->frequency_resolution;
 }
 
-/// @brief Detects peaks above a threshold value
-/// @param threshold Minimum value for peak detection
-/// @param peaks Output array to store peak indices
-/// @param max_peaks Maximum number of peaks to detect
-/// @return Number of peaks detected
-int SignalProcessing::DetectPeaksWithThreshold(double threshold, int *peaks, int max_peaks)
+/// @brief Detects frequency anomalies by comparing with baseline
+/// @param current_spectrum Current spectrum
+/// @param baseline_spectrum Baseline spectrum
+/// @param threshold Threshold ratio
+/// @return Anomaly score
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::DetectFrequencyAnomalies(FrequencySpectrum *current_spectrum,
+                                                 FrequencySpectrum *baseline_spectrum,
+                                                 double threshold)
 {
-    if (peaks == nullptr || max_peaks <= 0 || this->index < 3)
-        return 0;
+    if (current_spectrum == nullptr || baseline_spectrum == nullptr)
+        return 0.0;
     
-    int peak_count = 0;
+    int min_bins = (current_spectrum->num_bins < baseline_spectrum->num_bins) ? 
+                    current_spectrum->num_bins : baseline_spectrum->num_bins;
     
-    // Check each point (excluding first and last)
-    for (int i = 1; i < this->index - 1 && peak_count < max_peaks; ++i)
+    double anomaly_score = 0.0;
+    int anomaly_count = 0;
+    
+    for (int i = 1; i < min_bins; ++i)  // Skip DC component
     {
-        // A peak must be higher than both neighbors AND above threshold
-        if (this->SignalVector[i] > this->SignalVector[i - 1] && 
-            this->SignalVector[i] > this->SignalVector[i + 1] &&
-            this->SignalVector[i] >= threshold)
+        double baseline_mag = baseline_spectrum->bins[i].magnitude;
+        double current_mag = current_spectrum->bins[i].magnitude;
+        
+        if (baseline_mag > 0)
         {
-            peaks[peak_count++] = i;
+            double ratio = current_mag / baseline_mag;
+            
+            if (ratio > threshold || ratio < (1.0 / threshold))
+            {
+                double deviation = (ratio > 1.0) ? (ratio - 1.0) : (1.0 - ratio);
+                anomaly_score += deviation;
+                anomaly_count++;
+            }
         }
     }
     
-    return peak_count;
+    // Normalize by number of bins
+    if (anomaly_count > 0)
+    {
+        anomaly_score /= anomaly_count;
+    }
+    
+    return anomaly_score;
 }
 
-/// @brief Detects peaks with minimum prominence
-/// @param min_prominence Minimum prominence (height above surrounding valleys)
-/// @param peaks Output array to store peak indices
-/// @param max_peaks Maximum number of peaks to detect
-/// @return Number of peaks detected
-int SignalProcessing::DetectPeaksWithProminence(double min_prominence, int *peaks, int max_peaks)
+/// @brief Detects frequency anomalies by comparing power spectral densities
+/// @param current_psd Current density
+/// @param baseline_psd Baseline density
+/// @param threshold Amplitude ratio threshold
+/// @return Anomaly score
+template <typename T, typename Acc>
+double SignalProcessingT<T, Acc>::DetectFrequencyAnomalies(PowerSpectralDensity *current_psd,
+                                                           PowerSpectralDensity *baseline_psd, double threshold)
 {
-    if (peaks == nullptr || max_peaks <= 0 || this->index < 3 || min_prominence < 0)
-        return 0;
+    if (current_psd == nullptr || baseline_psd == nullptr || current_psd->psd == nullptr ||
+        baseline_psd->psd == nullptr)
+        return 0.0;
     
-    int peak_count = 0;
+    int min_bins = (current_psd->num_bins < baseline_psd->num_bins) ? current_psd->num_bins : baseline_psd->num_bins;
     
-    // First detect all local maxima
-    for (int i = 1; i < this->index - 1 && peak_count < max_peaks; ++i)
+    double anomaly_score = 0.0;
+    int anomaly_count = 0;
+    
+    for (int i = 1; i < min_bins; ++i)  // Skip DC component
     {
-        if (this->SignalVector[i] > this->SignalVector[i - 1] && 
-            this->SignalVector[i] > this->SignalVector[i + 1])
+        if (baseline_psd->psd[i] > 0)
         {
-            // Calculate prominence: find minimum on both sides
-            double left_min = this->SignalVector[i];
-            double right_min = this->SignalVector[i];
-            
-            // Search left for minimum
-            for (int j = i - 1; j >= 0; --j)
-            {
-                if (this->SignalVector[j] < left_min)
-                    left_min = this->SignalVector[j];
-                // Stop at higher peak
-                if (this->SignalVector[j] > this->SignalVector[i])
-                    break;
-            }
-            
-            // Search right for minimum
-            for (int j = i + 1; j < this->index; ++j)
-            {
-                if (this->SignalVector[j] < right_min)
-                    right_min = this->SignalVector[j];
-                // Stop at higher peak
-                if (this->SignalVector[j] > this->SignalVector[i])
-                    break;
-            }
+            // amplitude ratio, comparable with the magnitude ratio of the spectrum version
+            double ratio = sqrt(current_psd->psd[i] / baseline_psd->psd[i]);
             
-            // Prominence is the minimum of the two side differences
-            double left_prominence = this->SignalVector[i] - left_min;
-            double right_prominence = this->SignalVector[i] - right_min;
-            double prominence = (left_prominence < right_prominence) ? left_prominence : right_prominence;
-            
-            if (prominence >= min_prominence)
+            if (ratio > threshold || ratio < (1.0 / threshold))
             {
-                peaks[peak_count++] = i;
+                double deviation = (ratio > 1.0) ? (ratio - 1.0) : (1.0 - ratio);
+                anomaly_score += deviation;
+                anomaly_count++;
             }
         }
     }
     
-    return peak_count;
+    if (anomaly_count > 0)
+    {
+        anomaly_score /= anomaly_count;
+    }
+    
+    return anomaly_score;
 }
 
-/// @brief Detects peaks with minimum distance between them
-/// @param min_distance Minimum distance between consecutive peaks
-/// @param peaks Output array to store peak indices
-/// @param max_peaks Maximum number of peaks to detect
-/// @return Number of peaks detected
-int SignalProcessing::DetectPeaksWithDistance(int min_distance, int *peaks, int max_peaks)
+// ========== ML/AI FEATURE EXTRACTION IMPLEMENTATION ==========
+
+/// @brief Extracts comprehensive ML feature vector from current signal
+/// @param sampling_rate Sampling rate in Hz
+/// @param features Output structure for features
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ExtractMLFeatures(double sampling_rate, MLFeatureVector *features)
 {
-    if (peaks == nullptr || max_peaks <= 0 || this->index < 3 || min_distance < 1)
-        return 0;
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
     
-    // First detect all local maxima with their values
-    int temp_peaks[NB_MAX_VALUES];
-    double peak_values[NB_MAX_VALUES];
-    int temp_count = 0;
+    if (features == nullptr || length < 10)
+    {
+        return false;
+    }
+    
+    if (this->IsCached(this->features_generation) && this->features_rate == sampling_rate)
+    {
+        *features = this->cached_features;
+        return true;
+    }
+    
+    int n = length;
+    
+    // === STATISTICAL FEATURES ===
+    features->mean = this->GetMean();
+    features->variance = this->GetVariance();
+    features->std_dev = this->GetStandardDeviation();
+    
+    // RMS (Root Mean Square)
+    double sum_squares = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        sum_squares += signal[i] * signal[i];
+    }
+    features->rms = sqrt(sum_squares / n);
+    
+    // Peak-to-peak and crest factor
+    double min_val = signal[0];
+    double max_val = signal[0];
+    for (int i = 1; i < n; i++)
+    {
+        if (signal[i] < min_val) min_val = signal[i];
+        if (signal[i] > max_val) max_val = signal[i];
+    }
+    features->peak_to_peak = max_val - min_val;
+    features->crest_factor = (features->rms > 0) ? (max_val / features->rms) : 0.0;
+    
+    // Skewness (third moment)
+    double sum_cubed = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        double deviation = signal[i] - features->mean;
+        sum_cubed += deviation * deviation * deviation;
+    }
+    features->skewness = (features->std_dev > 0) ? 
+                         (sum_cubed / n) / (features->std_dev * features->std_dev * features->std_dev) : 0.0;
+    
+    // Kurtosis (fourth moment)
+    double sum_fourth = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        double deviation = signal[i] - features->mean;
+        double dev_squared = deviation * deviation;
+        sum_fourth += dev_squared * dev_squared;
+    }
+    features->kurtosis = (features->variance > 0) ? 
+                         (sum_fourth / n) / (features->variance * features->variance) : 0.0;
+    
+    // === TIME DOMAIN FEATURES ===
+    
+    // Zero crossing rate
+    int zero_crossings = 0;
+    for (int i = 1; i < n; i++)
+    {
+        if ((signal[i-1] >= 0 && signal[i] < 0) ||
+            (signal[i-1] < 0 && signal[i] >= 0))
+        {
+            zero_crossings++;
+        }
+    }
+    features->zero_crossing_rate = (double)zero_crossings / n;
     
-    for (int i = 1; i < this->index - 1; ++i)
+    // Mean crossing rate
+    int mean_crossings = 0;
+    for (int i = 1; i < n; i++)
     {
-        if (this->SignalVector[i] > this->SignalVector[i - 1] && 
-            this->SignalVector[i] > this->SignalVector[i + 1])
+        if ((signal[i-1] >= features->mean && signal[i] < features->mean) ||
+            (signal[i-1] < features->mean && signal[i] >= features->mean))
         {
-            temp_peaks[temp_count] = i;
-            peak_values[temp_count] = this->SignalVector[i];
-            temp_count++;
+            mean_crossings++;
         }
     }
+    features->mean_crossing_rate = (double)mean_crossings / n;
     
-    if (temp_count == 0)
-        return 0;
+    // Energy
+    features->energy = sum_squares;
     
-    // Sort peaks by value (descending) to prioritize higher peaks
-    // Simple bubble sort for this implementation
-    for (int i = 0; i < temp_count - 1; ++i)
+    // Autocorrelation peak (first non-zero lag peak)
+    features->autocorr_peak = 0.0;
+    int max_lag = (n > 100) ? 100 : n / 2;
+    double max_autocorr = 0.0;
+    size_t autocorr_mark = this->workspace->Mark();
+    Acc *lag_sums = (max_lag > 1) ? (Acc *)this->Scratch(max_lag * sizeof(Acc)) : nullptr;
+    if (lag_sums == nullptr || !this->LaggedProducts(signal, n, (Acc)0, max_lag - 1, CORRELATION_AUTO, lag_sums))
     {
-        for (int j = 0; j < temp_count - i - 1; ++j)
+        max_lag = 0;
+    }
+    for (int lag = 1; lag < max_lag; lag++)
+    {
+        double autocorr = (double)lag_sums[lag] / (n - lag);
+        if (autocorr > max_autocorr)
         {
-            if (peak_values[j] < peak_values[j + 1])
-            {
-                // Swap values
-                double temp_val = peak_values[j];
-                peak_values[j] = peak_values[j + 1];
-                peak_values[j + 1] = temp_val;
-                // Swap indices
-                int temp_idx = temp_peaks[j];
-                temp_peaks[j] = temp_peaks[j + 1];
-                temp_peaks[j + 1] = temp_idx;
-            }
+            max_autocorr = autocorr;
+            features->autocorr_peak = (double)lag / sampling_rate;  // in seconds
         }
     }
+    this->workspace->Release(autocorr_mark);
     
-    // Select peaks respecting minimum distance
-    bool selected[NB_MAX_VALUES] = {false};
-    int peak_count = 0;
+    // === FREQUENCY DOMAIN FEATURES ===
     
-    for (int i = 0; i < temp_count && peak_count < max_peaks; ++i)
+    // spectrum shared with FFTAnalysis(), or bins from the workspace for views
+    FrequencySpectrum spectrum;
+    size_t mark = this->workspace->Mark();
+    bool fft_success = this->CachedSpectrum(sampling_rate, &spectrum);
+    if (!fft_success)
     {
-        bool too_close = false;
+        int max_bins = n / 2 + 1;
+        FrequencyBin *bins = (FrequencyBin *)this->Scratch(max_bins * sizeof(FrequencyBin));
+        fft_success = this->ComputeSpectrum(0, n, sampling_rate, &spectrum, bins, max_bins);
+    }
+    
+    if (fft_success)
+    {
+        features->dominant_frequency = spectrum.dominant_frequency;
+        features->total_power = spectrum.total_power;
         
-        // Check distance to all already selected peaks
-        for (int j = 0; j < temp_count; ++j)
+        // Power in frequency bands
+        features->power_low_freq = this->GetPowerInBand(&spectrum, 0.0, 10.0);
+        features->power_mid_freq = this->GetPowerInBand(&spectrum, 10.0, 100.0);
+        features->power_high_freq = this->GetPowerInBand(&spectrum, 100.0, sampling_rate / 2.0);
+        
+        // Spectral centroid (center of mass of spectrum)
+        double weighted_sum = 0.0;
+        double total_magnitude = 0.0;
+        for (int i = 0; i < spectrum.num_bins; i++)
         {
-            if (selected[j])
-            {
-                int distance = temp_peaks[i] - temp_peaks[j];
-                if (distance < 0) distance = -distance; // abs()
-                
-                if (distance < min_distance)
-                {
-                    too_close = true;
-                    break;
-                }
-            }
+            weighted_sum += spectrum.bins[i].frequency * spectrum.bins[i].magnitude;
+            total_magnitude += spectrum.bins[i].magnitude;
         }
+        features->spectral_centroid = (total_magnitude > 0) ? (weighted_sum / total_magnitude) : 0.0;
         
-        if (!too_close)
+        // Spectral spread (standard deviation around centroid)
+        double spread_sum = 0.0;
+        for (int i = 0; i < spectrum.num_bins; i++)
         {
-            selected[i] = true;
-            peaks[peak_count++] = temp_peaks[i];
+            double diff = spectrum.bins[i].frequency - features->spectral_centroid;
+            spread_sum += diff * diff * spectrum.bins[i].magnitude;
         }
-    }
-    
-    // Sort final peaks by index for easier interpretation
-    for (int i = 0; i < peak_count - 1; ++i)
-    {
-        for (int j = 0; j < peak_count - i - 1; ++j)
+        features->spectral_spread = (total_magnitude > 0) ? 
+                                    sqrt(spread_sum / total_magnitude) : 0.0;
+        
+        // Spectral entropy (measure of spectral complexity)
+        features->spectral_entropy = 0.0;
+        for (int i = 0; i < spectrum.num_bins; i++)
         {
-            if (peaks[j] > peaks[j + 1])
+            if (spectrum.bins[i].magnitude > 0)
             {
-                int temp = peaks[j];
-                peaks[j] = peaks[j + 1];
-                peaks[j + 1] = temp;
+                double normalized = spectrum.bins[i].magnitude / total_magnitude;
+                features->spectral_entropy -= normalized * log(normalized + 1e-10);
             }
         }
     }
+    else
+    {
+        // FFT failed, set frequency features to 0
+        features->dominant_frequency = 0.0;
+        features->total_power = 0.0;
+        features->power_low_freq = 0.0;
+        features->power_mid_freq = 0.0;
+        features->power_high_freq = 0.0;
+        features->spectral_centroid = 0.0;
+        features->spectral_spread = 0.0;
+        features->spectral_entropy = 0.0;
+    }
+    this->workspace->Release(mark);
     
-    return peak_count;
+    features->num_features = 21;  // Total count
+    this->cached_features = *features;
+    this->features_generation = this->generation;
+    this->features_rate = sampling_rate;
+    this->result_computations++;
+    return true;
 }
 
-/// @brief Gets the value at a specific peak index
-/// @param peak_index Index of the peak in the signal vector
-/// @return Value at the peak
-double SignalProcessing::GetPeakValue(int peak_index)
+/// @brief Extracts features from a specific segment
+/// @param start_index Starting index
+/// @param window_size Size of segment
+/// @param sampling_rate Sampling rate in Hz
+/// @param features Output structure
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ExtractMLFeaturesFromSegment(int start_index, int window_size,
+                                                    double sampling_rate, MLFeatureVector *features)
 {
-    if (peak_index < 0 || peak_index >= this->index)
-        return 0.0;
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+    
+    if (features == nullptr || start_index < 0 || window_size <= 0)
+    {
+        return false;
+    }
+    
+    if (start_index + window_size > length)
+    {
+        return false;  // Segment out of bounds
+    }
     
-    return this->SignalVector[peak_index];
+    SignalViewT<T, Acc> segment(signal + start_index, window_size);
+    segment.SetWorkspace(this->workspace);
+    return segment.ExtractMLFeatures(sampling_rate, features);
 }
 
-/// @brief Gets the signal value at a specific index
-/// @param index Index in the signal vector
-/// @return Value at the specified index
-double SignalProcessing::GetValue(int index)
+/// @brief Exports features to flat array for ML libraries
+/// @param features Feature structure
+/// @param output_array Output array (size >= 21)
+/// @return Number of features exported
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::ExportFeaturesToArray(MLFeatureVector *features, double *output_array)
 {
-    if (index < 0 || index >= this->index)
-        return 0.0;
+    if (features == nullptr || output_array == nullptr)
+    {
+        return 0;
+    }
+    
+    int idx = 0;
+    
+    // Statistical features (8)
+    output_array[idx++] = features->mean;
+    output_array[idx++] = features->std_dev;
+    output_array[idx++] = features->variance;
+    output_array[idx++] = features->skewness;
+    output_array[idx++] = features->kurtosis;
+    output_array[idx++] = features->rms;
+    output_array[idx++] = features->peak_to_peak;
+    output_array[idx++] = features->crest_factor;
+    
+    // Frequency features (9)
+    output_array[idx++] = features->dominant_frequency;
+    output_array[idx++] = features->spectral_centroid;
+    output_array[idx++] = features->spectral_spread;
+    output_array[idx++] = features->spectral_entropy;
+    output_array[idx++] = features->total_power;
+    output_array[idx++] = features->power_low_freq;
+    output_array[idx++] = features->power_mid_freq;
+    output_array[idx++] = features->power_high_freq;
+    
+    // Time domain features (4)
+    output_array[idx++] = features->zero_crossing_rate;
+    output_array[idx++] = features->mean_crossing_rate;
+    output_array[idx++] = features->energy;
+    output_array[idx++] = features->autocorr_peak;
     
-    return this->SignalVector[index];
+    return idx;  // Should be 21
 }
 
-/// @brief Gets the timestamp at a specific index
-/// @param index Index in the signal vector
-/// @return Timestamp at the specified index
-struct timespec SignalProcessing::GetTimestamp(int index)
+/// @brief Normalizes features using z-score normalization
+/// @param features Feature vector to normalize
+/// @param mean_values Mean values from training set
+/// @param std_values Std dev values from training set
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::NormalizeMLFeatures(MLFeatureVector *features, 
+                                          double *mean_values, double *std_values)
 {
-    struct timespec empty_ts = {0, 0};
+    if (features == nullptr || mean_values == nullptr || std_values == nullptr)
+    {
+        return;
+    }
+    
+    double temp_array[21];
+    SignalProcessing::ExportFeaturesToArray(features, temp_array);
+    
+    // Apply z-score normalization: (x - mean) / std
+    for (int i = 0; i < 21; i++)
+    {
+        if (std_values[i] > 0)
+        {
+            temp_array[i] = (temp_array[i] - mean_values[i]) / std_values[i];
+        }
+    }
+    
+    // Put normalized values back into structure
+    int idx = 0;
+    features->mean = temp_array[idx++];
+    features->std_dev = temp_array[idx++];
+    features->variance = temp_array[idx++];
+    features->skewness = temp_array[idx++];
+    features->kurtosis = temp_array[idx++];
+    features->rms = temp_array[idx++];
+    features->peak_to_peak = temp_array[idx++];
+    features->crest_factor = temp_array[idx++];
+    
+    features->dominant_frequency = temp_array[idx++];
+    features->spectral_centroid = temp_array[idx++];
+    features->spectral_spread = temp_array[idx++];
+    features->spectral_entropy = temp_array[idx++];
+    features->total_power = temp_array[idx++];
+    features->power_low_freq = temp_array[idx++];
+    features->power_mid_freq = temp_array[idx++];
+    features->power_high_freq = temp_array[idx++];
+    
+    features->zero_crossing_rate = temp_array[idx++];
+    features->mean_crossing_rate = temp_array[idx++];
+    features->energy = temp_array[idx++];
+    features->autocorr_peak = temp_array[idx++];
+}
+
+// ========== DOWNSTREAM ML/AI INTEGRATION IMPLEMENTATION ==========
+
+/// @brief Creates an empty ML dataset
+/// @param capacity Maximum number of samples
+/// @param with_labels Allocate memory for labels
+/// @param dataset Output dataset
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::CreateMLDataset(int capacity, bool with_labels, MLDataset *dataset)
+{
+    if (dataset == nullptr || capacity <= 0)
+    {
+        return false;
+    }
+    
+    dataset->samples = new MLFeatureVector[capacity];
+    if (dataset->samples == nullptr)
+    {
+        return false;
+    }
+    
+    if (with_labels)
+    {
+        dataset->labels = new int[capacity];
+        if (dataset->labels == nullptr)
+        {
+            delete[] dataset->samples;
+            return false;
+        }
+        dataset->has_labels = true;
+    }
+    else
+    {
+        dataset->labels = nullptr;
+        dataset->has_labels = false;
+    }
     
-    if (index < 0 || index >= this->index)
-        return empty_ts;
+    dataset->num_samples = 0;
+    dataset->capacity = capacity;
     
-    return this->signal_timestamp[index];
+    return true;
 }
 
-/// @brief Applies a simple 1D Kalman filter for signal denoising
-/// @param process_noise Process noise covariance (Q)
-/// @param measurement_noise Measurement noise covariance (R)
-/// @param out_vector Output vector for filtered values
-/// @param initial_estimate Initial state estimate
-/// @param initial_error Initial error covariance
-void SignalProcessing::KalmanFilter(double process_noise, double measurement_noise, 
-                                   double *out_vector, double initial_estimate, double initial_error)
+/// @brief Frees ML dataset memory
+/// @param dataset Dataset to free
+template <typename T, typename Acc>
+void SignalProcessingT<T, Acc>::FreeMLDataset(MLDataset *dataset)
 {
-    if (out_vector == nullptr || this->index == 0)
+    if (dataset == nullptr)
+    {
         return;
+    }
     
-    // Kalman filter state variables
-    double estimate = initial_estimate;
-    double error_covariance = initial_error;
+    if (dataset->samples != nullptr)
+    {
+        delete[] dataset->samples;
+        dataset->samples = nullptr;
+    }
     
-    for (int i = 0; i < this->index; ++i)
+    if (dataset->labels != nullptr)
     {
-        // Prediction step
-        double predicted_estimate = estimate;
-        double predicted_error = error_covariance + process_noise;
-        
-        // Update step
-        double kalman_gain = predicted_error / (predicted_error + measurement_noise);
-        estimate = predicted_estimate + kalman_gain * (this->SignalVector[i] - predicted_estimate);
-        error_covariance = (1.0 - kalman_gain) * predicted_error;
-        
-        out_vector[i] = estimate;
+        delete[] dataset->labels;
+        dataset->labels = nullptr;
     }
+    
+    dataset->num_samples = 0;
+    dataset->capacity = 0;
+    dataset->has_labels = false;
 }
 
-/// @brief Soft thresholding function for wavelet denoising
-/// @param value Input value
-/// @param threshold Threshold value
-/// @return Thresholded value
-double SignalProcessing::SoftThreshold(double value, double threshold)
-{
-    if (value > threshold)
-        return value - threshold;
-    else if (value < -threshold)
-        return value + threshold;
-    else
-        return 0.0;
-}
-
-/// @brief Partition function for quicksort
-/// @param arr Array to partition
-/// @param low Starting index
-/// @param high Ending index
-/// @return Partition index
-int SignalProcessing::PartitionDouble(double *arr, int low, int high)
+/// @brief Adds feature vector to dataset
+/// @param dataset Dataset to add to
+/// @param features Features to add
+/// @param label Optional label
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::AddFeaturesToDataset(MLDataset *dataset, MLFeatureVector *features, int label)
 {
-    double pivot = arr[high];
-    int i = low - 1;
+    if (dataset == nullptr || features == nullptr || dataset->samples == nullptr)
+    {
+        return false;
+    }
     
-    for (int j = low; j < high; ++j)
+    if (dataset->num_samples >= dataset->capacity)
     {
-        if (arr[j] <= pivot)
-        {
-            i++;
-            double temp = arr[i];
-            arr[i] = arr[j];
-            arr[j] = temp;
-        }
+        return false;  // Dataset is full
     }
     
-    double temp = arr[i + 1];
-    arr[i + 1] = arr[high];
-    arr[high] = temp;
+    // Copy feature vector
+    dataset->samples[dataset->num_samples] = *features;
     
-    return i + 1;
-}
-
-/// @brief Quicksort implementation for doubles
-/// @param arr Array to sort
-/// @param low Starting index
-/// @param high Ending index
-void SignalProcessing::QuickSortDouble(double *arr, int low, int high)
-{
-    if (low < high)
+    // Add label if present
+    if (dataset->has_labels && dataset->labels != nullptr)
     {
-        int pi = PartitionDouble(arr, low, high);
-        QuickSortDouble(arr, low, pi - 1);
-        QuickSortDouble(arr, pi + 1, high);
+        dataset->labels[dataset->num_samples] = label;
     }
+    
+    dataset->num_samples++;
+    return true;
 }
 
-/// @brief Haar wavelet transform (1D)
-/// @param data Data array
-/// @param size Size of data (must be power of 2)
-/// @param direction 1 for forward, -1 for inverse
-void SignalProcessing::HaarWaveletTransform(double *data, int size, int direction)
+/// @brief Computes training statistics from dataset
+/// @param dataset Dataset to analyze
+/// @param stats Output statistics
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ComputeTrainingStats(MLDataset *dataset, MLTrainingStats *stats)
 {
-    if (data == nullptr || size < 2)
-        return;
+    if (dataset == nullptr || stats == nullptr || dataset->num_samples == 0)
+    {
+        return false;
+    }
     
-    double temp[NB_MAX_VALUES];
+    double temp_array[21];
     
-    if (direction == 1) // Forward transform
+    // Initialize accumulators
+    for (int f = 0; f < 21; f++)
     {
-        int half = size / 2;
-        for (int i = 0; i < half; ++i)
-        {
-            temp[i] = (data[2 * i] + data[2 * i + 1]) / 1.414213562373095; // sqrt(2)
-            temp[half + i] = (data[2 * i] - data[2 * i + 1]) / 1.414213562373095;
-        }
-        for (int i = 0; i < size; ++i)
-            data[i] = temp[i];
+        stats->mean_values[f] = 0.0;
+        stats->min_values[f] = 1e100;
+        stats->max_values[f] = -1e100;
     }
-    else // Inverse transform
+    
+    // First pass: compute mean, min, max
+    for (int i = 0; i < dataset->num_samples; i++)
     {
-        int half = size / 2;
-        for (int i = 0; i < half; ++i)
+        SignalProcessing::ExportFeaturesToArray(&dataset->samples[i], temp_array);
+        
+        for (int f = 0; f < 21; f++)
         {
-            temp[2 * i] = (data[i] + data[half + i]) / 1.414213562373095;
-            temp[2 * i + 1] = (data[i] - data[half + i]) / 1.414213562373095;
+            stats->mean_values[f] += temp_array[f];
+            if (temp_array[f] < stats->min_values[f])
+            {
+                stats->min_values[f] = temp_array[f];
+            }
+            if (temp_array[f] > stats->max_values[f])
+            {
+                stats->max_values[f] = temp_array[f];
+            }
         }
-        for (int i = 0; i < size; ++i)
-            data[i] = temp[i];
     }
-}
-
-/// @brief Applies wavelet denoising using soft thresholding
-/// @param threshold Threshold value for wavelet coefficients
-/// @param out_vector Output vector for denoised values
-/// @param level Decomposition level
-void SignalProcessing::WaveletDenoise(double threshold, double *out_vector, int level)
-{
-    if (out_vector == nullptr || this->index == 0)
-        return;
-    
-    // Copy signal to output
-    for (int i = 0; i < this->index; ++i)
-        out_vector[i] = this->SignalVector[i];
     
-    // Find nearest power of 2
-    int size = this->index;
-    int transform_size = 1;
-    while (transform_size < size)
-        transform_size *= 2;
+    // Compute mean
+    for (int f = 0; f < 21; f++)
+    {
+        stats->mean_values[f] /= dataset->num_samples;
+        stats->std_values[f] = 0.0;
+    }
     
-    // Pad with zeros if needed
-    for (int i = size; i < transform_size; ++i)
-        out_vector[i] = 0.0;
+    // Second pass: compute standard deviation
+    for (int i = 0; i < dataset->num_samples; i++)
+    {
+        SignalProcessing::ExportFeaturesToArray(&dataset->samples[i], temp_array);
+        
+        for (int f = 0; f < 21; f++)
+        {
+            double diff = temp_array[f] - stats->mean_values[f];
+            stats->std_values[f] += diff * diff;
+        }
+    }
     
-    // Apply forward wavelet transform multiple times
-    int current_size = transform_size;
-    for (int l = 0; l < level && current_size >= 2; ++l)
+    // Finalize standard deviation
+    for (int f = 0; f < 21; f++)
     {
-        HaarWaveletTransform(out_vector, current_size, 1);
-        current_size /= 2;
+        stats->std_values[f] = sqrt(stats->std_values[f] / dataset->num_samples);
+        
+        // Prevent division by zero in normalization
+        if (stats->std_values[f] < 1e-10)
+        {
+            stats->std_values[f] = 1.0;
+        }
     }
     
-    // Apply soft thresholding to detail coefficients
-    // Keep approximation coefficients (first current_size elements) untouched
-    for (int i = current_size; i < transform_size; ++i)
+    stats->num_samples = dataset->num_samples;
+    return true;
+}
+
+/// @brief Normalizes all samples in dataset
+/// @param dataset Dataset to normalize
+/// @param stats Training statistics
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::NormalizeDataset(MLDataset *dataset, MLTrainingStats *stats)
+{
+    if (dataset == nullptr || stats == nullptr || dataset->num_samples == 0)
     {
-        out_vector[i] = SoftThreshold(out_vector[i], threshold);
+        return false;
     }
     
-    // Apply inverse wavelet transform
-    current_size *= 2;
-    for (int l = 0; l < level && current_size <= transform_size; ++l)
+    // Normalize each sample
+    for (int i = 0; i < dataset->num_samples; i++)
     {
-        HaarWaveletTransform(out_vector, current_size, -1);
-        current_size *= 2;
+        SignalProcessing::NormalizeMLFeatures(&dataset->samples[i], stats->mean_values, stats->std_values);
     }
     
-    // Trim to original size
-    for (int i = size; i < transform_size; ++i)
-        out_vector[i] = 0.0;
+    return true;
 }
 
-/// @brief Applies median filter for noise removal
-/// @param window_size Window size (must be odd)
-/// @param out_vector Output vector for filtered values
-void SignalProcessing::MedianFilter(int window_size, double *out_vector)
+/// @brief Exports dataset to CSV file
+/// @param dataset Dataset to export
+/// @param filename Output filename
+/// @param include_labels Include label column
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ExportDatasetToCSV(MLDataset *dataset, const char *filename, bool include_labels)
 {
-    if (out_vector == nullptr || this->index == 0 || window_size < 1)
-        return;
+    if (dataset == nullptr || filename == nullptr || dataset->num_samples == 0)
+    {
+        return false;
+    }
     
-    // Ensure odd window size
-    if (window_size % 2 == 0)
-        window_size++;
+    FILE *fp = fopen(filename, "w");
+    if (fp == nullptr)
+    {
+        return false;
+    }
     
-    int half_window = window_size / 2;
-    double window[101]; // Support up to window size 101
+    // Write header
+    fprintf(fp, "mean,std_dev,variance,skewness,kurtosis,rms,peak_to_peak,crest_factor,");
+    fprintf(fp, "dominant_freq,spectral_centroid,spectral_spread,spectral_entropy,");
+    fprintf(fp, "total_power,power_low,power_mid,power_high,");
+    fprintf(fp, "zero_crossing_rate,mean_crossing_rate,energy,autocorr_peak");
     
-    if (window_size > 101)
-        window_size = 101;
+    if (include_labels && dataset->has_labels)
+    {
+        fprintf(fp, ",label");
+    }
+    fprintf(fp, "\n");
     
-    for (int i = 0; i < this->index; ++i)
+    // Write data
+    double temp_array[21];
+    for (int i = 0; i < dataset->num_samples; i++)
     {
-        int count = 0;
+        SignalProcessing::ExportFeaturesToArray(&dataset->samples[i], temp_array);
         
-        // Collect values in window
-        for (int j = -half_window; j <= half_window; ++j)
+        for (int f = 0; f < 21; f++)
         {
-            int idx = i + j;
-            if (idx >= 0 && idx < this->index)
+            fprintf(fp, "%.6f", temp_array[f]);
+            if (f < 20)
             {
-                window[count++] = this->SignalVector[idx];
+                fprintf(fp, ",");
             }
         }
         
-        // Sort window to find median
-        if (count > 0)
-        {
-            QuickSortDouble(window, 0, count - 1);
-            
-            // Get median
-            if (count % 2 == 1)
-                out_vector[i] = window[count / 2];
-            else
-                out_vector[i] = (window[count / 2 - 1] + window[count / 2]) / 2.0;
-        }
-        else
+        if (include_labels && dataset->has_labels)
         {
-            out_vector[i] = this->SignalVector[i];
+            fprintf(fp, ",%d", dataset->labels[i]);
         }
+        fprintf(fp, "\n");
     }
+    
+    fclose(fp);
+    return true;
 }
 
-/// @brief Estimates noise level using Median Absolute Deviation (MAD)
-/// @return Estimated noise standard deviation
-double SignalProcessing::EstimateNoiseLevel()
+/// @brief Extracts features using rolling window
+/// @param window_size Size of each window
+/// @param step_size Step between windows
+/// @param sampling_rate Sampling rate in Hz
+/// @param dataset Output dataset
+/// @return Number of windows processed
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::ExtractMLFeaturesRollingWindow(int window_size, int step_size, 
+                                                     double sampling_rate, MLDataset *dataset)
 {
-    if (this->index < 2)
-        return 0.0;
+    int length = this->WindowSize();
     
-    // Calculate differences (high-pass filter approximation)
-    double differences[NB_MAX_VALUES];
-    for (int i = 0; i < this->index - 1; ++i)
+    if (dataset == nullptr || window_size <= 0 || step_size <= 0)
     {
-        differences[i] = this->SignalVector[i + 1] - this->SignalVector[i];
+        return 0;
     }
-    int diff_size = this->index - 1;
     
-    // Calculate absolute values
-    for (int i = 0; i < diff_size; ++i)
+    if (window_size > length)
     {
-        if (differences[i] < 0)
-            differences[i] = -differences[i];
+        return 0;  // Not enough data
     }
     
-    // Sort to find median
-    QuickSortDouble(differences, 0, diff_size - 1);
+    int num_windows = 0;
+    int start_idx = 0;
     
-    // Get median
-    double median;
-    if (diff_size % 2 == 1)
-        median = differences[diff_size / 2];
-    else
-        median = (differences[diff_size / 2 - 1] + differences[diff_size / 2]) / 2.0;
+    while (start_idx + window_size <= length)
+    {
+        // Check if dataset has capacity
+        if (dataset->num_samples >= dataset->capacity)
+        {
+            break;  // Dataset is full
+        }
+        
+        MLFeatureVector features;
+        bool success = this->ExtractMLFeaturesFromSegment(start_idx, window_size, 
+                                                          sampling_rate, &features);
+        
+        if (success)
+        {
+            SignalProcessing::AddFeaturesToDataset(dataset, &features, -1);
+            num_windows++;
+        }
+        
+        start_idx += step_size;
+    }
     
-    // Estimate noise sigma using MAD
-    // sigma ≈ MAD / 0.6745
-    return median / 0.6745;
+    return num_windows;
 }
 
-// ========== ANOMALY DETECTION IMPLEMENTATION ==========
-
-/// @brief Detects anomalies using Z-score method (statistical threshold)
-/// @param threshold_sigma Number of standard deviations for anomaly threshold
-/// @param anomaly_indices Output array for anomaly indices
-/// @param max_anomalies Maximum number of anomalies to detect
-/// @return Number of anomalies detected
-int SignalProcessing::DetectAnomaliesZScore(double threshold_sigma, int *anomaly_indices, int max_anomalies)
+/// @brief Batch feature extraction from multiple signals
+/// @param signals Array of signal arrays
+/// @param signal_sizes Array of signal sizes
+/// @param num_signals Number of signals
+/// @param sampling_rate Sampling rate in Hz
+/// @param dataset Output dataset
+/// @return Number of signals processed
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::BatchExtractFeatures(double **signals, int *signal_sizes, int num_signals,
+                                          double sampling_rate, MLDataset *dataset)
 {
-    if (anomaly_indices == nullptr || this->index < 3 || max_anomalies <= 0)
-        return 0;
-    
-    double mean = GetMean();
-    double std_dev = GetStandardDeviation();
-    
-    if (std_dev == 0.0)
+    if (signals == nullptr || signal_sizes == nullptr || dataset == nullptr || num_signals <= 0)
+    {
         return 0;
+    }
     
-    int anomaly_count = 0;
+    int num_processed = 0;
+    SignalWorkspace workspace;
     
-    for (int i = 0; i < this->index && anomaly_count < max_anomalies; ++i)
+    for (int s = 0; s < num_signals; s++)
     {
-        double z_score = (this->SignalVector[i] - mean) / std_dev;
+        // Check if dataset has capacity
+        if (dataset->num_samples >= dataset->capacity)
+        {
+            break;  // Dataset is full
+        }
         
-        // Check if absolute z-score exceeds threshold
-        if (z_score > threshold_sigma || z_score < -threshold_sigma)
+        // Analyze the signal in place
+        SignalView view(signals[s], signal_sizes[s]);
+        view.SetWorkspace(&workspace);
+        
+        // Extract features
+        MLFeatureVector features;
+        bool success = view.ExtractMLFeatures(sampling_rate, &features);
+        
+        if (success)
         {
-            anomaly_indices[anomaly_count++] = i;
+            SignalProcessing::AddFeaturesToDataset(dataset, &features, -1);
+            num_processed++;
         }
     }
     
-    return anomaly_count;
+    return num_processed;
 }
 
-/// @brief Detects anomalies using Interquartile Range (IQR) method
-/// @param iqr_multiplier Multiplier for IQR (1.5 for outliers, 3.0 for extreme)
-/// @param anomaly_indices Output array for anomaly indices
-/// @param max_anomalies Maximum number of anomalies to detect
-/// @return Number of anomalies detected
-int SignalProcessing::DetectAnomaliesIQR(double iqr_multiplier, int *anomaly_indices, int max_anomalies)
+// ========== HDF5 EXPORT FOR ML/AI IMPLEMENTATION ==========
+
+#ifdef USE_HDF5
+// Full HDF5 implementation when library is available
+
+/// @brief Exports ML dataset to HDF5 file
+/// @param dataset Dataset to export
+/// @param filename Output HDF5 filename
+/// @param include_labels Include labels dataset
+/// @param path HDF5 group path
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ExportDatasetToH5(MLDataset *dataset, const char *filename, 
+                                        bool include_labels, const char *path)
 {
-    if (anomaly_indices == nullptr || this->index < 4 || max_anomalies <= 0)
-        return 0;
-    
-    // Copy and sort data to find quartiles
-    double sorted[NB_MAX_VALUES];
-    for (int i = 0; i < this->index; ++i)
-        sorted[i] = this->SignalVector[i];
-    
-    QuickSortDouble(sorted, 0, this->index - 1);
-    
-    // Calculate Q1, Q3
-    int q1_pos = this->index / 4;
-    int q3_pos = (3 * this->index) / 4;
-    
-    double q1 = sorted[q1_pos];
-    double q3 = sorted[q3_pos];
-    double iqr = q3 - q1;
-    
-    // Calculate bounds
-    double lower_bound = q1 - iqr_multiplier * iqr;
-    double upper_bound = q3 + iqr_multiplier * iqr;
-    
-    int anomaly_count = 0;
+    if (dataset == nullptr || filename == nullptr || dataset->num_samples == 0)
+    {
+        return false;
+    }
     
-    for (int i = 0; i < this->index && anomaly_count < max_anomalies; ++i)
+    try
     {
-        if (this->SignalVector[i] < lower_bound || this->SignalVector[i] > upper_bound)
+        SignalRecorder recorder(filename);
+        
+        // Prepare feature names
+        const char* feature_names[21] = {
+            "mean", "std_dev", "variance", "skewness", "kurtosis", 
+            "rms", "peak_to_peak", "crest_factor",
+            "dominant_freq", "spectral_centroid", "spectral_spread", "spectral_entropy",
+            "total_power", "power_low_freq", "power_mid_freq", "power_high_freq",
+            "zero_crossing_rate", "mean_crossing_rate", "energy", "autocorr_peak"
+        };
+        
+        // Create feature matrix (21 x num_samples)
+        std::vector<std::vector<double>> feature_matrix(21);
+        for (int f = 0; f < 21; f++)
         {
-            anomaly_indices[anomaly_count++] = i;
+            feature_matrix[f].resize(dataset->num_samples);
+        }
+        
+        // Fill feature matrix
+        double temp_array[21];
+        for (int i = 0; i < dataset->num_samples; i++)
+        {
+            SignalProcessing::ExportFeaturesToArray(&dataset->samples[i], temp_array);
+            for (int f = 0; f < 21; f++)
+            {
+                feature_matrix[f][i] = temp_array[f];
+            }
+        }
+        
+        // Save each feature as a separate dataset
+        for (int f = 0; f < 21; f++)
+        {
+            recorder.addDoubleVector(path, feature_names[f], feature_matrix[f]);
+        }
+        
+        // Save labels if present
+        if (include_labels && dataset->has_labels && dataset->labels != nullptr)
+        {
+            std::vector<double> labels_double(dataset->num_samples);
+            for (int i = 0; i < dataset->num_samples; i++)
+            {
+                labels_double[i] = (double)dataset->labels[i];
+            }
+            recorder.addDoubleVector(path, "labels", labels_double);
         }
+        
+        // Add metadata
+        char metadata[256];
+        sprintf(metadata, "%d", dataset->num_samples);
+        recorder.addMetadata(path, "num_samples", metadata);
+        sprintf(metadata, "%d", 21);
+        recorder.addMetadata(path, "num_features", metadata);
+        sprintf(metadata, "%s", dataset->has_labels ? "true" : "false");
+        recorder.addMetadata(path, "has_labels", metadata);
+        
+        // Add timestamp
+        time_t now = time(nullptr);
+        char timestamp[256];
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+        recorder.addMetadata(path, "export_timestamp", timestamp);
+        
+        return true;
+    }
+    catch (...)
+    {
+        return false;
     }
-    
-    return anomaly_count;
 }
 
-/// @brief Detects anomalies using Moving Average Deviation method
-/// @param window_size Window size for moving average
-/// @param threshold_factor Multiplication factor for deviation threshold
-/// @param anomaly_indices Output array for anomaly indices
-/// @param max_anomalies Maximum number of anomalies to detect
-/// @return Number of anomalies detected
-int SignalProcessing::DetectAnomaliesMAD(int window_size, double threshold_factor, int *anomaly_indices, int max_anomalies)
+/// @brief Exports training statistics to HDF5
+/// @param stats Training statistics
+/// @param filename Output HDF5 filename
+/// @param path HDF5 group path
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ExportTrainingStatsToH5(MLTrainingStats *stats, const char *filename,
+                                              const char *path)
 {
-    if (anomaly_indices == nullptr || this->index < window_size || max_anomalies <= 0)
-        return 0;
-    
-    int anomaly_count = 0;
+    if (stats == nullptr || filename == nullptr)
+    {
+        return false;
+    }
     
-    for (int i = window_size; i < this->index && anomaly_count < max_anomalies; ++i)
+    try
     {
-        // Calculate moving average for window before current point
-        double sum = 0.0;
-        for (int j = i - window_size; j < i; ++j)
-            sum += this->SignalVector[j];
-        double moving_avg = sum / window_size;
+        SignalRecorder recorder(filename);
         
-        // Calculate standard deviation in window
-        double variance_sum = 0.0;
-        for (int j = i - window_size; j < i; ++j)
-        {
-            double diff = this->SignalVector[j] - moving_avg;
-            variance_sum += diff * diff;
-        }
-        double std_dev = sqrt(variance_sum / window_size);
+        // Convert arrays to vectors
+        std::vector<double> mean_vec(stats->mean_values, stats->mean_values + 21);
+        std::vector<double> std_vec(stats->std_values, stats->std_values + 21);
+        std::vector<double> min_vec(stats->min_values, stats->min_values + 21);
+        std::vector<double> max_vec(stats->max_values, stats->max_values + 21);
+        
+        // Save statistics
+        recorder.addDoubleVector(path, "mean_values", mean_vec);
+        recorder.addDoubleVector(path, "std_values", std_vec);
+        recorder.addDoubleVector(path, "min_values", min_vec);
+        recorder.addDoubleVector(path, "max_values", max_vec);
         
-        // Check if current point deviates significantly
-        double deviation = this->SignalVector[i] - moving_avg;
-        if (deviation < 0) deviation = -deviation;
+        // Add metadata
+        char metadata[256];
+        sprintf(metadata, "%d", stats->num_samples);
+        recorder.addMetadata(path, "num_training_samples", metadata);
+        sprintf(metadata, "%d", 21);
+        recorder.addMetadata(path, "num_features", metadata);
         
-        if (std_dev > 0 && deviation > threshold_factor * std_dev)
-        {
-            anomaly_indices[anomaly_count++] = i;
-        }
+        // Add timestamp
+        time_t now = time(nullptr);
+        char timestamp[256];
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+        recorder.addMetadata(path, "creation_timestamp", timestamp);
+        
+        return true;
     }
-    
-    return anomaly_count;
-}
-
-/// @brief Detects sudden changes/spikes in signal (rate of change anomaly)
-/// @param threshold_change Minimum rate of change to be considered anomalous
-/// @param anomaly_indices Output array for anomaly indices
-/// @param max_anomalies Maximum number of anomalies to detect
-/// @return Number of anomalies detected
-int SignalProcessing::DetectSuddenChanges(double threshold_change, int *anomaly_indices, int max_anomalies)
-{
-    if (anomaly_indices == nullptr || this->index < 2 || max_anomalies <= 0)
-        return 0;
-    
-    int anomaly_count = 0;
-    
-    for (int i = 1; i < this->index && anomaly_count < max_anomalies; ++i)
+    catch (...)
     {
-        double change = this->SignalVector[i] - this->SignalVector[i - 1];
-        if (change < 0) change = -change;
-        
-        if (change >= threshold_change)
-        {
-            anomaly_indices[anomaly_count++] = i;
-        }
+        return false;
     }
-    
-    return anomaly_count;
 }
 
-/// @brief Segments signal by markers and calculates statistics for each segment
-/// @param marker_indices Array of indices where each segment starts
-/// @param num_markers Number of markers
-/// @param segment_stats Output array for segment statistics
-/// @return Number of segments analyzed
-int SignalProcessing::SegmentByMarkers(int *marker_indices, int num_markers, SegmentStats *segment_stats)
+/// @brief Exports feature vector and optionally raw signal to HDF5
+/// @param filename Output HDF5 filename
+/// @param features Feature vector to export
+/// @param path HDF5 group path
+/// @param save_raw_signal If true, also saves raw signal
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ExportMLFeaturesToH5(const char *filename, MLFeatureVector *features,
+                                           const char *path, bool save_raw_signal)
 {
-    if (marker_indices == nullptr || segment_stats == nullptr || num_markers < 1)
-        return 0;
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
     
-    int segment_count = 0;
+    if (filename == nullptr || features == nullptr)
+    {
+        return false;
+    }
     
-    for (int seg = 0; seg < num_markers; ++seg)
+    try
     {
-        int start = marker_indices[seg];
-        int end = (seg < num_markers - 1) ? marker_indices[seg + 1] - 1 : this->index - 1;
+        SignalRecorder recorder(filename);
         
-        if (start >= this->index || start < 0 || end >= this->index || start > end)
-            continue;
+        // Export features to array
+        double feature_array[21];
+        SignalProcessing::ExportFeaturesToArray(features, feature_array);
         
-        // Calculate statistics for this segment
-        segment_stats[segment_count].start_index = start;
-        segment_stats[segment_count].end_index = end;
-        segment_stats[segment_count].segment_id = seg;
-        segment_stats[segment_count].num_points = end - start + 1;
+        // Create feature vector
+        std::vector<double> feature_vec(feature_array, feature_array + 21);
         
-        // Calculate mean
-        double sum = 0.0;
-        double max_val = this->SignalVector[start];
-        double min_val = this->SignalVector[start];
+        // Save features
+        recorder.addDoubleVector(path, "features", feature_vec);
         
-        for (int i = start; i <= end; ++i)
+        // Save raw signal if requested
+        if (save_raw_signal && length > 0)
         {
-            sum += this->SignalVector[i];
-            if (this->SignalVector[i] > max_val) max_val = this->SignalVector[i];
-            if (this->SignalVector[i] < min_val) min_val = this->SignalVector[i];
+            std::vector<double> signal_vec(signal, signal + length);
+            recorder.addDoubleVector(path, "raw_signal", signal_vec, "signal_units");
+            
+            char metadata[256];
+            sprintf(metadata, "%d", length);
+            recorder.addMetadata(path, "num_samples", metadata);
         }
         
-        segment_stats[segment_count].mean = sum / segment_stats[segment_count].num_points;
-        segment_stats[segment_count].max_value = max_val;
-        segment_stats[segment_count].min_value = min_val;
-        segment_stats[segment_count].peak_to_peak = max_val - min_val;
-        
-        // Calculate standard deviation and RMS
-        double variance_sum = 0.0;
-        double rms_sum = 0.0;
+        // Add feature names as metadata
+        const char* feature_names[21] = {
+            "mean", "std_dev", "variance", "skewness", "kurtosis", 
+            "rms", "peak_to_peak", "crest_factor",
+            "dominant_freq", "spectral_centroid", "spectral_spread", "spectral_entropy",
+            "total_power", "power_low_freq", "power_mid_freq", "power_high_freq",
+            "zero_crossing_rate", "mean_crossing_rate", "energy", "autocorr_peak"
+        };
         
-        for (int i = start; i <= end; ++i)
+        // Save feature names as individual metadata entries
+        for (int i = 0; i < 21; i++)
         {
-            double diff = this->SignalVector[i] - segment_stats[segment_count].mean;
-            variance_sum += diff * diff;
-            rms_sum += this->SignalVector[i] * this->SignalVector[i];
+            char key[64];
+            sprintf(key, "feature_%d_name", i);
+            recorder.addMetadata(path, key, feature_names[i]);
         }
         
-        segment_stats[segment_count].std_dev = sqrt(variance_sum / segment_stats[segment_count].num_points);
-        segment_stats[segment_count].rms = sqrt(rms_sum / segment_stats[segment_count].num_points);
-        
-        // Initial anomaly score based on deviation from global mean
-        double global_mean = GetMean();
-        segment_stats[segment_count].anomaly_score = segment_stats[segment_count].mean - global_mean;
-        if (segment_stats[segment_count].anomaly_score < 0)
-            segment_stats[segment_count].anomaly_score = -segment_stats[segment_count].anomaly_score;
+        // Add timestamp
+        time_t now = time(nullptr);
+        char timestamp[256];
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+        recorder.addMetadata(path, "export_timestamp", timestamp);
         
-        segment_count++;
+        return true;
+    }
+    catch (...)
+    {
+        return false;
     }
-    
-    return segment_count;
 }
 
-/// @brief Finds the segment with highest anomaly score
-/// @param marker_indices Array of indices where each segment starts
-/// @param num_markers Number of markers
-/// @param anomaly_method Method: 0=ZScore, 1=IQR, 2=MAD, 3=MaxValue
-/// @return Index of most anomalous segment
-int SignalProcessing::FindMostAnomalousSegment(int *marker_indices, int num_markers, int anomaly_method)
+#else // USE_HDF5 not defined - provide stub implementations
+
+/// @brief Stub implementation when HDF5 is not available
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ExportDatasetToH5(MLDataset *dataset, const char *filename, 
+                                        bool include_labels, const char *path)
 {
-    if (marker_indices == nullptr || num_markers < 1)
-        return -1;
-    
-    SegmentStats segment_stats[100];
-    int num_segments = SegmentByMarkers(marker_indices, num_markers, segment_stats);
-    
-    if (num_segments == 0)
-        return -1;
+    (void)dataset; (void)filename; (void)include_labels; (void)path;
+    // HDF5 support not compiled in - define USE_HDF5 and link with HDF5 library
+    return false;
+}
+
+/// @brief Stub implementation when HDF5 is not available
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ExportTrainingStatsToH5(MLTrainingStats *stats, const char *filename,
+                                              const char *path)
+{
+    (void)stats; (void)filename; (void)path;
+    // HDF5 support not compiled in - define USE_HDF5 and link with HDF5 library
+    return false;
+}
+
+/// @brief Stub  implementation when HDF5 is not available
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::ExportMLFeaturesToH5(const char *filename, MLFeatureVector *features,
+                                           const char *path, bool save_raw_signal)
+{
+    (void)filename; (void)features; (void)path; (void)save_raw_signal;
+    // HDF5 support not compiled in - define USE_HDF5 and link with HDF5 library
+    return false;
+}
+
+#endif // USE_HDF5
+
+// ========== DECIMATION AND INTERPOLATION IMPLEMENTATION ==========
+
+/// @brief Decimates signal by factor (downsampling)
+/// @param factor Decimation factor
+/// @param out_vector Output array
+/// @param apply_antialiasing Apply low-pass filter before decimation
+/// @return Number of output samples
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::Decimate(int factor, Acc *out_vector, bool apply_antialiasing)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
     
-    int most_anomalous = 0;
-    double max_score = 0.0;
+    if (out_vector == nullptr || factor < 1 || length < factor)
+    {
+        return 0;
+    }
     
-    // Calculate global statistics for comparison
-    double global_mean = GetMean();
-    double global_std = GetStandardDeviation();
+    Acc *filtered = nullptr;
+    size_t mark = this->workspace->Mark();
     
-    for (int i = 0; i < num_segments; ++i)
+    // Apply anti-aliasing filter if requested
+    if (apply_antialiasing && factor > 1)
     {
-        double score = 0.0;
-        
-        switch (anomaly_method)
+        // Use moving average as low-pass filter
+        // Window size = factor to prevent aliasing
+        int window = factor;
+        filtered = (Acc *)this->Scratch(length * sizeof(Acc));
+        if (filtered == nullptr)
         {
-            case 0: // Z-Score based on mean deviation
-                if (global_std > 0)
-                {
-                    score = (segment_stats[i].mean - global_mean) / global_std;
-                    if (score < 0) score = -score;
-                }
-                break;
-                
-            case 1: // Based on standard deviation (variability)
-                score = segment_stats[i].std_dev;
-                break;
-                
-            case 2: // Based on RMS
-                score = segment_stats[i].rms;
-                break;
-                
-            case 3: // Based on max value
-                score = segment_stats[i].max_value;
-                if (score < 0) score = -score;
-                break;
-                
-            default:
-                score = segment_stats[i].anomaly_score;
-                break;
+            this->workspace->Release(mark);
+            return 0;
         }
-        
-        segment_stats[i].anomaly_score = score;
-        
-        if (score > max_score)
+        for (int i = 0; i < length; i++)
         {
-            max_score = score;
-            most_anomalous = i;
+            Acc sum = 0;
+            int count = 0;
+            int start = (i - window/2 < 0) ? 0 : i - window/2;
+            int end = (i + window/2 >= length) ? length - 1 : i + window/2;
+            
+            for (int j = start; j <= end; j++)
+            {
+                sum += signal[j];
+                count++;
+            }
+            filtered[i] = sum / count;
         }
     }
     
-    return most_anomalous;
+    // Decimate by keeping every Nth sample
+    int out_index = 0;
+    for (int i = 0; i < length; i += factor)
+    {
+        out_vector[out_index++] = (filtered != nullptr) ? filtered[i] : (Acc)signal[i];
+    }
+    
+    this->workspace->Release(mark);
+    return out_index;
 }
 
-/// @brief Detects anomalies in periodic signals
-/// @param period Expected period length
-/// @param tolerance Tolerance for period variations (0.0 to 1.0)
-/// @param anomaly_indices Output array for anomaly indices
-/// @param max_anomalies Maximum number of anomalies to detect
-/// @return Number of anomalies detected
-int SignalProcessing::DetectPeriodicAnomalies(int period, double tolerance, int *anomaly_indices, int max_anomalies)
-{
-    if (anomaly_indices == nullptr || this->index < period * 2 || max_anomalies <= 0)
-        return 0;
-    
-    int anomaly_count = 0;
-    int num_cycles = this->index / period;
-    
-    // Calculate average pattern for one period
-    double avg_pattern[NB_MAX_VALUES];
-    for (int i = 0; i < period; ++i)
-        avg_pattern[i] = 0.0;
+/// @brief Interpolates signal using linear interpolation
+/// @param factor Interpolation factor
+/// @param out_vector Output array
+/// @return Number of output samples
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::InterpolateLinear(int factor, Acc *out_vector)
+{
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
     
-    for (int cycle = 0; cycle < num_cycles; ++cycle)
+    if (out_vector == nullptr || factor < 1 || length < 2)
     {
-        for (int i = 0; i < period; ++i)
-        {
-            int idx = cycle * period + i;
-            if (idx < this->index)
-                avg_pattern[i] += this->SignalVector[idx];
-        }
+        return 0;
     }
     
-    for (int i = 0; i < period; ++i)
-        avg_pattern[i] /= num_cycles;
-    
-    // Calculate standard deviation for each position in period
-    double std_pattern[NB_MAX_VALUES];
-    for (int i = 0; i < period; ++i)
+    if (factor == 1)
     {
-        double variance = 0.0;
-        for (int cycle = 0; cycle < num_cycles; ++cycle)
+        // No interpolation needed
+        for (int i = 0; i < length; i++)
         {
-            int idx = cycle * period + i;
-            if (idx < this->index)
-            {
-                double diff = this->SignalVector[idx] - avg_pattern[i];
-                variance += diff * diff;
-            }
+            out_vector[i] = signal[i];
         }
-        std_pattern[i] = sqrt(variance / num_cycles);
+        return length;
     }
     
-    // Detect deviations
-    for (int i = 0; i < this->index && anomaly_count < max_anomalies; ++i)
+    int out_index = 0;
+    
+    // Interpolate between each pair of samples
+    for (int i = 0; i < length - 1; i++)
     {
-        int pattern_pos = i % period;
-        double expected = avg_pattern[pattern_pos];
-        double std_dev = std_pattern[pattern_pos];
+        Acc y0 = signal[i];
+        Acc y1 = signal[i + 1];
         
-        if (std_dev > 0)
+        // Insert original sample
+        out_vector[out_index++] = y0;
+        
+        // Insert interpolated samples
+        for (int j = 1; j < factor; j++)
         {
-            double deviation = this->SignalVector[i] - expected;
-            if (deviation < 0) deviation = -deviation;
-            
-            if (deviation > tolerance * std_dev)
-            {
-                anomaly_indices[anomaly_count++] = i;
-            }
+            Acc t = (Acc)j / factor;  // 0 < t < 1
+            out_vector[out_index++] = y0 + t * (y1 - y0);  // Linear interpolation
         }
     }
     
-    return anomaly_count;
+    // Add last sample
+    out_vector[out_index++] = signal[length - 1];
+    
+    return out_index;
 }
 
-/// @brief Calculates overall anomaly score for the signal
-/// @param method Method: 0=ZScore, 1=IQR, 2=MaxDeviation
-/// @return Anomaly score
-double SignalProcessing::CalculateAnomalyScore(int method)
+/// @brief Resamples signal to new sampling rate
+/// @param current_rate Current sampling rate in Hz
+/// @param target_rate Target sampling rate in Hz
+/// @param out_vector Output array
+/// @return Number of output samples
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::Resample(double current_rate, double target_rate, Acc *out_vector)
 {
-    if (this->index < 2)
-        return 0.0;
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
     
-    double score = 0.0;
+    if (out_vector == nullptr || current_rate <= 0 || target_rate <= 0)
+    {
+        return 0;
+    }
     
-    switch (method)
+    double ratio = target_rate / current_rate;
+    
+    if (ratio == 1.0)
     {
-        case 0: // Based on max Z-score
-        {
-            double mean = GetMean();
-            double std_dev = GetStandardDeviation();
-            if (std_dev > 0)
-            {
-                double max_zscore = 0.0;
-                for (int i = 0; i < this->index; ++i)
-                {
-                    double z = (this->SignalVector[i] - mean) / std_dev;
-                    if (z < 0) z = -z;
-                    if (z > max_zscore) max_zscore = z;
-                }
-                score = max_zscore;
-            }
-            break;
-        }
-        
-        case 1: // Based on IQR ratio
-        {
-            double sorted[NB_MAX_VALUES];
-            for (int i = 0; i < this->index; ++i)
-                sorted[i] = this->SignalVector[i];
-            
-            QuickSortDouble(sorted, 0, this->index - 1);
-            
-            int q1_pos = this->index / 4;
-            int q3_pos = (3 * this->index) / 4;
-            double iqr = sorted[q3_pos] - sorted[q1_pos];
-            double range = sorted[this->index - 1] - sorted[0];
-            
-            if (iqr > 0)
-                score = range / iqr;
-            break;
-        }
-        
-        case 2: // Based on max deviation from mean
+        // No resampling needed
+        for (int i = 0; i < length; i++)
         {
-            double mean = GetMean();
-            double max_dev = 0.0;
-            for (int i = 0; i < this->index; ++i)
-            {
-                double dev = this->SignalVector[i] - mean;
-                if (dev < 0) dev = -dev;
-                if (dev > max_dev) max_dev = dev;
-            }
-            score = max_dev;
-            break;
+            out_vector[i] = signal[i];
         }
-        
-        default:
-            score = GetStandardDeviation();
-            break;
+        return length;
+    }
+    else if (ratio < 1.0)
+    {
+        // Downsampling - use decimation
+        int factor = (int)(1.0 / ratio + 0.5);  // Round to nearest integer
+        return this->Decimate(factor, out_vector, true);
+    }
+    else
+    {
+        // Upsampling - use interpolation
+        int factor = (int)(ratio + 0.5);  // Round to nearest integer
+        return this->InterpolateLinear(factor, out_vector);
     }
-    
-    return score;
 }
 
-// ========== FREQUENCY ANALYSIS IMPLEMENTATION ==========
+// ========== CORRELATION ANALYSIS IMPLEMENTATION ==========
 
-/// @brief Finds next power of 2 greater than or equal to n
-/// @param n Input number
-/// @return Next power of 2
-int SignalProcessing::NextPowerOfTwo(int n)
+/// @brief Chooses the cheaper method for the correlation sums of lags 0 to max_lag
+/// @param length Number of samples
+/// @param max_lag Largest lag
+/// @return CORRELATION_DIRECT or CORRELATION_FFT
+int SignalCorrelationMethod(int length, int max_lag)
 {
-    int power = 1;
-    while (power < n)
-        power *= 2;
-    return power;
+    if (length < 2 || max_lag < 1)
+    {
+        return CORRELATION_DIRECT;
+    }
+    if (max_lag >= length)
+    {
+        max_lag = length - 1;
+    }
+    double direct = (max_lag + 1.0) * (length - max_lag / 2.0);
+    double size = SignalCorrelationLength(length, max_lag);
+    double fft = CORRELATION_FFT_COST * size * log2(size);
+    return (fft < direct) ? CORRELATION_FFT : CORRELATION_DIRECT;
 }
 
-/// @brief Applies window function to data
-/// @param data Data array
-/// @param size Size of data
-/// @param window_type 0=Rectangular, 1=Hann, 2=Hamming, 3=Blackman
-void SignalProcessing::ApplyWindow(double *data, int size, int window_type)
+/// @brief Chooses the cheaper method for the cross-correlation sums of lags -max_lag to max_lag
+/// @param length Number of samples of the first signal
+/// @param length2 Number of samples of the second signal
+/// @param max_lag Largest lag in both directions
+/// @return CORRELATION_DIRECT or CORRELATION_FFT
+int SignalCorrelationMethod(int length, int length2, int max_lag)
 {
-    if (data == nullptr || size < 1)
-        return;
-    
-    for (int i = 0; i < size; ++i)
+    if (length < 1 || length2 < 1 || max_lag < 1)
     {
-        double w = 1.0;
-        
-        switch (window_type)
-        {
-            case 1: // Hann window
-                w = 0.5 * (1.0 - cos(2.0 * M_PI * i / (size - 1)));
-                break;
-                
-            case 2: // Hamming window
-                w = 0.54 - 0.46 * cos(2.0 * M_PI * i / (size - 1));
-                break;
-                
-            case 3: // Blackman window
-                w = 0.42 - 0.5 * cos(2.0 * M_PI * i / (size - 1)) + 
-                    0.08 * cos(4.0 * M_PI * i / (size - 1));
-                break;
-                
-            default: // Rectangular (no window)
-                w = 1.0;
-                break;
-        }
-        
-        data[i] *= w;
+        return CORRELATION_DIRECT;
     }
+    // lags without overlapping pairs cost nothing either way
+    int low = (max_lag < length - 1) ? -max_lag : -(length - 1);
+    int high = (max_lag < length2 - 1) ? max_lag : length2 - 1;
+    double direct = 0.0;
+    for (int lag = low; lag <= high; lag++)
+    {
+        int first = (lag < 0) ? -lag : 0;
+        int last = (length < length2 - lag) ? length : length2 - lag;
+        direct += last - first;
+    }
+    int longest = (length > length2) ? length : length2;
+    double size = SignalCorrelationLength(longest, (-low > high) ? -low : high);
+    double fft = 2.0 * CORRELATION_FFT_COST * size * log2(size);
+    return (fft < direct) ? CORRELATION_FFT : CORRELATION_DIRECT;
 }
 
-/// @brief Cooley-Tukey FFT algorithm
-/// @param real Real part of signal
-/// @param imag Imaginary part of signal
-/// @param size Size (must be power of 2)
-/// @param direction 1 for forward, -1 for inverse
-void SignalProcessing::FFT(double *real, double *imag, int size, int direction)
+/// @brief Sums of lagged products: sums[k] = sum of (x[i] - offset) (x[i + k] - offset), k = 0 to max_lag
+/// @param signal Samples
+/// @param length Number of samples
+/// @param offset Value subtracted from every sample (the mean, or 0)
+/// @param max_lag Largest lag (< length)
+/// @param method CORRELATION_AUTO, CORRELATION_DIRECT or CORRELATION_FFT
+/// @param sums Output, max_lag + 1 values
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::LaggedProducts(const T *signal, int length, Acc offset, int max_lag, int method,
+                                               Acc *sums)
 {
-    if (size < 2 || real == nullptr || imag == nullptr)
-        return;
-    
-    // Bit-reversal permutation
-    int j = 0;
-    for (int i = 0; i < size - 1; ++i)
+    if (method == CORRELATION_AUTO)
     {
-        if (i < j)
-        {
-            double temp = real[i];
-            real[i] = real[j];
-            real[j] = temp;
-            
-            temp = imag[i];
-            imag[i] = imag[j];
-            imag[j] = temp;
-        }
-        
-        int k = size / 2;
-        while (k <= j)
-        {
-            j -= k;
-            k /= 2;
-        }
-        j += k;
+        method = SignalCorrelationMethod(length, max_lag);
     }
-    
-    // FFT computation
-    for (int step = 2; step <= size; step *= 2)
+    if (method != CORRELATION_FFT)
     {
-        double theta = direction * 2.0 * M_PI / step;
-        double w_real = cos(theta);
-        double w_imag = sin(theta);
-        
-        for (int start = 0; start < size; start += step)
+        for (int lag = 0; lag <= max_lag; lag++)
         {
-            double wr = 1.0;
-            double wi = 0.0;
-            
-            int half_step = step / 2;
-            for (int k = 0; k < half_step; ++k)
+            Acc sum = 0;
+            int count = length - lag;
+            for (int i = 0; i < count; i++)
             {
-                int idx1 = start + k;
-                int idx2 = idx1 + half_step;
-                
-                double tr = wr * real[idx2] - wi * imag[idx2];
-                double ti = wr * imag[idx2] + wi * real[idx2];
-                
-                real[idx2] = real[idx1] - tr;
-                imag[idx2] = imag[idx1] - ti;
-                real[idx1] += tr;
-                imag[idx1] += ti;
-                
-                double wr_temp = wr * w_real - wi * w_imag;
-                wi = wr * w_imag + wi * w_real;
-                wr = wr_temp;
+                sum += (signal[i] - offset) * (signal[i + lag] - offset);
             }
+            sums[lag] = sum;
         }
+        return true;
     }
-    
-    // Normalize for inverse FFT
-    if (direction == -1)
-    {
-        for (int i = 0; i < size; ++i)
-        {
-            real[i] /= size;
-            imag[i] /= size;
-        }
-    }
-}
 
-/// @brief Performs FFT analysis on a window of the signal
-/// @param start_index Starting index
-/// @param window_size Window size
-/// @param sampling_rate Sampling rate in Hz
-/// @param spectrum Output spectrum
-/// @return true if successful
-bool SignalProcessing::FFTAnalysis(int start_index, int window_size, double sampling_rate, FrequencySpectrum *spectrum)
-{
-    if (spectrum == nullptr || start_index < 0 || window_size < 2 || sampling_rate <= 0)
-        return false;
-    
-    int end_index = start_index + window_size;
-    if (end_index > this->index)
+    // Wiener-Khinchin: zero-padded to length + max_lag, lags up to max_lag do not wrap
+    int size = SignalCorrelationLength(length, max_lag);
+    const FFTPlan *plan = FFTPlan::Get(size, 1);
+    if (plan == nullptr)
+    {
         return false;
-    
-    // Round to nearest power of 2
-    int fft_size = NextPowerOfTwo(window_size);
-    
-    // Allocate temporary arrays
-    double *real = (double *)malloc(fft_size * sizeof(double));
-    double *imag = (double *)malloc(fft_size * sizeof(double));
-    
-    if (real == nullptr || imag == nullptr)
+    }
+    size_t mark = this->workspace->Mark();
+    Acc *buffer = (Acc *)this->Scratch(size * sizeof(Acc));
+    Acc *imag = (Acc *)this->Scratch((size / 2 + 1) * sizeof(Acc));
+    if (buffer == nullptr || imag == nullptr)
     {
-        if (real) free(real);
-        if (imag) free(imag);
+        this->workspace->Release(mark);
         return false;
     }
-    
-    // Copy data and zero-pad if necessary
-    for (int i = 0; i < fft_size; ++i)
+    for (int i = 0; i < length; i++)
     {
-        if (i < window_size)
-        {
-            real[i] = this->SignalVector[start_index + i];
-        }
-        else
-        {
-            real[i] = 0.0;
-        }
-        imag[i] = 0.0;
+        buffer[i] = signal[i] - offset;
     }
-    
-    // Apply Hann window to reduce spectral leakage
-    ApplyWindow(real, window_size, 1);
-    
-    // Perform FFT
-    FFT(real, imag, fft_size, 1);
-    
-    // Calculate magnitudes and phases (only first half due to symmetry)
-    int num_bins = fft_size / 2 + 1;
-    spectrum->bins = (FrequencyBin *)malloc(num_bins * sizeof(FrequencyBin));
-    
-    if (spectrum->bins == nullptr)
+    memset(buffer + length, 0, (size - length) * sizeof(Acc));
+    plan->ExecuteReal(buffer, buffer, imag);
+
+    // |X|^2 is real and even: its forward transform is size times the inverse one
+    int half = size / 2;
+    for (int k = 0; k <= half; k++)
     {
-        free(real);
-        free(imag);
-        return false;
+        buffer[k] = buffer[k] * buffer[k] + imag[k] * imag[k];
     }
-    
-    spectrum->num_bins = num_bins;
-    spectrum->sampling_rate = sampling_rate;
-    spectrum->frequency_resolution = sampling_rate / fft_size;
-    spectrum->window_size = window_size;
-    spectrum->total_power = 0.0;
-    spectrum->dominant_frequency = 0.0;
-    
-    double max_magnitude = 0.0;
-    
-    for (int i = 0; i < num_bins; ++i)
+    for (int k = 1; k < half; k++)
     {
-        spectrum->bins[i].frequency = i * spectrum->frequency_resolution;
-        spectrum->bins[i].magnitude = sqrt(real[i] * real[i] + imag[i] * imag[i]);
-        spectrum->bins[i].phase = atan2(imag[i], real[i]);
-        spectrum->bins[i].power = spectrum->bins[i].magnitude * spectrum->bins[i].magnitude;
-        
-        spectrum->total_power += spectrum->bins[i].power;
-        
-        if (i > 0 && spectrum->bins[i].magnitude > max_magnitude)
-        {
-            max_magnitude = spectrum->bins[i].magnitude;
-            spectrum->dominant_frequency = spectrum->bins[i].frequency;
-        }
+        buffer[size - k] = buffer[k];
     }
-    
-    free(real);
-    free(imag);
-    
+    plan->ExecuteReal(buffer, buffer, imag);
+    Acc scale = (Acc)1 / size;
+    for (int lag = 0; lag <= max_lag; lag++)
+    {
+        sums[lag] = buffer[lag] * scale;
+    }
+    this->workspace->Release(mark);
     return true;
 }
 
-/// @brief Performs FFT analysis on entire signal
-/// @param sampling_rate Sampling rate in Hz
-/// @param spectrum Output spectrum
-/// @return true if successful
-bool SignalProcessing::FFTAnalysis(double sampling_rate, FrequencySpectrum *spectrum)
-{
-    return FFTAnalysis(0, this->index, sampling_rate, spectrum);
-}
-
-/// @brief Finds peaks in frequency spectrum
-/// @param spectrum Frequency spectrum
-/// @param min_magnitude Minimum magnitude threshold
-/// @param peak_frequencies Output array for frequencies
-/// @param peak_magnitudes Output array for magnitudes
-/// @param max_peaks Maximum number of peaks
-/// @return Number of peaks found
-int SignalProcessing::FindFrequencyPeaks(FrequencySpectrum *spectrum, double min_magnitude,
-                                        double *peak_frequencies, double *peak_magnitudes, int max_peaks)
+/// @brief Computes autocorrelation of signal
+/// @param max_lag Maximum lag to compute
+/// @param out_correlation Output correlation array
+/// @param normalize Normalize to [-1, 1]
+/// @param method CORRELATION_AUTO, CORRELATION_DIRECT or CORRELATION_FFT
+/// @return Number of correlation values
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::Autocorrelation(int max_lag, Acc *out_correlation, bool normalize, int method)
 {
-    if (spectrum == nullptr || peak_frequencies == nullptr || peak_magnitudes == nullptr || max_peaks < 1)
-        return 0;
-    
-    int peak_count = 0;
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
     
-    // Find local maxima
-    for (int i = 1; i < spectrum->num_bins - 1 && peak_count < max_peaks; ++i)
+    if (out_correlation == nullptr || max_lag < 0 || length < 2 || method < CORRELATION_AUTO ||
+        method > CORRELATION_FFT)
     {
-        if (spectrum->bins[i].magnitude > spectrum->bins[i - 1].magnitude &&
-            spectrum->bins[i].magnitude > spectrum->bins[i + 1].magnitude &&
-            spectrum->bins[i].magnitude >= min_magnitude)
-        {
-            peak_frequencies[peak_count] = spectrum->bins[i].frequency;
-            peak_magnitudes[peak_count] = spectrum->bins[i].magnitude;
-            peak_count++;
-        }
+        return 0;
     }
     
-    // Sort peaks by magnitude (descending) using bubble sort
-    for (int i = 0; i < peak_count - 1; ++i)
+    // Limit max_lag to signal length
+    if (max_lag >= length)
     {
-        for (int j = 0; j < peak_count - i - 1; ++j)
-        {
-            if (peak_magnitudes[j] < peak_magnitudes[j + 1])
-            {
-                // Swap magnitudes
-                double temp_mag = peak_magnitudes[j];
-                peak_magnitudes[j] = peak_magnitudes[j + 1];
-                peak_magnitudes[j + 1] = temp_mag;
-                
-                // Swap frequencies
-                double temp_freq = peak_frequencies[j];
-                peak_frequencies[j] = peak_frequencies[j + 1];
-                peak_frequencies[j + 1] = temp_freq;
-            }
-        }
+        max_lag = length - 1;
     }
     
-    return peak_count;
-}
-
-/// @brief Calculates power in a frequency band
-/// @param spectrum Frequency spectrum
-/// @param freq_low Lower frequency bound
-/// @param freq_high Upper frequency bound
-/// @return Power in band
-double SignalProcessing::GetPowerInBand(FrequencySpectrum *spectrum, double freq_low, double freq_high)
-{
-    if (spectrum == nullptr || freq_low < 0 || freq_high <= freq_low)
-        return 0.0;
+    Acc mean = (Acc)this->GetMean();
+    int n = length;
     
-    double power = 0.0;
+    // Sum of products for each lag, averaged over the pairs
+    if (!this->LaggedProducts(signal, n, mean, max_lag, method, out_correlation))
+    {
+        return 0;
+    }
+    for (int lag = 0; lag <= max_lag; lag++)
+    {
+        out_correlation[lag] /= (n - lag);
+    }
     
-    for (int i = 0; i < spectrum->num_bins; ++i)
+    // Normalize if requested
+    if (normalize && out_correlation[0] != 0.0)
     {
-        if (spectrum->bins[i].frequency >= freq_low && spectrum->bins[i].frequency <= freq_high)
+        Acc r0 = out_correlation[0];  // Variance
+        for (int lag = 0; lag <= max_lag; lag++)
         {
-            power += spectrum->bins[i].power;
+            out_correlation[lag] /= r0;
         }
     }
     
-    return power;
+    return max_lag + 1;
 }
 
-/// @brief Analyzes harmonics of a fundamental frequency
-/// @param spectrum Frequency spectrum
-/// @param fundamental Fundamental frequency
-/// @param num_harmonics Number of harmonics to analyze
-/// @param harmonic_magnitudes Output array for harmonic magnitudes
-/// @return Total harmonic distortion (THD)
-double SignalProcessing::AnalyzeHarmonics(FrequencySpectrum *spectrum, double fundamental,
-                                         int num_harmonics, double *harmonic_magnitudes)
+/// @brief Sums of cross products: sums[max_lag + k] = sum of (x[i] - mean) (signal2[i + k] - mean2), |k| <= max_lag
+/// @param signal2 Second signal
+/// @param length2 Size of the second signal
+/// @param mean Value subtracted from the samples of the analysis window
+/// @param mean2 Value subtracted from the samples of signal2
+/// @param max_lag Largest lag in both directions
+/// @param method CORRELATION_AUTO, CORRELATION_DIRECT or CORRELATION_FFT (ignored for phat)
+/// @param phat Divide the cross-spectrum by its magnitude (GCC-PHAT)
+/// @param sums Output, 2 * max_lag + 1 values, 0 for lags without overlap
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalProcessingT<T, Acc>::CrossProducts(const T *signal2, int length2, Acc mean, Acc mean2, int max_lag,
+                                              int method, bool phat, Acc *sums)
 {
-    if (spectrum == nullptr || fundamental <= 0 || num_harmonics < 1 || harmonic_magnitudes == nullptr)
-        return 0.0;
-    
-    double fundamental_magnitude = 0.0;
-    double harmonics_sum = 0.0;
-    
-    // For each harmonic
-    for (int h = 1; h <= num_harmonics; ++h)
+    T *signal = this->WindowData();
+    int length = this->WindowSize();
+
+    // lags with at least one pair: -(length - 1) to length2 - 1
+    int low = (max_lag < length - 1) ? -max_lag : -(length - 1);
+    int high = (max_lag < length2 - 1) ? max_lag : length2 - 1;
+    memset(sums, 0, (2 * max_lag + 1) * sizeof(Acc));
+    if (method == CORRELATION_AUTO)
     {
-        double target_freq = h * fundamental;
-        double tolerance = spectrum->frequency_resolution * 2.0;
-        
-        // Find closest bin to harmonic frequency
-        double max_mag = 0.0;
-        for (int i = 0; i < spectrum->num_bins; ++i)
+        method = SignalCorrelationMethod(length, length2, max_lag);
+    }
+    if (method != CORRELATION_FFT && !phat)
+    {
+        for (int lag = low; lag <= high; lag++)
         {
-            double freq_diff = spectrum->bins[i].frequency - target_freq;
-            if (freq_diff < 0) freq_diff = -freq_diff;
-            
-            if (freq_diff < tolerance && spectrum->bins[i].magnitude > max_mag)
+            int first = (lag < 0) ? -lag : 0;
+            int last = (length < length2 - lag) ? length : length2 - lag;
+            Acc sum = 0;
+            for (int i = first; i < last; i++)
             {
-                max_mag = spectrum->bins[i].magnitude;
+                sum += (signal[i] - mean) * (signal2[i + lag] - mean2);
             }
+            sums[max_lag + lag] = sum;
         }
-        
-        harmonic_magnitudes[h - 1] = max_mag;
-        
-        if (h == 1)
+        return true;
+    }
+
+    // both signals in one transform, zero-padded so that lags low to high do not wrap
+    int longest = (length > length2) ? length : length2;
+    int size = SignalCorrelationLength(longest, (-low > high) ? -low : high);
+    const FFTPlan *forward = FFTPlan::Get(size, 1);
+    const FFTPlan *inverse = FFTPlan::Get(size, -1);
+    if (forward == nullptr || inverse == nullptr)
+    {
+        return false;
+    }
+    size_t mark = this->workspace->Mark();
+    Acc *real = (Acc *)this->Scratch(size * sizeof(Acc));
+    Acc *imag = (Acc *)this->Scratch(size * sizeof(Acc));
+    if (real == nullptr || imag == nullptr)
+    {
+        this->workspace->Release(mark);
+        return false;
+    }
+    for (int i = 0; i < size; i++)
+    {
+        real[i] = (i < length) ? (Acc)(signal[i] - mean) : (Acc)0;
+        imag[i] = (i < length2) ? (Acc)(signal2[i] - mean2) : (Acc)0;
+    }
+    forward->Execute(real, imag);
+
+    // X = (Z[k] + conj(Z[N - k])) / 2, Y = (Z[k] - conj(Z[N - k])) / 2i, cross-spectrum conj(X) Y
+    int half = size / 2;
+    Acc largest = 0;
+    for (int k = 0; k <= half; k++)
+    {
+        int m = (size - k) % size;
+        Acc xr = (real[k] + real[m]) / 2, xi = (imag[k] - imag[m]) / 2;
+        Acc yr = (imag[k] + imag[m]) / 2, yi = (real[m] - real[k]) / 2;
+        Acc pr = xr * yr + xi * yi;
+        Acc pi = xr * yi - xi * yr;
+        real[k] = pr;
+        imag[k] = pi;
+        real[m] = pr;
+        imag[m] = -pi;
+        if (phat)
         {
-            fundamental_magnitude = max_mag;
+            Acc magnitude = (Acc)sqrt(pr * pr + pi * pi);
+            largest = (magnitude > largest) ? magnitude : largest;
         }
-        else
+    }
+    if (phat)
+    {
+        Acc floor = largest * (Acc)CORRELATION_PHAT_FLOOR;
+        for (int k = 0; k < size; k++)
         {
-            harmonics_sum += max_mag * max_mag;
+            Acc magnitude = (Acc)sqrt(real[k] * real[k] + imag[k] * imag[k]);
+            Acc weight = (magnitude > floor) ? magnitude : floor;
+            if (weight > 0)
+            {
+                real[k] /= weight;
+                imag[k] /= weight;
+            }
         }
     }
-    
-    // Calculate THD (Total Harmonic Distortion)
-    if (fundamental_magnitude > 0)
+    inverse->Execute(real, imag);
+
+    // lag k at k, negative lags at the end
+    for (int lag = low; lag <= high; lag++)
     {
-        return sqrt(harmonics_sum) / fundamental_magnitude;
+        sums[max_lag + lag] = real[(lag < 0) ? size + lag : lag];
     }
-    
-    return 0.0;
+    this->workspace->Release(mark);
+    return true;
 }
 
-/// @brief Compares frequency spectra of different segments
-/// @param marker_indices Segment start indices
-/// @param num_markers Number of segments
-/// @param sampling_rate Sampling rate
-/// @param spectra Output array of spectra
-/// @return Number of spectra computed
-int SignalProcessing::CompareSegmentSpectra(int *marker_indices, int num_markers,
-                                           double sampling_rate, FrequencySpectrum *spectra)
+/// @brief Computes cross-correlation between two signals
+/// @param signal2 Second signal
+/// @param signal2_size Size of second signal
+/// @param max_lag Maximum lag (positive and negative)
+/// @param out_correlation Output correlation array
+/// @param normalize Normalize to [-1, 1]
+/// @param method CORRELATION_AUTO, CORRELATION_DIRECT or CORRELATION_FFT
+/// @return Number of correlation values
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::CrossCorrelation(const T *signal2, int signal2_size, int max_lag,
+                                       Acc *out_correlation, bool normalize, int method)
 {
-    if (marker_indices == nullptr || spectra == nullptr || num_markers < 1)
+    int length = this->WindowSize();
+    
+    if (out_correlation == nullptr || signal2 == nullptr || 
+        max_lag < 0 || length < 1 || signal2_size < 1 || method < CORRELATION_AUTO || method > CORRELATION_FFT)
+    {
+        return 0;
+    }
+    
+    // mean of this signal from the running statistics
+    Acc mean1 = (Acc)this->GetMean();
+    
+    // Calculate mean of signal2
+    Acc sum2 = 0;
+    for (int i = 0; i < signal2_size; i++)
+    {
+        sum2 += signal2[i];
+    }
+    Acc mean2 = sum2 / signal2_size;
+    
+    if (!this->CrossProducts(signal2, signal2_size, mean1, mean2, max_lag, method, false, out_correlation))
+    {
         return 0;
+    }
     
-    int count = 0;
+    // Average over the overlapping pairs of each lag
+    int out_index = 2 * max_lag + 1;
+    for (int lag = -max_lag; lag <= max_lag; lag++)
+    {
+        int first = (lag < 0) ? -lag : 0;
+        int last = (length < signal2_size - lag) ? length : signal2_size - lag;
+        int count = last - first;
+        out_correlation[max_lag + lag] = (count > 0) ? out_correlation[max_lag + lag] / count : (Acc)0;
+    }
     
-    for (int seg = 0; seg < num_markers; ++seg)
+    // Normalize if requested
+    if (normalize)
     {
-        int start = marker_indices[seg];
-        int end = (seg < num_markers - 1) ? marker_indices[seg + 1] : this->index;
-        int size = end - start;
+        Acc var1 = (Acc)this->GetVariance();
         
-        if (start >= 0 && end <= this->index && size > 4)
+        Acc var2 = 0;
+        for (int i = 0; i < signal2_size; i++)
         {
-            if (FFTAnalysis(start, size, sampling_rate, &spectra[count]))
+            Acc diff = signal2[i] - mean2;
+            var2 += diff * diff;
+        }
+        var2 /= signal2_size;
+        
+        Acc normalization = (Acc)sqrt(var1 * var2);
+        if (normalization > 0.0)
+        {
+            for (int i = 0; i < out_index; i++)
             {
-                count++;
+                out_correlation[i] /= normalization;
             }
         }
     }
     
-    return count;
+    return out_index;
 }
 
-/// @brief Frees memory allocated for spectrum
-/// @param spectrum Spectrum to free
-void SignalProcessing::FreeSpectrum(FrequencySpectrum *spectrum)
+/// @brief Computes the generalized cross-correlation with phase transform
+/// @param signal2 Second signal
+/// @param signal2_size Size of second signal
+/// @param max_lag Maximum lag (positive and negative)
+/// @param out_correlation Output correlation array
+/// @return Number of correlation values
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::GCCPHAT(const T *signal2, int signal2_size, int max_lag, Acc *out_correlation)
 {
-    if (spectrum != nullptr && spectrum->bins != nullptr)
+    int length = this->WindowSize();
+    
+    if (out_correlation == nullptr || signal2 == nullptr || max_lag < 0 || length < 1 || signal2_size < 1)
     {
-        free(spectrum->bins);
-        spectrum->bins = nullptr;
-        spectrum->num_bins = 0;
+        return 0;
+    }
+    
+    Acc sum2 = 0;
+    for (int i = 0; i < signal2_size; i++)
+    {
+        sum2 += signal2[i];
+    }
+    Acc mean2 = sum2 / signal2_size;
+    
+    if (!this->CrossProducts(signal2, signal2_size, (Acc)this->GetMean(), mean2, max_lag, CORRELATION_FFT, true,
+                             out_correlation))
+    {
+        return 0;
     }
+    return 2 * max_lag + 1;
 }
 
-/// @brief Detects frequency anomalies by comparing with baseline
-/// @param current_spectrum Current spectrum
-/// @param baseline_spectrum Baseline spectrum
-/// @param threshold Threshold ratio
-/// @return Anomaly score
-double SignalProcessing::DetectFrequencyAnomalies(FrequencySpectrum *current_spectrum,
-                                                 FrequencySpectrum *baseline_spectrum,
-                                                 double threshold)
+/// @brief Finds lag with maximum correlation
+/// @param correlation Correlation array
+/// @param size Array size
+/// @param peak_value Output peak value
+/// @param peak_position Output sub-sample position of the peak (optional)
+/// @return Index of peak
+template <typename T, typename Acc>
+int SignalProcessingT<T, Acc>::FindCorrelationPeak(const Acc *correlation, int size, double *peak_value,
+                                                   double *peak_position)
 {
-    if (current_spectrum == nullptr || baseline_spectrum == nullptr)
-        return 0.0;
+    if (correlation == nullptr || size < 1)
+    {
+        if (peak_value != nullptr) *peak_value = 0.0;
+        if (peak_position != nullptr) *peak_position = -1.0;
+        return -1;
+    }
     
-    int min_bins = (current_spectrum->num_bins < baseline_spectrum->num_bins) ? 
-                    current_spectrum->num_bins : baseline_spectrum->num_bins;
+    int peak_index = 0;
+    double max_value = correlation[0];
     
-    double anomaly_score = 0.0;
-    int anomaly_count = 0;
+    // Skip lag=0 for autocorrelation (always 1.0 when normalized)
+    int start = (size > 1) ? 1 : 0;
     
-    for (int i = 1; i < min_bins; ++i)  // Skip DC component
+    for (int i = start; i < size; i++)
     {
-        double baseline_mag = baseline_spectrum->bins[i].magnitude;
-        double current_mag = current_spectrum->bins[i].magnitude;
-        
-        if (baseline_mag > 0)
+        if (correlation[i] > max_value)
         {
-            double ratio = current_mag / baseline_mag;
-            
-            if (ratio > threshold || ratio < (1.0 / threshold))
+            max_value = correlation[i];
+            peak_index = i;
+        }
+    }
+    
+    if (peak_value != nullptr)
+    {
+        *peak_value = max_value;
+    }
+    
+    // Parabola through the peak and its neighbours
+    if (peak_position != nullptr)
+    {
+        *peak_position = peak_index;
+        if (peak_index > 0 && peak_index < size - 1)
+        {
+            double left = correlation[peak_index - 1];
+            double right = correlation[peak_index + 1];
+            double curvature = left - 2.0 * max_value + right;
+            if (curvature < 0.0)
             {
-                double deviation = (ratio > 1.0) ? (ratio - 1.0) : (1.0 - ratio);
-                anomaly_score += deviation;
-                anomaly_count++;
+                double offset = 0.5 * (left - right) / curvature;
+                if (offset > 0.5) offset = 0.5;
+                if (offset < -0.5) offset = -0.5;
+                *peak_position = peak_index + offset;
             }
         }
     }
     
-    // Normalize by number of bins
-    if (anomaly_count > 0)
+    return peak_index;
+}
+
+// ========== NON-OWNING SIGNAL VIEW IMPLEMENTATION ==========
+
+/// @brief Creates a view over external samples
+/// @param data Oldest sample
+/// @param length Number of samples
+/// @param stride Distance between two samples, in elements
+template <typename T, typename Acc>
+SignalViewT<T, Acc>::SignalViewT(const T *data, int length, int stride)
+    : SignalProcessingT<T, Acc>(nullptr, 0)
+{
+    this->gathered = nullptr;
+    this->gathered_capacity = 0;
+    this->Reset(data, length, stride);
+}
+
+/// @brief SignalViewT destructor
+template <typename T, typename Acc>
+SignalViewT<T, Acc>::~SignalViewT()
+{
+    free(this->gathered);
+}
+
+/// @brief Points the view at other samples
+/// @param data Oldest sample
+/// @param length Number of samples
+/// @param stride Distance between two samples, in elements
+template <typename T, typename Acc>
+void SignalViewT<T, Acc>::Reset(const T *data, int length, int stride)
+{
+    if (data == nullptr || length <= 0 || stride == 0)
+    {
+        this->BindView(nullptr, 0);
+        return;
+    }
+    if (stride == 1)
+    {
+        this->BindView(data, length);
+        return;
+    }
+    // the analysis kernels need contiguous samples: gather the strided ones once
+    if (length > this->gathered_capacity)
+    {
+        T *buffer = (T *)realloc(this->gathered, (size_t)length * sizeof(T));
+        if (buffer == nullptr)
+        {
+            this->BindView(nullptr, 0);
+            return;
+        }
+        this->gathered = buffer;
+        this->gathered_capacity = length;
+    }
+    for (int i = 0; i < length; ++i)
     {
-        anomaly_score /= anomaly_count;
+        this->gathered[i] = data[(long long)i * stride];
     }
-    
-    return anomaly_score;
+    this->BindView(this->gathered, length);
 }
 
-// ========== ML/AI FEATURE EXTRACTION IMPLEMENTATION ==========
+// ========== MULTI-CHANNEL SIGNAL BANK IMPLEMENTATION ==========
 
-/// @brief Extracts comprehensive ML feature vector from current signal
-/// @param sampling_rate Sampling rate in Hz
-/// @param features Output structure for features
-/// @return true if successful
-bool SignalProcessing::ExtractMLFeatures(double sampling_rate, MLFeatureVector *features)
+/// @brief SignalBankT constructor
+/// @param num_channels Number of channels
+/// @param capacity Number of frames kept in the ring buffer
+template <typename T, typename Acc>
+SignalBankT<T, Acc>::SignalBankT(int num_channels, int capacity) : channel_view(1)
 {
-    if (features == nullptr || this->index < 10)
-    {
-        return false;
-    }
-    
-    int n = this->index;
-    
-    // === STATISTICAL FEATURES ===
-    features->mean = this->GetMean();
-    features->variance = this->GetVariance();
-    features->std_dev = this->GetStandardDeviation();
-    
-    // RMS (Root Mean Square)
-    double sum_squares = 0.0;
-    for (int i = 0; i < n; i++)
+    if (num_channels < 1)
     {
-        sum_squares += this->SignalVector[i] * this->SignalVector[i];
+        num_channels = 1;
     }
-    features->rms = sqrt(sum_squares / n);
-    
-    // Peak-to-peak and crest factor
-    double min_val = this->SignalVector[0];
-    double max_val = this->SignalVector[0];
-    for (int i = 1; i < n; i++)
+    if (capacity < 1)
     {
-        if (this->SignalVector[i] < min_val) min_val = this->SignalVector[i];
-        if (this->SignalVector[i] > max_val) max_val = this->SignalVector[i];
+        capacity = NB_MAX_VALUES;
     }
-    features->peak_to_peak = max_val - min_val;
-    features->crest_factor = (features->rms > 0) ? (max_val / features->rms) : 0.0;
-    
-    // Skewness (third moment)
-    double sum_cubed = 0.0;
-    for (int i = 0; i < n; i++)
+    this->num_channels = num_channels;
+    this->capacity = capacity;
+    // each channel is mirrored like SignalProcessingT and starts on an aligned address
+    size_t per_line = SIGNALBANK_ALIGNMENT / sizeof(T);
+    this->channel_stride = ((2 * (size_t)capacity + per_line - 1) / per_line) * per_line;
+    this->storage = (T *)AlignedCalloc((size_t)num_channels * this->channel_stride * sizeof(T));
+    this->timestamp_ns = (long long *)calloc((size_t)capacity, sizeof(long long));
+    this->head = 0;
+    this->count = 0;
+    this->total = 0;
+    this->analysis_window = 0;
+}
+
+/// @brief SignalBankT destructor
+template <typename T, typename Acc>
+SignalBankT<T, Acc>::~SignalBankT()
+{
+    AlignedFree(this->storage);
+    free(this->timestamp_ns);
+}
+
+/// @brief Gets the number of channels
+/// @return Number of channels
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::GetNumChannels()
+{
+    return this->num_channels;
+}
+
+/// @brief Gets the number of frames the ring buffer can hold
+/// @return Capacity in frames
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::GetMaxCapacity()
+{
+    return this->capacity;
+}
+
+/// @brief Gets the number of frames stored
+/// @return Number of stored frames
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::GetIndex()
+{
+    return this->count;
+}
+
+/// @brief Gets the total number of frames added
+/// @return Total number of frames, including overwritten ones
+template <typename T, typename Acc>
+long long SignalBankT<T, Acc>::GetTotalCount()
+{
+    return this->total;
+}
+
+/// @brief Restricts all channel and batch methods to the newest frames
+/// @param last_n Number of newest frames (0 = all stored frames)
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::SetAnalysisWindow(int last_n)
+{
+    this->analysis_window = (last_n > 0) ? last_n : 0;
+}
+
+/// @brief Gets the number of frames seen by the analysis methods
+/// @return Analysis window length
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::GetAnalysisWindow()
+{
+    if (this->analysis_window > 0 && this->analysis_window < this->count)
     {
-        double deviation = this->SignalVector[i] - features->mean;
-        sum_cubed += deviation * deviation * deviation;
+        return this->analysis_window;
     }
-    features->skewness = (features->std_dev > 0) ? 
-                         (sum_cubed / n) / (features->std_dev * features->std_dev * features->std_dev) : 0.0;
-    
-    // Kurtosis (fourth moment)
-    double sum_fourth = 0.0;
-    for (int i = 0; i < n; i++)
+    return this->count;
+}
+
+/// @brief Removes all frames
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::ClearVector()
+{
+    this->head = 0;
+    this->count = 0;
+    this->total = 0;
+}
+
+/// @brief Gets the storage of a channel
+/// @param channel Channel number
+/// @return First of the 2 * capacity mirrored samples of the channel
+template <typename T, typename Acc>
+T *SignalBankT<T, Acc>::ChannelBase(int channel)
+{
+    return this->storage + (size_t)channel * this->channel_stride;
+}
+
+/// @brief Copies frames into every channel at the write position
+/// @param values Source values
+/// @param frame_step Distance between two frames of a channel in values
+/// @param channel_step Distance between two channels of a frame in values
+/// @param ts Timestamps of the frames, nullptr for none
+/// @param frames Number of frames
+/// @return Number of frames stored
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::WriteFrames(const T *values, int frame_step, int channel_step,
+                                     const struct timespec *ts, int frames)
+{
+    if (this->storage == nullptr || this->timestamp_ns == nullptr || values == nullptr || frames <= 0)
     {
-        double deviation = this->SignalVector[i] - features->mean;
-        double dev_squared = deviation * deviation;
-        sum_fourth += dev_squared * dev_squared;
+        return this->count;
     }
-    features->kurtosis = (features->variance > 0) ? 
-                         (sum_fourth / n) / (features->variance * features->variance) : 0.0;
-    
-    // === TIME DOMAIN FEATURES ===
-    
-    // Zero crossing rate
-    int zero_crossings = 0;
-    for (int i = 1; i < n; i++)
+    this->total += frames;
+
+    // frames that would be overwritten by the same block are skipped
+    if (frames > this->capacity)
     {
-        if ((this->SignalVector[i-1] >= 0 && this->SignalVector[i] < 0) ||
-            (this->SignalVector[i-1] < 0 && this->SignalVector[i] >= 0))
+        int skipped = frames - this->capacity;
+        this->head = (int)((this->head + (long long)skipped) % this->capacity);
+        values += (size_t)skipped * frame_step;
+        if (ts != nullptr)
         {
-            zero_crossings++;
+            ts += skipped;
         }
+        frames = this->capacity;
     }
-    features->zero_crossing_rate = (double)zero_crossings / n;
-    
-    // Mean crossing rate
-    int mean_crossings = 0;
-    for (int i = 1; i < n; i++)
+
+    // at most two segments: [head, capacity) then [0, rest)
+    int done = 0;
+    while (done < frames)
     {
-        if ((this->SignalVector[i-1] >= features->mean && this->SignalVector[i] < features->mean) ||
-            (this->SignalVector[i-1] < features->mean && this->SignalVector[i] >= features->mean))
+        int length = this->capacity - this->head;
+        if (length > frames - done)
         {
-            mean_crossings++;
+            length = frames - done;
         }
-    }
-    features->mean_crossing_rate = (double)mean_crossings / n;
-    
-    // Energy
-    features->energy = sum_squares;
-    
-    // Autocorrelation peak (first non-zero lag peak)
-    features->autocorr_peak = 0.0;
-    int max_lag = (n > 100) ? 100 : n / 2;
-    double max_autocorr = 0.0;
-    for (int lag = 1; lag < max_lag; lag++)
-    {
-        double autocorr = 0.0;
-        for (int i = 0; i < n - lag; i++)
+        for (int ch = 0; ch < this->num_channels; ++ch)
         {
-            autocorr += this->SignalVector[i] * this->SignalVector[i + lag];
+            T *dst = this->ChannelBase(ch) + this->head;
+            const T *src = values + (size_t)done * frame_step + (size_t)ch * channel_step;
+            if (frame_step == 1)
+            {
+                memcpy(dst, src, (size_t)length * sizeof(T));
+                memcpy(dst + this->capacity, src, (size_t)length * sizeof(T));
+            }
+            else
+            {
+                for (int i = 0; i < length; ++i)
+                {
+                    T v = src[(size_t)i * frame_step];
+                    dst[i] = v;
+                    dst[i + this->capacity] = v;
+                }
+            }
         }
-        autocorr /= (n - lag);
-        if (autocorr > max_autocorr)
+        if (ts != nullptr)
         {
-            max_autocorr = autocorr;
-            features->autocorr_peak = (double)lag / sampling_rate;  // in seconds
+            for (int i = 0; i < length; ++i)
+            {
+                this->timestamp_ns[this->head + i] = TimespecToNs(ts[done + i]);
+            }
         }
-    }
-    
-    // === FREQUENCY DOMAIN FEATURES ===
-    
-    FrequencySpectrum spectrum;
-    bool fft_success = this->FFTAnalysis(sampling_rate, &spectrum);
-    
-    if (fft_success)
-    {
-        features->dominant_frequency = spectrum.dominant_frequency;
-        features->total_power = spectrum.total_power;
-        
-        // Power in frequency bands
-        features->power_low_freq = this->GetPowerInBand(&spectrum, 0.0, 10.0);
-        features->power_mid_freq = this->GetPowerInBand(&spectrum, 10.0, 100.0);
-        features->power_high_freq = this->GetPowerInBand(&spectrum, 100.0, sampling_rate / 2.0);
-        
-        // Spectral centroid (center of mass of spectrum)
-        double weighted_sum = 0.0;
-        double total_magnitude = 0.0;
-        for (int i = 0; i < spectrum.num_bins; i++)
+        else
         {
-            weighted_sum += spectrum.bins[i].frequency * spectrum.bins[i].magnitude;
-            total_magnitude += spectrum.bins[i].magnitude;
+            memset(this->timestamp_ns + this->head, 0, (size_t)length * sizeof(long long));
         }
-        features->spectral_centroid = (total_magnitude > 0) ? (weighted_sum / total_magnitude) : 0.0;
-        
-        // Spectral spread (standard deviation around centroid)
-        double spread_sum = 0.0;
-        for (int i = 0; i < spectrum.num_bins; i++)
+        this->head += length;
+        if (this->head == this->capacity)
         {
-            double diff = spectrum.bins[i].frequency - features->spectral_centroid;
-            spread_sum += diff * diff * spectrum.bins[i].magnitude;
+            this->head = 0;
         }
-        features->spectral_spread = (total_magnitude > 0) ? 
-                                    sqrt(spread_sum / total_magnitude) : 0.0;
-        
-        // Spectral entropy (measure of spectral complexity)
-        features->spectral_entropy = 0.0;
-        for (int i = 0; i < spectrum.num_bins; i++)
+        done += length;
+    }
+
+    this->count = (this->total < this->capacity) ? (int)this->total : this->capacity;
+    return this->count;
+}
+
+/// @brief Adds one sample to every channel
+/// @param values One value per channel
+/// @return Number of frames stored
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::AddFrame(const T *values)
+{
+    return this->WriteFrames(values, this->num_channels, 1, nullptr, 1);
+}
+
+/// @brief Adds one sample to every channel with a shared timestamp
+/// @param values One value per channel
+/// @param ts Timestamp of the frame
+/// @return Number of frames stored
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::AddFrameWithTimestamp(const T *values, struct timespec ts)
+{
+    return this->WriteFrames(values, this->num_channels, 1, &ts, 1);
+}
+
+/// @brief Adds a block of interleaved frames
+/// @param values Interleaved values (values[frame * channels + channel])
+/// @param frames Number of frames
+/// @return Number of frames stored
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::AddFrames(const T *values, int frames)
+{
+    return this->WriteFrames(values, this->num_channels, 1, nullptr, frames);
+}
+
+/// @brief Adds a block of interleaved frames with one timestamp per frame
+/// @param values Interleaved values (values[frame * channels + channel])
+/// @param ts Timestamps of the frames
+/// @param frames Number of frames
+/// @return Number of frames stored
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::AddFramesWithTimestamps(const T *values, const struct timespec *ts, int frames)
+{
+    if (ts == nullptr)
+    {
+        return this->count;
+    }
+    return this->WriteFrames(values, this->num_channels, 1, ts, frames);
+}
+
+/// @brief Adds a block given channel by channel
+/// @param values Planar values (values[channel * frames + frame])
+/// @param frames Number of frames
+/// @return Number of frames stored
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::AddPlanarFrames(const T *values, int frames)
+{
+    return this->WriteFrames(values, 1, frames, nullptr, frames);
+}
+
+/// @brief Binds the shared channel view to a channel
+/// @param channel Channel number (clamped to the valid range)
+/// @return Read-only signal over the channel storage
+template <typename T, typename Acc>
+SignalProcessingT<T, Acc> &SignalBankT<T, Acc>::Channel(int channel)
+{
+    if (channel < 0)
+    {
+        channel = 0;
+    }
+    if (channel >= this->num_channels)
+    {
+        channel = this->num_channels - 1;
+    }
+    this->channel_view.BindStorage(this->ChannelBase(channel), this->timestamp_ns, this->capacity,
+                                   this->count, this->total, this->analysis_window);
+    return this->channel_view;
+}
+
+/// @brief Gets the analysis window of one channel
+/// @param channel Channel number
+/// @return Contiguous samples of the channel, nullptr for an invalid channel
+template <typename T, typename Acc>
+const T *SignalBankT<T, Acc>::GetChannelData(int channel)
+{
+    if (channel < 0 || channel >= this->num_channels || this->storage == nullptr)
+    {
+        return nullptr;
+    }
+    return this->Channel(channel).WindowData();
+}
+
+/// @brief Gets a sample of one channel
+/// @param channel Channel number
+/// @param index Index relative to the oldest frame of the analysis window
+/// @return Sample value (0 if out of range)
+template <typename T, typename Acc>
+T SignalBankT<T, Acc>::GetValue(int channel, int index)
+{
+    if (channel < 0 || channel >= this->num_channels)
+    {
+        return 0;
+    }
+    return this->Channel(channel).GetValue(index);
+}
+
+/// @brief Gets the shared timestamp of a frame
+/// @param index Index relative to the oldest frame of the analysis window
+/// @return Timestamp (zero if the frame was added without timestamp)
+template <typename T, typename Acc>
+struct timespec SignalBankT<T, Acc>::GetTimestamp(int index)
+{
+    return this->Channel(0).GetTimestamp(index);
+}
+
+/// @brief Calculates the mean of every channel
+/// @param out_values Output array (one value per channel)
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::GetMeans(double *out_values)
+{
+    if (out_values == nullptr)
+        return;
+    for (int ch = 0; ch < this->num_channels; ++ch)
+        out_values[ch] = this->Channel(ch).GetMean();
+}
+
+/// @brief Calculates the variance of every channel
+/// @param out_values Output array (one value per channel)
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::GetVariances(double *out_values)
+{
+    if (out_values == nullptr)
+        return;
+    for (int ch = 0; ch < this->num_channels; ++ch)
+        out_values[ch] = this->Channel(ch).GetVariance();
+}
+
+/// @brief Calculates the standard deviation of every channel
+/// @param out_values Output array (one value per channel)
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::GetStandardDeviations(double *out_values)
+{
+    if (out_values == nullptr)
+        return;
+    for (int ch = 0; ch < this->num_channels; ++ch)
+        out_values[ch] = this->Channel(ch).GetStandardDeviation();
+}
+
+/// @brief Moving average of every channel
+/// @param out_vector Planar output
+/// @param window_size Number of values to average
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::GetMovingAverageVector(Acc *out_vector, int window_size)
+{
+    if (out_vector == nullptr)
+        return;
+    size_t length = (size_t)this->GetAnalysisWindow();
+    for (int ch = 0; ch < this->num_channels; ++ch)
+        this->Channel(ch).GetMovingAverageVector(out_vector + ch * length, window_size);
+}
+
+/// @brief Exponential smoothing of every channel
+/// @param alpha Smoothing factor (0 < alpha <= 1)
+/// @param out_vector Planar output
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::ExponentialSmoothing(double alpha, Acc *out_vector)
+{
+    if (out_vector == nullptr)
+        return;
+    size_t length = (size_t)this->GetAnalysisWindow();
+    for (int ch = 0; ch < this->num_channels; ++ch)
+        this->Channel(ch).ExponentialSmoothing(alpha, out_vector + ch * length);
+}
+
+/// @brief Kalman filter applied to every channel
+/// @param process_noise Process noise covariance (Q)
+/// @param measurement_noise Measurement noise covariance (R)
+/// @param out_vector Planar output
+/// @param initial_estimate Initial state estimate
+/// @param initial_error Initial error covariance
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::KalmanFilter(double process_noise, double measurement_noise, Acc *out_vector,
+                                       double initial_estimate, double initial_error)
+{
+    if (out_vector == nullptr)
+        return;
+    size_t length = (size_t)this->GetAnalysisWindow();
+    for (int ch = 0; ch < this->num_channels; ++ch)
+        this->Channel(ch).KalmanFilter(process_noise, measurement_noise, out_vector + ch * length,
+                                       initial_estimate, initial_error);
+}
+
+/// @brief Median filter applied to every channel
+/// @param window_size Window size (odd, up to 101)
+/// @param out_vector Planar output
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::MedianFilter(int window_size, Acc *out_vector)
+{
+    if (out_vector == nullptr)
+        return;
+    size_t length = (size_t)this->GetAnalysisWindow();
+    for (int ch = 0; ch < this->num_channels; ++ch)
+        this->Channel(ch).MedianFilter(window_size, out_vector + ch * length);
+}
+
+/// @brief FFT analysis of every channel
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectra Output spectra (one per channel)
+/// @return true if every channel was analyzed
+template <typename T, typename Acc>
+bool SignalBankT<T, Acc>::FFTAnalysis(double sampling_rate, FrequencySpectrum *spectra)
+{
+    if (spectra == nullptr || sampling_rate <= 0)
+        return false;
+    int num_bins = this->GetNumBins();
+    for (int ch = 0; ch < this->num_channels; ++ch)
+    {
+        spectra[ch].bins = (FrequencyBin *)malloc(num_bins * sizeof(FrequencyBin));
+        if (spectra[ch].bins == nullptr)
         {
-            if (spectrum.bins[i].magnitude > 0)
-            {
-                double normalized = spectrum.bins[i].magnitude / total_magnitude;
-                features->spectral_entropy -= normalized * log(normalized + 1e-10);
-            }
+            for (int i = 0; i < ch; ++i)
+                this->channel_view.FreeSpectrum(&spectra[i]);
+            return false;
         }
-        
-        this->FreeSpectrum(&spectrum);
     }
-    else
+    if (!this->template BatchSpectra<Acc>(sampling_rate, spectra, (Acc *)nullptr))
     {
-        // FFT failed, set frequency features to 0
-        features->dominant_frequency = 0.0;
-        features->total_power = 0.0;
-        features->power_low_freq = 0.0;
-        features->power_mid_freq = 0.0;
-        features->power_high_freq = 0.0;
-        features->spectral_centroid = 0.0;
-        features->spectral_spread = 0.0;
-        features->spectral_entropy = 0.0;
+        for (int ch = 0; ch < this->num_channels; ++ch)
+            free(spectra[ch].bins);
+        return false;
     }
-    
-    features->num_features = 21;  // Total count
     return true;
 }
 
-/// @brief Extracts features from a specific segment
-/// @param start_index Starting index
-/// @param window_size Size of segment
+/// @brief Single-precision FFT analysis of every channel
 /// @param sampling_rate Sampling rate in Hz
-/// @param features Output structure
+/// @param spectra Output spectra (GetNumChannels() entries)
 /// @return true if successful
-bool SignalProcessing::ExtractMLFeaturesFromSegment(int start_index, int window_size,
-                                                    double sampling_rate, MLFeatureVector *features)
+template <typename T, typename Acc>
+bool SignalBankT<T, Acc>::FFTAnalysis(double sampling_rate, FrequencySpectrumF *spectra)
 {
-    if (features == nullptr || start_index < 0 || window_size <= 0)
-    {
+    if (spectra == nullptr || sampling_rate <= 0)
         return false;
-    }
-    
-    if (start_index + window_size > this->index)
+    int num_bins = this->GetNumBins();
+    for (int ch = 0; ch < this->num_channels; ++ch)
     {
-        return false;  // Segment out of bounds
+        spectra[ch].bins = (FrequencyBinF *)malloc(num_bins * sizeof(FrequencyBinF));
+        if (spectra[ch].bins == nullptr)
+        {
+            for (int i = 0; i < ch; ++i)
+                this->channel_view.FreeSpectrum(&spectra[i]);
+            return false;
+        }
     }
-    
-    // Create temporary SignalProcessing object with segment data
-    SignalProcessing temp;
-    for (int i = 0; i < window_size; i++)
+    if (!this->template BatchSpectra<float>(sampling_rate, spectra, (float *)nullptr))
     {
-        temp.AddValue(this->SignalVector[start_index + i]);
+        for (int ch = 0; ch < this->num_channels; ++ch)
+            free(spectra[ch].bins);
+        return false;
     }
-    
-    return temp.ExtractMLFeatures(sampling_rate, features);
+    return true;
 }
 
-/// @brief Exports features to flat array for ML libraries
-/// @param features Feature structure
-/// @param output_array Output array (size >= 21)
-/// @return Number of features exported
-int SignalProcessing::ExportFeaturesToArray(MLFeatureVector *features, double *output_array)
+/// @brief Magnitudes of the FFT of every channel
+/// @param out_matrix Output matrix (GetNumBins() values per channel)
+/// @return true if successful
+template <typename T, typename Acc>
+bool SignalBankT<T, Acc>::FFTMagnitudeMatrix(Acc *out_matrix)
 {
-    if (features == nullptr || output_array == nullptr)
-    {
-        return 0;
-    }
-    
-    int idx = 0;
-    
-    // Statistical features (8)
-    output_array[idx++] = features->mean;
-    output_array[idx++] = features->std_dev;
-    output_array[idx++] = features->variance;
-    output_array[idx++] = features->skewness;
-    output_array[idx++] = features->kurtosis;
-    output_array[idx++] = features->rms;
-    output_array[idx++] = features->peak_to_peak;
-    output_array[idx++] = features->crest_factor;
-    
-    // Frequency features (9)
-    output_array[idx++] = features->dominant_frequency;
-    output_array[idx++] = features->spectral_centroid;
-    output_array[idx++] = features->spectral_spread;
-    output_array[idx++] = features->spectral_entropy;
-    output_array[idx++] = features->total_power;
-    output_array[idx++] = features->power_low_freq;
-    output_array[idx++] = features->power_mid_freq;
-    output_array[idx++] = features->power_high_freq;
-    
-    // Time domain features (4)
-    output_array[idx++] = features->zero_crossing_rate;
-    output_array[idx++] = features->mean_crossing_rate;
-    output_array[idx++] = features->energy;
-    output_array[idx++] = features->autocorr_peak;
-    
-    return idx;  // Should be 21
+    if (out_matrix == nullptr)
+        return false;
+    return this->template BatchSpectra<Acc>(1.0, (FrequencySpectrum *)nullptr, out_matrix);
 }
 
-/// @brief Normalizes features using z-score normalization
-/// @param features Feature vector to normalize
-/// @param mean_values Mean values from training set
-/// @param std_values Std dev values from training set
-void SignalProcessing::NormalizeMLFeatures(MLFeatureVector *features, 
-                                          double *mean_values, double *std_values)
+/// @brief Gets the number of bins of the batch spectra
+/// @return GetAnalysisWindow() / 2 + 1
+template <typename T, typename Acc>
+int SignalBankT<T, Acc>::GetNumBins()
 {
-    if (features == nullptr || mean_values == nullptr || std_values == nullptr)
-    {
-        return;
-    }
-    
-    double temp_array[21];
-    SignalProcessing::ExportFeaturesToArray(features, temp_array);
-    
-    // Apply z-score normalization: (x - mean) / std
-    for (int i = 0; i < 21; i++)
-    {
-        if (std_values[i] > 0)
-        {
-            temp_array[i] = (temp_array[i] - mean_values[i]) / std_values[i];
-        }
-    }
-    
-    // Put normalized values back into structure
-    int idx = 0;
-    features->mean = temp_array[idx++];
-    features->std_dev = temp_array[idx++];
-    features->variance = temp_array[idx++];
-    features->skewness = temp_array[idx++];
-    features->kurtosis = temp_array[idx++];
-    features->rms = temp_array[idx++];
-    features->peak_to_peak = temp_array[idx++];
-    features->crest_factor = temp_array[idx++];
-    
-    features->dominant_frequency = temp_array[idx++];
-    features->spectral_centroid = temp_array[idx++];
-    features->spectral_spread = temp_array[idx++];
-    features->spectral_entropy = temp_array[idx++];
-    features->total_power = temp_array[idx++];
-    features->power_low_freq = temp_array[idx++];
-    features->power_mid_freq = temp_array[idx++];
-    features->power_high_freq = temp_array[idx++];
-    
-    features->zero_crossing_rate = temp_array[idx++];
-    features->mean_crossing_rate = temp_array[idx++];
-    features->energy = temp_array[idx++];
-    features->autocorr_peak = temp_array[idx++];
+    return this->GetAnalysisWindow() / 2 + 1;
 }
 
-// ========== DOWNSTREAM ML/AI INTEGRATION IMPLEMENTATION ==========
+/// @brief Selects the window applied before the FFT of every channel
+/// @param window_type SIGNAL_WINDOW_* constant
+/// @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+/// @return false for an unknown window type
+template <typename T, typename Acc>
+bool SignalBankT<T, Acc>::SetSpectrumWindow(int window_type, double parameter)
+{
+    // the channel view keeps the setting, so Channel(c).FFTAnalysis() uses it too
+    return this->channel_view.SetSpectrumWindow(window_type, parameter);
+}
 
-/// @brief Creates an empty ML dataset
-/// @param capacity Maximum number of samples
-/// @param with_labels Allocate memory for labels
-/// @param dataset Output dataset
+/// @brief Windowed batch FFT of every channel, in groups of channels
+/// @param sampling_rate Sampling rate in Hz
+/// @param spectra Output spectra with allocated bins, nullptr for none
+/// @param out_matrix Output magnitudes (GetNumBins() values per channel), nullptr for none
 /// @return true if successful
-bool SignalProcessing::CreateMLDataset(int capacity, bool with_labels, MLDataset *dataset)
+///
+/// F is the arithmetic of the window and the transform, Spectrum the type of the spectra.
+template <typename T, typename Acc>
+template <typename F, typename Spectrum>
+bool SignalBankT<T, Acc>::BatchSpectra(double sampling_rate, Spectrum *spectra, F *out_matrix)
 {
-    if (dataset == nullptr || capacity <= 0)
-    {
+    int length = this->GetAnalysisWindow();
+    if (length < 2 || this->storage == nullptr)
         return false;
-    }
-    
-    dataset->samples = new MLFeatureVector[capacity];
-    if (dataset->samples == nullptr)
-    {
+    const FFTPlan *plan = FFTPlan::Get(length, 1);
+    const SignalWindow *window = SignalWindow::Get(this->channel_view.spectrum_window_type, length,
+                                                   this->channel_view.spectrum_window_parameter);
+    if (plan == nullptr || window == nullptr)
         return false;
-    }
-    
-    if (with_labels)
+    const F *coefficients = SignalWindowValues<F>(window);
+
+    // a group of channels at a time keeps the windowed samples in cache for the transform
+    const int group = 2 * FFT_BATCH_LANES;
+    size_t num_bins = (size_t)(length / 2 + 1);
+    size_t values = (size_t)group * length + 2 * (size_t)group * num_bins + plan->GetBatchScratchSize();
+    F *windowed = (F *)malloc(values * sizeof(F));
+    if (windowed == nullptr)
+        return false;
+    F *real = windowed + (size_t)group * length;
+    F *imag = real + (size_t)group * num_bins;
+    F *scratch = imag + (size_t)group * num_bins;
+
+    for (int first = 0; first < this->num_channels; first += group)
     {
-        dataset->labels = new int[capacity];
-        if (dataset->labels == nullptr)
+        int channels = (this->num_channels - first < group) ? this->num_channels - first : group;
+        for (int c = 0; c < channels; ++c)
         {
-            delete[] dataset->samples;
-            return false;
+            const T *data = this->GetChannelData(first + c);
+            F *x = windowed + (size_t)c * length;
+            for (int i = 0; i < length; ++i)
+                x[i] = (F)data[i] * coefficients[i];
+        }
+        plan->ExecuteRealBatch(windowed, channels, length, 1, real, imag, scratch);
+        for (int c = 0; c < channels; ++c)
+        {
+            const F *r = real + c * num_bins;
+            const F *im = imag + c * num_bins;
+            if (spectra != nullptr)
+                SignalFillSpectrum(r, im, length, sampling_rate, &spectra[first + c], spectra[first + c].bins);
+            if (out_matrix != nullptr)
+            {
+                F *row = out_matrix + (size_t)(first + c) * num_bins;
+                for (size_t k = 0; k < num_bins; ++k)
+                    row[k] = sqrt(r[k] * r[k] + im[k] * im[k]);
+            }
         }
-        dataset->has_labels = true;
-    }
-    else
-    {
-        dataset->labels = nullptr;
-        dataset->has_labels = false;
     }
-    
-    dataset->num_samples = 0;
-    dataset->capacity = capacity;
-    
+    free(windowed);
     return true;
 }
 
-/// @brief Frees ML dataset memory
-/// @param dataset Dataset to free
-void SignalProcessing::FreeMLDataset(MLDataset *dataset)
+/// @brief Releases the spectra computed by FFTAnalysis()
+/// @param spectra Spectra (one per channel)
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::FreeSpectra(FrequencySpectrum *spectra)
 {
-    if (dataset == nullptr)
-    {
+    if (spectra == nullptr)
         return;
-    }
-    
-    if (dataset->samples != nullptr)
+    for (int ch = 0; ch < this->num_channels; ++ch)
+        this->channel_view.FreeSpectrum(&spectra[ch]);
+}
+
+/// @brief Releases single-precision spectra
+/// @param spectra Spectra (GetNumChannels() entries)
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::FreeSpectra(FrequencySpectrumF *spectra)
+{
+    if (spectra == nullptr)
+        return;
+    for (int ch = 0; ch < this->num_channels; ++ch)
+        this->channel_view.FreeSpectrum(&spectra[ch]);
+}
+
+/// @brief Mean across channels at every frame
+/// @param out_vector Output array (one value per frame of the analysis window)
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::GetCrossChannelMean(Acc *out_vector)
+{
+    if (out_vector == nullptr)
+        return;
+    int length = this->GetAnalysisWindow();
+    for (int i = 0; i < length; ++i)
+        out_vector[i] = 0;
+    // channel by channel so that every pass streams through contiguous memory
+    for (int ch = 0; ch < this->num_channels; ++ch)
     {
-        delete[] dataset->samples;
-        dataset->samples = nullptr;
+        const T *data = this->GetChannelData(ch);
+        for (int i = 0; i < length; ++i)
+            out_vector[i] += data[i];
     }
-    
-    if (dataset->labels != nullptr)
+    for (int i = 0; i < length; ++i)
+        out_vector[i] /= this->num_channels;
+}
+
+/// @brief Pearson correlation coefficient between every pair of channels
+/// @param out_matrix Output matrix, row-major (channels x channels)
+template <typename T, typename Acc>
+void SignalBankT<T, Acc>::GetCorrelationMatrix(double *out_matrix)
+{
+    if (out_matrix == nullptr)
+        return;
+    int n = this->num_channels;
+    int length = this->GetAnalysisWindow();
+    Acc *means = (Acc *)malloc((size_t)n * sizeof(Acc));
+    if (means == nullptr)
+        return;
+    for (int ch = 0; ch < n; ++ch)
+        means[ch] = (Acc)this->Channel(ch).GetMean();
+
+    for (int a = 0; a < n; ++a)
     {
-        delete[] dataset->labels;
-        dataset->labels = nullptr;
+        const T *x = this->GetChannelData(a);
+        for (int b = a; b < n; ++b)
+        {
+            const T *y = this->GetChannelData(b);
+            Acc sxy = 0;
+            Acc sxx = 0;
+            Acc syy = 0;
+            for (int i = 0; i < length; ++i)
+            {
+                Acc dx = x[i] - means[a];
+                Acc dy = y[i] - means[b];
+                sxy += dx * dy;
+                sxx += dx * dx;
+                syy += dy * dy;
+            }
+            double denominator = sqrt((double)sxx * (double)syy);
+            double r = (denominator > 0.0) ? sxy / denominator : 0.0;
+            if (a == b)
+                r = 1.0;
+            out_matrix[a * n + b] = r;
+            out_matrix[b * n + a] = r;
+        }
     }
-    
-    dataset->num_samples = 0;
-    dataset->capacity = 0;
-    dataset->has_labels = false;
+    free(means);
 }
 
-/// @brief Adds feature vector to dataset
-/// @param dataset Dataset to add to
-/// @param features Features to add
-/// @param label Optional label
-/// @return true if successful
-bool SignalProcessing::AddFeaturesToDataset(MLDataset *dataset, MLFeatureVector *features, int label)
+// ========== MEMORY-MAPPED SIGNAL FILE IMPLEMENTATION ==========
+
+/// @brief Sample type code written in the header of a signal file
+template <typename T>
+static inline unsigned int SignalFileType();
+template <>
+inline unsigned int SignalFileType<double>()
 {
-    if (dataset == nullptr || features == nullptr || dataset->samples == nullptr)
+    return SIGNALFILE_DOUBLE;
+}
+template <>
+inline unsigned int SignalFileType<float>()
+{
+    return SIGNALFILE_FLOAT;
+}
+template <>
+inline unsigned int SignalFileType<int16_t>()
+{
+    return SIGNALFILE_INT16;
+}
+
+/// @brief Signal files are little-endian, they are only read and written natively
+static inline bool HostIsLittleEndian()
+{
+    const unsigned int one = 1;
+    return *(const unsigned char *)&one == 1;
+}
+
+/// @brief Creates an object with no file open
+template <typename T, typename Acc>
+SignalFileT<T, Acc>::SignalFileT()
+    : SignalProcessingT<T, Acc>(nullptr, 0)
+{
+    this->mapping = nullptr;
+    this->mapping_size = 0;
+    this->map_handle = nullptr;
+    this->samples = nullptr;
+    this->num_samples = 0;
+    this->sample_rate = 0.0;
+    this->t0_ns = 0;
+    this->range_start = 0;
+}
+
+/// @brief Creates an object and opens a signal file
+/// @param path File to map
+template <typename T, typename Acc>
+SignalFileT<T, Acc>::SignalFileT(const char *path)
+    : SignalFileT()
+{
+    this->Open(path);
+}
+
+/// @brief SignalFileT destructor
+template <typename T, typename Acc>
+SignalFileT<T, Acc>::~SignalFileT()
+{
+    this->Close();
+}
+
+/// @brief Maps a signal file and selects all of its samples
+/// @param path File to map
+/// @return true on success
+template <typename T, typename Acc>
+bool SignalFileT<T, Acc>::Open(const char *path)
+{
+    this->Close();
+    if (path == nullptr || !HostIsLittleEndian())
     {
         return false;
     }
-    
-    if (dataset->num_samples >= dataset->capacity)
+
+#ifdef WINDOWS
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
     {
-        return false;  // Dataset is full
+        return false;
     }
-    
-    // Copy feature vector
-    dataset->samples[dataset->num_samples] = *features;
-    
-    // Add label if present
-    if (dataset->has_labels && dataset->labels != nullptr)
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < (LONGLONG)sizeof(SignalFileHeader))
     {
-        dataset->labels[dataset->num_samples] = label;
+        CloseHandle(file);
+        return false;
     }
-    
-    dataset->num_samples++;
-    return true;
-}
-
-/// @brief Computes training statistics from dataset
-/// @param dataset Dataset to analyze
-/// @param stats Output statistics
-/// @return true if successful
-bool SignalProcessing::ComputeTrainingStats(MLDataset *dataset, MLTrainingStats *stats)
-{
-    if (dataset == nullptr || stats == nullptr || dataset->num_samples == 0)
+    HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (map == NULL)
     {
         return false;
     }
-    
-    double temp_array[21];
-    
-    // Initialize accumulators
-    for (int f = 0; f < 21; f++)
+    void *view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL)
     {
-        stats->mean_values[f] = 0.0;
-        stats->min_values[f] = 1e100;
-        stats->max_values[f] = -1e100;
+        CloseHandle(map);
+        return false;
     }
-    
-    // First pass: compute mean, min, max
-    for (int i = 0; i < dataset->num_samples; i++)
+    this->mapping = view;
+    this->map_handle = map;
+    this->mapping_size = (size_t)file_size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
     {
-        SignalProcessing::ExportFeaturesToArray(&dataset->samples[i], temp_array);
-        
-        for (int f = 0; f < 21; f++)
-        {
-            stats->mean_values[f] += temp_array[f];
-            if (temp_array[f] < stats->min_values[f])
-            {
-                stats->min_values[f] = temp_array[f];
-            }
-            if (temp_array[f] > stats->max_values[f])
-            {
-                stats->max_values[f] = temp_array[f];
-            }
-        }
+        return false;
     }
-    
-    // Compute mean
-    for (int f = 0; f < 21; f++)
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(SignalFileHeader))
     {
-        stats->mean_values[f] /= dataset->num_samples;
-        stats->std_values[f] = 0.0;
+        close(fd);
+        return false;
     }
-    
-    // Second pass: compute standard deviation
-    for (int i = 0; i < dataset->num_samples; i++)
+    void *view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
     {
-        SignalProcessing::ExportFeaturesToArray(&dataset->samples[i], temp_array);
-        
-        for (int f = 0; f < 21; f++)
-        {
-            double diff = temp_array[f] - stats->mean_values[f];
-            stats->std_values[f] += diff * diff;
-        }
+        return false;
     }
-    
-    // Finalize standard deviation
-    for (int f = 0; f < 21; f++)
+#ifdef MADV_SEQUENTIAL
+    // whole-recording analyses read front to back: let the kernel read ahead
+    madvise(view, (size_t)info.st_size, MADV_SEQUENTIAL);
+#endif
+    this->mapping = view;
+    this->mapping_size = (size_t)info.st_size;
+#endif
+
+    SignalFileHeader header;
+    memcpy(&header, this->mapping, sizeof(header));
+    if (memcmp(header.magic, SIGNALFILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SIGNALFILE_VERSION ||
+        header.sample_type != SignalFileType<T>() ||
+        header.sample_size != sizeof(T) ||
+        header.header_size < sizeof(SignalFileHeader) ||
+        header.header_size % sizeof(T) != 0 ||
+        header.header_size > this->mapping_size ||
+        header.num_samples < 0 ||
+        header.sample_rate <= 0.0)
     {
-        stats->std_values[f] = sqrt(stats->std_values[f] / dataset->num_samples);
-        
-        // Prevent division by zero in normalization
-        if (stats->std_values[f] < 1e-10)
-        {
-            stats->std_values[f] = 1.0;
-        }
+        this->Close();
+        return false;
     }
-    
-    stats->num_samples = dataset->num_samples;
+
+    // a recording cut short (writer stopped before updating the header) keeps
+    // the samples actually present in the file
+    long long available = (long long)((this->mapping_size - header.header_size) / sizeof(T));
+    this->num_samples = std::min(header.num_samples, available);
+    this->samples = (const T *)((const char *)this->mapping + header.header_size);
+    this->sample_rate = header.sample_rate;
+    this->t0_ns = header.t0_ns;
+    this->SelectRange(0, (int)std::min(this->num_samples, (long long)INT_MAX));
     return true;
 }
 
-/// @brief Normalizes all samples in dataset
-/// @param dataset Dataset to normalize
-/// @param stats Training statistics
-/// @return true if successful
-bool SignalProcessing::NormalizeDataset(MLDataset *dataset, MLTrainingStats *stats)
+/// @brief Unmaps the file
+template <typename T, typename Acc>
+void SignalFileT<T, Acc>::Close()
 {
-    if (dataset == nullptr || stats == nullptr || dataset->num_samples == 0)
+    this->BindView(nullptr, 0);
+    if (this->mapping != nullptr)
     {
-        return false;
+#ifdef WINDOWS
+        UnmapViewOfFile(this->mapping);
+        CloseHandle((HANDLE)this->map_handle);
+#else
+        munmap(this->mapping, this->mapping_size);
+#endif
     }
-    
-    // Normalize each sample
-    for (int i = 0; i < dataset->num_samples; i++)
+    this->mapping = nullptr;
+    this->mapping_size = 0;
+    this->map_handle = nullptr;
+    this->samples = nullptr;
+    this->num_samples = 0;
+    this->sample_rate = 0.0;
+    this->t0_ns = 0;
+    this->range_start = 0;
+}
+
+/// @brief Tells whether a file is mapped
+/// @return true if a file is open
+template <typename T, typename Acc>
+bool SignalFileT<T, Acc>::IsOpen() const
+{
+    return this->mapping != nullptr;
+}
+
+/// @brief Selects the samples analysed by the SignalProcessingT methods
+/// @param first Index of the first sample in the file
+/// @param length Number of samples
+/// @return true on success
+template <typename T, typename Acc>
+bool SignalFileT<T, Acc>::SelectRange(long long first, int length)
+{
+    if (this->mapping == nullptr || first < 0 || length < 0 || first + length > this->num_samples)
     {
-        SignalProcessing::NormalizeMLFeatures(&dataset->samples[i], stats->mean_values, stats->std_values);
+        return false;
     }
-    
+    this->range_start = first;
+    this->BindView(this->samples + first, length);
+    // start of the range computed from t0 so the rounding of the period does
+    // not accumulate over hours of samples
+    long long start_ns = this->t0_ns + llround((double)first * NS_PER_SECOND / this->sample_rate);
+    this->SetUniformSampling(NsToTimespec(start_ns), llround(NS_PER_SECOND / this->sample_rate));
     return true;
 }
 
-/// @brief Exports dataset to CSV file
-/// @param dataset Dataset to export
-/// @param filename Output filename
-/// @param include_labels Include label column
-/// @return true if successful
-bool SignalProcessing::ExportDatasetToCSV(MLDataset *dataset, const char *filename, bool include_labels)
+/// @brief Gets the file index of the first selected sample
+/// @return Index in the file
+template <typename T, typename Acc>
+long long SignalFileT<T, Acc>::GetRangeStart() const
 {
-    if (dataset == nullptr || filename == nullptr || dataset->num_samples == 0)
+    return this->range_start;
+}
+
+/// @brief Gets the number of samples in the file
+/// @return Number of samples
+template <typename T, typename Acc>
+long long SignalFileT<T, Acc>::GetFileSampleCount() const
+{
+    return this->num_samples;
+}
+
+/// @brief Gets the sampling rate stored in the header
+/// @return Sampling rate in Hz
+template <typename T, typename Acc>
+double SignalFileT<T, Acc>::GetSampleRate() const
+{
+    return this->sample_rate;
+}
+
+/// @brief Gets the timestamp of the first sample of the file
+/// @return Timestamp
+template <typename T, typename Acc>
+struct timespec SignalFileT<T, Acc>::GetStartTime() const
+{
+    return NsToTimespec(this->t0_ns);
+}
+
+/// @brief Writes a signal file, replacing any existing file
+/// @param path File to write
+/// @param samples Samples to write
+/// @param count Number of samples
+/// @param sample_rate Sampling rate in Hz
+/// @param t0 Timestamp of the first sample
+/// @return true on success
+template <typename T, typename Acc>
+bool SignalFileT<T, Acc>::WriteFile(const char *path, const T *samples, long long count,
+                                    double sample_rate, struct timespec t0)
+{
+    if (path == nullptr || count < 0 || (count > 0 && samples == nullptr) ||
+        sample_rate <= 0.0 || !HostIsLittleEndian())
     {
         return false;
     }
-    
-    FILE *fp = fopen(filename, "w");
-    if (fp == nullptr)
+    SignalFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SIGNALFILE_MAGIC, sizeof(header.magic));
+    header.version = SIGNALFILE_VERSION;
+    header.sample_type = SignalFileType<T>();
+    header.sample_size = sizeof(T);
+    header.header_size = sizeof(SignalFileHeader);
+    header.sample_rate = sample_rate;
+    header.t0_ns = TimespecToNs(t0);
+    header.num_samples = count;
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
     {
         return false;
     }
-    
-    // Write header
-    fprintf(fp, "mean,std_dev,variance,skewness,kurtosis,rms,peak_to_peak,crest_factor,");
-    fprintf(fp, "dominant_freq,spectral_centroid,spectral_spread,spectral_entropy,");
-    fprintf(fp, "total_power,power_low,power_mid,power_high,");
-    fprintf(fp, "zero_crossing_rate,mean_crossing_rate,energy,autocorr_peak");
-    
-    if (include_labels && dataset->has_labels)
-    {
-        fprintf(fp, ",label");
-    }
-    fprintf(fp, "\n");
-    
-    // Write data
-    double temp_array[21];
-    for (int i = 0; i < dataset->num_samples; i++)
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && count > 0)
     {
-        SignalProcessing::ExportFeaturesToArray(&dataset->samples[i], temp_array);
-        
-        for (int f = 0; f < 21; f++)
-        {
-            fprintf(fp, "%.6f", temp_array[f]);
-            if (f < 20)
-            {
-                fprintf(fp, ",");
-            }
-        }
-        
-        if (include_labels && dataset->has_labels)
-        {
-            fprintf(fp, ",%d", dataset->labels[i]);
-        }
-        fprintf(fp, "\n");
+        ok = fwrite(samples, sizeof(T), (size_t)count, file) == (size_t)count;
     }
-    
-    fclose(fp);
-    return true;
+    return fclose(file) == 0 && ok;
 }
 
-/// @brief Extracts features using rolling window
-/// @param window_size Size of each window
-/// @param step_size Step between windows
-/// @param sampling_rate Sampling rate in Hz
-/// @param dataset Output dataset
-/// @return Number of windows processed
-int SignalProcessing::ExtractMLFeaturesRollingWindow(int window_size, int step_size, 
-                                                     double sampling_rate, MLDataset *dataset)
+/// @brief Appends samples to a signal file and updates its header
+/// @param path File created by WriteFile()
+/// @param samples Samples to append
+/// @param count Number of samples
+/// @return true on success
+template <typename T, typename Acc>
+bool SignalFileT<T, Acc>::AppendToFile(const char *path, const T *samples, long long count)
 {
-    if (dataset == nullptr || window_size <= 0 || step_size <= 0)
+    if (path == nullptr || count < 0 || (count > 0 && samples == nullptr))
     {
-        return 0;
+        return false;
     }
-    
-    if (window_size > this->index)
+    FILE *file = fopen(path, "r+b");
+    if (file == NULL)
     {
-        return 0;  // Not enough data
+        return false;
     }
-    
-    int num_windows = 0;
-    int start_idx = 0;
-    
-    while (start_idx + window_size <= this->index)
+    SignalFileHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              memcmp(header.magic, SIGNALFILE_MAGIC, sizeof(header.magic)) == 0 &&
+              header.sample_type == SignalFileType<T>();
+    // samples go right after the last counted one, overwriting a partial tail
+    long long offset = (long long)header.header_size + header.num_samples * (long long)sizeof(T);
+#ifdef WINDOWS
+    ok = ok && _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+    ok = ok && fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+    ok = ok && (count == 0 || fwrite(samples, sizeof(T), (size_t)count, file) == (size_t)count);
+    if (ok)
     {
-        // Check if dataset has capacity
-        if (dataset->num_samples >= dataset->capacity)
-        {
-            break;  // Dataset is full
-        }
-        
-        MLFeatureVector features;
-        bool success = this->ExtractMLFeaturesFromSegment(start_idx, window_size, 
-                                                          sampling_rate, &features);
-        
-        if (success)
-        {
-            SignalProcessing::AddFeaturesToDataset(dataset, &features, -1);
-            num_windows++;
-        }
-        
-        start_idx += step_size;
+        // the count is updated last so readers never see samples not yet written
+        fflush(file);
+        header.num_samples += count;
+        ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
     }
-    
-    return num_windows;
+    return fclose(file) == 0 && ok;
 }
 
-/// @brief Batch feature extraction from multiple signals
-/// @param signals Array of signal arrays
-/// @param signal_sizes Array of signal sizes
-/// @param num_signals Number of signals
-/// @param sampling_rate Sampling rate in Hz
-/// @param dataset Output dataset
-/// @return Number of signals processed
-int SignalProcessing::BatchExtractFeatures(double **signals, int *signal_sizes, int num_signals,
-                                          double sampling_rate, MLDataset *dataset)
+// ========== STREAMING SPECTROGRAM IMPLEMENTATION ==========
+
+/// @brief SpectrogramT constructor
+/// @param window_size Samples per frame (>= 2)
+/// @param hop_size Samples between frames (>= 1)
+/// @param max_frames Rows of the frame matrix
+/// @param window_type Window function
+/// @param output Values of a frame
+/// @param matrix Caller memory for the frames, nullptr to allocate
+template <typename T, typename Acc>
+SpectrogramT<T, Acc>::SpectrogramT(int window_size, int hop_size, int max_frames, int window_type, int output,
+                                   Acc *matrix)
 {
-    if (signals == nullptr || signal_sizes == nullptr || dataset == nullptr || num_signals <= 0)
+    this->window_size = window_size;
+    this->hop_size = hop_size;
+    this->num_bins = window_size / 2 + 1;
+    this->max_frames = max_frames;
+    this->output = output;
+    this->plan = nullptr;
+    this->window = nullptr;
+    this->input = nullptr;
+    this->real = nullptr;
+    this->imag = nullptr;
+    this->scratch = nullptr;
+    this->matrix = matrix;
+    this->owns_matrix = false;
+    this->frame_start = nullptr;
+    this->Reset();
+    this->signal_total = 0;
+    if (window_size < 2 || hop_size < 1 || max_frames < 1 || output < SPECTROGRAM_MAGNITUDE ||
+        output > SPECTROGRAM_DB)
     {
-        return 0;
+        return;
     }
-    
-    int num_processed = 0;
-    
-    for (int s = 0; s < num_signals; s++)
+
+    // everything a frame needs is set up here, once
+    this->plan = FFTPlan::Get(window_size, 1);
+    if (this->plan == nullptr)
     {
-        // Check if dataset has capacity
-        if (dataset->num_samples >= dataset->capacity)
-        {
-            break;  // Dataset is full
-        }
-        
-        // Create temporary SignalProcessing object for this signal
-        SignalProcessing sp;
-        for (int i = 0; i < signal_sizes[s]; i++)
-        {
-            sp.AddValue(signals[s][i]);
-        }
-        
-        // Extract features
-        MLFeatureVector features;
-        bool success = sp.ExtractMLFeatures(sampling_rate, &features);
-        
-        if (success)
-        {
-            SignalProcessing::AddFeaturesToDataset(dataset, &features, -1);
-            num_processed++;
-        }
+        return;
     }
-    
-    return num_processed;
+    const SignalWindow *table = SignalWindow::Get(window_type, window_size);
+    if (table != nullptr)
+    {
+        this->window = SignalWindowValues<Acc>(table);
+    }
+    this->input = (Acc *)calloc(window_size, sizeof(Acc));
+    this->real = (Acc *)malloc(window_size * sizeof(Acc));
+    this->imag = (Acc *)malloc(this->num_bins * sizeof(Acc));
+    if (this->plan->GetScratchSize() > 0)
+    {
+        this->scratch = (Acc *)malloc(this->plan->GetScratchSize() * sizeof(Acc));
+    }
+    if (this->matrix == nullptr)
+    {
+        this->matrix = (Acc *)calloc((size_t)max_frames * this->num_bins, sizeof(Acc));
+        this->owns_matrix = true;
+    }
+    this->frame_start = (long long *)malloc(max_frames * sizeof(long long));
 }
 
-// ========== HDF5 EXPORT FOR ML/AI IMPLEMENTATION ==========
+/// @brief SpectrogramT destructor
+template <typename T, typename Acc>
+SpectrogramT<T, Acc>::~SpectrogramT()
+{
+    free(this->input);
+    free(this->real);
+    free(this->imag);
+    free(this->scratch);
+    if (this->owns_matrix)
+    {
+        free(this->matrix);
+    }
+    free(this->frame_start);
+}
 
-#ifdef USE_HDF5
-// Full HDF5 implementation when library is available
+/// @brief Checks that the parameters were valid and the buffers allocated
+/// @return true if the spectrogram can be used
+template <typename T, typename Acc>
+bool SpectrogramT<T, Acc>::IsValid() const
+{
+    return this->plan != nullptr && this->window != nullptr && this->input != nullptr && this->real != nullptr &&
+           this->imag != nullptr && (this->scratch != nullptr || this->plan->GetScratchSize() == 0) &&
+           this->matrix != nullptr && this->frame_start != nullptr;
+}
 
-/// @brief Exports ML dataset to HDF5 file
-/// @param dataset Dataset to export
-/// @param filename Output HDF5 filename
-/// @param include_labels Include labels dataset
-/// @param path HDF5 group path
-/// @return true if successful
-bool SignalProcessing::ExportDatasetToH5(MLDataset *dataset, const char *filename, 
-                                        bool include_labels, const char *path)
+/// @brief Gets the number of samples per frame
+/// @return Window size
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::GetWindowSize() const
 {
-    if (dataset == nullptr || filename == nullptr || dataset->num_samples == 0)
+    return this->window_size;
+}
+
+/// @brief Gets the number of samples between frames
+/// @return Hop size
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::GetHopSize() const
+{
+    return this->hop_size;
+}
+
+/// @brief Gets the number of values per frame
+/// @return window_size / 2 + 1
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::GetNumBins() const
+{
+    return this->num_bins;
+}
+
+/// @brief Gets the number of rows of the frame matrix
+/// @return Maximum number of stored frames
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::GetMaxFrames() const
+{
+    return this->max_frames;
+}
+
+/// @brief Gets the number of stored frames
+/// @return Number of frames
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::GetFrameCount() const
+{
+    return this->frame_count;
+}
+
+/// @brief Gets the number of frames computed since construction or Reset()
+/// @return Total number of frames
+template <typename T, typename Acc>
+long long SpectrogramT<T, Acc>::GetTotalFrames() const
+{
+    return this->total_frames;
+}
+
+/// @brief Gets the number of samples consumed since construction or Reset()
+/// @return Sample count
+template <typename T, typename Acc>
+long long SpectrogramT<T, Acc>::GetSampleCount() const
+{
+    return this->sample_count;
+}
+
+/// @brief Removes the stored frames and the pending input
+template <typename T, typename Acc>
+void SpectrogramT<T, Acc>::Reset()
+{
+    this->input_pos = 0;
+    this->until_frame = this->window_size;
+    this->newest_row = -1;
+    this->frame_count = 0;
+    this->total_frames = 0;
+    this->sample_count = 0;
+}
+
+/// @brief Adds one sample
+/// @param value Sample
+/// @return Number of frames computed
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::AddValue(T value)
+{
+    return this->AddValues(&value, 1);
+}
+
+/// @brief Adds a block of samples
+/// @param values Samples, oldest first
+/// @param n Number of samples
+/// @return Number of frames computed
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::AddValues(const T *values, int n)
+{
+    if (!this->IsValid() || values == nullptr || n < 1)
     {
-        return false;
+        return 0;
     }
-    
-    try
+
+    int frames = 0;
+    while (n > 0)
     {
-        SignalRecorder recorder(filename);
-        
-        // Prepare feature names
-        const char* feature_names[21] = {
-            "mean", "std_dev", "variance", "skewness", "kurtosis", 
-            "rms", "peak_to_peak", "crest_factor",
-            "dominant_freq", "spectral_centroid", "spectral_spread", "spectral_entropy",
-            "total_power", "power_low_freq", "power_mid_freq", "power_high_freq",
-            "zero_crossing_rate", "mean_crossing_rate", "energy", "autocorr_peak"
-        };
-        
-        // Create feature matrix (21 x num_samples)
-        std::vector<std::vector<double>> feature_matrix(21);
-        for (int f = 0; f < 21; f++)
+        // up to the next frame or the end of the input ring, whichever comes first
+        int chunk = n;
+        if (chunk > this->until_frame)
         {
-            feature_matrix[f].resize(dataset->num_samples);
+            chunk = this->until_frame;
         }
-        
-        // Fill feature matrix
-        double temp_array[21];
-        for (int i = 0; i < dataset->num_samples; i++)
+        if (chunk > this->window_size - this->input_pos)
         {
-            SignalProcessing::ExportFeaturesToArray(&dataset->samples[i], temp_array);
-            for (int f = 0; f < 21; f++)
-            {
-                feature_matrix[f][i] = temp_array[f];
-            }
+            chunk = this->window_size - this->input_pos;
+        }
+        Acc *dst = this->input + this->input_pos;
+        for (int i = 0; i < chunk; ++i)
+        {
+            dst[i] = (Acc)values[i];
         }
-        
-        // Save each feature as a separate dataset
-        for (int f = 0; f < 21; f++)
+        values += chunk;
+        n -= chunk;
+        this->input_pos += chunk;
+        if (this->input_pos == this->window_size)
         {
-            recorder.addDoubleVector(path, feature_names[f], feature_matrix[f]);
+            this->input_pos = 0;
         }
-        
-        // Save labels if present
-        if (include_labels && dataset->has_labels && dataset->labels != nullptr)
+        this->until_frame -= chunk;
+        this->sample_count += chunk;
+        if (this->until_frame == 0)
         {
-            std::vector<double> labels_double(dataset->num_samples);
-            for (int i = 0; i < dataset->num_samples; i++)
-            {
-                labels_double[i] = (double)dataset->labels[i];
-            }
-            recorder.addDoubleVector(path, "labels", labels_double);
+            this->ComputeFrame();
+            this->until_frame = this->hop_size;
+            frames++;
         }
-        
-        // Add metadata
-        char metadata[256];
-        sprintf(metadata, "%d", dataset->num_samples);
-        recorder.addMetadata(path, "num_samples", metadata);
-        sprintf(metadata, "%d", 21);
-        recorder.addMetadata(path, "num_features", metadata);
-        sprintf(metadata, "%s", dataset->has_labels ? "true" : "false");
-        recorder.addMetadata(path, "has_labels", metadata);
-        
-        // Add timestamp
-        time_t now = time(nullptr);
-        char timestamp[256];
-        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-        recorder.addMetadata(path, "export_timestamp", timestamp);
-        
-        return true;
     }
-    catch (...)
+    return frames;
+}
+
+/// @brief Adds the samples added to a signal since the previous Update()
+/// @param signal Signal ring buffer
+/// @return Number of frames computed
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::Update(SignalProcessingT<T, Acc> *signal)
+{
+    if (signal == nullptr)
     {
-        return false;
+        return 0;
+    }
+    long long total = signal->GetTotalCount();
+    long long fresh = total - this->signal_total;
+    if (fresh < 0)
+    {
+        // the signal was cleared
+        fresh = total;
+    }
+    this->signal_total = total;
+    if (fresh > signal->count)
+    {
+        // overwritten before they were read: the next frame starts after the gap
+        this->sample_count += fresh - signal->count;
+        this->until_frame = this->window_size;
+        fresh = signal->count;
     }
+    // the newest samples are contiguous in the mirrored ring buffer
+    const T *newest = signal->WindowData() + signal->WindowSize();
+    return this->AddValues(newest - fresh, (int)fresh);
 }
 
-/// @brief Exports training statistics to HDF5
-/// @param stats Training statistics
-/// @param filename Output HDF5 filename
-/// @param path HDF5 group path
-/// @return true if successful
-bool SignalProcessing::ExportTrainingStatsToH5(MLTrainingStats *stats, const char *filename,
-                                              const char *path)
+/// @brief Gets the matrix row of a stored frame
+/// @param index 0 for the oldest stored frame
+/// @return Row
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::Row(int index) const
 {
-    if (stats == nullptr || filename == nullptr)
+    int row = this->newest_row - (this->frame_count - 1) + index;
+    return (row < 0) ? (row + this->max_frames) : row;
+}
+
+/// @brief Gets a stored frame
+/// @param index 0 for the oldest stored frame
+/// @return Frame values, nullptr if index is out of range
+template <typename T, typename Acc>
+const Acc *SpectrogramT<T, Acc>::GetFrame(int index) const
+{
+    if (index < 0 || index >= this->frame_count)
     {
-        return false;
+        return nullptr;
     }
-    
-    try
+    return this->matrix + (size_t)this->Row(index) * this->num_bins;
+}
+
+/// @brief Gets the first sample of a stored frame
+/// @param index 0 for the oldest stored frame
+/// @return Sample number, -1 if index is out of range
+template <typename T, typename Acc>
+long long SpectrogramT<T, Acc>::GetFrameStart(int index) const
+{
+    if (index < 0 || index >= this->frame_count)
     {
-        SignalRecorder recorder(filename);
-        
-        // Convert arrays to vectors
-        std::vector<double> mean_vec(stats->mean_values, stats->mean_values + 21);
-        std::vector<double> std_vec(stats->std_values, stats->std_values + 21);
-        std::vector<double> min_vec(stats->min_values, stats->min_values + 21);
-        std::vector<double> max_vec(stats->max_values, stats->max_values + 21);
-        
-        // Save statistics
-        recorder.addDoubleVector(path, "mean_values", mean_vec);
-        recorder.addDoubleVector(path, "std_values", std_vec);
-        recorder.addDoubleVector(path, "min_values", min_vec);
-        recorder.addDoubleVector(path, "max_values", max_vec);
-        
-        // Add metadata
-        char metadata[256];
-        sprintf(metadata, "%d", stats->num_samples);
-        recorder.addMetadata(path, "num_training_samples", metadata);
-        sprintf(metadata, "%d", 21);
-        recorder.addMetadata(path, "num_features", metadata);
-        
-        // Add timestamp
-        time_t now = time(nullptr);
-        char timestamp[256];
-        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-        recorder.addMetadata(path, "creation_timestamp", timestamp);
-        
-        return true;
+        return -1;
     }
-    catch (...)
+    return this->frame_start[this->Row(index)];
+}
+
+/// @brief Copies the newest stored frames in time order
+/// @param out Output matrix
+/// @param max_frames Number of rows of out
+/// @return Number of rows written
+template <typename T, typename Acc>
+int SpectrogramT<T, Acc>::CopyFrames(Acc *out, int max_frames) const
+{
+    if (out == nullptr || max_frames < 1)
     {
-        return false;
+        return 0;
+    }
+    int frames = (this->frame_count < max_frames) ? this->frame_count : max_frames;
+    int first = this->frame_count - frames;
+    for (int f = 0; f < frames; ++f)
+    {
+        memcpy(out + (size_t)f * this->num_bins, this->GetFrame(first + f), this->num_bins * sizeof(Acc));
     }
+    return frames;
 }
 
-/// @brief Exports feature vector and optionally raw signal to HDF5
-/// @param filename Output HDF5 filename
-/// @param features Feature vector to export
-/// @param path HDF5 group path
-/// @param save_raw_signal If true, also saves raw signal
-/// @return true if successful
-bool SignalProcessing::ExportMLFeaturesToH5(const char *filename, MLFeatureVector *features,
-                                           const char *path, bool save_raw_signal)
+/// @brief Transforms the newest window_size samples into the next row of the matrix
+template <typename T, typename Acc>
+void SpectrogramT<T, Acc>::ComputeFrame()
 {
-    if (filename == nullptr || features == nullptr)
+    // the oldest sample of the window is the next one to be overwritten
+    int first = this->window_size - this->input_pos;
+    const Acc *oldest = this->input + this->input_pos;
+    for (int i = 0; i < first; ++i)
     {
-        return false;
+        this->real[i] = oldest[i] * this->window[i];
     }
-    
-    try
+    for (int i = first; i < this->window_size; ++i)
     {
-        SignalRecorder recorder(filename);
-        
-        // Export features to array
-        double feature_array[21];
-        SignalProcessing::ExportFeaturesToArray(features, feature_array);
-        
-        // Create feature vector
-        std::vector<double> feature_vec(feature_array, feature_array + 21);
-        
-        // Save features
-        recorder.addDoubleVector(path, "features", feature_vec);
-        
-        // Save raw signal if requested
-        if (save_raw_signal && this->index > 0)
+        this->real[i] = this->input[i - first] * this->window[i];
+    }
+    this->plan->ExecuteReal(this->real, this->real, this->imag, this->scratch);
+
+    this->newest_row = (this->newest_row + 1 == this->max_frames) ? 0 : this->newest_row + 1;
+    Acc *row = this->matrix + (size_t)this->newest_row * this->num_bins;
+    for (int k = 0; k < this->num_bins; ++k)
+    {
+        Acc power = this->real[k] * this->real[k] + this->imag[k] * this->imag[k];
+        if (this->output == SPECTROGRAM_MAGNITUDE)
         {
-            std::vector<double> signal_vec(this->SignalVector, 
-                                          this->SignalVector + this->index);
-            recorder.addDoubleVector(path, "raw_signal", signal_vec, "signal_units");
-            
-            char metadata[256];
-            sprintf(metadata, "%d", this->index);
-            recorder.addMetadata(path, "num_samples", metadata);
+            row[k] = sqrt(power);
         }
-        
-        // Add feature names as metadata
-        const char* feature_names[21] = {
-            "mean", "std_dev", "variance", "skewness", "kurtosis", 
-            "rms", "peak_to_peak", "crest_factor",
-            "dominant_freq", "spectral_centroid", "spectral_spread", "spectral_entropy",
-            "total_power", "power_low_freq", "power_mid_freq", "power_high_freq",
-            "zero_crossing_rate", "mean_crossing_rate", "energy", "autocorr_peak"
-        };
-        
-        // Save feature names as individual metadata entries
-        for (int i = 0; i < 21; i++)
+        else if (this->output == SPECTROGRAM_POWER)
         {
-            char key[64];
-            sprintf(key, "feature_%d_name", i);
-            recorder.addMetadata(path, key, feature_names[i]);
+            row[k] = power;
+        }
+        else
+        {
+            row[k] = (power > 0) ? (Acc)fmax(10.0 * log10((double)power), SPECTROGRAM_DB_FLOOR) : (Acc)SPECTROGRAM_DB_FLOOR;
         }
-        
-        // Add timestamp
-        time_t now = time(nullptr);
-        char timestamp[256];
-        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-        recorder.addMetadata(path, "export_timestamp", timestamp);
-        
-        return true;
     }
-    catch (...)
+    this->frame_start[this->newest_row] = this->sample_count - this->window_size;
+    if (this->frame_count < this->max_frames)
     {
-        return false;
+        this->frame_count++;
     }
+    this->total_frames++;
 }
 
-#else // USE_HDF5 not defined - provide stub implementations
+// ========== TONE TRACKER IMPLEMENTATION ==========
 
-/// @brief Stub implementation when HDF5 is not available
-bool SignalProcessing::ExportDatasetToH5(MLDataset *dataset, const char *filename, 
-                                        bool include_labels, const char *path)
+/// @brief ToneTrackerT constructor
+/// @param sampling_rate Sampling rate in Hz
+/// @param window_size Samples per DFT
+/// @param max_tones Maximum number of tones
+/// @param window_type SIGNAL_WINDOW_RECTANGULAR or SIGNAL_WINDOW_HANN
+template <typename T, typename Acc>
+ToneTrackerT<T, Acc>::ToneTrackerT(double sampling_rate, int window_size, int max_tones, int window_type)
 {
-    (void)dataset; (void)filename; (void)include_labels; (void)path;
-    // HDF5 support not compiled in - define USE_HDF5 and link with HDF5 library
-    return false;
+    this->sampling_rate = sampling_rate;
+    this->window_size = window_size;
+    this->max_tones = max_tones;
+    this->num_tones = 0;
+    this->bins_per_tone = (window_type == SIGNAL_WINDOW_HANN) ? 3 : 1;
+    this->frequencies = nullptr;
+    this->bins = nullptr;
+    this->history = nullptr;
+    this->history_pos = 0;
+    this->windows_since_resync = 0;
+    this->sample_count = 0;
+    this->signal_total = 0;
+    if (sampling_rate <= 0 || window_size < 2 || max_tones < 1 ||
+        (window_type != SIGNAL_WINDOW_RECTANGULAR && window_type != SIGNAL_WINDOW_HANN))
+    {
+        return;
+    }
+    this->frequencies = (double *)calloc(max_tones, sizeof(double));
+    this->bins = (SlidingBin *)calloc((size_t)max_tones * this->bins_per_tone, sizeof(SlidingBin));
+    this->history = (Acc *)calloc(window_size, sizeof(Acc));
 }
 
-/// @brief Stub implementation when HDF5 is not available
-bool SignalProcessing::ExportTrainingStatsToH5(MLTrainingStats *stats, const char *filename,
-                                              const char *path)
+/// @brief ToneTrackerT destructor
+template <typename T, typename Acc>
+ToneTrackerT<T, Acc>::~ToneTrackerT()
 {
-    (void)stats; (void)filename; (void)path;
-    // HDF5 support not compiled in - define USE_HDF5 and link with HDF5 library
-    return false;
+    free(this->frequencies);
+    free(this->bins);
+    free(this->history);
 }
 
-/// @brief Stub  implementation when HDF5 is not available
-bool SignalProcessing::ExportMLFeaturesToH5(const char *filename, MLFeatureVector *features,
-                                           const char *path, bool save_raw_signal)
+/// @brief Checks that the parameters were valid and the buffers allocated
+/// @return true if the tracker can be used
+template <typename T, typename Acc>
+bool ToneTrackerT<T, Acc>::IsValid() const
 {
-    (void)filename; (void)features; (void)path; (void)save_raw_signal;
-    // HDF5 support not compiled in - define USE_HDF5 and link with HDF5 library
-    return false;
+    return this->frequencies != nullptr && this->bins != nullptr && this->history != nullptr;
 }
 
-#endif // USE_HDF5
+/// @brief Gets the number of samples per DFT
+/// @return Window size
+template <typename T, typename Acc>
+int ToneTrackerT<T, Acc>::GetWindowSize() const
+{
+    return this->window_size;
+}
 
-// ========== DECIMATION AND INTERPOLATION IMPLEMENTATION ==========
+/// @brief Gets the number of tracked tones
+/// @return Number of tones
+template <typename T, typename Acc>
+int ToneTrackerT<T, Acc>::GetNumTones() const
+{
+    return this->num_tones;
+}
 
-/// @brief Decimates signal by factor (downsampling)
-/// @param factor Decimation factor
-/// @param out_vector Output array
-/// @param apply_antialiasing Apply low-pass filter before decimation
-/// @return Number of output samples
-int SignalProcessing::Decimate(int factor, double *out_vector, bool apply_antialiasing)
+/// @brief Gets the number of samples added since construction or Reset()
+/// @return Sample count
+template <typename T, typename Acc>
+long long ToneTrackerT<T, Acc>::GetSampleCount() const
+{
+    return this->sample_count;
+}
+
+/// @brief Removes the samples, keeps the tones
+template <typename T, typename Acc>
+void ToneTrackerT<T, Acc>::Reset()
 {
-    if (out_vector == nullptr || factor < 1 || this->index < factor)
+    if (!this->IsValid())
     {
-        return 0;
+        return;
     }
-    
-    double *temp_signal = this->SignalVector;
-    double filtered[NB_MAX_VALUES];
-    
-    // Apply anti-aliasing filter if requested
-    if (apply_antialiasing && factor > 1)
+    memset(this->history, 0, this->window_size * sizeof(Acc));
+    this->history_pos = 0;
+    this->windows_since_resync = 0;
+    this->sample_count = 0;
+    this->Resync(0, this->num_tones * this->bins_per_tone);
+}
+
+/// @brief Sets the frequency of a tone and recomputes its sums
+/// @param tone Index of the tone
+/// @param frequency Frequency in Hz
+template <typename T, typename Acc>
+void ToneTrackerT<T, Acc>::Retune(int tone, double frequency)
+{
+    this->frequencies[tone] = frequency;
+    double nu = 2.0 * M_PI * frequency / this->sampling_rate;
+    for (int b = 0; b < this->bins_per_tone; ++b)
     {
-        // Use moving average as low-pass filter
-        // Window size = factor to prevent aliasing
-        int window = factor;
-        for (int i = 0; i < this->index; i++)
+        // Hann: neighbours one bin below and above
+        double bin_nu = nu + (b - (this->bins_per_tone - 1) / 2) * 2.0 * M_PI / this->window_size;
+        SlidingBin *bin = &this->bins[tone * this->bins_per_tone + b];
+        bin->rotate_real = cos(bin_nu);
+        bin->rotate_imag = sin(bin_nu);
+        bin->newest_real = cos(bin_nu * (this->window_size - 1));
+        bin->newest_imag = -sin(bin_nu * (this->window_size - 1));
+    }
+    this->Resync(tone * this->bins_per_tone, this->bins_per_tone);
+}
+
+/// @brief Recomputes sliding sums from the history
+/// @param first_bin First sliding bin
+/// @param num_bins Number of sliding bins
+template <typename T, typename Acc>
+void ToneTrackerT<T, Acc>::Resync(int first_bin, int num_bins)
+{
+    for (int b = first_bin; b < first_bin + num_bins; ++b)
+    {
+        SlidingBin *bin = &this->bins[b];
+        double sum_real = 0.0, sum_imag = 0.0;
+        double rot_real = 1.0, rot_imag = 0.0;
+        int pos = this->history_pos;
+        for (int m = 0; m < this->window_size; ++m)
         {
-            double sum = 0.0;
-            int count = 0;
-            int start = (i - window/2 < 0) ? 0 : i - window/2;
-            int end = (i + window/2 >= this->index) ? this->index - 1 : i + window/2;
-            
-            for (int j = start; j <= end; j++)
+            double x = (double)this->history[pos];
+            sum_real += x * rot_real;
+            sum_imag += x * rot_imag;
+            // rot = exp(-i nu m)
+            double next_real = rot_real * bin->rotate_real + rot_imag * bin->rotate_imag;
+            rot_imag = rot_imag * bin->rotate_real - rot_real * bin->rotate_imag;
+            rot_real = next_real;
+            if (++pos == this->window_size)
             {
-                sum += this->SignalVector[j];
-                count++;
+                pos = 0;
             }
-            filtered[i] = sum / count;
         }
-        temp_signal = filtered;
+        bin->sum_real = sum_real;
+        bin->sum_imag = sum_imag;
     }
-    
-    // Decimate by keeping every Nth sample
-    int out_index = 0;
-    for (int i = 0; i < this->index; i += factor)
+}
+
+/// @brief Adds a tone
+/// @param frequency Frequency in Hz
+/// @return Index of the tone, -1 on failure
+template <typename T, typename Acc>
+int ToneTrackerT<T, Acc>::AddTone(double frequency)
+{
+    if (!this->IsValid() || this->num_tones >= this->max_tones || frequency < 0 ||
+        frequency > this->sampling_rate / 2.0)
     {
-        out_vector[out_index++] = temp_signal[i];
+        return -1;
     }
-    
-    return out_index;
+    this->Retune(this->num_tones, frequency);
+    return this->num_tones++;
 }
 
-/// @brief Interpolates signal using linear interpolation
-/// @param factor Interpolation factor
-/// @param out_vector Output array
-/// @return Number of output samples
-int SignalProcessing::InterpolateLinear(int factor, double *out_vector)
+/// @brief Retunes a tone
+/// @param tone Index of the tone
+/// @param frequency Frequency in Hz
+/// @return true on success
+template <typename T, typename Acc>
+bool ToneTrackerT<T, Acc>::SetFrequency(int tone, double frequency)
+{
+    if (tone < 0 || tone >= this->num_tones || frequency < 0 || frequency > this->sampling_rate / 2.0)
+    {
+        return false;
+    }
+    this->Retune(tone, frequency);
+    return true;
+}
+
+/// @brief Tracks a fundamental and its harmonics
+/// @param fundamental Fundamental frequency in Hz
+/// @param num_harmonics Number of tones
+/// @return Number of tones set
+template <typename T, typename Acc>
+int ToneTrackerT<T, Acc>::SetHarmonics(double fundamental, int num_harmonics)
 {
-    if (out_vector == nullptr || factor < 1 || this->index < 2)
+    if (!this->IsValid() || fundamental <= 0)
     {
         return 0;
     }
-    
-    if (factor == 1)
+    int count = 0;
+    while (count < num_harmonics && count < this->max_tones && (count + 1) * fundamental <= this->sampling_rate / 2.0)
     {
-        // No interpolation needed
-        for (int i = 0; i < this->index; i++)
-        {
-            out_vector[i] = this->SignalVector[i];
-        }
-        return this->index;
+        this->Retune(count, (count + 1) * fundamental);
+        count++;
     }
-    
-    int out_index = 0;
-    
-    // Interpolate between each pair of samples
-    for (int i = 0; i < this->index - 1; i++)
+    this->num_tones = count;
+    return count;
+}
+
+/// @brief Adds one sample
+/// @param value Sample
+template <typename T, typename Acc>
+void ToneTrackerT<T, Acc>::AddValue(T value)
+{
+    this->AddValues(&value, 1);
+}
+
+/// @brief Adds a block of samples
+/// @param values Samples, oldest first
+/// @param n Number of samples
+template <typename T, typename Acc>
+void ToneTrackerT<T, Acc>::AddValues(const T *values, int n)
+{
+    if (!this->IsValid() || values == nullptr)
     {
-        double y0 = this->SignalVector[i];
-        double y1 = this->SignalVector[i + 1];
-        
-        // Insert original sample
-        out_vector[out_index++] = y0;
-        
-        // Insert interpolated samples
-        for (int j = 1; j < factor; j++)
+        return;
+    }
+    int num_bins = this->num_tones * this->bins_per_tone;
+    for (int i = 0; i < n; ++i)
+    {
+        // the stored value is the one subtracted later, so both are rounded alike
+        Acc stored = (Acc)values[i];
+        double x_new = (double)stored;
+        double x_old = (double)this->history[this->history_pos];
+        this->history[this->history_pos] = stored;
+        for (int b = 0; b < num_bins; ++b)
         {
-            double t = (double)j / factor;  // 0 < t < 1
-            out_vector[out_index++] = y0 + t * (y1 - y0);  // Linear interpolation
+            SlidingBin *bin = &this->bins[b];
+            // X' = exp(i nu) (X - x_old) + x_new exp(-i nu (N - 1))
+            double real = bin->sum_real - x_old;
+            double imag = bin->sum_imag;
+            bin->sum_real = real * bin->rotate_real - imag * bin->rotate_imag + x_new * bin->newest_real;
+            bin->sum_imag = real * bin->rotate_imag + imag * bin->rotate_real + x_new * bin->newest_imag;
+        }
+        this->sample_count++;
+        if (++this->history_pos == this->window_size)
+        {
+            this->history_pos = 0;
+            if (++this->windows_since_resync == TONE_TRACKER_RESYNC)
+            {
+                // exact sums again before rounding errors accumulate
+                this->windows_since_resync = 0;
+                this->Resync(0, num_bins);
+            }
         }
     }
-    
-    // Add last sample
-    out_vector[out_index++] = this->SignalVector[this->index - 1];
-    
-    return out_index;
 }
 
-/// @brief Resamples signal to new sampling rate
-/// @param current_rate Current sampling rate in Hz
-/// @param target_rate Target sampling rate in Hz
-/// @param out_vector Output array
-/// @return Number of output samples
-int SignalProcessing::Resample(double current_rate, double target_rate, double *out_vector)
+/// @brief Adds the samples added to a signal since the previous Update()
+/// @param signal Signal ring buffer
+/// @return Number of samples added
+template <typename T, typename Acc>
+int ToneTrackerT<T, Acc>::Update(SignalProcessingT<T, Acc> *signal)
 {
-    if (out_vector == nullptr || current_rate <= 0 || target_rate <= 0)
+    if (signal == nullptr)
     {
         return 0;
     }
-    
-    double ratio = target_rate / current_rate;
-    
-    if (ratio == 1.0)
+    long long total = signal->GetTotalCount();
+    long long fresh = total - this->signal_total;
+    if (fresh < 0)
     {
-        // No resampling needed
-        for (int i = 0; i < this->index; i++)
-        {
-            out_vector[i] = this->SignalVector[i];
-        }
-        return this->index;
+        fresh = total;
     }
-    else if (ratio < 1.0)
+    this->signal_total = total;
+    if (fresh > signal->count)
     {
-        // Downsampling - use decimation
-        int factor = (int)(1.0 / ratio + 0.5);  // Round to nearest integer
-        return this->Decimate(factor, out_vector, true);
+        fresh = signal->count;
     }
-    else
+    const T *newest = signal->WindowData() + signal->WindowSize();
+    this->AddValues(newest - fresh, (int)fresh);
+    return (int)fresh;
+}
+
+/// @brief Windowed DFT of a tone over the newest window_size samples
+/// @param tone Index of the tone
+/// @param real Real part
+/// @param imag Imaginary part
+template <typename T, typename Acc>
+void ToneTrackerT<T, Acc>::Window(int tone, double *real, double *imag) const
+{
+    // Hann (periodic) = 0.5 X(nu) - 0.25 X(nu - 2 pi / N) - 0.25 X(nu + 2 pi / N)
+    static const double hann[3] = {-0.25, 0.5, -0.25};
+    *real = 0.0;
+    *imag = 0.0;
+    for (int b = 0; b < this->bins_per_tone; ++b)
     {
-        // Upsampling - use interpolation
-        int factor = (int)(ratio + 0.5);  // Round to nearest integer
-        return this->InterpolateLinear(factor, out_vector);
+        const SlidingBin *bin = &this->bins[tone * this->bins_per_tone + b];
+        double weight = (this->bins_per_tone == 3) ? hann[b] : 1.0;
+        *real += weight * bin->sum_real;
+        *imag += weight * bin->sum_imag;
     }
 }
 
-// ========== CORRELATION ANALYSIS IMPLEMENTATION ==========
+/// @brief Gets the frequency of a tone
+/// @param tone Index of the tone
+/// @return Frequency in Hz
+template <typename T, typename Acc>
+double ToneTrackerT<T, Acc>::GetFrequency(int tone) const
+{
+    return (tone >= 0 && tone < this->num_tones) ? this->frequencies[tone] : 0.0;
+}
 
-/// @brief Computes autocorrelation of signal
-/// @param max_lag Maximum lag to compute
-/// @param out_correlation Output correlation array
-/// @param normalize Normalize to [-1, 1]
-/// @return Number of correlation values
-int SignalProcessing::Autocorrelation(int max_lag, double *out_correlation, bool normalize)
+/// @brief Gets the DFT magnitude of a tone
+/// @param tone Index of the tone
+/// @return Magnitude
+template <typename T, typename Acc>
+double ToneTrackerT<T, Acc>::GetMagnitude(int tone) const
 {
-    if (out_correlation == nullptr || max_lag < 0 || this->index < 2)
+    if (tone < 0 || tone >= this->num_tones)
     {
-        return 0;
+        return 0.0;
     }
-    
-    // Limit max_lag to signal length
-    if (max_lag >= this->index)
+    double real, imag;
+    this->Window(tone, &real, &imag);
+    return sqrt(real * real + imag * imag);
+}
+
+/// @brief Gets the amplitude of a sinusoid at the tone frequency
+/// @param tone Index of the tone
+/// @return Amplitude
+template <typename T, typename Acc>
+double ToneTrackerT<T, Acc>::GetAmplitude(int tone) const
+{
+    double window_sum = (this->bins_per_tone == 3) ? this->window_size / 2.0 : this->window_size;
+    return 2.0 * this->GetMagnitude(tone) / window_sum;
+}
+
+/// @brief Gets the phase of a tone at the newest sample
+/// @param tone Index of the tone
+/// @return Phase in radians
+template <typename T, typename Acc>
+double ToneTrackerT<T, Acc>::GetPhase(int tone) const
+{
+    if (tone < 0 || tone >= this->num_tones)
     {
-        max_lag = this->index - 1;
+        return 0.0;
     }
-    
-    double mean = this->GetMean();
-    int n = this->index;
-    
-    // Compute autocorrelation for each lag
-    for (int lag = 0; lag <= max_lag; lag++)
+    double real, imag;
+    this->Window(tone, &real, &imag);
+    // from the oldest sample of the window to the newest
+    double nu = 2.0 * M_PI * this->frequencies[tone] / this->sampling_rate;
+    return remainder(atan2(imag, real) + nu * (this->window_size - 1), 2.0 * M_PI);
+}
+
+/// @brief Total harmonic distortion of tones 1.. against tone 0
+/// @return THD
+template <typename T, typename Acc>
+double ToneTrackerT<T, Acc>::GetHarmonicDistortion() const
+{
+    double fundamental = this->GetAmplitude(0);
+    if (fundamental <= 0)
     {
-        double sum = 0.0;
-        int count = n - lag;
-        
-        for (int i = 0; i < count; i++)
-        {
-            sum += (this->SignalVector[i] - mean) * 
-                   (this->SignalVector[i + lag] - mean);
-        }
-        
-        out_correlation[lag] = sum / count;
+        return 0.0;
     }
-    
-    // Normalize if requested
-    if (normalize && out_correlation[0] != 0.0)
+    double harmonics_sum = 0.0;
+    for (int t = 1; t < this->num_tones; ++t)
     {
-        double r0 = out_correlation[0];  // Variance
-        for (int lag = 0; lag <= max_lag; lag++)
-        {
-            out_correlation[lag] /= r0;
-        }
+        double amplitude = this->GetAmplitude(t);
+        harmonics_sum += amplitude * amplitude;
     }
-    
-    return max_lag + 1;
+    return sqrt(harmonics_sum) / fundamental;
 }
 
-/// @brief Computes cross-correlation between two signals
-/// @param signal2 Second signal
-/// @param signal2_size Size of second signal
-/// @param max_lag Maximum lag (positive and negative)
-/// @param out_correlation Output correlation array
-/// @param normalize Normalize to [-1, 1]
-/// @return Number of correlation values
-int SignalProcessing::CrossCorrelation(double *signal2, int signal2_size, int max_lag,
-                                       double *out_correlation, bool normalize)
+// ========== FIR FILTER IMPLEMENTATION ==========
+
+/// @brief Designs a windowed-sinc FIR filter
+/// @param low_hz Lower cutoff in Hz, <= 0 for low-pass
+/// @param high_hz Upper cutoff in Hz, >= sampling_rate / 2 for high-pass
+/// @param sampling_rate Sampling rate in Hz
+/// @param num_taps Number of coefficients
+/// @param coefficients Output coefficients
+/// @param window_type Window function
+/// @return true if successful
+bool SignalDesignFIR(double low_hz, double high_hz, double sampling_rate, int num_taps, double *coefficients,
+                     int window_type)
 {
-    if (out_correlation == nullptr || signal2 == nullptr || 
-        max_lag < 0 || this->index < 1 || signal2_size < 1)
+    if (coefficients == nullptr || num_taps < 1 || sampling_rate <= 0)
+        return false;
+    double nyquist = sampling_rate / 2.0;
+    bool low_pass = low_hz <= 0;
+    bool high_pass = high_hz >= nyquist;
+    if ((low_pass && high_pass) || (!low_pass && !high_pass && low_hz >= high_hz) || (high_pass && num_taps % 2 == 0))
+        return false;
+    const SignalWindow *window = SignalWindow::Get(window_type, num_taps);
+    if (window == nullptr)
+        return false;
+
+    // ideal band-pass: difference of two low-pass responses, cutoffs in cycles per sample
+    double low = low_pass ? 0.0 : low_hz / sampling_rate;
+    double high = high_pass ? 0.5 : high_hz / sampling_rate;
+    double center = (num_taps - 1) / 2.0;
+    const double *w = window->GetValues();
+    for (int n = 0; n < num_taps; ++n)
     {
-        return 0;
+        double m = n - center;
+        double ideal;
+        if (m == 0)
+            ideal = 2.0 * (high - low);
+        else
+            ideal = (sin(2.0 * M_PI * high * m) - sin(2.0 * M_PI * low * m)) / (M_PI * m);
+        coefficients[n] = ideal * w[n];
     }
-    
-    double mean1 = this->GetMean();
-    
-    // Calculate mean of signal2
-    double sum2 = 0.0;
-    for (int i = 0; i < signal2_size; i++)
+
+    // unit gain in the middle of the pass band
+    double reference = low_pass ? 0.0 : (high_pass ? 0.5 : (low + high) / 2.0);
+    double gain = 0.0;
+    for (int n = 0; n < num_taps; ++n)
+        gain += coefficients[n] * cos(2.0 * M_PI * reference * (n - center));
+    if (fabs(gain) < 1e-12)
+        return false;
+    for (int n = 0; n < num_taps; ++n)
+        coefficients[n] /= gain;
+    return true;
+}
+
+/// @brief Direct convolution on vectors of W outputs: output[i] = sum of reversed[k] * x[i + k]
+/// @param count Number of outputs
+/// @param x Input, count + taps - 1 values
+/// @param reversed Coefficients in reverse order
+/// @param taps Number of coefficients
+/// @param output Outputs
+template <typename Acc, int W>
+static FFT_ALWAYS_INLINE void FIRDirect(int count, const Acc *x, const Acc *reversed, int taps, Acc *output)
+{
+	typedef typename FFTVector<Acc, W>::Type Vec;
+	int i = 0;
+	// four vectors of outputs per coefficient: one broadcast for 4 W multiply-adds
+	for (; i + 4 * W <= count; i += 4 * W)
+	{
+		Vec a0 = {}, a1 = {}, a2 = {}, a3 = {};
+		const Acc *p = x + i;
+		for (int k = 0; k < taps; ++k)
+		{
+			Acc c = reversed[k];
+			Vec x0, x1, x2, x3;
+			memcpy(&x0, p + k, sizeof(Vec));
+			memcpy(&x1, p + k + W, sizeof(Vec));
+			memcpy(&x2, p + k + 2 * W, sizeof(Vec));
+			memcpy(&x3, p + k + 3 * W, sizeof(Vec));
+			a0 += c * x0;
+			a1 += c * x1;
+			a2 += c * x2;
+			a3 += c * x3;
+		}
+		memcpy(output + i, &a0, sizeof(Vec));
+		memcpy(output + i + W, &a1, sizeof(Vec));
+		memcpy(output + i + 2 * W, &a2, sizeof(Vec));
+		memcpy(output + i + 3 * W, &a3, sizeof(Vec));
+	}
+	for (; i + W <= count; i += W)
+	{
+		Vec a = {};
+		for (int k = 0; k < taps; ++k)
+		{
+			Vec v;
+			memcpy(&v, x + i + k, sizeof(Vec));
+			a += reversed[k] * v;
+		}
+		memcpy(output + i, &a, sizeof(Vec));
+	}
+	for (; i < count; ++i)
+	{
+		Acc a = 0;
+		for (int k = 0; k < taps; ++k)
+			a += reversed[k] * x[i + k];
+		output[i] = a;
+	}
+}
+
+#ifdef FFT_X86_KERNELS
+/// @brief Direct convolution on 256-bit vectors with FMA
+template <typename Acc>
+__attribute__((target("avx2,fma"))) static void FIRDirectAVX2(int count, const Acc *x, const Acc *reversed, int taps,
+                                                              Acc *output)
+{
+	FIRDirect<Acc, 32 / sizeof(Acc)>(count, x, reversed, taps, output);
+	__builtin_ia32_vzeroupper();   // see the kernel switch of FFTPlan::Transform()
+}
+
+/// @brief Direct convolution on 512-bit vectors
+template <typename Acc>
+__attribute__((target("avx512f"))) static void FIRDirectAVX512(int count, const Acc *x, const Acc *reversed, int taps,
+                                                               Acc *output)
+{
+	FIRDirect<Acc, 64 / sizeof(Acc)>(count, x, reversed, taps, output);
+	__builtin_ia32_vzeroupper();   // see the kernel switch of FFTPlan::Transform()
+}
+#endif
+
+/// @brief Direct convolution with the kernel of the FFT plans
+/// @param count Number of outputs
+/// @param x Input, count + taps - 1 values
+/// @param reversed Coefficients in reverse order
+/// @param taps Number of coefficients
+/// @param output Outputs
+template <typename Acc>
+static void FIRDirectKernel(int count, const Acc *x, const Acc *reversed, int taps, Acc *output)
+{
+	switch (FFTPlan::GetKernel())
+	{
+#ifdef FFT_X86_KERNELS
+	case FFT_KERNEL_AVX512:
+		FIRDirectAVX512<Acc>(count, x, reversed, taps, output);
+		break;
+	case FFT_KERNEL_AVX2:
+		FIRDirectAVX2<Acc>(count, x, reversed, taps, output);
+		break;
+#endif
+#ifdef FFT_VECTOR128_KERNELS
+	case FFT_KERNEL_SSE2:
+	case FFT_KERNEL_NEON:
+		FIRDirect<Acc, 16 / sizeof(Acc)>(count, x, reversed, taps, output);
+		break;
+#endif
+	default:
+		FIRDirect<Acc, 1>(count, x, reversed, taps, output);
+		break;
+	}
+}
+
+/// @brief FIRFilterT constructor
+/// @param coefficients Impulse response
+/// @param num_taps Number of coefficients (>= 1)
+/// @param method FIR_AUTO, FIR_DIRECT or FIR_FFT
+template <typename T, typename Acc>
+FIRFilterT<T, Acc>::FIRFilterT(const double *coefficients, int num_taps, int method)
+{
+    this->num_taps = num_taps;
+    this->method = FIR_DIRECT;
+    this->block = FIR_DIRECT_BLOCK;
+    this->fft_size = 0;
+    this->forward = nullptr;
+    this->inverse = nullptr;
+    this->reversed = nullptr;
+    this->response_real = nullptr;
+    this->response_imag = nullptr;
+    this->input = nullptr;
+    this->real = nullptr;
+    this->imag = nullptr;
+    this->scratch = nullptr;
+    this->sample_count = 0;
+    if (coefficients == nullptr || num_taps < 1 || method < FIR_AUTO || method > FIR_FFT)
     {
-        sum2 += signal2[i];
+        this->num_taps = 0;
+        return;
     }
-    double mean2 = sum2 / signal2_size;
-    
-    int out_index = 0;
-    
-    // Compute cross-correlation for negative lags
-    for (int lag = -max_lag; lag <= max_lag; lag++)
+    if (method == FIR_FFT || (method == FIR_AUTO && num_taps >= FIR_FFT_MIN_TAPS))
     {
-        double sum = 0.0;
-        int count = 0;
-        
-        for (int i = 0; i < this->index; i++)
+        this->method = FIR_FFT;
+    }
+
+    this->reversed = (Acc *)malloc(num_taps * sizeof(Acc));
+    if (this->reversed == nullptr)
+    {
+        return;
+    }
+    for (int k = 0; k < num_taps; ++k)
+    {
+        this->reversed[k] = (Acc)coefficients[num_taps - 1 - k];
+    }
+
+    if (this->method == FIR_FFT)
+    {
+        // transform length with the fewest operations per output: N log2 N / (N - num_taps + 1)
+        int size = SignalPowerOfTwo(2 * num_taps);
+        double best = -1.0;
+        for (int candidate = size; candidate <= (1 << 22) && candidate <= 64 * SignalPowerOfTwo(num_taps);
+             candidate *= 2)
         {
-            int j = i + lag;
-            if (j >= 0 && j < signal2_size)
+            double cost = candidate * log2((double)candidate) / (candidate - num_taps + 1);
+            if (best < 0 || cost < best)
             {
-                sum += (this->SignalVector[i] - mean1) * (signal2[j] - mean2);
-                count++;
+                best = cost;
+                size = candidate;
             }
         }
-        
-        if (count > 0)
-        {
-            out_correlation[out_index++] = sum / count;
-        }
-        else
-        {
-            out_correlation[out_index++] = 0.0;
-        }
-    }
-    
-    // Normalize if requested
-    if (normalize)
-    {
-        // Compute variances
-        double var1 = 0.0;
-        for (int i = 0; i < this->index; i++)
+        this->fft_size = size;
+        this->block = 2 * (size - num_taps + 1);
+        this->forward = FFTPlan::Get(size, 1);
+        this->inverse = FFTPlan::Get(size, -1);
+        if (this->forward == nullptr || this->inverse == nullptr)
         {
-            double diff = this->SignalVector[i] - mean1;
-            var1 += diff * diff;
+            return;
         }
-        var1 /= this->index;
-        
-        double var2 = 0.0;
-        for (int i = 0; i < signal2_size; i++)
+        this->response_real = (Acc *)malloc(size * sizeof(Acc));
+        this->response_imag = (Acc *)malloc(size * sizeof(Acc));
+        this->real = (Acc *)malloc(size * sizeof(Acc));
+        this->imag = (Acc *)malloc(size * sizeof(Acc));
+        size_t scratch_size = (this->forward->GetScratchSize() > this->inverse->GetScratchSize())
+                                  ? this->forward->GetScratchSize()
+                                  : this->inverse->GetScratchSize();
+        if (scratch_size > 0)
         {
-            double diff = signal2[i] - mean2;
-            var2 += diff * diff;
+            this->scratch = (Acc *)malloc(scratch_size * sizeof(Acc));
         }
-        var2 /= signal2_size;
-        
-        double normalization = sqrt(var1 * var2);
-        if (normalization > 0.0)
+        // spectrum of the coefficients, computed in double once
+        double *h_real = (double *)calloc(size, sizeof(double));
+        double *h_imag = (double *)calloc(size, sizeof(double));
+        if (h_real != nullptr && h_imag != nullptr && this->response_real != nullptr && this->response_imag != nullptr)
         {
-            for (int i = 0; i < out_index; i++)
+            memcpy(h_real, coefficients, num_taps * sizeof(double));
+            this->forward->Execute(h_real, h_imag);
+            for (int k = 0; k < size; ++k)
             {
-                out_correlation[i] /= normalization;
+                this->response_real[k] = (Acc)h_real[k];
+                this->response_imag[k] = (Acc)h_imag[k];
             }
         }
+        else
+        {
+            free(this->response_real);
+            this->response_real = nullptr;
+        }
+        free(h_real);
+        free(h_imag);
     }
-    
-    return out_index;
+    this->input = (Acc *)calloc(num_taps - 1 + this->block, sizeof(Acc));
 }
 
-/// @brief Finds lag with maximum correlation
-/// @param correlation Correlation array
-/// @param size Array size
-/// @param peak_value Output peak value
-/// @return Index of peak
-int SignalProcessing::FindCorrelationPeak(double *correlation, int size, double *peak_value)
+/// @brief FIRFilterT destructor
+template <typename T, typename Acc>
+FIRFilterT<T, Acc>::~FIRFilterT()
 {
-    if (correlation == nullptr || size < 1)
+    free(this->reversed);
+    free(this->response_real);
+    free(this->response_imag);
+    free(this->input);
+    free(this->real);
+    free(this->imag);
+    free(this->scratch);
+}
+
+/// @brief Checks that the parameters were valid and the buffers allocated
+/// @return true if the filter can be used
+template <typename T, typename Acc>
+bool FIRFilterT<T, Acc>::IsValid() const
+{
+    if (this->num_taps < 1 || this->reversed == nullptr || this->input == nullptr)
     {
-        if (peak_value != nullptr) *peak_value = 0.0;
-        return -1;
+        return false;
     }
-    
-    int peak_index = 0;
-    double max_value = correlation[0];
-    
-    // Skip lag=0 for autocorrelation (always 1.0 when normalized)
-    int start = (size > 1) ? 1 : 0;
-    
-    for (int i = start; i < size; i++)
+    if (this->method == FIR_DIRECT)
     {
-        if (correlation[i] > max_value)
+        return true;
+    }
+    return this->forward != nullptr && this->inverse != nullptr && this->response_real != nullptr &&
+           this->response_imag != nullptr && this->real != nullptr && this->imag != nullptr &&
+           (this->scratch != nullptr ||
+            (this->forward->GetScratchSize() == 0 && this->inverse->GetScratchSize() == 0));
+}
+
+/// @brief Gets the number of coefficients
+/// @return Number of taps
+template <typename T, typename Acc>
+int FIRFilterT<T, Acc>::GetNumTaps() const
+{
+    return this->num_taps;
+}
+
+/// @brief Gets the convolution method in use
+/// @return FIR_DIRECT or FIR_FFT
+template <typename T, typename Acc>
+int FIRFilterT<T, Acc>::GetMethod() const
+{
+    return this->method;
+}
+
+/// @brief Gets the transform length of FIR_FFT
+/// @return Transform length, 0 for FIR_DIRECT
+template <typename T, typename Acc>
+int FIRFilterT<T, Acc>::GetFFTSize() const
+{
+    return this->fft_size;
+}
+
+/// @brief Gets the delay of a symmetric filter
+/// @return (num_taps - 1) / 2
+template <typename T, typename Acc>
+double FIRFilterT<T, Acc>::GetGroupDelay() const
+{
+    return (this->num_taps > 0) ? (this->num_taps - 1) / 2.0 : 0.0;
+}
+
+/// @brief Gets the number of samples filtered since construction or Reset()
+/// @return Sample count
+template <typename T, typename Acc>
+long long FIRFilterT<T, Acc>::GetSampleCount() const
+{
+    return this->sample_count;
+}
+
+/// @brief Clears the stored input
+template <typename T, typename Acc>
+void FIRFilterT<T, Acc>::Reset()
+{
+    if (this->input != nullptr)
+    {
+        memset(this->input, 0, (this->num_taps - 1) * sizeof(Acc));
+    }
+    this->sample_count = 0;
+}
+
+/// @brief Filters one sample
+/// @param value Input sample
+/// @return Output sample
+template <typename T, typename Acc>
+Acc FIRFilterT<T, Acc>::Filter(T value)
+{
+    if (!this->IsValid())
+    {
+        return 0;
+    }
+    int history = this->num_taps - 1;
+    this->input[history] = (Acc)value;
+    Acc output;
+    FIRDirect<Acc, 1>(1, this->input, this->reversed, this->num_taps, &output);
+    memmove(this->input, this->input + 1, history * sizeof(Acc));
+    this->sample_count++;
+    return output;
+}
+
+/// @brief Filters a block of samples
+/// @param input Input samples
+/// @param output Output samples
+/// @param n Number of samples
+/// @return Number of output samples
+template <typename T, typename Acc>
+int FIRFilterT<T, Acc>::Filter(const T *input, Acc *output, int n)
+{
+    if (!this->IsValid() || input == nullptr || output == nullptr || n < 1)
+    {
+        return 0;
+    }
+    Acc *pending = this->input + this->num_taps - 1;
+    for (int done = 0; done < n;)
+    {
+        // copied before the outputs are written, so output may be input
+        int count = (n - done < this->block) ? n - done : this->block;
+        for (int i = 0; i < count; ++i)
         {
-            max_value = correlation[i];
-            peak_index = i;
+            pending[i] = (Acc)input[done + i];
         }
+        this->FilterBlock(count, output + done);
+        done += count;
     }
-    
-    if (peak_value != nullptr)
+    this->sample_count += n;
+    return n;
+}
+
+/// @brief Filters the count samples following the stored history, then keeps the newest history
+/// @param count Number of new samples (at most block)
+/// @param output Outputs
+template <typename T, typename Acc>
+void FIRFilterT<T, Acc>::FilterBlock(int count, Acc *output)
+{
+    int history = this->num_taps - 1;
+    if (this->method == FIR_DIRECT)
     {
-        *peak_value = max_value;
+        FIRDirectKernel<Acc>(count, this->input, this->reversed, this->num_taps, output);
     }
-    
-    return peak_index;
+    else
+    {
+        // overlap-save: the first block of new samples as the real part, the second as the imaginary part;
+        // outputs of a frame start after its num_taps - 1 samples of history
+        int size = this->fft_size;
+        int length = size - history;
+        int first = (count < length) ? count : length;
+        int second = count - first;
+        const Acc *frame = this->input + length;
+        for (int j = 0; j < size; ++j)
+        {
+            this->real[j] = (j < history + first) ? this->input[j] : (Acc)0;
+            this->imag[j] = (j < history + second) ? frame[j] : (Acc)0;
+        }
+        this->forward->Execute(this->real, this->imag, this->scratch);
+        for (int k = 0; k < size; ++k)
+        {
+            Acc xr = this->real[k], xi = this->imag[k];
+            Acc hr = this->response_real[k], hi = this->response_imag[k];
+            this->real[k] = xr * hr - xi * hi;
+            this->imag[k] = xr * hi + xi * hr;
+        }
+        this->inverse->Execute(this->real, this->imag, this->scratch);
+        for (int i = 0; i < first; ++i)
+        {
+            output[i] = this->real[history + i];
+        }
+        for (int i = 0; i < second; ++i)
+        {
+            output[first + i] = this->imag[history + i];
+        }
+    }
+    memmove(this->input, this->input + count, history * sizeof(Acc));
 }
 
+template class SignalProcessingT<double, double>;
+template class SignalProcessingT<float, float>;
+template class SignalProcessingT<float, double>;
+template class SignalProcessingT<int16_t, float>;
+template class SignalProcessingT<int16_t, double>;
+
+template class SignalBankT<double, double>;
+template class SignalBankT<float, float>;
+template class SignalBankT<float, double>;
+template class SignalBankT<int16_t, float>;
+template class SignalBankT<int16_t, double>;
+
+template class SignalViewT<double, double>;
+template class SignalViewT<float, float>;
+template class SignalViewT<float, double>;
+template class SignalViewT<int16_t, float>;
+template class SignalViewT<int16_t, double>;
+
+template class SignalFileT<double, double>;
+template class SignalFileT<float, float>;
+template class SignalFileT<float, double>;
+template class SignalFileT<int16_t, float>;
+template class SignalFileT<int16_t, double>;
+
+template class SpectrogramT<double, double>;
+template class SpectrogramT<float, float>;
+template class SpectrogramT<float, double>;
+template class SpectrogramT<int16_t, float>;
+template class SpectrogramT<int16_t, double>;
+
+template class ToneTrackerT<double, double>;
+template class ToneTrackerT<float, float>;
+template class ToneTrackerT<float, double>;
+template class ToneTrackerT<int16_t, float>;
+template class ToneTrackerT<int16_t, double>;
+
+template class FIRFilterT<double, double>;
+template class FIRFilterT<float, float>;
+template class FIRFilterT<float, double>;
+template class FIRFilterT<int16_t, float>;
+template class FIRFilterT<int16_t, double>;
@@ -1,11 +1,55 @@
 #ifndef SIGNALPROCESSING_H
 #define SIGNALPROCESSING_H
-#define NB_MAX_VALUES 1000 /* number of values in the signal vector  */
+#define NB_MAX_VALUES 1000 /* default capacity of the signal ring buffer */
 #define NS_PER_SECOND 1000000000
 #define DEBUG_INFO 1
 #define MAX_INDX 12
+#define TIMESTAMP_EXPLICIT 0 /* one int64 nanosecond timestamp per sample */
+#define TIMESTAMP_DELTA 1 /* 32-bit nanosecond offsets from int64 bases per TIMESTAMP_BLOCK samples */
+#define TIMESTAMP_UNIFORM 2 /* no per-sample storage: t0 + sample number * period */
+#define TIMESTAMP_BLOCK 16 /* samples sharing one base in TIMESTAMP_DELTA mode */
+#define SIGNALBANK_ALIGNMENT 64 /* byte alignment of every channel of a SignalBank */
+#define SIGNALFILE_MAGIC "SPSIGNAL" /* first 8 bytes of a signal file */
+#define SIGNALFILE_VERSION 1
+#define SIGNALFILE_DOUBLE 0 /* sample types stored in a signal file */
+#define SIGNALFILE_FLOAT 1
+#define SIGNALFILE_INT16 2
+#define FFT_KERNEL_SCALAR 0 /* butterfly kernels of FFTPlan, see FFTPlan::SetKernel() */
+#define FFT_KERNEL_SSE2 1 /* 128-bit vectors, x86-64 */
+#define FFT_KERNEL_NEON 2 /* 128-bit vectors, AArch64 */
+#define FFT_KERNEL_AVX2 3 /* 256-bit vectors with FMA */
+#define FFT_KERNEL_AVX512 4 /* 512-bit vectors */
+#define FFT_BATCH_LANES 16 /* widest vector of the batch transforms (16 floats with AVX-512) */
+#define SIGNAL_WINDOW_RECTANGULAR 0 /* window functions of the spectral analysis */
+#define SIGNAL_WINDOW_HANN 1
+#define SIGNAL_WINDOW_HAMMING 2
+#define SIGNAL_WINDOW_BLACKMAN 3
+#define SIGNAL_WINDOW_FLATTOP 4 /* 5-term flat top: amplitudes within 0.01 dB between bins */
+#define SIGNAL_WINDOW_KAISER 5 /* parameter beta */
+#define SIGNAL_WINDOW_TUKEY 6 /* parameter alpha: tapered fraction, 0 = rectangular, 1 = Hann */
+#define SIGNAL_WINDOW_KAISER_BETA 8.6 /* default parameters, used when the parameter is <= 0 */
+#define SIGNAL_WINDOW_TUKEY_ALPHA 0.5
+#define SPECTROGRAM_MAGNITUDE 0 /* values of a spectrogram frame: |X[k]| */
+#define SPECTROGRAM_POWER 1 /* |X[k]|^2 */
+#define SPECTROGRAM_DB 2 /* 10 log10(|X[k]|^2), at least SPECTROGRAM_DB_FLOOR */
+#define SPECTROGRAM_DB_FLOOR -200.0
+#define WELCH_PARALLEL_SAMPLES 262144 /* samples transformed per thread before WelchPSD() uses more threads */
+#define WELCH_MAX_THREADS 8
+#define TONE_TRACKER_RESYNC 16 /* windows between exact recomputations of the sliding DFT sums */
+#define FIR_AUTO 0 /* convolution methods of FIRFilterT */
+#define FIR_DIRECT 1 /* direct sums on vectors, O(taps) per sample */
+#define FIR_FFT 2 /* overlap-save FFT convolution, O(log taps) per sample */
+#define FIR_FFT_MIN_TAPS 128 /* taps from which FIR_AUTO uses FIR_FFT */
+#define FIR_DIRECT_BLOCK 512 /* samples filtered per pass of FIR_DIRECT */
+#define CORRELATION_AUTO 0 /* methods of Autocorrelation() and CrossCorrelation(), chosen by SignalCorrelationMethod() */
+#define CORRELATION_DIRECT 1 /* sums over the samples, O(n * max_lag) */
+#define CORRELATION_FFT 2 /* inverse transform of |X|^2 (Wiener-Khinchin) or of conj(X) Y, O(n log n) */
+#define CORRELATION_FFT_COST 2 /* direct multiply-adds worth one N log2 N of the two transforms */
+#define CORRELATION_PHAT_FLOOR 1e-6 /* GCCPHAT() weights bins by 1 / max(|cross-spectrum|, this fraction of the largest) */
 #include <time.h>
 #include <math.h>
+#include <stdint.h>
+#include <atomic>
 
 // Forward declaration for HDF5 integration (optional)
 // Define USE_HDF5 to enable HDF5 export functionality
@@ -31,6 +75,7 @@ typedef struct prob_dist
 {
     prob_dist_item *items;
     int count;
+    int capacity;   // allocated items, grown geometrically
 
     double total_probability;
     double total_normal_probability;
@@ -87,6 +132,46 @@ typedef struct FrequencySpectrum
     int window_size;        // Size of analyzed window
 } FrequencySpectrum;
 
+// --------------------------------------------------------
+// STRUCT FrequencyBinF - Single-precision frequency bin
+// --------------------------------------------------------
+typedef struct FrequencyBinF
+{
+    float frequency;        // Frequency in Hz
+    float magnitude;        // Magnitude of this frequency component
+    float phase;            // Phase in radians
+    float power;            // Power (magnitude squared)
+} FrequencyBinF;
+
+// --------------------------------------------------------
+// STRUCT FrequencySpectrumF - Frequency analysis with single-precision bins
+// --------------------------------------------------------
+typedef struct FrequencySpectrumF
+{
+    FrequencyBinF *bins;    // Array of frequency bins (half the size of FrequencyBin)
+    int num_bins;           // Number of frequency bins
+    double sampling_rate;   // Sampling rate in Hz
+    double frequency_resolution; // Frequency resolution (bin width)
+    double dominant_frequency;   // Frequency with highest magnitude
+    double total_power;     // Total signal power
+    int window_size;        // Size of analyzed window
+} FrequencySpectrumF;
+
+// --------------------------------------------------------
+// STRUCT PowerSpectralDensity - Averaged (Welch) power spectral density
+// --------------------------------------------------------
+typedef struct PowerSpectralDensity
+{
+    double *psd;            // One-sided PSD in units^2/Hz, bin k at k * frequency_resolution
+    int num_bins;           // segment_length / 2 + 1
+    double sampling_rate;   // Sampling rate in Hz
+    double frequency_resolution; // sampling_rate / segment_length
+    double dominant_frequency;   // Frequency with the highest density (DC excluded)
+    double total_power;     // Sum of psd * frequency_resolution (units^2)
+    int segment_length;     // Samples per segment
+    int num_segments;       // Number of averaged segments
+} PowerSpectralDensity;
+
 // --------------------------------------------------------
 // STRUCT MLFeatureVector - Feature vector for ML/AI
 // --------------------------------------------------------
@@ -146,14 +231,596 @@ typedef struct MLTrainingStats
     int num_samples;            // Number of samples used to compute statistics
 } MLTrainingStats;
 
-class SignalProcessing{
+// --------------------------------------------------------
+// STRUCT SampleTraits - Default accumulator for a sample type
+// --------------------------------------------------------
+// Sums, filter states and FFT buffers use the accumulator type. 16-bit ADC
+// samples are processed in float; use SignalProcessingT<int16_t, double> or
+// SignalProcessingT<float, double> for long windows that need double sums.
+template <typename T>
+struct SampleTraits
+{
+    typedef double Accumulator;
+};
+template <>
+struct SampleTraits<float>
+{
+    typedef float Accumulator;
+};
+template <>
+struct SampleTraits<int16_t>
+{
+    typedef float Accumulator;
+};
+
+/**
+ * @brief Smallest power of two >= n, usable in constant expressions
+ * @param n Number
+ * @param power Candidate (leave the default)
+ * @return Power of two
+ */
+constexpr int SignalPowerOfTwo(int n, int power = 1)
+{
+    return (power >= n) ? power : SignalPowerOfTwo(n, 2 * power);
+}
+
+/**
+ * @brief Checks that an FFT length has no prime factor other than 2, 3 and 5
+ * (mixed-radix plan; other lengths use Bluestein's algorithm)
+ * @param n Transform length
+ * @return true for 2, 3, 5-smooth lengths
+ */
+constexpr bool SignalFFTSmooth(int n)
+{
+    return (n <= 1) ? true : (n % 2 == 0) ? SignalFFTSmooth(n / 2) : (n % 3 == 0) ? SignalFFTSmooth(n / 3) :
+                             (n % 5 == 0) ? SignalFFTSmooth(n / 5) : false;
+}
+
+/**
+ * @brief Smaller of two lengths (helper of SignalFFTSmoothLength(), each recursion evaluated once)
+ */
+constexpr long long SignalFFTMinLength(long long a, long long b)
+{
+    return (a < b) ? a : b;
+}
+
+/**
+ * @brief Smallest 2, 3, 5-smooth multiple m * 2^k >= n for m = 3^b * 5^c, m * 5, m * 25, ... (helper of SignalFFTSmoothLength())
+ * @param n Length
+ * @param m Odd factor
+ * @return Smallest candidate
+ */
+constexpr long long SignalFFTSmoothLength5(int n, long long m)
+{
+    return (m >= n) ? m : SignalFFTMinLength(m * SignalPowerOfTwo((int)((n + m - 1) / m)), SignalFFTSmoothLength5(n, 5 * m));
+}
+
+/**
+ * @brief Smallest 2, 3, 5-smooth length >= n among the odd factors m, 3 m, 9 m, ... (helper of SignalFFTSmoothLength())
+ * @param n Length
+ * @param m Power of three
+ * @return Smallest candidate
+ */
+constexpr long long SignalFFTSmoothLength3(int n, long long m)
+{
+    return (m >= n) ? SignalFFTSmoothLength5(n, m) :
+                      SignalFFTMinLength(SignalFFTSmoothLength5(n, m), SignalFFTSmoothLength3(n, 3 * m));
+}
+
+/**
+ * @brief Smallest length >= n with no prime factor other than 2, 3 and 5 (fast window sizes)
+ * @param n Length, at most 2^30
+ * @return Length, e.g. 1000 for 999 and 10000 for 9997
+ */
+constexpr int SignalFFTSmoothLength(int n)
+{
+    return (int)SignalFFTSmoothLength3(n, 1);
+}
+
+/**
+ * @brief Scratch values needed by FFTPlan::Execute() and FFTPlan::ExecuteReal() of length n:
+ * two arrays of the convolution length SignalFFTSmoothLength(2 n - 1) for Bluestein lengths,
+ * plus a complex copy of the samples for real transforms of odd length
+ * @param n Transform length
+ * @return Number of values of the sample type, 0 if no scratch is needed
+ */
+constexpr size_t SignalFFTScratch(int n)
+{
+    return (size_t)((n % 2 == 1) ? 2 * n : 0) + (SignalFFTSmooth(n) ? 0 : 2 * (size_t)SignalFFTSmoothLength(2 * n - 1));
+}
+
+/**
+ * @brief Workspace needed by an FFT analysis of n samples (real and imaginary
+ * arrays, FFT scratch and the spectrum bins), the largest demand of the analysis methods
+ * @param n Number of samples
+ * @param acc_size Size of the accumulator type
+ * @return Size in bytes
+ */
+constexpr size_t SignalWorkspaceBytes(int n, size_t acc_size)
+{
+    return 2 * (((size_t)n * acc_size + SIGNALBANK_ALIGNMENT - 1) / SIGNALBANK_ALIGNMENT * SIGNALBANK_ALIGNMENT) +
+           ((SignalFFTScratch(n) * acc_size + SIGNALBANK_ALIGNMENT - 1) / SIGNALBANK_ALIGNMENT * SIGNALBANK_ALIGNMENT) +
+           (((size_t)(n / 2 + 1) * sizeof(FrequencyBin) + SIGNALBANK_ALIGNMENT - 1) / SIGNALBANK_ALIGNMENT * SIGNALBANK_ALIGNMENT);
+}
+
+/**
+ * @brief Transform length of an FFT correlation: even, 2, 3, 5-smooth and >= length + max_lag
+ * @param length Number of samples
+ * @param max_lag Largest lag
+ * @return Transform length
+ */
+constexpr int SignalCorrelationLength(int length, int max_lag)
+{
+    return 2 * SignalFFTSmoothLength((length + max_lag + 1) / 2);
+}
+
+/**
+ * @brief Chooses the cheaper method for the correlation sums of lags 0 to max_lag
+ * @param length Number of samples
+ * @param max_lag Largest lag
+ * @return CORRELATION_DIRECT or CORRELATION_FFT
+ *
+ * Compares the (max_lag + 1) (length - max_lag / 2) multiply-adds of the
+ * direct sums with CORRELATION_FFT_COST * N log2 N for the two real
+ * transforms of length N = SignalCorrelationLength(length, max_lag).
+ */
+int SignalCorrelationMethod(int length, int max_lag);
+
+/**
+ * @brief Chooses the cheaper method for the cross-correlation sums of lags -max_lag to max_lag
+ * @param length Number of samples of the first signal
+ * @param length2 Number of samples of the second signal
+ * @param max_lag Largest lag in both directions
+ * @return CORRELATION_DIRECT or CORRELATION_FFT
+ *
+ * Compares the multiply-adds of the overlapping pairs of every lag with
+ * 2 * CORRELATION_FFT_COST * N log2 N for the two complex transforms of
+ * length N = SignalCorrelationLength(max(length, length2), max_lag).
+ */
+int SignalCorrelationMethod(int length, int length2, int max_lag);
+
+/**
+ * @brief Precomputed tables of an FFT of one size and direction
+ *
+ * Holds the digit-reversal swaps and the twiddle factors of every stage, each
+ * computed directly with cos/sin (no recurrence), in double and float. Get()
+ * returns plans from a process-wide cache: the tables of a size are built
+ * once, on first use, and shared by all objects and threads. Plans are
+ * immutable, so Execute() can run concurrently on different arrays.
+ *
+ * Any length >= 2 is supported. Lengths whose only prime factors are 2, 3
+ * and 5 run in place: the radix-2 stages first, then radix-3 and radix-5
+ * passes. Other lengths use Bluestein's algorithm: the transform becomes a
+ * convolution with a chirp, computed with plans of the smooth length
+ * SignalFFTSmoothLength(2 * size - 1) (several times the work of a smooth
+ * length of the same size), in GetScratchSize() values of scratch memory.
+ *
+ * Execute() merges the radix-2 stages in pairs into radix-4 passes (one
+ * radix-2 stage first when their number is odd) and runs these and the
+ * radix-3 and radix-5 butterflies on the widest vectors the CPU supports,
+ * detected once at run time. All kernels
+ * compute the same butterflies from the same tables; they differ from the
+ * scalar kernel only by rounding (FMA contraction and operation order),
+ * within 1e-12 (double) and 1e-5 (float) of the largest output magnitude.
+ */
+class FFTPlan{
+public:
+    /**
+     * @brief Builds the tables of a transform
+     * @param size Transform length >= 2
+     * @param direction 1 = forward, -1 = inverse (normalized by 1 / size)
+     */
+    FFTPlan(int size, int direction);
+    /**
+     * @brief Destructor, releases the tables
+     */
+    ~FFTPlan();
+    FFTPlan(const FFTPlan &) = delete;
+    FFTPlan &operator=(const FFTPlan &) = delete;
+
+    /**
+     * @brief Gets the shared plan of a size and direction, built on first use
+     * @param size Transform length >= 2
+     * @param direction 1 = forward, -1 = inverse
+     * @return Plan kept until the end of the process, nullptr for an invalid size
+     */
+    static const FFTPlan *Get(int size, int direction);
+    /**
+     * @brief Checks that the tables were built
+     * @return true if the plan can be executed
+     */
+    bool IsValid() const;
+    /**
+     * @brief Gets the transform length
+     * @return Size
+     */
+    int GetSize() const;
+    /**
+     * @brief Gets the direction of the transform
+     * @return 1 = forward, -1 = inverse
+     */
+    int GetDirection() const;
+    /**
+     * @brief Gets the scratch memory needed by Execute() and ExecuteReal()
+     * @return Number of values of the data type, SignalFFTScratch(GetSize())
+     */
+    size_t GetScratchSize() const;
+    /**
+     * @brief Transforms complex data in place
+     * @param real Real parts (GetSize() values)
+     * @param imag Imaginary parts (GetSize() values)
+     * @param scratch GetScratchSize() values, nullptr to allocate them on each call when needed
+     */
+    void Execute(double *real, double *imag, double *scratch = nullptr) const;
+    /**
+     * @brief Transforms complex data in place, float butterflies and twiddles
+     * @param real Real parts (GetSize() values)
+     * @param imag Imaginary parts (GetSize() values)
+     * @param scratch GetScratchSize() values, nullptr to allocate them on each call when needed
+     */
+    void Execute(float *real, float *imag, float *scratch = nullptr) const;
+    /**
+     * @brief Transforms real data: bins 0 to GetSize() / 2 of GetSize() real samples
+     * @param input Real samples (GetSize() values), may be the same array as real
+     * @param real Output real parts (GetSize() / 2 + 1 values)
+     * @param imag Output imaginary parts (GetSize() / 2 + 1 values)
+     * @param scratch GetScratchSize() values, nullptr to allocate them on each call when needed
+     *
+     * For an even length, even samples become the real parts and odd samples
+     * the imaginary parts of one complex FFT of half the size; a twiddle pass
+     * then separates the two spectra. About half the work and memory of a
+     * complex transform with a zero imaginary part, and the same bins up to
+     * rounding. Odd lengths run the complex transform on a copy in scratch.
+     */
+    void ExecuteReal(const double *input, double *real, double *imag, double *scratch = nullptr) const;
+    /**
+     * @brief Transforms real data with float arithmetic, see ExecuteReal(const double *, double *, double *, double *)
+     * @param input Real samples (GetSize() values), may be the same array as real
+     * @param real Output real parts (GetSize() / 2 + 1 values)
+     * @param imag Output imaginary parts (GetSize() / 2 + 1 values)
+     * @param scratch GetScratchSize() values, nullptr to allocate them on each call when needed
+     */
+    void ExecuteReal(const float *input, float *real, float *imag, float *scratch = nullptr) const;
+    /**
+     * @brief Transforms the real data of several channels of GetSize() samples
+     * @param input Sample n of channel c at input[c * channel_step + n * sample_step]
+     * (planar: channel_step >= GetSize(), sample_step 1; interleaved: channel_step 1, sample_step num_channels)
+     * @param num_channels Number of channels
+     * @param channel_step Distance between the first samples of two channels
+     * @param sample_step Distance between two samples of a channel
+     * @param real Output real parts, bin k of channel c at real[c * (GetSize() / 2 + 1) + k]
+     * @param imag Output imaginary parts, same layout
+     * @param scratch GetBatchScratchSize() values, nullptr to allocate them on each call
+     *
+     * The channels are transformed together: a vector lane per pair of
+     * channels, one as the real and one as the imaginary part of a complex
+     * transform, split afterwards by symmetry. Every butterfly then runs on
+     * full vectors with its twiddle loaded once for all the lanes, including
+     * the short first stages and the digit reversal that limit the vectors of
+     * a single transform. Same bins as ExecuteReal() up to rounding. Bluestein
+     * lengths transform the channels one by one.
+     */
+    void ExecuteRealBatch(const double *input, int num_channels, int channel_step, int sample_step, double *real,
+                          double *imag, double *scratch = nullptr) const;
+    /**
+     * @brief Transforms the real data of several channels with float arithmetic, see ExecuteRealBatch(const double *, int, int, int, double *, double *, double *)
+     * @param input Sample n of channel c at input[c * channel_step + n * sample_step]
+     * @param num_channels Number of channels
+     * @param channel_step Distance between the first samples of two channels
+     * @param sample_step Distance between two samples of a channel
+     * @param real Output real parts, bin k of channel c at real[c * (GetSize() / 2 + 1) + k]
+     * @param imag Output imaginary parts, same layout
+     * @param scratch GetBatchScratchSize() values, nullptr to allocate them on each call
+     */
+    void ExecuteRealBatch(const float *input, int num_channels, int channel_step, int sample_step, float *real,
+                          float *imag, float *scratch = nullptr) const;
+    /**
+     * @brief Gets the scratch memory needed by ExecuteRealBatch()
+     * @return Number of values of the data type: (2 * GetSize() + 1) * FFT_BATCH_LANES,
+     * or GetSize() + GetScratchSize() for Bluestein lengths
+     */
+    size_t GetBatchScratchSize() const;
+    /**
+     * @brief Gets the butterfly kernel used by all plans
+     * @return FFT_KERNEL_* constant, the widest one supported by the CPU unless set with SetKernel()
+     */
+    static int GetKernel();
+    /**
+     * @brief Selects the butterfly kernel used by all plans (e.g. FFT_KERNEL_SCALAR for reference results)
+     * @param kernel FFT_KERNEL_* constant
+     * @return false if the kernel is not available on this CPU or build (kernel unchanged)
+     */
+    static bool SetKernel(int kernel);
+    /**
+     * @brief Checks that a kernel can run on this CPU and build
+     * @param kernel FFT_KERNEL_* constant
+     * @return true if available
+     */
+    static bool IsKernelSupported(int kernel);
+    /**
+     * @brief Gets the name of a kernel
+     * @param kernel FFT_KERNEL_* constant
+     * @return "scalar", "SSE2", "NEON", "AVX2" or "AVX-512" ("unknown" otherwise)
+     */
+    static const char *GetKernelName(int kernel);
+
+private:
+        template <typename Acc>
+        void Transform(Acc *real, Acc *imag, Acc *scratch, const Acc *twiddle_real, const Acc *twiddle_imag,
+                       const Acc *chirp_real, const Acc *chirp_imag) const;
+        template <typename Acc>
+        void TransformReal(const Acc *input, Acc *real, Acc *imag, Acc *scratch, const Acc *twiddle_real,
+                           const Acc *twiddle_imag) const;
+        template <typename Acc>
+        void TransformRealBatch(const Acc *input, int num_channels, int channel_step, int sample_step, Acc *real,
+                                Acc *imag, Acc *scratch, const Acc *twiddle_real, const Acc *twiddle_imag) const;
+
+        int size;
+        int direction;
+        /**
+         * @brief Power-of-two factor of size, then the number of radix-3 and radix-5 passes
+         */
+        int power_of_two;
+        int num_radix3;
+        int num_radix5;
+        /**
+         * @brief Index pairs (i, j) with i < j exchanged in order by the digit-reversal permutation
+         */
+        int *swaps;
+        int num_swaps;
+        /**
+         * @brief Twiddles of all stages, stage spanning m points with radix r at offset m - 1
+         * ((r - 1) * m values, W^(j k) for j = 1..r-1 and k < m), then the twiddles
+         * exp(i * direction * 2 pi * k / size) of the real transform at real_offset
+         */
+        double *twiddle_real;
+        double *twiddle_imag;
+        float *twiddle_real_f;
+        float *twiddle_imag_f;
+        int real_offset;
+        /**
+         * @brief Bluestein length (0 for smooth lengths), chirp exp(i * direction * pi * n^2 / size)
+         * (size values) followed by the transformed conjugate chirp (bluestein_size values)
+         */
+        int bluestein_size;
+        double *chirp_real;
+        double *chirp_imag;
+        float *chirp_real_f;
+        float *chirp_imag_f;
+        const FFTPlan *bluestein_forward;
+        const FFTPlan *bluestein_inverse;
+        size_t scratch_size;
+        /**
+         * @brief Next plan of the cache of non-power-of-two lengths
+         */
+        FFTPlan *next;
+    };
+
+/**
+ * @brief Precomputed coefficients of a window function of one type and size
+ *
+ * Get() returns tables from a process-wide cache, as FFTPlan::Get(): the
+ * coefficients of a type, size and parameter are computed once, on first
+ * use, in double and float, and shared by all objects and threads. Windows
+ * are symmetric (w[i] = w[size - 1 - i], period size - 1). Apply() multiplies
+ * data by the coefficients on the vectors of FFTPlan::GetKernel(), so
+ * windowing costs one multiply per sample instead of one or more cos().
+ */
+class SignalWindow{
+public:
+    /**
+     * @brief Computes the coefficients of a window
+     * @param window_type SIGNAL_WINDOW_* constant
+     * @param size Number of coefficients >= 1
+     * @param parameter Kaiser beta or Tukey alpha, <= 0 for the default (ignored by the other types)
+     */
+    SignalWindow(int window_type, int size, double parameter);
+    /**
+     * @brief Destructor, releases the coefficients
+     */
+    ~SignalWindow();
+    SignalWindow(const SignalWindow &) = delete;
+    SignalWindow &operator=(const SignalWindow &) = delete;
+
+    /**
+     * @brief Gets the shared window of a type, size and parameter, computed on first use
+     * @param window_type SIGNAL_WINDOW_* constant
+     * @param size Number of coefficients >= 1
+     * @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+     * @return Window kept until the end of the process, nullptr for an unknown type or invalid size
+     */
+    static const SignalWindow *Get(int window_type, int size, double parameter = 0.0);
+    /**
+     * @brief Value of a window function, computed directly
+     * @param window_type SIGNAL_WINDOW_* constant
+     * @param i Coefficient index (0 to size - 1)
+     * @param size Number of coefficients
+     * @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+     * @return w[i], 1 for an unknown type
+     */
+    static double Value(int window_type, int i, int size, double parameter = 0.0);
+    /**
+     * @brief Checks that the coefficients were computed
+     * @return true if the window can be used
+     */
+    bool IsValid() const;
+    /**
+     * @brief Gets the window function
+     * @return SIGNAL_WINDOW_* constant
+     */
+    int GetType() const;
+    /**
+     * @brief Gets the number of coefficients
+     * @return Size
+     */
+    int GetSize() const;
+    /**
+     * @brief Gets the parameter of the window
+     * @return Kaiser beta or Tukey alpha after defaults, 0 for the other types
+     */
+    double GetParameter() const;
+    /**
+     * @brief Gets the coefficients
+     * @return GetSize() values
+     */
+    const double *GetValues() const;
+    /**
+     * @brief Gets the coefficients rounded to float
+     * @return GetSize() values
+     */
+    const float *GetValuesF() const;
+    /**
+     * @brief Sum of the coefficients (coherent gain times size): a sinusoid of amplitude A gives a peak of A * sum / 2
+     * @return Sum
+     */
+    double GetSum() const;
+    /**
+     * @brief Sum of the squared coefficients, the noise power gain of the window
+     * @return Sum of squares
+     */
+    double GetSumOfSquares() const;
+    /**
+     * @brief Multiplies data by the window in place
+     * @param data GetSize() values
+     */
+    void Apply(double *data) const;
+    /**
+     * @brief Multiplies data by the float coefficients in place
+     * @param data GetSize() values
+     */
+    void Apply(float *data) const;
+
+private:
+        int window_type;
+        int size;
+        double parameter;
+        double *values;
+        float *values_f;
+        double sum;
+        double sum_of_squares;
+        /**
+         * @brief Next window of the same type in the cache
+         */
+        SignalWindow *next;
+    };
+
+/**
+ * @brief Scratch memory for the temporary buffers of the analysis methods
+ *
+ * A bump allocator: Alloc() hands out 64-byte aligned blocks from one buffer
+ * and Release() returns everything allocated since the matching Mark(). The
+ * buffer is sized once; a request that does not fit falls back to malloc
+ * (freed by Release()) and the buffer grows to the largest demand the next
+ * time it is completely released, so a steady-state loop makes no heap
+ * allocation. Not thread-safe: use one workspace per thread.
+ */
+class SignalWorkspace{
+public:
+    /**
+     * @brief Creates a workspace
+     * @param bytes Initial size in bytes (0 = allocated on first use)
+     */
+    explicit SignalWorkspace(size_t bytes = 0);
+    /**
+     * @brief Destructor, releases the buffer
+     */
+    ~SignalWorkspace();
+    SignalWorkspace(const SignalWorkspace &) = delete;
+    SignalWorkspace &operator=(const SignalWorkspace &) = delete;
+
+    /**
+     * @brief Makes the buffer at least bytes long (only while nothing is allocated)
+     * @param bytes Size in bytes
+     * @return true on success
+     */
+    bool Reserve(size_t bytes);
+    /**
+     * @brief Uses caller memory as the buffer (only while nothing is allocated)
+     * @param memory Buffer, aligned here to SIGNALBANK_ALIGNMENT; never freed by the workspace
+     * @param bytes Size of memory in bytes
+     * @return true on success
+     */
+    bool UseBuffer(void *memory, size_t bytes);
+    /**
+     * @brief Gets the size of the buffer
+     * @return Size in bytes
+     */
+    size_t GetSize();
+    /**
+     * @brief Gets the largest amount of scratch memory requested at once
+     * @return Size in bytes
+     */
+    size_t GetPeakUsage();
+    /**
+     * @brief Gets the number of heap allocations made after the first Reserve()
+     * @return Fallback allocations and buffer growths
+     */
+    long long GetHeapAllocationCount();
+    /**
+     * @brief Enables the no-allocation check of the steady-state hot path
+     * @param enable true to assert (debug builds) on every heap allocation
+     *
+     * Builds with NDEBUG only count the allocations, see GetHeapAllocationCount().
+     */
+    void SetAllocationGuard(bool enable);
+
+    /**
+     * @brief Allocates scratch memory
+     * @param bytes Size in bytes
+     * @return 64-byte aligned block, valid until Release() of an earlier mark
+     */
+    void *Alloc(size_t bytes);
+    /**
+     * @brief Records the current allocation position
+     * @return Mark to pass to Release()
+     */
+    size_t Mark();
+    /**
+     * @brief Frees everything allocated since a mark
+     * @param mark Value returned by Mark()
+     */
+    void Release(size_t mark);
+
+private:
+        unsigned char *buffer;
+        size_t size;
+        bool owns_buffer;
+        /**
+         * @brief Allocated bytes, including fallback blocks (may exceed size)
+         */
+        size_t used;
+        size_t peak;
+        /**
+         * @brief Fallback blocks, newest first
+         */
+        void *overflow;
+        long long heap_allocations;
+        bool guard;
+    };
+
+/**
+ * @brief Signal ring buffer and analysis methods for one sample type
+ * @tparam T Storage type of the samples (double, float or int16_t)
+ * @tparam Acc Accumulator type used for sums, filter outputs and FFT buffers
+ *
+ * The implementation is explicitly instantiated in SignalProcessing.cpp for
+ * <double, double>, <float, float>, <float, double>, <int16_t, float> and
+ * <int16_t, double>. Values written back into the buffer (NormalizeVector,
+ * ScaleVector, *WithValue) are rounded and saturated for integer samples.
+ */
+template <typename T, typename Acc> class SignalBankT;
+template <typename T, typename Acc> class SpectrogramT;
+template <typename T, typename Acc> class ToneTrackerT;
+
+template <typename T, typename Acc = typename SampleTraits<T>::Accumulator>
+class SignalProcessingT{
 public:
     /**
      * @brief Applies exponential smoothing to the signal vector
      * @param alpha Smoothing factor (0 < alpha <= 1)
      * @param out_vector Destination vector for smoothed values (size >= GetIndex())
      */
-    void ExponentialSmoothing(double alpha, double *out_vector);
+    void ExponentialSmoothing(double alpha, Acc *out_vector);
 
     /**
      * @brief Normalizes the signal vector to [0, 1] range
@@ -168,6 +835,12 @@ public:
     /**
      * @brief Calculates the mean (average) of the signal vector
      * @return Mean value
+     *
+     * The mean, variance, standard deviation, minimum and maximum of the
+     * analysis window are maintained by the Add methods (compensated sums
+     * updated as samples enter and leave the window), so these getters are
+     * O(1). Views, SignalBank channels and the concurrent ingest mode compute
+     * them with one scan of the window.
      */
     double GetMean();
     /**
@@ -180,6 +853,16 @@ public:
      * @return Standard deviation value
      */
     double GetStandardDeviation();
+    /**
+     * @brief Gets the smallest value of the signal vector
+     * @return Minimum value (0 if the vector is empty)
+     */
+    double GetMin();
+    /**
+     * @brief Gets the largest value of the signal vector
+     * @return Maximum value (0 if the vector is empty)
+     */
+    double GetMax();
 
     /**
      * @brief Calculates the moving average of the last window_size values
@@ -192,25 +875,67 @@ public:
      * @param out_vector Destination vector
      * @param window_size Number of values to average
      */
-    void GetMovingAverageVector(double *out_vector, int window_size);
+    void GetMovingAverageVector(Acc *out_vector, int window_size);
 
     /**
-     * @brief Constructor for SignalProcessing class
+     * @brief Constructor for SignalProcessing class, check IsValid() for the result
+     * @param capacity Number of samples kept in the ring buffer (default NB_MAX_VALUES)
+     *
+     * When the buffer is full, every new value overwrites the oldest one and
+     * all analysis methods operate on the most recent samples.
+     */
+    SignalProcessingT(int capacity = NB_MAX_VALUES);
+    /**
+     * @brief Destructor, releases the ring buffer and the probability distribution
      */
-    SignalProcessing();
+    ~SignalProcessingT();
+    SignalProcessingT(const SignalProcessingT &) = delete;
+    SignalProcessingT &operator=(const SignalProcessingT &) = delete;
+    /**
+     * @brief Checks that the ring buffer was allocated
+     * @return true if the object can be used, false after an allocation failure (capacity 0)
+     */
+    bool IsValid() const;
     /**
      * @brief Adds a value to the signal vector
      * @param value Value to add
      * @return Current index
      */
-    int AddValue(double value);
+    int AddValue(T value);
     /**
      * @brief Adds a value with timestamp to the signal vector
      * @param value Value to add
      * @param ts Timestamp to associate with the value
      * @return Current index
      */
-    int AddValueWithTimestamp(double value, struct timespec ts);
+    int AddValueWithTimestamp(T value, struct timespec ts);
+    /**
+     * @brief Appends a block of values to the signal vector (e.g. one DMA buffer)
+     * @param values Values to add, oldest first
+     * @param n Number of values
+     * @return Number of values stored in the vector
+     *
+     * The block is copied with at most two memcpy segments per copy of the ring
+     * buffer. If n exceeds the capacity, only the newest GetMaxCapacity() values are kept.
+     */
+    int AddValues(const T *values, int n);
+    /**
+     * @brief Appends a block of values with one timestamp per value
+     * @param values Values to add, oldest first
+     * @param ts Timestamps associated with the values
+     * @param n Number of values
+     * @return Number of values stored in the vector
+     */
+    int AddValuesWithTimestamps(const T *values, const struct timespec *ts, int n);
+    /**
+     * @brief Appends a block of uniformly sampled values
+     * @param values Values to add, oldest first
+     * @param n Number of values
+     * @param start Timestamp of values[0]
+     * @param period_ns Sample period in nanoseconds
+     * @return Number of values stored in the vector
+     */
+    int AddValuesWithTimestamps(const T *values, int n, struct timespec start, long long period_ns);
     /**
      * @brief Sets the item identifier
      * @param Item Item value
@@ -226,7 +951,7 @@ public:
      * @brief Returns the last value added
      * @return Value
      */
-    double GetLastValue();
+    T GetLastValue();
     /**
      * @brief Returns the maximum capacity of the vector
      * @return Maximum capacity
@@ -238,10 +963,96 @@ public:
      */
     int GetSize();
     /**
-     * @brief Returns the current index
+     * @brief Returns the number of samples currently stored (at most GetMaxCapacity())
      * @return Index
      */
     int GetIndex();
+    /**
+     * @brief Returns the total number of samples added since construction or ClearVector()
+     * @return Total number of samples, including the ones already overwritten
+     */
+    long long GetTotalCount();
+    /**
+     * @brief Restricts all read and analysis methods to the most recent samples
+     * @param last_n Number of newest samples to analyze (0 = all stored samples)
+     *
+     * Indices passed to or returned by analysis methods (peaks, anomalies,
+     * FFT start index, GetValue...) are relative to the oldest sample of the window.
+     */
+    void SetAnalysisWindow(int last_n);
+    /**
+     * @brief Returns the number of samples seen by the analysis methods
+     * @return Effective analysis window length
+     */
+    int GetAnalysisWindow();
+    /**
+     * @brief Enables the single-producer/single-consumer ingest mode
+     * @param enable true to decouple readers from the producer
+     *
+     * In this mode one thread calls AddValue()/AddValueWithTimestamp() while
+     * another thread analyzes the data. The producer publishes each sample with
+     * a release store of the write cursor and never blocks. The reader sees the
+     * samples published at its last AcquireSnapshot() call and nothing newer.
+     * Set it before starting the threads. ClearVector(), InitVector() and the
+     * in-place operations (NormalizeVector, MultiplyWithValue...) must not run
+     * while the producer is active.
+     */
+    void SetConcurrentIngest(bool enable);
+    /**
+     * @brief Takes a snapshot of the samples published by the producer (consumer thread)
+     * @return Number of samples stored in the snapshot
+     *
+     * All read and analysis methods operate on this snapshot until the next call.
+     */
+    int AcquireSnapshot();
+    /**
+     * @brief Checks that the producer has not overwritten the snapshot window (consumer thread)
+     * @return true if the results computed since AcquireSnapshot() are consistent
+     *
+     * The producer may write GetMaxCapacity() - GetAnalysisWindow() - 1 samples
+     * after the snapshot before it starts overwriting the analysis window. Call
+     * this after the analysis and discard the results if it returns false.
+     */
+    bool IsSnapshotValid();
+    /**
+     * @brief Sizes the scratch workspace of the analysis methods up front
+     * @param bytes Size in bytes (0 = enough for an FFT of the whole capacity)
+     * @return true on success
+     *
+     * Temporary buffers (FFT arrays, sort copies, internal spectra) come from
+     * the workspace instead of malloc. Without this call it is sized from the
+     * analysis window on first use and grows to the largest demand.
+     */
+    bool ReserveWorkspace(size_t bytes = 0);
+    /**
+     * @brief Uses another workspace for the temporary buffers
+     * @param workspace Workspace shared by objects of one thread (nullptr = own workspace)
+     */
+    void SetWorkspace(SignalWorkspace *workspace);
+    /**
+     * @brief Gets the workspace used for the temporary buffers
+     * @return Workspace (the object's own one unless SetWorkspace() was called)
+     */
+    SignalWorkspace *GetWorkspace();
+    /**
+     * @brief Gets the generation of the analysis window
+     * @return Counter incremented whenever the samples seen by the analysis methods change
+     *
+     * Adding values, in-place operations, SetAnalysisWindow(), ClearVector()
+     * and AcquireSnapshot() start a new generation. The quartiles, the noise
+     * estimate, the spectrum of the whole window and the ML feature vector are
+     * computed once per generation: repeated queries on unchanged data return
+     * the stored result. Views, bank channels and files do not keep results,
+     * since their samples can change without the object knowing.
+     */
+    long long GetGeneration();
+    /**
+     * @brief Gets the number of derived results computed and stored
+     * @return Quartiles, noise estimates, spectra and feature vectors computed since construction
+     *
+     * Queries answered from the stored result leave the counter unchanged.
+     */
+    long long GetResultComputations();
     /**
      * @brief Returns the item identifier
      * @return Item
@@ -251,7 +1062,7 @@ public:
      * @brief Copies the signal vector to another vector
      * @param signalProc_vector Destination vector
      */
-    void GetVector(double *signalProc_vector);
+    void GetVector(T *signalProc_vector);
     /**
      * @brief Copies the signal vector to an int vector
      * @param signalProc_vector Destination vector
@@ -263,7 +1074,7 @@ public:
      * @param values Source vector
      * @param size Size
      */
-    void InitVector(double *values, int size);
+    void InitVector(const T *values, int size);
     /**
      * @brief Multiplies the signal vector by a value
      * @param value Value
@@ -294,7 +1105,7 @@ public:
      * @param size Size
      * @param offset Offset
      */
-    void GetVectorWithOffset(double *signalProc_vector,int size, int offset);
+    void GetVectorWithOffset(T *signalProc_vector,int size, int offset);
     /**
      * @brief Resets the signal vector
      */
@@ -409,14 +1220,14 @@ public:
      * @param peak_index Index of the peak in the signal vector
      * @return Value at the peak
      */
-    double GetPeakValue(int peak_index);
+    T GetPeakValue(int peak_index);
 
     /**
      * @brief Gets the signal value at a specific index
      * @param index Index in the signal vector
      * @return Value at the specified index
      */
-    double GetValue(int index);
+    T GetValue(int index);
     
     /**
      * @brief Gets the timestamp at a specific index
@@ -424,6 +1235,42 @@ public:
      * @return Timestamp at the specified index
      */
     struct timespec GetTimestamp(int index);
+    /**
+     * @brief Selects how timestamps are stored (clears the signal vector)
+     * @param mode TIMESTAMP_EXPLICIT (default, 8 bytes/sample), TIMESTAMP_DELTA
+     *             (5 bytes/sample) or TIMESTAMP_UNIFORM (no per-sample storage)
+     * @return true if successful
+     *
+     * TIMESTAMP_DELTA expects increasing timestamps and at most ~4.29 s between
+     * the first and the last sample of a TIMESTAMP_BLOCK group; larger offsets are
+     * clamped and counted by GetTimestampOverflowCount(). In TIMESTAMP_UNIFORM mode
+     * the timestamps passed to the Add methods are ignored, see SetUniformSampling().
+     */
+    bool SetTimestampMode(int mode);
+    /**
+     * @brief Returns the timestamp storage mode
+     * @return TIMESTAMP_EXPLICIT, TIMESTAMP_DELTA or TIMESTAMP_UNIFORM
+     */
+    int GetTimestampMode();
+    /**
+     * @brief Sets the sampling grid used in TIMESTAMP_UNIFORM mode
+     * @param t0 Timestamp of the first sample added after ClearVector()
+     * @param period_ns Sample period in nanoseconds
+     */
+    void SetUniformSampling(struct timespec t0, long long period_ns);
+    /**
+     * @brief Returns the number of timestamps clamped in TIMESTAMP_DELTA mode
+     * @return Number of clamped timestamps since the mode was set
+     */
+    long long GetTimestampOverflowCount();
+    /**
+     * @brief Finds the first sample at or after a given time
+     * @param ts Time to search for
+     * @return Index of the first sample with timestamp >= ts, GetAnalysisWindow() if none
+     *
+     * Timestamps must be increasing. O(1) in TIMESTAMP_UNIFORM mode, binary search otherwise.
+     */
+    int FindTimestampIndex(struct timespec ts);
 
     /**
      * @brief Applies a simple 1D Kalman filter for signal denoising
@@ -433,7 +1280,7 @@ public:
      * @param initial_estimate Initial state estimate (use 0 if unknown)
      * @param initial_error Initial error covariance (use 1.0 if unknown)
      */
-    void KalmanFilter(double process_noise, double measurement_noise, double *out_vector, 
+    void KalmanFilter(double process_noise, double measurement_noise, Acc *out_vector, 
                       double initial_estimate = 0.0, double initial_error = 1.0);
     
     /**
@@ -442,14 +1289,14 @@ public:
      * @param out_vector Output vector for denoised values (size >= GetIndex())
      * @param level Decomposition level (1-3, default 1)
      */
-    void WaveletDenoise(double threshold, double *out_vector, int level = 1);
+    void WaveletDenoise(double threshold, Acc *out_vector, int level = 1);
     
     /**
      * @brief Applies median filter for noise removal
      * @param window_size Window size (must be odd number, e.g., 3, 5, 7)
      * @param out_vector Output vector for filtered values (size >= GetIndex())
      */
-    void MedianFilter(int window_size, double *out_vector);
+    void MedianFilter(int window_size, Acc *out_vector);
     
     /**
      * @brief Estimates noise level using Median Absolute Deviation (MAD)
@@ -533,13 +1380,34 @@ public:
 
     // ========== FREQUENCY ANALYSIS ==========
     
+    /**
+     * @brief Selects the window function of FFTAnalysis() and of the spectral ML features
+     * @param window_type SIGNAL_WINDOW_* constant (SIGNAL_WINDOW_HANN by default)
+     * @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+     * @return false for an unknown window type (window unchanged)
+     *
+     * SIGNAL_WINDOW_FLATTOP reads sinusoid amplitudes accurately between bins,
+     * SIGNAL_WINDOW_KAISER trades main-lobe width for side-lobe level through
+     * beta, SIGNAL_WINDOW_TUKEY keeps most of the window flat. Cached spectra
+     * and features are recomputed with the new window.
+     */
+    bool SetSpectrumWindow(int window_type, double parameter = 0.0);
+    /**
+     * @brief Gets the window function of FFTAnalysis()
+     * @return SIGNAL_WINDOW_* constant
+     */
+    int GetSpectrumWindow() const;
+
     /**
      * @brief Performs FFT on a window of the signal
      * @param start_index Starting index of the window
-     * @param window_size Size of the window (will be rounded to nearest power of 2)
+     * @param window_size Size of the window, also the transform length (frequency resolution sampling_rate / window_size)
      * @param sampling_rate Sampling rate in Hz
      * @param spectrum Output structure containing frequency analysis
      * @return true if successful, false otherwise
+     *
+     * The samples are multiplied by the window of SetSpectrumWindow() (Hann
+     * unless changed), from a table cached per size (see SignalWindow).
      */
     bool FFTAnalysis(int start_index, int window_size, double sampling_rate, FrequencySpectrum *spectrum);
     
@@ -550,6 +1418,50 @@ public:
      * @return true if successful, false otherwise
      */
     bool FFTAnalysis(double sampling_rate, FrequencySpectrum *spectrum);
+
+    /**
+     * @brief Performs FFT on entire signal into caller-provided bins (no allocation)
+     * @param sampling_rate Sampling rate in Hz
+     * @param spectrum Output structure, spectrum->bins points to bins (do not call FreeSpectrum)
+     * @param bins Output bins
+     * @param max_bins Size of bins, at least GetAnalysisWindow() / 2 + 1
+     * @return true if successful, false otherwise (including max_bins too small)
+     */
+    bool FFTAnalysis(double sampling_rate, FrequencySpectrum *spectrum, FrequencyBin *bins, int max_bins);
+
+    /**
+     * @brief Performs a single-precision FFT on a window of the signal
+     * @param start_index Starting index of the window
+     * @param window_size Size of the window, also the transform length
+     * @param sampling_rate Sampling rate in Hz
+     * @param spectrum Output structure with float bins, release with FreeSpectrum()
+     * @return true if successful, false otherwise
+     *
+     * The window and the transform use float arithmetic (the float tables of
+     * SignalWindow and FFTPlan), whatever the sample type: twice the vector
+     * lanes of a double transform and half the memory per bin. Magnitudes
+     * match FFTAnalysis() to about 1e-6 of the largest one. A spectrum of the
+     * whole window already cached in double is converted instead.
+     */
+    bool FFTAnalysis(int start_index, int window_size, double sampling_rate, FrequencySpectrumF *spectrum);
+
+    /**
+     * @brief Performs a single-precision FFT on entire signal
+     * @param sampling_rate Sampling rate in Hz
+     * @param spectrum Output structure with float bins, release with FreeSpectrum()
+     * @return true if successful, false otherwise
+     */
+    bool FFTAnalysis(double sampling_rate, FrequencySpectrumF *spectrum);
+
+    /**
+     * @brief Performs a single-precision FFT on entire signal into caller-provided bins (no allocation)
+     * @param sampling_rate Sampling rate in Hz
+     * @param spectrum Output structure, spectrum->bins points to bins (do not call FreeSpectrum)
+     * @param bins Output bins
+     * @param max_bins Size of bins, at least GetAnalysisWindow() / 2 + 1
+     * @return true if successful, false otherwise (including max_bins too small)
+     */
+    bool FFTAnalysis(double sampling_rate, FrequencySpectrumF *spectrum, FrequencyBinF *bins, int max_bins);
     
     /**
      * @brief Finds peaks in frequency spectrum
@@ -599,6 +1511,59 @@ public:
      * @param spectrum Spectrum to free
      */
     void FreeSpectrum(FrequencySpectrum *spectrum);
+
+    /**
+     * @brief Frees memory allocated for a single-precision spectrum
+     * @param spectrum Spectrum to free
+     */
+    void FreeSpectrum(FrequencySpectrumF *spectrum);
+
+    /**
+     * @brief Estimates the power spectral density with Welch's method
+     * @param segment_length Samples per segment, also the transform length (>= 2)
+     * @param overlap Samples shared by consecutive segments (0 to segment_length - 1, segment_length / 2 is common)
+     * @param window_type SIGNAL_WINDOW_* constant, Kaiser and Tukey with their default parameter
+     * @param sampling_rate Sampling rate in Hz
+     * @param psd Output density, psd->psd allocated (release with FreePSD())
+     * @return true if successful, false if the analysis window is shorter than a segment
+     *
+     * The analysis window is cut into segments of segment_length samples,
+     * segment_length - overlap apart. Each segment has its mean removed, is
+     * windowed and transformed; the squared magnitudes are averaged and scaled
+     * by 1 / (sampling_rate * sum(w^2)), doubled for the bins folded from
+     * negative frequencies. The variance of each bin falls roughly as
+     * 1 / num_segments, which makes comparisons against a baseline far
+     * steadier than with a single FFTAnalysis(). Inputs of more than
+     * WELCH_PARALLEL_SAMPLES transformed samples are split over up to
+     * WELCH_MAX_THREADS threads with their own buffers.
+     */
+    bool WelchPSD(int segment_length, int overlap, int window_type, double sampling_rate, PowerSpectralDensity *psd);
+    /**
+     * @brief Estimates the power spectral density with Welch's method into a caller array
+     * @param segment_length Samples per segment (>= 2)
+     * @param overlap Samples shared by consecutive segments
+     * @param window_type Window function, see SIGNAL_WINDOW_HANN
+     * @param sampling_rate Sampling rate in Hz
+     * @param psd Output density, psd->psd points to values (do not call FreePSD())
+     * @param values Output array
+     * @param max_bins Size of values, at least segment_length / 2 + 1
+     * @return true if successful
+     */
+    bool WelchPSD(int segment_length, int overlap, int window_type, double sampling_rate, PowerSpectralDensity *psd,
+                  double *values, int max_bins);
+    /**
+     * @brief Frees memory allocated for a power spectral density
+     * @param psd Density to free
+     */
+    void FreePSD(PowerSpectralDensity *psd);
+    /**
+     * @brief Calculates power in a frequency band of a power spectral density
+     * @param psd Power spectral density
+     * @param freq_low Lower frequency bound (Hz)
+     * @param freq_high Upper frequency bound (Hz)
+     * @return Integral of the density over the bins in the band (units^2)
+     */
+    double GetPowerInBand(PowerSpectralDensity *psd, double freq_low, double freq_high);
     
     /**
      * @brief Detects frequency anomalies by comparing with baseline spectrum
@@ -611,6 +1576,17 @@ public:
                                    FrequencySpectrum *baseline_spectrum, 
                                    double threshold);
 
+    /**
+     * @brief Detects frequency anomalies by comparing power spectral densities
+     * @param current_psd Current density
+     * @param baseline_psd Baseline (normal) density, same segment length
+     * @param threshold Threshold for anomaly detection (amplitude ratio sqrt(current / baseline),
+     *                  as in the FrequencySpectrum version)
+     * @return Anomaly score (0 = normal, higher = more anomalous)
+     */
+    double DetectFrequencyAnomalies(PowerSpectralDensity *current_psd, PowerSpectralDensity *baseline_psd,
+                                    double threshold);
+
     // ========== ML/AI FEATURE EXTRACTION ==========
     
     /**
@@ -814,7 +1790,7 @@ public:
      * Reduces sampling rate by factor. If apply_antialiasing=true, applies
      * moving average filter to prevent aliasing artifacts.
      */
-    int Decimate(int factor, double *out_vector, bool apply_antialiasing = true);
+    int Decimate(int factor, Acc *out_vector, bool apply_antialiasing = true);
     
     /**
      * @brief Interpolates signal using linear interpolation (upsampling)
@@ -825,7 +1801,7 @@ public:
      * Increases sampling rate by inserting linearly interpolated values
      * between existing samples.
      */
-    int InterpolateLinear(int factor, double *out_vector);
+    int InterpolateLinear(int factor, Acc *out_vector);
     
     /**
      * @brief Resamples signal to a new sampling rate
@@ -837,7 +1813,7 @@ public:
      * Combines decimation and interpolation to achieve arbitrary resampling.
      * Example: 100 Hz → 48 Hz for audio processing
      */
-    int Resample(double current_rate, double target_rate, double *out_vector);
+    int Resample(double current_rate, double target_rate, Acc *out_vector);
 
     // ========== CORRELATION ANALYSIS ==========
     
@@ -846,6 +1822,7 @@ public:
      * @param max_lag Maximum lag to compute (number of shifts)
      * @param out_correlation Output array for autocorrelation values (size >= max_lag+1)
      * @param normalize If true, normalizes output to [-1, 1] range
+     * @param method CORRELATION_AUTO, CORRELATION_DIRECT or CORRELATION_FFT
      * @return Number of correlation values computed
      * 
      * Autocorrelation measures similarity of signal with delayed version of itself.
@@ -853,8 +1830,16 @@ public:
      * - Detecting periodicity
      * - Finding fundamental frequency
      * - Measuring signal predictability
-     */
-    int Autocorrelation(int max_lag, double *out_correlation, bool normalize = true);
+     *
+     * Value at lag k: sum of (x[i] - mean) (x[i + k] - mean) over the n - k
+     * pairs, divided by n - k. CORRELATION_FFT computes all the sums as the
+     * inverse transform of |X|^2, zero-padded to at least n + max_lag samples
+     * so that no lag wraps around; both methods agree up to rounding. The
+     * FFT sums are within about the precision of Acc times the lag 0 sum,
+     * so the last lags, averaged over few pairs, differ most in float.
+     * CORRELATION_AUTO takes the cheaper one for n and max_lag.
+     */
+    int Autocorrelation(int max_lag, Acc *out_correlation, bool normalize = true, int method = CORRELATION_AUTO);
     
     /**
      * @brief Computes cross-correlation between current signal and another signal
@@ -863,6 +1848,7 @@ public:
      * @param max_lag Maximum lag to compute (positive and negative)
      * @param out_correlation Output array for correlation values (size >= 2*max_lag+1)
      * @param normalize If true, normalizes output to [-1, 1] range
+     * @param method CORRELATION_AUTO, CORRELATION_DIRECT or CORRELATION_FFT
      * @return Number of correlation values computed
      * 
      * Cross-correlation measures similarity between two signals at different time shifts.
@@ -871,47 +1857,1242 @@ public:
      * - Pattern matching
      * - Signal alignment
      * - Detecting common patterns
-     */
-    int CrossCorrelation(double *signal2, int signal2_size, int max_lag, 
-                        double *out_correlation, bool normalize = true);
+     *
+     * out_correlation[max_lag + k] is the sum of (x[i] - mean) (signal2[i + k] - mean2)
+     * over the overlapping pairs, divided by their number (0 without overlap):
+     * a signal2 delayed by d samples peaks at k = d. CORRELATION_FFT computes
+     * all lags from one complex transform of both signals (x as the real,
+     * signal2 as the imaginary part) and one inverse transform, zero-padded
+     * so that no lag wraps around. The mean and variance of this signal come
+     * from the running statistics; signal2 is read once for its mean and
+     * once more for its variance when normalizing.
+     */
+    int CrossCorrelation(const T *signal2, int signal2_size, int max_lag, 
+                        Acc *out_correlation, bool normalize = true, int method = CORRELATION_AUTO);
+    
+    /**
+     * @brief Computes the generalized cross-correlation with phase transform (GCC-PHAT)
+     * @param signal2 Second signal array
+     * @param signal2_size Size of second signal
+     * @param max_lag Maximum lag to compute (positive and negative)
+     * @param out_correlation Output array, lag k at out_correlation[max_lag + k] (size >= 2*max_lag+1)
+     * @return Number of correlation values computed
+     *
+     * Same transforms as CrossCorrelation() with CORRELATION_FFT, but every
+     * bin of the cross-spectrum is divided by its magnitude (at least
+     * CORRELATION_PHAT_FLOOR of the largest) before the inverse transform.
+     * Only the phase, that is the delay, is kept: the peak is sharp and
+     * does not follow the strongest frequencies of the signals, which makes
+     * delays between sensors robust to resonances and coloured noise. The
+     * values are not a normalized correlation: identical signals give about
+     * 1 at lag 0, and the samples that only one signal contains lower the
+     * peak, the more so for strongly coloured signals.
+     */
+    int GCCPHAT(const T *signal2, int signal2_size, int max_lag, Acc *out_correlation);
     
     /**
      * @brief Finds the lag with maximum correlation value
-     * @param correlation Correlation array (from Autocorrelation or CrossCorrelation)
+     * @param correlation Correlation array (from Autocorrelation, CrossCorrelation or GCCPHAT)
      * @param size Size of correlation array
      * @param peak_value Output parameter for the peak correlation value
+     * @param peak_position Optional output: position of the peak with sub-sample precision
      * @return Lag index with maximum correlation
      * 
      * Useful for finding:
      * - Fundamental period (autocorrelation)
      * - Time delay between signals (cross-correlation)
+     *
+     * peak_position fits a parabola through the peak and its two neighbours:
+     * index + (c[-1] - c[+1]) / (2 (c[-1] - 2 c[0] + c[+1])), within half a
+     * sample of the index (the index itself at either end of the array).
+     * Subtract max_lag for the delay of a cross-correlation.
      */
-    int FindCorrelationPeak(double *correlation, int size, double *peak_value);
+    int FindCorrelationPeak(const Acc *correlation, int size, double *peak_value, double *peak_position = nullptr);
+
+protected:
+        SignalProcessingT(const T *data, int length);
+        SignalProcessingT(T *signal, long long *timestamps, int capacity, void *scratch, size_t scratch_bytes,
+                          FrequencyBin *spectrum_bins);
+        void BindView(const T *data, int length);
 
 private:
         int IndexOf(double value, prob_dist *pd);
-        void HaarWaveletTransform(double *data, int size, int direction);
+        void HaarWaveletTransform(Acc *data, int size, int direction);
         double SoftThreshold(double value, double threshold);
         void QuickSortDouble(double *arr, int low, int high);
         int PartitionDouble(double *arr, int low, int high);
-        void FFT(double *real, double *imag, int size, int direction);
-        int NextPowerOfTwo(int n);
-        void ApplyWindow(double *data, int size, int window_type);
+        void FFT(Acc *real, Acc *imag, int size, int direction);
+        void RealFFT(Acc *real, Acc *imag, int size);
+        void ApplyWindow(Acc *data, int size, int window_type, double parameter = 0.0);
+        bool ComputeSpectrum(int start_index, int window_size, double sampling_rate,
+                             FrequencySpectrum *spectrum, FrequencyBin *bins, int max_bins);
+        bool ComputeSpectrum(int start_index, int window_size, double sampling_rate,
+                             FrequencySpectrumF *spectrum, FrequencyBinF *bins, int max_bins);
+        bool IsCached(long long result_generation);
+        bool CachedSpectrum(double sampling_rate, FrequencySpectrum *spectrum);
+        bool GetQuartiles(double *q1, double *q3);
+        bool LaggedProducts(const T *signal, int length, Acc offset, int max_lag, int method, Acc *sums);
+        bool CrossProducts(const T *signal2, int length2, Acc mean, Acc mean2, int max_lag, int method, bool phat,
+                           Acc *sums);
+        void *Scratch(size_t bytes);
+        T *WindowData();
+        int WindowSize();
+        int WindowStart();
+        int TimestampSlot(int window_index);
+        int Publish(int n);
+        int WriteBlock(const T *values, const struct timespec *ts, int n,
+                       long long start_ns, long long period_ns);
+        void StoreTimestamp(int slot, long long ns);
+        void ClearTimestamps(int slot, int n);
+        long long LoadTimestamp(int window_index, bool *valid);
+        void SyncMirror(int offset, int length);
+        void UpdateRunningStats(const T *values, int n);
+        void PrepareRunningStats();
+        void RefreshRunningStats();
+        void RefreshRunningExtrema();
+        template <typename, typename> friend class SignalBankT;
+        template <typename, typename> friend class SpectrogramT;
+        template <typename, typename> friend class ToneTrackerT;
+        void BindStorage(T *signal, long long *timestamps, int capacity, int count,
+                         long long total, int analysis_window);
+        /**
+         * @brief Signal ring buffer, stored twice (2 * capacity) so that the
+         * newest samples are always contiguous in memory
+         */
+        T *SignalVector;
+        bool owns_storage;
         /**
-         * @brief Signal vector
+         * @brief Samples, timestamps and workspace provided by SignalProcessingFixed
+         * (never freed, no heap allocation)
          */
-        double SignalVector[NB_MAX_VALUES];
+        bool inline_storage;
+        long long *inline_timestamps;
+        bool writable;
         index_lookup_table index_lookup[MAX_INDX];
-        timespec signal_timestamp[NB_MAX_VALUES];
         int item;
         /**
-         * @brief total number of values added in SignalVector
+         * @brief Timestamp storage mode (TIMESTAMP_EXPLICIT, TIMESTAMP_DELTA, TIMESTAMP_UNIFORM)
+         */
+        int timestamp_mode;
+        /**
+         * @brief TIMESTAMP_EXPLICIT: nanoseconds since the epoch, one per slot (0 = no timestamp)
+         */
+        long long *timestamp_ns;
+        /**
+         * @brief TIMESTAMP_DELTA: base timestamp of each group of TIMESTAMP_BLOCK slots,
+         * two per group (index group * 2 + lap parity)
+         */
+        long long *timestamp_base;
+        /**
+         * @brief TIMESTAMP_DELTA: offset of each slot from its group base (0xFFFFFFFF = no timestamp)
+         */
+        unsigned int *timestamp_delta;
+        /**
+         * @brief TIMESTAMP_DELTA: group base (group * 2 + lap parity) in use by the producer
+         */
+        int timestamp_open_block;
+        long long timestamp_overflow;
+        /**
+         * @brief TIMESTAMP_UNIFORM: timestamp of sample 0 and sample period (ns)
+         */
+        long long uniform_t0_ns;
+        long long uniform_period_ns;
+        /**
+         * @brief Ring buffer capacity
+         */
+        int capacity;
+        /**
+         * @brief Next write position in the ring buffer (producer side)
+         */
+        int head;
+        /**
+         * @brief Parity of the lap the producer is writing (toggles when head wraps)
+         */
+        int head_lap;
+        /**
+         * @brief Total number of values published in SignalVector (written by the producer)
+         */
+        std::atomic<long long> write_cursor;
+        /**
+         * @brief Total number of values visible to the readers (snapshot of write_cursor)
+         */
+        long long read_cursor;
+        /**
+         * @brief Number of valid values in the reader snapshot
+         */
+        int count;
+        /**
+         * @brief Single-producer/single-consumer mode flag
+         */
+        bool concurrent_ingest;
+        /**
+         * @brief Analysis window length (0 = all stored samples)
+         */
+        int analysis_window;
+        /**
+         * @brief Running statistics of the analysis window: Kahan-compensated
+         * sums of (x - stats_shift) and (x - stats_shift)^2
+         */
+        bool stats_valid;
+        int stats_count;
+        int stats_removed;
+        double stats_shift;
+        double stats_sum;
+        double stats_sum_c;
+        double stats_sumsq;
+        double stats_sumsq_c;
+        /**
+         * @brief Running extrema, rescanned when a sample equal to one of them leaves the window
+         */
+        bool extrema_valid;
+        double stats_min;
+        double stats_max;
+        /**
+         * @brief Scratch memory of the analysis methods (own_workspace unless shared)
+         */
+        SignalWorkspace own_workspace;
+        SignalWorkspace *workspace;
+        /**
+         * @brief Generation of the analysis window, and generation of each stored result (-1 = none)
+         */
+        long long generation;
+        long long quartiles_generation;
+        double cached_q1;
+        double cached_q3;
+        long long noise_generation;
+        double cached_noise;
+        long long spectrum_generation;
+        double spectrum_rate;
+        /**
+         * @brief Window of FFTAnalysis() and the spectral features
          */
-        int index;
+        int spectrum_window_type;
+        double spectrum_window_parameter;
+        FrequencySpectrum cached_spectrum;
+        /**
+         * @brief Bins of cached_spectrum (inline for SignalProcessingFixed, malloc'd otherwise)
+         */
+        FrequencyBin *cached_bins;
+        int cached_bins_capacity;
+        long long features_generation;
+        double features_rate;
+        MLFeatureVector cached_features;
+        /**
+         * @brief Results stored since construction, see GetResultComputations()
+         */
+        long long result_computations;
         timespec timestamp;
         prob_dist *p_d;
         bool threshold_crossing_flag;
         bool zero_crossing_flag;
     };
 
+typedef SignalProcessingT<double> SignalProcessing;
+typedef SignalProcessingT<float> SignalProcessingF;
+typedef SignalProcessingT<int16_t> SignalProcessingI16;
+
+/**
+ * @brief Read-only view of samples owned by the caller
+ * @tparam T Storage type of the samples
+ * @tparam Acc Accumulator type used for sums, filter outputs and FFT buffers
+ *
+ * Every analysis method of SignalProcessingT (statistics, peaks, anomalies,
+ * FFT, correlation, ML features) runs directly on the external samples,
+ * without the AddValue copy and without allocating a ring buffer. The data
+ * must stay valid while the view is used. Adding values and the in-place
+ * operations (NormalizeVector, ScaleVector, *WithValue) are ignored.
+ *
+ * A stride > 1 (one channel of interleaved data) is gathered once into a
+ * compact buffer owned by the view. Timestamps read as zero unless
+ * SetUniformSampling() is called on the view.
+ */
+template <typename T, typename Acc = typename SampleTraits<T>::Accumulator>
+class SignalViewT : public SignalProcessingT<T, Acc>{
+public:
+    /**
+     * @brief Creates a view over external samples
+     * @param data Oldest sample
+     * @param length Number of samples
+     * @param stride Distance between two samples, in elements (default 1)
+     */
+    SignalViewT(const T *data, int length, int stride = 1);
+    /**
+     * @brief Destructor, releases the gather buffer of strided views
+     */
+    ~SignalViewT();
+    SignalViewT(const SignalViewT &) = delete;
+    SignalViewT &operator=(const SignalViewT &) = delete;
+
+    /**
+     * @brief Points the view at other samples
+     * @param data Oldest sample
+     * @param length Number of samples
+     * @param stride Distance between two samples, in elements (default 1)
+     */
+    void Reset(const T *data, int length, int stride = 1);
+
+private:
+        T *gathered;
+        int gathered_capacity;
+    };
+
+typedef SignalViewT<double> SignalView;
+typedef SignalViewT<float> SignalViewF;
+typedef SignalViewT<int16_t> SignalViewI16;
+
+/**
+ * @brief Storage of SignalProcessingFixed, a base class so that it is
+ * constructed before SignalProcessingT binds it
+ */
+template <int N, typename T, typename Acc>
+struct SignalFixedStorage
+{
+    T fixed_signal[2 * N];
+    long long fixed_timestamps[N];
+    unsigned char fixed_workspace[SignalWorkspaceBytes(N, sizeof(Acc)) + SIGNALBANK_ALIGNMENT];
+    FrequencyBin fixed_spectrum[N / 2 + 1];
+};
+
+/**
+ * @brief Ring buffer whose capacity is fixed at compile time, without heap allocation
+ * @tparam N Capacity in samples
+ * @tparam T Storage type of the samples
+ * @tparam Acc Accumulator type used for sums, filter outputs and FFT buffers
+ *
+ * The mirrored samples, the explicit timestamps, the scratch workspace and the
+ * cached spectrum are members of the object, sized from N: construction, ingest and the analysis
+ * methods make no heap allocation, and instances of different capacities
+ * (256-sample tachometer, 65536-sample vibration channel) only take the
+ * memory they need. Large instances belong in static storage rather than on
+ * the stack (about 2 * N * sizeof(T) + 8 * N bytes plus the workspace, see
+ * WORKSPACE_BYTES, and SPECTRUM_BINS * sizeof(FrequencyBin)).
+ *
+ * TIMESTAMP_DELTA is not available (SetTimestampMode() returns false), and
+ * NormalDistributionRun() allocates its table on first use. The FFT and
+ * window tables are shared by the process and built on first use of a size:
+ * call FFTPlan::Get(FFT_SIZE, 1), FFTPlan::Get(FFT_SIZE / 2, 1) and
+ * SignalWindow::Get(SIGNAL_WINDOW_HANN, N) (or the window of
+ * SetSpectrumWindow()) at start-up to keep the analysis free of allocation,
+ * and the same two plans of CORRELATION_FFT_SIZE for ExtractMLFeatures().
+ */
+template <int N, typename T = double, typename Acc = typename SampleTraits<T>::Accumulator>
+class SignalProcessingFixed : private SignalFixedStorage<N, T, Acc>, public SignalProcessingT<T, Acc>{
+    static_assert(N > 0, "SignalProcessingFixed needs a positive capacity");
+
+public:
+    /**
+     * @brief Ring buffer capacity
+     */
+    static const int CAPACITY = N;
+    /**
+     * @brief FFT length of a full window (N itself, no zero padding)
+     */
+    static const int FFT_SIZE = N;
+    /**
+     * @brief Number of bins of the spectrum of a full window, for FFTAnalysis() into caller bins
+     */
+    static const int SPECTRUM_BINS = FFT_SIZE / 2 + 1;
+    /**
+     * @brief FFT length of the autocorrelation feature of ExtractMLFeatures() (lags below 100), when CORRELATION_AUTO picks the FFT
+     */
+    static const int CORRELATION_FFT_SIZE = SignalCorrelationLength(N, (N > 100) ? 99 : N / 2 - 1);
+    /**
+     * @brief Size of the scratch workspace in bytes
+     */
+    static const size_t WORKSPACE_BYTES = SignalWorkspaceBytes(N, sizeof(Acc));
+
+    /**
+     * @brief Creates an empty ring buffer of N samples
+     */
+    SignalProcessingFixed()
+        : SignalProcessingT<T, Acc>(this->fixed_signal, this->fixed_timestamps, N,
+                                    this->fixed_workspace, sizeof(this->fixed_workspace), this->fixed_spectrum)
+    {
+    }
+    SignalProcessingFixed(const SignalProcessingFixed &) = delete;
+    SignalProcessingFixed &operator=(const SignalProcessingFixed &) = delete;
+};
+
+template <int N, typename T, typename Acc> const int SignalProcessingFixed<N, T, Acc>::CAPACITY;
+template <int N, typename T, typename Acc> const int SignalProcessingFixed<N, T, Acc>::FFT_SIZE;
+template <int N, typename T, typename Acc> const int SignalProcessingFixed<N, T, Acc>::SPECTRUM_BINS;
+template <int N, typename T, typename Acc> const int SignalProcessingFixed<N, T, Acc>::CORRELATION_FFT_SIZE;
+template <int N, typename T, typename Acc> const size_t SignalProcessingFixed<N, T, Acc>::WORKSPACE_BYTES;
+
+/**
+ * @brief Header at the start of a signal file, followed by the raw samples
+ *
+ * All fields and samples are little-endian. The samples start at header_size
+ * bytes from the beginning of the file.
+ */
+typedef struct SignalFileHeader
+{
+    char magic[8];              ///< SIGNALFILE_MAGIC, not null-terminated
+    unsigned int version;       ///< SIGNALFILE_VERSION
+    unsigned int sample_type;   ///< SIGNALFILE_DOUBLE, SIGNALFILE_FLOAT or SIGNALFILE_INT16
+    unsigned int sample_size;   ///< Bytes per sample
+    unsigned int header_size;   ///< Offset of the first sample in bytes
+    double sample_rate;         ///< Sampling rate in Hz
+    long long t0_ns;            ///< Timestamp of the first sample (ns since the epoch)
+    long long num_samples;      ///< Number of samples following the header
+    unsigned char reserved[16];
+} SignalFileHeader;
+
+/**
+ * @brief Read-only analysis of a recording stored in a memory-mapped file
+ * @tparam T Storage type of the samples, must match the sample type of the file
+ * @tparam Acc Accumulator type used for sums, filter outputs and FFT buffers
+ *
+ * The file is mapped read-only and shared, so the OS pages the samples in on
+ * demand and several processes can analyse the same recording. The object is
+ * a view over the selected range of the file: every analysis method of
+ * SignalProcessingT runs on it without loading the recording into memory.
+ * Open() selects the whole file (at most INT_MAX samples); SelectRange()
+ * moves to any other part of longer recordings. Timestamps are uniform,
+ * computed from t0 and the sampling rate of the header.
+ */
+template <typename T, typename Acc = typename SampleTraits<T>::Accumulator>
+class SignalFileT : public SignalProcessingT<T, Acc>{
+public:
+    /**
+     * @brief Creates an object with no file open
+     */
+    SignalFileT();
+    /**
+     * @brief Creates an object and opens a signal file
+     * @param path File to map, check IsOpen() for the result
+     */
+    explicit SignalFileT(const char *path);
+    /**
+     * @brief Destructor, unmaps the file
+     */
+    ~SignalFileT();
+    SignalFileT(const SignalFileT &) = delete;
+    SignalFileT &operator=(const SignalFileT &) = delete;
+
+    /**
+     * @brief Maps a signal file and selects all of its samples
+     * @param path File to map
+     * @return true on success, false if the file cannot be mapped, the header
+     *         is invalid or the sample type differs from T
+     */
+    bool Open(const char *path);
+    /**
+     * @brief Unmaps the file, the selected range becomes empty
+     */
+    void Close();
+    /**
+     * @brief Tells whether a file is mapped
+     * @return true if a file is open
+     */
+    bool IsOpen() const;
+
+    /**
+     * @brief Selects the samples analysed by the SignalProcessingT methods
+     * @param first Index of the first sample in the file
+     * @param length Number of samples
+     * @return true on success, false if the range is outside the file
+     */
+    bool SelectRange(long long first, int length);
+    /**
+     * @brief Gets the file index of the first selected sample
+     * @return Index in the file
+     */
+    long long GetRangeStart() const;
+    /**
+     * @brief Gets the number of samples in the file
+     * @return Number of samples
+     */
+    long long GetFileSampleCount() const;
+    /**
+     * @brief Gets the sampling rate stored in the header
+     * @return Sampling rate in Hz
+     */
+    double GetSampleRate() const;
+    /**
+     * @brief Gets the timestamp of the first sample of the file
+     * @return Timestamp
+     */
+    struct timespec GetStartTime() const;
+
+    /**
+     * @brief Writes a signal file (header and samples), replacing any existing file
+     * @param path File to write
+     * @param samples Samples to write (can be nullptr if count is 0)
+     * @param count Number of samples
+     * @param sample_rate Sampling rate in Hz
+     * @param t0 Timestamp of the first sample
+     * @return true on success
+     */
+    static bool WriteFile(const char *path, const T *samples, long long count,
+                          double sample_rate, struct timespec t0);
+    /**
+     * @brief Appends samples to a signal file and updates its header
+     * @param path File created by WriteFile()
+     * @param samples Samples to append
+     * @param count Number of samples
+     * @return true on success
+     *
+     * Lets a long recording be written block by block. Readers that already
+     * mapped the file keep seeing the samples present when they opened it.
+     */
+    static bool AppendToFile(const char *path, const T *samples, long long count);
+
+private:
+        void *mapping;
+        size_t mapping_size;
+        void *map_handle;
+        const T *samples;
+        long long num_samples;
+        double sample_rate;
+        long long t0_ns;
+        long long range_start;
+    };
+
+typedef SignalFileT<double> SignalFile;
+typedef SignalFileT<float> SignalFileF;
+typedef SignalFileT<int16_t> SignalFileI16;
+
+/**
+ * @brief Bank of channels sampled together, stored in one planar allocation
+ * @tparam T Storage type of the samples
+ * @tparam Acc Accumulator type used for sums, filter outputs and FFT buffers
+ *
+ * Every channel is a ring buffer of the same capacity laid out contiguously
+ * (aligned to SIGNALBANK_ALIGNMENT bytes) in a single allocation. The channels
+ * advance together frame by frame and share one timestamp per frame, the
+ * layout expected by SignalRecorder::addSynchronizedChannels().
+ *
+ * Planar output arrays hold GetAnalysisWindow() values per channel:
+ * out[channel * GetAnalysisWindow() + i].
+ *
+ * FFTAnalysis() and FFTMagnitudeMatrix() transform the channels in groups
+ * through FFTPlan::ExecuteRealBatch(), several channels per vector, instead
+ * of one channel at a time.
+ */
+template <typename T, typename Acc = typename SampleTraits<T>::Accumulator>
+class SignalBankT{
+public:
+    /**
+     * @brief Constructor for SignalBankT class
+     * @param num_channels Number of channels
+     * @param capacity Number of frames kept in the ring buffer (default NB_MAX_VALUES)
+     */
+    SignalBankT(int num_channels, int capacity = NB_MAX_VALUES);
+    /**
+     * @brief Destructor, releases the channel storage
+     */
+    ~SignalBankT();
+    SignalBankT(const SignalBankT &) = delete;
+    SignalBankT &operator=(const SignalBankT &) = delete;
+
+    /**
+     * @brief Gets the number of channels
+     * @return Number of channels
+     */
+    int GetNumChannels();
+    /**
+     * @brief Gets the number of frames the ring buffer can hold
+     * @return Capacity in frames
+     */
+    int GetMaxCapacity();
+    /**
+     * @brief Gets the number of frames stored
+     * @return Number of stored frames
+     */
+    int GetIndex();
+    /**
+     * @brief Gets the total number of frames added since the last ClearVector()
+     * @return Total number of frames, including overwritten ones
+     */
+    long long GetTotalCount();
+    /**
+     * @brief Restricts all channel and batch methods to the newest frames
+     * @param last_n Number of newest frames (0 = all stored frames)
+     */
+    void SetAnalysisWindow(int last_n);
+    /**
+     * @brief Gets the number of frames seen by the analysis methods
+     * @return Analysis window length
+     */
+    int GetAnalysisWindow();
+    /**
+     * @brief Removes all frames
+     */
+    void ClearVector();
+
+    /**
+     * @brief Adds one sample to every channel
+     * @param values One value per channel
+     * @return Number of frames stored
+     */
+    int AddFrame(const T *values);
+    /**
+     * @brief Adds one sample to every channel with a shared timestamp
+     * @param values One value per channel
+     * @param ts Timestamp of the frame
+     * @return Number of frames stored
+     */
+    int AddFrameWithTimestamp(const T *values, struct timespec ts);
+    /**
+     * @brief Adds a block of interleaved frames (values[frame * channels + channel])
+     * @param values Interleaved values, oldest frame first
+     * @param frames Number of frames
+     * @return Number of frames stored
+     */
+    int AddFrames(const T *values, int frames);
+    /**
+     * @brief Adds a block of interleaved frames with one timestamp per frame
+     * @param values Interleaved values, oldest frame first
+     * @param ts Timestamps of the frames
+     * @param frames Number of frames
+     * @return Number of frames stored
+     */
+    int AddFramesWithTimestamps(const T *values, const struct timespec *ts, int frames);
+    /**
+     * @brief Adds a block given channel by channel (values[channel * frames + frame])
+     * @param values Planar values, oldest frame first in each channel
+     * @param frames Number of frames
+     * @return Number of frames stored
+     */
+    int AddPlanarFrames(const T *values, int frames);
+
+    /**
+     * @brief Gets the analysis window of one channel
+     * @param channel Channel number
+     * @return GetAnalysisWindow() contiguous samples, nullptr for an invalid channel
+     */
+    const T *GetChannelData(int channel);
+    /**
+     * @brief Gets a sample of one channel
+     * @param channel Channel number
+     * @param index Index relative to the oldest frame of the analysis window
+     * @return Sample value (0 if out of range)
+     */
+    T GetValue(int channel, int index);
+    /**
+     * @brief Gets the shared timestamp of a frame
+     * @param index Index relative to the oldest frame of the analysis window
+     * @return Timestamp (zero if the frame was added without timestamp)
+     */
+    struct timespec GetTimestamp(int index);
+    /**
+     * @brief Gives access to every analysis method of SignalProcessingT for one channel
+     * @param channel Channel number (clamped to the valid range)
+     * @return Read-only signal bound to the channel storage, without copy
+     *
+     * The returned object is shared by all channels and rebound on every call,
+     * so use it before calling Channel() again. Adding values through it is ignored.
+     */
+    SignalProcessingT<T, Acc> &Channel(int channel);
+
+    // ========== BATCH STATISTICS (one value per channel) ==========
+    /**
+     * @brief Calculates the mean of every channel
+     * @param out_values Output array (size >= GetNumChannels())
+     */
+    void GetMeans(double *out_values);
+    /**
+     * @brief Calculates the variance of every channel
+     * @param out_values Output array (size >= GetNumChannels())
+     */
+    void GetVariances(double *out_values);
+    /**
+     * @brief Calculates the standard deviation of every channel
+     * @param out_values Output array (size >= GetNumChannels())
+     */
+    void GetStandardDeviations(double *out_values);
+
+    // ========== BATCH FILTERS (planar outputs) ==========
+    /**
+     * @brief Moving average of every channel
+     * @param out_vector Planar output (size >= GetNumChannels() * GetAnalysisWindow())
+     * @param window_size Number of values to average
+     */
+    void GetMovingAverageVector(Acc *out_vector, int window_size);
+    /**
+     * @brief Exponential smoothing of every channel
+     * @param alpha Smoothing factor (0 < alpha <= 1)
+     * @param out_vector Planar output (size >= GetNumChannels() * GetAnalysisWindow())
+     */
+    void ExponentialSmoothing(double alpha, Acc *out_vector);
+    /**
+     * @brief Kalman filter applied to every channel
+     * @param process_noise Process noise covariance (Q)
+     * @param measurement_noise Measurement noise covariance (R)
+     * @param out_vector Planar output (size >= GetNumChannels() * GetAnalysisWindow())
+     * @param initial_estimate Initial state estimate
+     * @param initial_error Initial error covariance
+     */
+    void KalmanFilter(double process_noise, double measurement_noise, Acc *out_vector,
+                      double initial_estimate = 0.0, double initial_error = 1.0);
+    /**
+     * @brief Median filter applied to every channel
+     * @param window_size Window size (odd, up to 101)
+     * @param out_vector Planar output (size >= GetNumChannels() * GetAnalysisWindow())
+     */
+    void MedianFilter(int window_size, Acc *out_vector);
+
+    // ========== BATCH FREQUENCY ANALYSIS ==========
+    /**
+     * @brief FFT analysis of the analysis window of every channel
+     * @param sampling_rate Sampling rate in Hz
+     * @param spectra Output spectra (GetNumChannels() entries), release with FreeSpectra()
+     * @return true if every channel was analyzed
+     */
+    bool FFTAnalysis(double sampling_rate, FrequencySpectrum *spectra);
+    /**
+     * @brief Single-precision FFT analysis of the analysis window of every channel
+     * @param sampling_rate Sampling rate in Hz
+     * @param spectra Output spectra with float bins (GetNumChannels() entries), release with FreeSpectra()
+     * @return true if every channel was analyzed
+     *
+     * The batch transforms run in float whatever the sample type.
+     */
+    bool FFTAnalysis(double sampling_rate, FrequencySpectrumF *spectra);
+    /**
+     * @brief Magnitudes of the FFT of the analysis window of every channel
+     * @param out_matrix Output matrix, bin k of channel c at out_matrix[c * GetNumBins() + k]
+     * (size >= GetNumChannels() * GetNumBins())
+     * @return false if the analysis window holds fewer than 2 frames
+     */
+    bool FFTMagnitudeMatrix(Acc *out_matrix);
+    /**
+     * @brief Gets the number of bins of the spectra of FFTAnalysis() and FFTMagnitudeMatrix()
+     * @return GetAnalysisWindow() / 2 + 1
+     */
+    int GetNumBins();
+    /**
+     * @brief Selects the window applied before the FFT of every channel (Hann by default)
+     * @param window_type SIGNAL_WINDOW_* constant
+     * @param parameter Kaiser beta or Tukey alpha, <= 0 for the default
+     * @return false for an unknown window type (window unchanged)
+     */
+    bool SetSpectrumWindow(int window_type, double parameter = 0.0);
+    /**
+     * @brief Releases the spectra computed by FFTAnalysis()
+     * @param spectra Spectra (GetNumChannels() entries)
+     */
+    void FreeSpectra(FrequencySpectrum *spectra);
+    /**
+     * @brief Releases the single-precision spectra computed by FFTAnalysis()
+     * @param spectra Spectra (GetNumChannels() entries)
+     */
+    void FreeSpectra(FrequencySpectrumF *spectra);
+
+    // ========== CROSS-CHANNEL ANALYSIS ==========
+    /**
+     * @brief Mean across channels at every frame (common-mode signal)
+     * @param out_vector Output array (size >= GetAnalysisWindow())
+     */
+    void GetCrossChannelMean(Acc *out_vector);
+    /**
+     * @brief Pearson correlation coefficient between every pair of channels
+     * @param out_matrix Output matrix, row-major (size >= GetNumChannels()^2)
+     *
+     * Channels with zero variance get a coefficient of 0 (1 on the diagonal).
+     */
+    void GetCorrelationMatrix(double *out_matrix);
+
+private:
+        T *ChannelBase(int channel);
+        template <typename F, typename Spectrum>
+        bool BatchSpectra(double sampling_rate, Spectrum *spectra, F *out_matrix);
+        int WriteFrames(const T *values, int frame_step, int channel_step,
+                        const struct timespec *ts, int frames);
+        T *storage;
+        long long *timestamp_ns;
+        int num_channels;
+        int capacity;
+        size_t channel_stride;
+        int head;
+        int count;
+        long long total;
+        int analysis_window;
+        SignalProcessingT<T, Acc> channel_view;
+    };
+
+typedef SignalBankT<double> SignalBank;
+typedef SignalBankT<float> SignalBankF;
+typedef SignalBankT<int16_t> SignalBankI16;
+
+/**
+ * @brief Streaming short-time Fourier transform (spectrogram)
+ * @tparam T Type of the input samples
+ * @tparam Acc Type of the FFT buffers and of the output frames (double or float)
+ *
+ * Samples are pushed as they arrive; every hop_size samples, once window_size
+ * samples have been seen, the newest window_size samples are windowed and
+ * transformed and one frame of window_size / 2 + 1 values is written to the
+ * next row of a time-by-frequency matrix of max_frames rows, overwriting the
+ * oldest row when full (a waterfall). The window table, the FFT plan, the
+ * input ring and the FFT scratch are set up by the constructor, so adding
+ * samples makes no heap allocation. Bin k is at k * sampling_rate /
+ * window_size. With SIGNAL_WINDOW_HANN and SPECTROGRAM_MAGNITUDE a frame has
+ * the magnitudes of FFTAnalysis() over the same samples. Not thread-safe.
+ */
+template <typename T, typename Acc = typename SampleTraits<T>::Accumulator>
+class SpectrogramT{
+public:
+    /**
+     * @brief Constructor for SpectrogramT class, check IsValid() for the result
+     * @param window_size Samples per frame, also the transform length (>= 2)
+     * @param hop_size Samples between the starts of consecutive frames (>= 1; overlap = window_size - hop_size)
+     * @param max_frames Rows of the frame matrix
+     * @param window_type SIGNAL_WINDOW_* constant, Kaiser and Tukey with their default parameter
+     * @param output SPECTROGRAM_MAGNITUDE, SPECTROGRAM_POWER or SPECTROGRAM_DB
+     * @param matrix Caller memory for max_frames * GetNumBins() values (nullptr = allocated); never freed by the spectrogram
+     */
+    SpectrogramT(int window_size, int hop_size, int max_frames, int window_type = SIGNAL_WINDOW_HANN,
+                 int output = SPECTROGRAM_MAGNITUDE, Acc *matrix = nullptr);
+    /**
+     * @brief Destructor, releases the buffers
+     */
+    ~SpectrogramT();
+    SpectrogramT(const SpectrogramT &) = delete;
+    SpectrogramT &operator=(const SpectrogramT &) = delete;
+
+    /**
+     * @brief Checks that the parameters were valid and the buffers allocated
+     * @return true if the spectrogram can be used
+     */
+    bool IsValid() const;
+    /**
+     * @brief Gets the number of samples per frame
+     * @return Window size
+     */
+    int GetWindowSize() const;
+    /**
+     * @brief Gets the number of samples between frames
+     * @return Hop size
+     */
+    int GetHopSize() const;
+    /**
+     * @brief Gets the number of values per frame
+     * @return window_size / 2 + 1
+     */
+    int GetNumBins() const;
+    /**
+     * @brief Gets the number of rows of the frame matrix
+     * @return Maximum number of stored frames
+     */
+    int GetMaxFrames() const;
+    /**
+     * @brief Gets the number of stored frames
+     * @return Frames available to GetFrame(), at most GetMaxFrames()
+     */
+    int GetFrameCount() const;
+    /**
+     * @brief Gets the number of frames computed since construction or Reset()
+     * @return Total number of frames, including overwritten ones
+     */
+    long long GetTotalFrames() const;
+    /**
+     * @brief Gets the number of samples consumed since construction or Reset()
+     * @return Sample count, including samples skipped by Update()
+     */
+    long long GetSampleCount() const;
+    /**
+     * @brief Removes the stored frames and the pending input
+     */
+    void Reset();
+
+    /**
+     * @brief Adds one sample
+     * @param value Sample
+     * @return Number of frames computed (0 or 1)
+     */
+    int AddValue(T value);
+    /**
+     * @brief Adds a block of samples
+     * @param values Samples, oldest first
+     * @param n Number of samples
+     * @return Number of frames computed
+     */
+    int AddValues(const T *values, int n);
+    /**
+     * @brief Adds the samples added to a signal since the previous Update() with it
+     * @param signal Signal ring buffer, read on the thread that adds its samples
+     * @return Number of frames computed
+     *
+     * Samples overwritten in the ring buffer before they were read are
+     * skipped: they count in GetSampleCount() and the next frame starts after
+     * them, so sample numbers follow the GetTotalCount() of the signal. The
+     * first call reads every stored sample.
+     */
+    int Update(SignalProcessingT<T, Acc> *signal);
+
+    /**
+     * @brief Gets a stored frame
+     * @param index 0 for the oldest stored frame, GetFrameCount() - 1 for the newest
+     * @return GetNumBins() values, nullptr if index is out of range; valid until the row is overwritten
+     */
+    const Acc *GetFrame(int index) const;
+    /**
+     * @brief Gets the first sample of a stored frame
+     * @param index 0 for the oldest stored frame, GetFrameCount() - 1 for the newest
+     * @return Sample number (see GetSampleCount()) of the first sample of the frame, -1 if index is out of range
+     */
+    long long GetFrameStart(int index) const;
+    /**
+     * @brief Copies the newest stored frames in time order
+     * @param out Output matrix, max_frames rows of GetNumBins() values
+     * @param max_frames Number of rows of out
+     * @return Number of rows written
+     */
+    int CopyFrames(Acc *out, int max_frames) const;
+
+private:
+        int Row(int index) const;
+        void ComputeFrame();
+        int window_size;
+        int hop_size;
+        int num_bins;
+        int max_frames;
+        int output;
+        const FFTPlan *plan;
+        /**
+         * @brief Window function, window_size values of the shared SignalWindow table
+         */
+        const Acc *window;
+        /**
+         * @brief Newest window_size samples, next one written at input_pos
+         */
+        Acc *input;
+        int input_pos;
+        /**
+         * @brief Samples still needed before the next frame
+         */
+        int until_frame;
+        Acc *real;
+        Acc *imag;
+        Acc *scratch;
+        Acc *matrix;
+        bool owns_matrix;
+        long long *frame_start;
+        /**
+         * @brief Row of the newest frame
+         */
+        int newest_row;
+        int frame_count;
+        long long total_frames;
+        long long sample_count;
+        /**
+         * @brief GetTotalCount() of the signal at the previous Update()
+         */
+        long long signal_total;
+    };
+
+typedef SpectrogramT<double> Spectrogram;
+typedef SpectrogramT<float> SpectrogramF;
+typedef SpectrogramT<int16_t> SpectrogramI16;
+
+/**
+ * @brief Sliding DFT of a few monitored frequencies (shaft orders, blade pass)
+ * @tparam T Type of the input samples
+ * @tparam Acc Type of the stored input history (sums are double)
+ *
+ * Each tone is the DFT of the newest window_size samples at an arbitrary
+ * frequency, updated in O(1) per sample: the sample leaving the window is
+ * subtracted, the sum rotated by one sample and the new sample added. With
+ * SIGNAL_WINDOW_HANN the (periodic) Hann window is applied in the frequency
+ * domain from two more sliding sums one bin (sampling_rate / window_size) on
+ * each side, so a Hann tone costs three times a rectangular one. Magnitude and
+ * phase can be read after any sample. The sums are recomputed from the
+ * history every TONE_TRACKER_RESYNC windows, which bounds rounding errors, and
+ * retuning a tone recomputes it the same way (O(window_size)).
+ * Before window_size samples have been added the missing samples count as 0.
+ * Not thread-safe.
+ */
+template <typename T, typename Acc = typename SampleTraits<T>::Accumulator>
+class ToneTrackerT{
+public:
+    /**
+     * @brief Constructor for ToneTrackerT class, check IsValid() for the result
+     * @param sampling_rate Sampling rate in Hz
+     * @param window_size Samples per DFT (frequency resolution sampling_rate / window_size)
+     * @param max_tones Maximum number of tones
+     * @param window_type SIGNAL_WINDOW_RECTANGULAR or SIGNAL_WINDOW_HANN
+     */
+    ToneTrackerT(double sampling_rate, int window_size, int max_tones, int window_type = SIGNAL_WINDOW_HANN);
+    /**
+     * @brief Destructor, releases the buffers
+     */
+    ~ToneTrackerT();
+    ToneTrackerT(const ToneTrackerT &) = delete;
+    ToneTrackerT &operator=(const ToneTrackerT &) = delete;
+
+    /**
+     * @brief Checks that the parameters were valid and the buffers allocated
+     * @return true if the tracker can be used
+     */
+    bool IsValid() const;
+    /**
+     * @brief Gets the number of samples per DFT
+     * @return Window size
+     */
+    int GetWindowSize() const;
+    /**
+     * @brief Gets the number of tracked tones
+     * @return Number of tones
+     */
+    int GetNumTones() const;
+    /**
+     * @brief Gets the number of samples added since construction or Reset()
+     * @return Sample count
+     */
+    long long GetSampleCount() const;
+    /**
+     * @brief Removes the samples; the tones stay configured
+     */
+    void Reset();
+
+    /**
+     * @brief Adds a tone
+     * @param frequency Frequency in Hz, 0 to sampling_rate / 2
+     * @return Index of the tone, -1 if max_tones are tracked or the frequency is out of range
+     */
+    int AddTone(double frequency);
+    /**
+     * @brief Retunes a tone, recomputed from the stored window (O(window_size))
+     * @param tone Index of the tone
+     * @param frequency Frequency in Hz, 0 to sampling_rate / 2
+     * @return true on success
+     */
+    bool SetFrequency(int tone, double frequency);
+    /**
+     * @brief Tracks a fundamental and its harmonics, e.g. the 1x, 2x, 3x orders of a shaft speed
+     * @param fundamental Fundamental frequency in Hz (shaft speed: rpm / 60)
+     * @param num_harmonics Number of tones, at fundamental, 2 * fundamental, ...
+     * @return Number of tones set, fewer if max_tones or sampling_rate / 2 is reached
+     *
+     * Call again when the speed changes: tones are retuned in place.
+     */
+    int SetHarmonics(double fundamental, int num_harmonics);
+
+    /**
+     * @brief Adds one sample, O(number of tones)
+     * @param value Sample
+     */
+    void AddValue(T value);
+    /**
+     * @brief Adds a block of samples
+     * @param values Samples, oldest first
+     * @param n Number of samples
+     */
+    void AddValues(const T *values, int n);
+    /**
+     * @brief Adds the samples added to a signal since the previous Update() with it
+     * @param signal Signal ring buffer, read on the thread that adds its samples
+     * @return Number of samples added
+     *
+     * Samples overwritten in the ring buffer before they were read are lost;
+     * the tracker continues with the stored ones.
+     */
+    int Update(SignalProcessingT<T, Acc> *signal);
+
+    /**
+     * @brief Gets the frequency of a tone
+     * @param tone Index of the tone
+     * @return Frequency in Hz, 0 if tone is out of range
+     */
+    double GetFrequency(int tone) const;
+    /**
+     * @brief Gets the DFT magnitude of a tone, on the scale of an FFT bin over the same window
+     * @param tone Index of the tone
+     * @return Magnitude, 0 if tone is out of range
+     */
+    double GetMagnitude(int tone) const;
+    /**
+     * @brief Gets the amplitude of a sinusoid at the tone frequency
+     * @param tone Index of the tone
+     * @return 2 * magnitude / sum of the window, 0 if tone is out of range
+     */
+    double GetAmplitude(int tone) const;
+    /**
+     * @brief Gets the phase of a tone at the newest sample
+     * @param tone Index of the tone
+     * @return Phase in radians (-pi to pi) of a cos(2 pi f t + phase) component, 0 if tone is out of range
+     */
+    double GetPhase(int tone) const;
+    /**
+     * @brief Total harmonic distortion when tone 0 is a fundamental and the others its harmonics
+     * @return sqrt(sum of the squared amplitudes of tones 1..) / amplitude of tone 0, as AnalyzeHarmonics()
+     */
+    double GetHarmonicDistortion() const;
+
+private:
+        /**
+         * @brief Sliding DFT at one frequency nu (radians per sample)
+         */
+        struct SlidingBin
+        {
+            double sum_real, sum_imag;          // sum of x[start + m] exp(-i nu m), m = 0 .. window_size - 1
+            double rotate_real, rotate_imag;    // exp(i nu)
+            double newest_real, newest_imag;    // exp(-i nu (window_size - 1))
+        };
+        void Retune(int tone, double frequency);
+        void Resync(int first_bin, int num_bins);
+        void Window(int tone, double *real, double *imag) const;
+        double sampling_rate;
+        int window_size;
+        int max_tones;
+        int num_tones;
+        /**
+         * @brief Sliding sums per tone: 1 (rectangular) or 3 (Hann: nu - 2 pi / N, nu, nu + 2 pi / N)
+         */
+        int bins_per_tone;
+        double *frequencies;
+        SlidingBin *bins;
+        /**
+         * @brief Last window_size samples, oldest at history_pos
+         */
+        Acc *history;
+        int history_pos;
+        int windows_since_resync;
+        long long sample_count;
+        long long signal_total;
+    };
+
+typedef ToneTrackerT<double> ToneTracker;
+typedef ToneTrackerT<float> ToneTrackerF;
+typedef ToneTrackerT<int16_t> ToneTrackerI16;
+
+/**
+ * @brief Designs a linear-phase FIR filter by the windowed-sinc method
+ * @param low_hz Lower cutoff in Hz, <= 0 for a low-pass filter
+ * @param high_hz Upper cutoff in Hz, >= sampling_rate / 2 for a high-pass filter
+ * @param sampling_rate Sampling rate in Hz
+ * @param num_taps Number of coefficients, odd for high-pass and band-stop-like responses
+ * @param coefficients Output coefficients (num_taps values)
+ * @param window_type SIGNAL_WINDOW_* constant (Hamming: about 53 dB stop band)
+ * @return false for invalid cutoffs, a high-pass filter with an even num_taps or an unknown window
+ *
+ * The gain is normalized to 1 at 0 Hz (low-pass), at the band centre
+ * (band-pass) or at sampling_rate / 2 (high-pass). The transition band is
+ * about 3.3 * sampling_rate / num_taps wide with the Hamming window.
+ */
+bool SignalDesignFIR(double low_hz, double high_hz, double sampling_rate, int num_taps, double *coefficients,
+                     int window_type = SIGNAL_WINDOW_HAMMING);
+
+/**
+ * @brief Streaming FIR filter: y[n] = sum of coefficients[k] * x[n - k]
+ * @tparam T Type of the input samples
+ * @tparam Acc Type of the output and of the arithmetic (double or float)
+ *
+ * Short filters are computed directly, several outputs per vector with the
+ * kernel of FFTPlan::GetKernel(). Long filters use overlap-save FFT
+ * convolution: blocks of new samples, preceded by the last num_taps - 1
+ * samples, are transformed, multiplied by the precomputed spectrum of the
+ * coefficients and transformed back. Two blocks share one complex transform
+ * (one as the real, one as the imaginary part), since the coefficients are
+ * real. FIR_AUTO picks FIR_FFT from FIR_FFT_MIN_TAPS taps on.
+ *
+ * The last num_taps - 1 input samples are kept between calls, so a signal
+ * filtered in blocks of any size gives the same output as in one block, and
+ * every call returns one output per input sample, without latency. Samples
+ * before the first one (or Reset()) count as 0. All buffers are set up by
+ * the constructor: filtering makes no heap allocation. Not thread-safe.
+ */
+template <typename T, typename Acc = typename SampleTraits<T>::Accumulator>
+class FIRFilterT{
+public:
+    /**
+     * @brief Constructor for FIRFilterT class, check IsValid() for the result
+     * @param coefficients Impulse response (num_taps values), copied
+     * @param num_taps Number of coefficients (>= 1)
+     * @param method FIR_AUTO, FIR_DIRECT or FIR_FFT
+     */
+    FIRFilterT(const double *coefficients, int num_taps, int method = FIR_AUTO);
+    /**
+     * @brief Destructor, releases the buffers
+     */
+    ~FIRFilterT();
+    FIRFilterT(const FIRFilterT &) = delete;
+    FIRFilterT &operator=(const FIRFilterT &) = delete;
+
+    /**
+     * @brief Checks that the parameters were valid and the buffers allocated
+     * @return true if the filter can be used
+     */
+    bool IsValid() const;
+    /**
+     * @brief Gets the number of coefficients
+     * @return Number of taps
+     */
+    int GetNumTaps() const;
+    /**
+     * @brief Gets the convolution method in use
+     * @return FIR_DIRECT or FIR_FFT (FIR_AUTO resolved)
+     */
+    int GetMethod() const;
+    /**
+     * @brief Gets the transform length of FIR_FFT
+     * @return Power of two, each transform filtering two blocks of GetFFTSize() - num_taps + 1 samples; 0 for FIR_DIRECT
+     */
+    int GetFFTSize() const;
+    /**
+     * @brief Gets the delay of a symmetric (linear-phase) filter
+     * @return (num_taps - 1) / 2 samples
+     */
+    double GetGroupDelay() const;
+    /**
+     * @brief Gets the number of samples filtered since construction or Reset()
+     * @return Sample count
+     */
+    long long GetSampleCount() const;
+    /**
+     * @brief Clears the stored input: the next samples are filtered as if preceded by zeros
+     */
+    void Reset();
+
+    /**
+     * @brief Filters one sample, O(num_taps) with either method
+     * @param value Input sample
+     * @return Output sample
+     */
+    Acc Filter(T value);
+    /**
+     * @brief Filters a block of samples
+     * @param input Input samples, oldest first
+     * @param output Output samples (n values), may be input when T is Acc
+     * @param n Number of samples
+     * @return Number of output samples (n, 0 if the filter is not valid)
+     */
+    int Filter(const T *input, Acc *output, int n);
+
+private:
+        void FilterBlock(int count, Acc *output);
+        int num_taps;
+        int method;
+        /**
+         * @brief New samples per pass: 2 * (fft_size - num_taps + 1) for FIR_FFT, FIR_DIRECT_BLOCK otherwise
+         */
+        int block;
+        int fft_size;
+        const FFTPlan *forward;
+        const FFTPlan *inverse;
+        /**
+         * @brief Coefficients in reverse order (FIR_DIRECT and Filter(T))
+         */
+        Acc *reversed;
+        /**
+         * @brief Spectrum of the zero-padded coefficients (fft_size values each)
+         */
+        Acc *response_real;
+        Acc *response_imag;
+        /**
+         * @brief Last num_taps - 1 samples followed by up to block new samples
+         */
+        Acc *input;
+        Acc *real;
+        Acc *imag;
+        Acc *scratch;
+        long long sample_count;
+    };
+
+typedef FIRFilterT<double> FIRFilter;
+typedef FIRFilterT<float> FIRFilterF;
+typedef FIRFilterT<int16_t> FIRFilterI16;
+
 #endif // SIGNALPROCESSING_H
@@ -0,0 +1,626 @@
+/*
+ * Benchmarks of the library hot paths
+ * Prints timings only: results are checked by the test suites, which do not
+ * time anything. Build with build_benchmark.sh (optimized).
+ */
+
+#include "../source/SignalProcessing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const int KERNELS[5] = {FFT_KERNEL_SCALAR, FFT_KERNEL_SSE2, FFT_KERNEL_NEON, FFT_KERNEL_AVX2, FFT_KERNEL_AVX512};
+
+static double elapsed_us(std::chrono::steady_clock::time_point begin)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// two tones, a chirp and a deterministic noise term per channel
+static double bench_value(int n, int channel)
+{
+    return sin(0.031 * (channel + 1) * n) + 0.4 * cos(0.0013 * n * n + channel) +
+           (((long long)n * 7919 + channel) % 11) * 0.02;
+}
+
+static double cache_sample(int n)
+{
+    double v = sin(2.0 * M_PI * 60.0 * n / 1000.0) + 0.2 * sin(2.0 * M_PI * 180.0 * n / 1000.0);
+    if (n % 211 == 7)
+        v += 2.5;
+    return v;
+}
+
+void bench_ingest()
+{
+    printf("=== Ingest: AddValue against AddValues (4096-sample DMA blocks) ===\n");
+
+    const int block_size = 4096;
+    const int num_blocks = 2000;
+    static double block[block_size];
+    for (int i = 0; i < block_size; i++)
+        block[i] = sin(0.01 * i);
+
+    SignalProcessing sp_single(1 << 20);
+    auto begin = std::chrono::steady_clock::now();
+    for (int b = 0; b < num_blocks; b++)
+        for (int i = 0; i < block_size; i++)
+            sp_single.AddValue(block[i]);
+    double single_us = elapsed_us(begin);
+
+    SignalProcessing sp_block(1 << 20);
+    begin = std::chrono::steady_clock::now();
+    for (int b = 0; b < num_blocks; b++)
+        sp_block.AddValues(block, block_size);
+    double block_us = elapsed_us(begin);
+
+    double samples = (double)block_size * num_blocks;
+    printf("AddValue %.2f ns/sample, AddValues %.2f ns/sample\n", single_us * 1000.0 / samples,
+           block_us * 1000.0 / samples);
+    printf("\n");
+}
+
+void bench_running_stats()
+{
+    printf("=== Running statistics (65536-sample window) ===\n");
+
+    const int capacity = 65536;
+    const int samples = 20000;
+    SignalProcessing sp(capacity);
+    for (int i = 0; i < capacity; i++)
+        sp.AddValue(sin(i * 0.01));
+
+    int anomalies[16];
+    double sink = 0.0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; i++)
+    {
+        sp.AddValue(sin(i * 0.01));
+        sink += sp.GetMean() + sp.GetStandardDeviation();
+    }
+    double running_us = elapsed_us(begin);
+
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < 200; i++)
+        sink += sp.DetectAnomaliesZScore(4.0, anomalies, 16);
+    double zscore_us = elapsed_us(begin);
+
+    printf("AddValue + GetMean + GetStandardDeviation %.1f ns, DetectAnomaliesZScore %.1f us (checksum %.3f)\n",
+           running_us * 1000.0 / samples, zscore_us / 200, sink);
+    printf("\n");
+}
+
+// one forward transform of a fresh copy of the input
+template <typename T>
+static double time_transform(int kernel, int size)
+{
+    std::vector<T> input_real(size), input_imag(size), real(size), imag(size);
+    for (int i = 0; i < size; i++)
+    {
+        input_real[i] = (T)bench_value(i, 0);
+        input_imag[i] = (T)bench_value(i, 1);
+    }
+    FFTPlan::SetKernel(kernel);
+    const FFTPlan *plan = FFTPlan::Get(size, 1);
+    int repeats = (int)(1000000 / size) + 1;
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        real = input_real;
+        imag = input_imag;
+        plan->Execute(real.data(), imag.data());
+    }
+    return elapsed_us(begin) / repeats;
+}
+
+void bench_kernels()
+{
+    printf("=== FFT: complex transform per kernel ===\n");
+
+    const int sizes[3] = {1024, 4096, 65536};
+    int detected = FFTPlan::GetKernel();
+    printf("%-8s", "kernel");
+    for (int s = 0; s < 3; s++)
+        printf("  %6d double  %6d float", sizes[s], sizes[s]);
+    printf("\n");
+    for (int k = 0; k < 5; k++)
+    {
+        if (!FFTPlan::IsKernelSupported(KERNELS[k]))
+            continue;
+        printf("%-8s", FFTPlan::GetKernelName(KERNELS[k]));
+        for (int s = 0; s < 3; s++)
+            printf("  %10.1f us  %9.1f us", time_transform<double>(KERNELS[k], sizes[s]),
+                   time_transform<float>(KERNELS[k], sizes[s]));
+        printf("\n");
+    }
+    FFTPlan::SetKernel(detected);
+    printf("\n");
+}
+
+void bench_real_fft()
+{
+    printf("=== FFT: real against complex transform ===\n");
+
+    const int sizes[2] = {4096, 65536};
+    static double input[65536], real[65536], imag[65536];
+    for (int i = 0; i < 65536; i++)
+        input[i] = bench_value(i, 0);
+    for (int s = 0; s < 2; s++)
+    {
+        int size = sizes[s];
+        int repeats = (1 << 22) / size;
+        const FFTPlan *plan = FFTPlan::Get(size, 1);
+        plan->ExecuteReal(input, real, imag);
+        auto begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+        {
+            for (int i = 0; i < size; i++)
+            {
+                real[i] = input[i];
+                imag[i] = 0.0;
+            }
+            plan->Execute(real, imag);
+        }
+        double complex_us = elapsed_us(begin);
+        begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+            plan->ExecuteReal(input, real, imag);
+        double real_us = elapsed_us(begin);
+        printf("%d points: complex %.1f us, real %.1f us\n", size, complex_us / repeats, real_us / repeats);
+    }
+    printf("\n");
+}
+
+static double time_real(int size)
+{
+    std::vector<double> samples(size), real(size / 2 + 1), imag(size / 2 + 1);
+    for (int i = 0; i < size; i++)
+        samples[i] = bench_value(i, 0);
+    const FFTPlan *plan = FFTPlan::Get(size, 1);
+    std::vector<double> scratch(plan->GetScratchSize() + 1);
+    int repeats = 2000000 / size + 1;
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        plan->ExecuteReal(samples.data(), real.data(), imag.data(), scratch.data());
+    return elapsed_us(begin) / repeats;
+}
+
+void bench_lengths()
+{
+    printf("=== FFT: natural length against zero padding (real input) ===\n");
+
+    const int sizes[4] = {1000, 5000, 6000, 4999};
+    for (int s = 0; s < 4; s++)
+    {
+        int padded = SignalPowerOfTwo(sizes[s]);
+        printf("%5d points (%s): %7.1f us, padded to %5d: %7.1f us\n", sizes[s],
+               SignalFFTSmooth(sizes[s]) ? "mixed radix" : "Bluestein  ", time_real(sizes[s]), padded,
+               time_real(padded));
+    }
+    printf("\n");
+}
+
+void bench_batch_fft()
+{
+    printf("=== FFT: 2048-point spectra of 512 channels ===\n");
+
+    const int size = 2048, channels = 512, bins = size / 2 + 1;
+    const FFTPlan *plan = FFTPlan::Get(size, 1);
+    std::vector<float> input((size_t)channels * size), real((size_t)channels * bins), imag((size_t)channels * bins);
+    std::vector<float> scratch(plan->GetBatchScratchSize());
+    for (int c = 0; c < channels; c++)
+        for (int n = 0; n < size; n++)
+            input[(size_t)c * size + n] = (float)bench_value(n, c);
+
+    const int repeats = 5;
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        for (int c = 0; c < channels; c++)
+            plan->ExecuteReal(input.data() + (size_t)c * size, real.data() + (size_t)c * bins,
+                              imag.data() + (size_t)c * bins);
+    double loop_us = elapsed_us(begin) / (repeats * channels);
+    begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        plan->ExecuteRealBatch(input.data(), channels, size, 1, real.data(), imag.data(), scratch.data());
+    double batch_us = elapsed_us(begin) / (repeats * channels);
+    printf("float (%s): ExecuteReal loop %.2f us/channel, ExecuteRealBatch %.2f us/channel (%.1fx)\n",
+           FFTPlan::GetKernelName(FFTPlan::GetKernel()), loop_us, batch_us, loop_us / batch_us);
+
+    // the bank: per-channel analysis against the batch
+    SignalBankF bank(channels, size);
+    std::vector<float> frame(channels);
+    for (int n = 0; n < size; n++)
+    {
+        for (int c = 0; c < channels; c++)
+            frame[c] = input[(size_t)c * size + n];
+        bank.AddFrame(frame.data());
+    }
+    // second cycle of each: the heap blocks of the bins are reused as in a monitoring loop
+    std::vector<FrequencySpectrum> spectra(channels);
+    double single_us = 0.0, bank_us = 0.0;
+    for (int cycle = 0; cycle < 2; cycle++)
+    {
+        begin = std::chrono::steady_clock::now();
+        for (int c = 0; c < channels; c++)
+            bank.Channel(c).FFTAnalysis(48000.0, &spectra[c]);
+        single_us = elapsed_us(begin) / channels;
+        bank.FreeSpectra(spectra.data());
+        begin = std::chrono::steady_clock::now();
+        bank.FFTAnalysis(48000.0, spectra.data());
+        bank_us = elapsed_us(begin) / channels;
+        bank.FreeSpectra(spectra.data());
+    }
+    std::vector<float> matrix((size_t)channels * bins);
+    begin = std::chrono::steady_clock::now();
+    bank.FFTMagnitudeMatrix(matrix.data());
+    double matrix_us = elapsed_us(begin) / channels;
+    printf("SignalBankF: Channel(c).FFTAnalysis() %.2f us/channel, FFTAnalysis() %.2f us/channel, "
+           "FFTMagnitudeMatrix() %.2f us/channel\n", single_us, bank_us, matrix_us);
+    printf("\n");
+}
+
+void bench_spectra()
+{
+    printf("=== FFTAnalysis: 4096-point spectra of a double buffer ===\n");
+
+    const int size = 4096, repeats = 300;
+    SignalProcessing sp(size + 1);
+    for (int n = 0; n <= size; n++)
+        sp.AddValue(bench_value(n, 2));
+
+    // warm the plans and window tables of both types
+    FrequencySpectrum reference;
+    FrequencySpectrumF spectrum;
+    sp.FFTAnalysis(1, size, 48000.0, &reference);
+    sp.FFTAnalysis(1, size, 48000.0, &spectrum);
+    sp.FreeSpectrum(&reference);
+    sp.FreeSpectrum(&spectrum);
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        sp.FFTAnalysis(1, size, 48000.0, &reference);
+        sp.FreeSpectrum(&reference);
+    }
+    double double_us = elapsed_us(begin) / repeats;
+    begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        sp.FFTAnalysis(1, size, 48000.0, &spectrum);
+        sp.FreeSpectrum(&spectrum);
+    }
+    double float_us = elapsed_us(begin) / repeats;
+
+    // the float phase is a polynomial instead of atan2(), most of the gain with optimization (-O2)
+    printf("%s: FrequencySpectrum %.1f us, FrequencySpectrumF %.1f us (%.1fx), bins %zu -> %zu bytes\n",
+           FFTPlan::GetKernelName(FFTPlan::GetKernel()), double_us, float_us, double_us / float_us,
+           (size_t)(size / 2 + 1) * sizeof(FrequencyBin), (size_t)(size / 2 + 1) * sizeof(FrequencyBinF));
+    printf("\n");
+}
+
+void bench_window()
+{
+    printf("=== Window: cached table against cos() per call ===\n");
+
+    const int sizes[3] = {64, 256, 1024};
+    for (int s = 0; s < 3; s++)
+    {
+        int size = sizes[s];
+        std::vector<double> data(size, 1.0);
+        int repeats = 4000000 / size;
+        volatile double sink = 0.0;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+        {
+            for (int i = 0; i < size; i++)
+                data[i] *= 0.5 * (1.0 - cos(2.0 * M_PI * i / (size - 1)));
+            sink = sink + data[size / 2];
+            data[size / 2] = 1.0;
+        }
+        double direct_ns = elapsed_us(begin) * 1000.0 / repeats;
+        begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+        {
+            SignalWindow::Get(SIGNAL_WINDOW_HANN, size)->Apply(data.data());
+            sink = sink + data[size / 2];
+            data[size / 2] = 1.0;
+        }
+        double cached_ns = elapsed_us(begin) * 1000.0 / repeats;
+
+        // a part of the window: not served from the cached spectrum
+        SignalProcessing sp(size + 1);
+        for (int i = 0; i <= size; i++)
+            sp.AddValue(sin(0.3 * i));
+        sp.ReserveWorkspace();
+        FrequencySpectrum spectrum;
+        int fft_repeats = 200000 / size;
+        begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < fft_repeats; r++)
+            sp.FFTAnalysis(0, size, 1000.0, &spectrum), sp.FreeSpectrum(&spectrum);
+        double fft_ns = elapsed_us(begin) * 1000.0 / fft_repeats;
+        printf("%4d samples: cos() per sample %7.0f ns, cached table %5.0f ns, whole FFTAnalysis %7.0f ns\n", size,
+               direct_ns, cached_ns, fft_ns);
+    }
+    printf("\n");
+}
+
+template <typename T, typename Acc>
+static double time_filter(int taps, int method, int length, int repeats)
+{
+    std::vector<double> h(taps);
+    for (int k = 0; k < taps; k++)
+        h[k] = 0.54 - 0.46 * cos(2.0 * M_PI * k / (taps - 1));
+    std::vector<T> x(length);
+    std::vector<Acc> y(length);
+    for (int n = 0; n < length; n++)
+        x[n] = (T)bench_value(n, 0);
+    FIRFilterT<T, Acc> filter(h.data(), taps, method);
+    filter.Filter(x.data(), y.data(), length);
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        filter.Filter(x.data(), y.data(), length);
+    return elapsed_us(begin) * 1000.0 / ((double)repeats * length);
+}
+
+void bench_fir()
+{
+    printf("=== FIR filter: direct and FFT convolution ===\n");
+
+    const int length = 16384, repeats = 3;
+    const int taps[3] = {32, 256, 1024};
+    printf("%s, ns per sample (double / float):\n", FFTPlan::GetKernelName(FFTPlan::GetKernel()));
+    for (int t = 0; t < 3; t++)
+        printf("  %4d taps: direct %7.1f / %7.1f, FFT %6.1f / %6.1f\n", taps[t],
+               time_filter<double, double>(taps[t], FIR_DIRECT, length, repeats),
+               time_filter<float, float>(taps[t], FIR_DIRECT, length, repeats),
+               time_filter<double, double>(taps[t], FIR_FFT, length, repeats),
+               time_filter<float, float>(taps[t], FIR_FFT, length, repeats));
+    printf("\n");
+}
+
+template <typename S, typename Acc>
+static double time_autocorrelation(S &sp, int max_lag, int method, Acc *out)
+{
+    int repeats = 0;
+    double elapsed = 0.0;
+    auto begin = std::chrono::steady_clock::now();
+    do
+    {
+        sp.Autocorrelation(max_lag, out, true, method);
+        repeats++;
+        elapsed = elapsed_us(begin);
+    } while (elapsed < 50000.0);
+    return elapsed / repeats;
+}
+
+void bench_correlation()
+{
+    printf("=== Correlation: direct and FFT ===\n");
+
+    const int n = 65536;
+    SignalProcessing sp(n);
+    for (int i = 0; i < n; i++)
+        sp.AddValue(bench_value(i, 0));
+    std::vector<double> out(n);
+    const int lags[3] = {16, 1000, 8000};
+    printf("%d samples, %s:\n", n, FFTPlan::GetKernelName(FFTPlan::GetKernel()));
+    for (int l = 0; l < 3; l++)
+        printf("  max_lag %5d: direct %10.1f us, FFT %8.1f us, AUTO uses %s\n", lags[l],
+               time_autocorrelation(sp, lags[l], CORRELATION_DIRECT, out.data()),
+               time_autocorrelation(sp, lags[l], CORRELATION_FFT, out.data()),
+               SignalCorrelationMethod(n, lags[l]) == CORRELATION_FFT ? "FFT" : "direct");
+
+    // two sensors, +-4000 lags
+    std::vector<double> sensor2(n), cross(8001);
+    for (int i = 0; i < n; i++)
+        sensor2[i] = bench_value(i + 1234, 0);
+    sp.GCCPHAT(sensor2.data(), n, 4000, cross.data());  // builds the plans of the transform length
+    int repeats = 0;
+    double phat_us = 0.0;
+    auto begin = std::chrono::steady_clock::now();
+    do
+    {
+        sp.GCCPHAT(sensor2.data(), n, 4000, cross.data());
+        repeats++;
+        phat_us = elapsed_us(begin);
+    } while (phat_us < 50000.0);
+    phat_us /= repeats;
+    begin = std::chrono::steady_clock::now();
+    sp.CrossCorrelation(sensor2.data(), n, 4000, cross.data(), true, CORRELATION_DIRECT);
+    double direct_us = elapsed_us(begin);
+    begin = std::chrono::steady_clock::now();
+    sp.CrossCorrelation(sensor2.data(), n, 4000, cross.data(), true, CORRELATION_FFT);
+    double fft_us = elapsed_us(begin);
+    printf("  cross-correlation, max_lag 4000: direct %10.1f us, FFT %8.1f us, GCC-PHAT %8.1f us\n", direct_us,
+           fft_us, phat_us);
+    printf("\n");
+}
+
+void bench_spectrogram()
+{
+    printf("=== Spectrogram against an FFTAnalysis() loop ===\n");
+
+    const int n = 48000, window = 1024, hop = 256;
+    SignalProcessing sp(n);
+    std::vector<double> samples(n);
+    for (int i = 0; i < n; i++)
+        samples[i] = bench_value(i, 0);
+    sp.AddValues(samples.data(), n);
+
+    auto begin = std::chrono::steady_clock::now();
+    int loop_frames = 0;
+    for (int start = 0; start + window <= n; start += hop, loop_frames++)
+    {
+        FrequencySpectrum spectrum;
+        if (sp.FFTAnalysis(start, window, 48000.0, &spectrum))
+            sp.FreeSpectrum(&spectrum);
+    }
+    double loop_us = elapsed_us(begin);
+
+    Spectrogram spectrogram(window, hop, 256);
+    begin = std::chrono::steady_clock::now();
+    spectrogram.AddValues(samples.data(), n);
+    double stream_us = elapsed_us(begin);
+    printf("%d frames: FFTAnalysis loop %.1f us/frame, Spectrogram %.1f us/frame\n", loop_frames,
+           loop_us / loop_frames, stream_us / spectrogram.GetTotalFrames());
+    printf("\n");
+}
+
+void bench_tone_tracker()
+{
+    printf("=== Tone tracker: four tones against FFTAnalysis() ===\n");
+
+    const int n = 48000, window = 4800;
+    std::vector<double> samples(n);
+    for (int i = 0; i < n; i++)
+        samples[i] = sin(2.0 * M_PI * 2400.0 * i / 48000.0) + 0.3 * sin(2.0 * M_PI * 4800.0 * i / 48000.0);
+    SignalProcessing sp(window);
+    sp.AddValues(samples.data(), window);
+
+    int repeats = 20;
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        FrequencySpectrum spectrum;
+        if (sp.FFTAnalysis(48000.0, &spectrum))
+            sp.FreeSpectrum(&spectrum);
+    }
+    double fft_us = elapsed_us(begin) / repeats;
+
+    ToneTracker tracker(48000.0, window, 4);
+    tracker.SetHarmonics(2400.0, 4);
+    begin = std::chrono::steady_clock::now();
+    tracker.AddValues(samples.data(), n);
+    double sample_ns = elapsed_us(begin) * 1000.0 / n;
+    printf("Window %d: FFTAnalysis %.1f us per spectrum, ToneTracker %.1f ns per sample (4 tones, Hann)\n", window,
+           fft_us, sample_ns);
+    printf("Per hop of %d samples: %.1f us, with every sample up to date\n", window / 4, sample_ns * window / 4 / 1000.0);
+    printf("\n");
+}
+
+void bench_welch()
+{
+    printf("=== Welch PSD of 4M float samples ===\n");
+
+    const int n = 1 << 22, segment = 4096, overlap = 2048;
+    SignalProcessingF sp(n);
+    std::vector<float> x(n);
+    for (int i = 0; i < n; i++)
+        x[i] = (float)bench_value(i, 0);
+    sp.AddValues(x.data(), n);
+    sp.ReserveWorkspace();
+
+    PowerSpectralDensity psd;
+    auto begin = std::chrono::steady_clock::now();
+    bool ok = sp.WelchPSD(segment, overlap, SIGNAL_WINDOW_HANN, 48000.0, &psd);
+    double us = elapsed_us(begin);
+    printf("%d segments of %d: %.1f ms\n", ok ? psd.num_segments : 0, segment, us / 1000.0);
+    if (ok)
+        sp.FreePSD(&psd);
+    printf("\n");
+}
+
+void bench_segment_features()
+{
+    printf("=== Segment features: copy against SignalView ===\n");
+
+    const int n = 20000;
+    const int window = 1000;
+    std::vector<double> data(n);
+    for (int i = 0; i < n; i++)
+        data[i] = bench_value(i, 0);
+
+    const int repeats = 200;
+    MLFeatureVector features;
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        SignalProcessing copy(window);
+        copy.AddValues(data.data() + (r * 97) % (n - window), window);
+        copy.ExtractMLFeatures(1000.0, &features);
+    }
+    double copy_us = elapsed_us(begin);
+
+    begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        SignalView view(data.data() + (r * 97) % (n - window), window);
+        view.ExtractMLFeatures(1000.0, &features);
+    }
+    double view_us = elapsed_us(begin);
+    printf("Feature extraction per segment: copy %.1f us, view %.1f us\n", copy_us / repeats, view_us / repeats);
+    printf("\n");
+}
+
+void bench_control_cycle()
+{
+    printf("=== Result cache: queries of one control cycle (8192 samples) ===\n");
+
+    SignalProcessing sp(8192);
+    for (int i = 0; i < 8192; i++)
+        sp.AddValue(cache_sample(i));
+    static FrequencyBin bins[4097];
+    const int cycles = 50;
+    double checksum = 0.0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int c = 0; c < cycles; c++)
+    {
+        sp.AddValue(cache_sample(8192 + c));
+        for (int q = 0; q < 5; q++)
+        {
+            MLFeatureVector features;
+            FrequencySpectrum spectrum;
+            sp.ExtractMLFeatures(1000.0, &features);
+            sp.FFTAnalysis(1000.0, &spectrum, bins, 4097);
+            checksum += features.spectral_centroid + spectrum.dominant_frequency + sp.CalculateAnomalyScore(1) +
+                        sp.GetMean() + sp.GetStandardDeviation();
+        }
+    }
+    double us = elapsed_us(begin);
+
+    MLFeatureVector features;
+    begin = std::chrono::steady_clock::now();
+    for (int c = 0; c < cycles; c++)
+    {
+        sp.AddValue(cache_sample(8192 + cycles + c));
+        sp.ExtractMLFeatures(1000.0, &features);
+    }
+    double single_us = elapsed_us(begin);
+
+    printf("Per cycle: 5 x (features, FFT, IQR score, moments) %.0f us, one ExtractMLFeatures %.0f us (checksum %.3f)\n",
+           us / cycles, single_us / cycles, checksum);
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     SignalProcessing Benchmarks            ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    bench_ingest();
+    bench_running_stats();
+    bench_kernels();
+    bench_real_fft();
+    bench_lengths();
+    bench_batch_fft();
+    bench_spectra();
+    bench_window();
+    bench_fir();
+    bench_correlation();
+    bench_spectrogram();
+    bench_tone_tracker();
+    bench_welch();
+    bench_segment_features();
+    bench_control_cycle();
+
+    return 0;
+}
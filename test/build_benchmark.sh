@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building benchmark..."
+g++ -std=c++11 -O2 -o benchmark benchmark.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running benchmark..."
+    echo ""
+    ./benchmark
+else
+    echo "Build failed!"
+    exit 1
+fi
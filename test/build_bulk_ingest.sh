@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_bulk_ingest..."
+g++ -std=c++11 -o test_bulk_ingest test_bulk_ingest.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_bulk_ingest
+else
+    echo "Build failed!"
+    exit 1
+fi
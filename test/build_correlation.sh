@@ -1,6 +1,6 @@
 #!/bin/bash
 echo "Building test_correlation..."
-g++ -std=c++11 -o test_correlation test_correlation.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt
+g++ -std=c++11 -o test_correlation test_correlation.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
 
 if [ $? -eq 0 ]; then
     echo "Build successful! Running test..."
@@ -4,7 +4,7 @@
 
 echo "Building test_denoising..."
 
-g++ -std=c++11 -o test_denoising test_denoising.cpp ../source/SignalProcessing.cpp -I../source -lm
+g++ -std=c++11 -o test_denoising test_denoising.cpp ../source/SignalProcessing.cpp -I../source -lm -pthread
 
 if [ $? -eq 0 ]; then
     echo "✓ Build successful!"
@@ -1,2 +1,2 @@
 #!/bin/bash
-g++ -o test_event_detection test_event_detection.cpp ../source/SignalProcessing.cpp -I../source -lrt -lm
+g++ -o test_event_detection test_event_detection.cpp ../source/SignalProcessing.cpp -I../source -lrt -lm -pthread
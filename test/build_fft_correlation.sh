@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_fft_correlation..."
+g++ -std=c++11 -o test_fft_correlation test_fft_correlation.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_fft_correlation
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_fft_kernels..."
+g++ -std=c++11 -o test_fft_kernels test_fft_kernels.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_fft_kernels
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_fir_filter..."
+g++ -std=c++11 -o test_fir_filter test_fir_filter.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_fir_filter
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_fixed_capacity..."
+g++ -std=c++11 -o test_fixed_capacity test_fixed_capacity.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_fixed_capacity
+else
+    echo "Build failed!"
+    exit 1
+fi
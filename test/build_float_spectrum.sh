@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_float_spectrum..."
+g++ -std=c++11 -o test_float_spectrum test_float_spectrum.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_float_spectrum
+else
+    echo "Build failed!"
+    exit 1
+fi
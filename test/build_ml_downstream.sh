@@ -3,7 +3,7 @@
 
 echo "Building test_ml_downstream..."
 
-g++ -std=c++11 -o test_ml_downstream test_ml_downstream.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt
+g++ -std=c++11 -o test_ml_downstream test_ml_downstream.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
 
 if [ $? -eq 0 ]; then
     echo "Build successful! Run with: ./test_ml_downstream"
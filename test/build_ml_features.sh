@@ -2,7 +2,7 @@
 # Build script for test_ml_features
 
 echo "Building test_ml_features..."
-g++ -o test_ml_features test_ml_features.cpp ../source/SignalProcessing.cpp -lm -lrt
+g++ -o test_ml_features test_ml_features.cpp ../source/SignalProcessing.cpp -lm -lrt -pthread
 
 if [ $? -eq 0 ]; then
     echo "Build successful!"
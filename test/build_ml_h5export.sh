@@ -7,7 +7,7 @@ echo "Building test_ml_h5export..."
 # On Ubuntu/Debian: sudo apt-get install libhdf5-dev libhdf5-cpp-103
 # On Fedora/RHEL: sudo dnf install hdf5-devel
 
-g++ -std=c++11 -DUSE_HDF5 -o test_ml_h5export test_ml_h5export.cpp ../source/SignalProcessing.cpp -I../source -lhdf5_cpp -lhdf5 -lm -lrt
+g++ -std=c++11 -DUSE_HDF5 -o test_ml_h5export test_ml_h5export.cpp ../source/SignalProcessing.cpp -I../source -lhdf5_cpp -lhdf5 -lm -lrt -pthread
 
 if [ $? -eq 0 ]; then
     echo "Build successful! Run with: ./test_ml_h5export"
@@ -1,2 +1,2 @@
 #!/bin/bash
-g++ -o test_moving_average test_moving_average.cpp ../source/SignalProcessing.cpp -I../source -lrt
+g++ -o test_moving_average test_moving_average.cpp ../source/SignalProcessing.cpp -I../source -lrt -pthread
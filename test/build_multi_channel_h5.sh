@@ -9,7 +9,7 @@ g++ -std=c++11 \
     test_multi_channel_h5.cpp \
     ../source/SignalProcessing.cpp \
     -L/usr/lib/x86_64-linux-gnu/hdf5/serial \
-    -lhdf5_cpp -lhdf5 -lm -lrt
+    -lhdf5_cpp -lhdf5 -lm -lrt -pthread
 
 if [ $? -eq 0 ]; then
     echo "✓ Build successful!"
@@ -1,2 +1,2 @@
 #!/bin/bash
-g++ -o test_normalize test_normalize.cpp ../source/SignalProcessing.cpp -I../source -lrt
+g++ -o test_normalize test_normalize.cpp ../source/SignalProcessing.cpp -I../source -lrt -pthread
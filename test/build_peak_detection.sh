@@ -1,3 +1,3 @@
 #!/bin/bash
-g++ -o test_peak_detection test_peak_detection.cpp ../source/SignalProcessing.cpp -lm -lrt
+g++ -o test_peak_detection test_peak_detection.cpp ../source/SignalProcessing.cpp -lm -lrt -pthread
 echo "Build complete: test_peak_detection"
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_real_fft..."
+g++ -std=c++11 -o test_real_fft test_real_fft.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_real_fft
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_result_cache..."
+g++ -std=c++11 -o test_result_cache test_result_cache.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_result_cache
+else
+    echo "Build failed!"
+    exit 1
+fi
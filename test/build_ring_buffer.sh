@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_ring_buffer..."
+g++ -std=c++11 -o test_ring_buffer test_ring_buffer.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_ring_buffer
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_running_stats..."
+g++ -std=c++11 -o test_running_stats test_running_stats.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_running_stats
+else
+    echo "Build failed!"
+    exit 1
+fi
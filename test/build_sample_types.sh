@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_sample_types..."
+g++ -std=c++11 -o test_sample_types test_sample_types.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_sample_types
+else
+    echo "Build failed!"
+    exit 1
+fi
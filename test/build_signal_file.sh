@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_signal_file..."
+g++ -std=c++11 -o test_signal_file test_signal_file.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_signal_file
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -1,2 +1,2 @@
 #!/bin/bash
-g++ -o test_smoothing test_smoothing.cpp ../source/SignalProcessing.cpp -I../source -lrt
+g++ -o test_smoothing test_smoothing.cpp ../source/SignalProcessing.cpp -I../source -lrt -pthread
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_spectrogram..."
+g++ -std=c++11 -o test_spectrogram test_spectrogram.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_spectrogram
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_spsc_ingest..."
+g++ -std=c++11 -o test_spsc_ingest test_spsc_ingest.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_spsc_ingest
+else
+    echo "Build failed!"
+    exit 1
+fi
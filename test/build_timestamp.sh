@@ -1,2 +1,2 @@
 #!/bin/bash
-g++ -o test_timestamp test_timestamp.cpp ../source/SignalProcessing.cpp -I../source -lrt -lm
+g++ -o test_timestamp test_timestamp.cpp ../source/SignalProcessing.cpp -I../source -lrt -lm -pthread
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_timestamp_modes..."
+g++ -std=c++11 -o test_timestamp_modes test_timestamp_modes.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_timestamp_modes
+else
+    echo "Build failed!"
+    exit 1
+fi
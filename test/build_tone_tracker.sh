@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_tone_tracker..."
+g++ -std=c++11 -o test_tone_tracker test_tone_tracker.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_tone_tracker
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -4,7 +4,7 @@
 
 echo "Building test_turbine_anomaly..."
 
-g++ -std=c++11 -o test_turbine_anomaly test_turbine_anomaly.cpp ../source/SignalProcessing.cpp -I../source -lm
+g++ -std=c++11 -o test_turbine_anomaly test_turbine_anomaly.cpp ../source/SignalProcessing.cpp -I../source -lm -pthread
 
 if [ $? -eq 0 ]; then
     echo "✓ Build successful!"
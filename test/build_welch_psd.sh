@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_welch_psd..."
+g++ -std=c++11 -o test_welch_psd test_welch_psd.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_welch_psd
+else
+    echo "Build failed!"
+    exit 1
+fi
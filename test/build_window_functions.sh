@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_window_functions..."
+g++ -std=c++11 -o test_window_functions test_window_functions.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_window_functions
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,12 @@
+#!/bin/bash
+echo "Building test_workspace..."
+g++ -std=c++11 -o test_workspace test_workspace.cpp ../source/SignalProcessing.cpp -I../source -lm -lrt -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Running test..."
+    echo ""
+    ./test_workspace
+else
+    echo "Build failed!"
+    exit 1
+fi
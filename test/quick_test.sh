@@ -22,7 +22,7 @@ for test in test_stats test_moving_average test_normalize test_smoothing \
             test_event_detection test_timestamp test_peak_detection; do
     
     # Compile
-    g++ -o "${test}" "${test}.cpp" ../source/SignalProcessing.cpp -lm -lrt 2>/dev/null
+    g++ -o "${test}" "${test}.cpp" ../source/SignalProcessing.cpp -lm -lrt -pthread 2>/dev/null
     
     if [ $? -eq 0 ]; then
         # Run
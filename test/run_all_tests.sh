@@ -43,7 +43,7 @@ SCRIPT_DIR=$(pwd)
 # Clean old executables
 echo -e "${YELLOW}[CLEANUP]${NC} Removing old executables..."
 rm -f test_stats test_moving_average test_normalize test_smoothing \
-      test_event_detection test_timestamp test_peak_detection test 2>/dev/null
+      test_event_detection test_timestamp test_peak_detection test_ring_buffer test_spsc_ingest test_bulk_ingest test_timestamp_modes test_sample_types test_signal_bank test_signal_view test_signal_file test_running_stats test_workspace test_fixed_capacity test_result_cache test_fft_plan test_real_fft test_fft_kernels test_fft_lengths test_spectrogram test_welch_psd test_tone_tracker test_window_functions test_batch_fft test_float_spectrum test_fir_filter test_fft_correlation test 2>/dev/null
 echo ""
 
 # Define test files (without .cpp extension)
@@ -55,6 +55,30 @@ TEST_FILES=(
     "test_event_detection"
     "test_timestamp"
     "test_peak_detection"
+    "test_ring_buffer"
+    "test_spsc_ingest"
+    "test_bulk_ingest"
+    "test_timestamp_modes"
+    "test_sample_types"
+    "test_signal_bank"
+    "test_signal_view"
+    "test_signal_file"
+    "test_running_stats"
+    "test_workspace"
+    "test_fixed_capacity"
+    "test_result_cache"
+    "test_fft_plan"
+    "test_real_fft"
+    "test_fft_kernels"
+    "test_fft_lengths"
+    "test_spectrogram"
+    "test_welch_psd"
+    "test_tone_tracker"
+    "test_window_functions"
+    "test_batch_fft"
+    "test_float_spectrum"
+    "test_fir_filter"
+    "test_fft_correlation"
 )
 
 echo -e "${CYAN}═══════════════════════════════════════════════════════════${NC}"
@@ -78,7 +102,7 @@ for test in "${TEST_FILES[@]}"; do
     fi
     
     # Compile
-    g++ -o "${test}" "${test}.cpp" ../source/SignalProcessing.cpp -lm -lrt 2> compile_error_${test}.log
+    g++ -o "${test}" "${test}.cpp" ../source/SignalProcessing.cpp -lm -lrt -pthread 2> compile_error_${test}.log
     
     if [ $? -eq 0 ]; then
         echo -e "  ${GREEN}✓ SUCCESS${NC} - Compiled successfully"
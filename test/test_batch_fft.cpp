@@ -0,0 +1,180 @@
+/*
+ * Test file for the batch FFT of many channels
+ * Checks FFTPlan::ExecuteRealBatch() against one ExecuteReal() per channel
+ * for planar and interleaved layouts, every kernel and length class, the
+ * SignalBank spectra and magnitude matrix
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double test_value(int n, int channel)
+{
+    return sin(0.031 * (channel + 1) * n) + 0.4 * cos(0.0013 * n * n + channel) + ((n * 7919 + channel) % 11) * 0.02;
+}
+
+// largest difference between the batch and per-channel transforms, relative to the largest bin
+template <typename V>
+static double batch_error(int size, int direction, int channels, bool interleaved)
+{
+    const FFTPlan *plan = FFTPlan::Get(size, direction);
+    int bins = size / 2 + 1;
+    std::vector<V> input((size_t)channels * size), channel(size), real((size_t)channels * bins),
+        imag((size_t)channels * bins), expected_real(bins), expected_imag(bins);
+    for (int c = 0; c < channels; c++)
+        for (int n = 0; n < size; n++)
+            input[interleaved ? (size_t)n * channels + c : (size_t)c * size + n] = (V)test_value(n, c);
+    if (interleaved)
+        plan->ExecuteRealBatch(input.data(), channels, 1, channels, real.data(), imag.data());
+    else
+        plan->ExecuteRealBatch(input.data(), channels, size, 1, real.data(), imag.data());
+
+    double worst = 0.0;
+    for (int c = 0; c < channels; c++)
+    {
+        for (int n = 0; n < size; n++)
+            channel[n] = (V)test_value(n, c);
+        plan->ExecuteReal(channel.data(), expected_real.data(), expected_imag.data());
+        double largest = 1e-30, difference = 0.0;
+        for (int k = 0; k < bins; k++)
+        {
+            largest = fmax(largest, fabs(expected_real[k]) + fabs(expected_imag[k]));
+            difference = fmax(difference, fmax(fabs(real[(size_t)c * bins + k] - expected_real[k]),
+                                               fabs(imag[(size_t)c * bins + k] - expected_imag[k])));
+        }
+        worst = fmax(worst, difference / largest);
+    }
+    return worst;
+}
+
+void test_against_single()
+{
+    printf("=== Test 1: Batch against one transform per channel ===\n");
+
+    const int sizes[10] = {2, 3, 8, 45, 64, 97, 1000, 1009, 2048, 4096};
+    const int channels[4] = {1, 5, 32, 67};
+    int original = FFTPlan::GetKernel();
+    for (int kernel = FFT_KERNEL_SCALAR; kernel <= FFT_KERNEL_AVX512; kernel++)
+    {
+        if (!FFTPlan::SetKernel(kernel))
+            continue;
+        double worst_double = 0.0, worst_float = 0.0;
+        for (int s = 0; s < 10; s++)
+            for (int c = 0; c < 4; c++)
+            {
+                worst_double = fmax(worst_double, batch_error<double>(sizes[s], 1, channels[c], c % 2 == 1));
+                worst_double = fmax(worst_double, batch_error<double>(sizes[s], -1, channels[c], c % 2 == 0));
+                worst_float = fmax(worst_float, batch_error<float>(sizes[s], 1, channels[c], c % 2 == 0));
+            }
+        char message[96];
+        snprintf(message, sizeof(message), "%s: double %.2e, float %.2e", FFTPlan::GetKernelName(kernel),
+                 worst_double, worst_float);
+        check(worst_double < 1e-13 && worst_float < 1e-5, message);
+    }
+    FFTPlan::SetKernel(original);
+
+    // caller scratch and strided channels inside a larger matrix
+    const int size = 960, rows = 9, row_step = 1000;
+    const FFTPlan *plan = FFTPlan::Get(size, 1);
+    std::vector<double> matrix((size_t)rows * row_step), scratch(plan->GetBatchScratchSize());
+    std::vector<double> a_real(rows * 481), a_imag(rows * 481), b_real(rows * 481), b_imag(rows * 481);
+    for (int c = 0; c < rows; c++)
+        for (int n = 0; n < row_step; n++)
+            matrix[(size_t)c * row_step + n] = test_value(n, c);
+    plan->ExecuteRealBatch(matrix.data(), rows, row_step, 1, a_real.data(), a_imag.data());
+    plan->ExecuteRealBatch(matrix.data(), rows, row_step, 1, b_real.data(), b_imag.data(), scratch.data());
+    check(a_real == b_real && a_imag == b_imag, "caller scratch, channel step longer than the transform");
+    check(plan->GetBatchScratchSize() == (2 * 960 + 1) * FFT_BATCH_LANES &&
+          FFTPlan::Get(1009, 1)->GetBatchScratchSize() == 1009 + SignalFFTScratch(1009),
+          "scratch of smooth and Bluestein lengths");
+    printf("\n");
+}
+
+void test_signal_bank()
+{
+    printf("=== Test 2: SignalBank spectra and magnitude matrix ===\n");
+
+    const int channels = 37, frames = 1500;
+    SignalBank bank(channels, 2048);
+    std::vector<double> frame(channels);
+    for (int n = 0; n < frames; n++)
+    {
+        for (int c = 0; c < channels; c++)
+            frame[c] = test_value(n, c);
+        bank.AddFrame(frame.data());
+    }
+    bank.SetAnalysisWindow(1024);
+
+    std::vector<FrequencySpectrum> spectra(channels);
+    bool ok = bank.FFTAnalysis(1000.0, spectra.data());
+    double worst = 0.0;
+    bool same_summary = true;
+    for (int c = 0; ok && c < channels; c++)
+    {
+        FrequencySpectrum single;
+        if (!bank.Channel(c).FFTAnalysis(1000.0, &single))
+        {
+            worst = 1.0;
+            continue;
+        }
+        for (int k = 0; k < single.num_bins; k++)
+            worst = fmax(worst, fabs(spectra[c].bins[k].magnitude - single.bins[k].magnitude));
+        same_summary = same_summary && spectra[c].num_bins == single.num_bins &&
+                       spectra[c].dominant_frequency == single.dominant_frequency &&
+                       fabs(spectra[c].total_power - single.total_power) < 1e-9 * single.total_power;
+        bank.Channel(c).FreeSpectrum(&single);
+    }
+    printf("%d channels of 1024 samples: worst magnitude difference %.2e\n", channels, worst);
+    check(ok && bank.GetNumBins() == 513 && worst < 1e-10, "same spectra as FFTAnalysis() per channel");
+    check(same_summary, "same dominant frequency and total power");
+
+    std::vector<double> matrix((size_t)channels * bank.GetNumBins());
+    ok = bank.FFTMagnitudeMatrix(matrix.data());
+    bool same = ok;
+    for (int c = 0; same && c < channels; c++)
+        for (int k = 0; k < 513; k++)
+            same = same && matrix[(size_t)c * 513 + k] == spectra[c].bins[k].magnitude;
+    check(same, "magnitude matrix, one row per channel");
+    bank.FreeSpectra(spectra.data());
+
+    // window selection is shared with the channel view
+    check(bank.SetSpectrumWindow(SIGNAL_WINDOW_BLACKMAN) && !bank.SetSpectrumWindow(99), "window selection");
+    bank.FFTMagnitudeMatrix(matrix.data());
+    FrequencySpectrum single;
+    bank.Channel(20).FFTAnalysis(1000.0, &single);
+    worst = 0.0;
+    for (int k = 0; k < 513; k++)
+        worst = fmax(worst, fabs(matrix[20 * 513 + k] - single.bins[k].magnitude));
+    check(worst < 1e-10, "Blackman window on both paths");
+    bank.Channel(20).FreeSpectrum(&single);
+
+    SignalBankF empty(4, 64);
+    static float unused[4 * 33];
+    check(!empty.FFTMagnitudeMatrix(unused) && !bank.FFTMagnitudeMatrix(nullptr), "empty bank rejected");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Batch FFT Test Suite                   ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_against_single();
+    test_signal_bank();
+
+    if (failures == 0)
+        printf("All batch FFT tests passed.\n");
+    else
+        printf("%d batch FFT check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
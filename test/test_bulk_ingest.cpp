@@ -0,0 +1,121 @@
+/*
+ * Test file for block ingest (AddValues / AddValuesWithTimestamps)
+ * Tests wraparound of blocks, timestamps and the content against AddValue
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <math.h>
+
+void test_block_wraparound()
+{
+    printf("=== Test 1: Blocks crossing the end of the ring buffer ===\n");
+
+    SignalProcessing sp(10);
+    double block[7];
+    int next = 0;
+    for (int b = 0; b < 5; b++)
+    {
+        for (int i = 0; i < 7; i++)
+            block[i] = (double)(next++);
+        sp.AddValues(block, 7);
+    }
+
+    // 35 samples added: 25..34 remain
+    double values[10];
+    sp.GetVector(values);
+    bool ordered = true;
+    for (int i = 0; i < 10; i++)
+        ordered = ordered && (values[i] == 25.0 + i);
+    check(sp.GetIndex() == 10 && sp.GetTotalCount() == 35, "counts after 5 blocks of 7 samples");
+    check(ordered, "newest 10 samples in order");
+    check(sp.GetLastValue() == 34.0, "last value of the last block");
+
+    // a block larger than the capacity keeps its newest samples
+    double big[25];
+    for (int i = 0; i < 25; i++)
+        big[i] = 100.0 + i;
+    int stored = sp.AddValues(big, 25);
+    sp.GetVector(values);
+    check(stored == 10 && values[0] == 115.0 && values[9] == 124.0, "oversized block keeps its last 10 samples");
+    check(sp.GetTotalCount() == 60, "oversized block counted entirely");
+    printf("\n");
+}
+
+void test_block_timestamps()
+{
+    printf("=== Test 2: Block timestamps ===\n");
+
+    SignalProcessing sp(8);
+    double values[6] = {1, 2, 3, 4, 5, 6};
+    struct timespec ts[6];
+    for (int i = 0; i < 6; i++)
+    {
+        ts[i].tv_sec = 10 + i;
+        ts[i].tv_nsec = 500;
+    }
+    sp.AddValuesWithTimestamps(values, ts, 6);
+    check(sp.GetTimestamp(5).tv_sec == 15 && sp.GetTimestamp(5).tv_nsec == 500, "explicit timestamp array");
+
+    // 40 us period (25 kHz), start close to a second boundary
+    struct timespec start;
+    start.tv_sec = 1000;
+    start.tv_nsec = 999950000;
+    sp.AddValuesWithTimestamps(values, 6, start, 40000);
+    struct timespec t0 = sp.GetTimestamp(2);
+    struct timespec t1 = sp.GetTimestamp(3);
+    struct timespec t5 = sp.GetTimestamp(7);
+    printf("Timestamps: %ld.%09ld, %ld.%09ld ... %ld.%09ld\n",
+           (long)t0.tv_sec, t0.tv_nsec, (long)t1.tv_sec, t1.tv_nsec, (long)t5.tv_sec, t5.tv_nsec);
+    check(t0.tv_sec == 1000 && t0.tv_nsec == 999950000, "start timestamp");
+    check(t1.tv_sec == 1000 && t1.tv_nsec == 999990000, "second sample one period later");
+    check(t5.tv_sec == 1001 && t5.tv_nsec == 150000, "carry into the next second");
+
+    sp.AddValues(values, 3);
+    check(sp.GetTimestamp(7).tv_sec == 0 && sp.GetTimestamp(7).tv_nsec == 0, "untimed block clears timestamps");
+    printf("\n");
+}
+
+void test_same_content()
+{
+    printf("=== Test 3: AddValues stores what AddValue stores (4096-sample DMA blocks) ===\n");
+
+    const int block_size = 4096;
+    const int num_blocks = 300;
+    static double block[block_size];
+    for (int i = 0; i < block_size; i++)
+        block[i] = sin(0.01 * i);
+
+    SignalProcessing sp_single(1 << 20);
+    for (int b = 0; b < num_blocks; b++)
+        for (int i = 0; i < block_size; i++)
+            sp_single.AddValue(block[i]);
+
+    SignalProcessing sp_block(1 << 20);
+    for (int b = 0; b < num_blocks; b++)
+        sp_block.AddValues(block, block_size);
+
+    check(sp_block.GetTotalCount() == sp_single.GetTotalCount(), "same number of samples ingested");
+    check(sp_block.GetValue(12345) == sp_single.GetValue(12345) &&
+          sp_block.GetLastValue() == sp_single.GetLastValue(), "same buffer content");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Bulk Ingest Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_block_wraparound();
+    test_block_timestamps();
+    test_same_content();
+
+    if (failures == 0)
+        printf("All bulk ingest tests passed.\n");
+    else
+        printf("%d bulk ingest check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+/*
+ * Helpers shared by the test suites
+ * check() prints one line per condition and counts the failures. Defining
+ * TEST_COUNT_HEAP_CALLS before the include also counts every heap allocation
+ * of the process in HEAP_CALLS (glibc only, 0 elsewhere) and lets a test make
+ * calloc() fail with fail_calloc (glibc only, CALLOC_CAN_FAIL).
+ */
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int failures = 0;
+
+static void check(bool condition, const char *message)
+{
+    printf("  %s %s\n", condition ? "v" : "x", message);
+    if (!condition)
+        failures++;
+}
+
+#ifdef TEST_COUNT_HEAP_CALLS
+#if defined(__GLIBC__)
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+static long long heap_calls = 0;
+static bool fail_calloc = false;
+extern "C" void *malloc(size_t size)
+{
+    heap_calls++;
+    return __libc_malloc(size);
+}
+extern "C" void *calloc(size_t count, size_t size)
+{
+    heap_calls++;
+    if (fail_calloc)
+        return NULL;
+    return __libc_calloc(count, size);
+}
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    heap_calls++;
+    return __libc_realloc(ptr, size);
+}
+extern "C" int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    heap_calls++;
+    *memptr = __libc_memalign(alignment, size);
+    return (*memptr != NULL) ? 0 : 12;
+}
+#define HEAP_CALLS heap_calls
+#define CALLOC_CAN_FAIL 1
+#else
+#define HEAP_CALLS 0LL
+#define CALLOC_CAN_FAIL 0
+#endif
+#endif
+
+#endif
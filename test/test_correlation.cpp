@@ -97,7 +97,7 @@ void test_autocorrelation_ecg()
     printf("Expected R-R interval: %.1f samples\n", sampling_rate / heart_rate);
     
     // Compute autocorrelation
-    double autocorr[100];
+    double autocorr[101];
     int max_lag = 100;
     int corr_count = sp.Autocorrelation(max_lag, autocorr, true);
     
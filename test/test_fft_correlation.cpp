@@ -0,0 +1,426 @@
+/*
+ * Test file for FFT correlation
+ * Checks Autocorrelation() and CrossCorrelation() with CORRELATION_FFT
+ * against the direct sums for every sample type and lag range, the
+ * CORRELATION_AUTO cost model, the normalization, analysis windows and
+ * views, the autocorrelation feature of ExtractMLFeatures(), GCC-PHAT delays
+ * and sub-sample peaks of FindCorrelationPeak()
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double test_value(int n)
+{
+    return 2.0 + sin(2.0 * M_PI * 0.0213 * n) + 0.4 * cos(0.0011 * n * n) + ((n * 7919) % 23) * 0.03;
+}
+
+// largest difference relative to the lag 0 value
+template <typename Acc>
+static double relative_error(const Acc *reference, const Acc *values, int count)
+{
+    double difference = 0.0;
+    for (int k = 0; k < count; k++)
+        difference = fmax(difference, fabs((double)reference[k] - (double)values[k]));
+    return difference / fmax(fabs((double)reference[0]), 1e-30);
+}
+
+// same for the sums before the division by the n - k pairs: the FFT error is
+// absolute, so averages over the few pairs of the last lags differ more
+template <typename Acc>
+static double sum_error(const Acc *reference, const Acc *values, int count, int n)
+{
+    double difference = 0.0;
+    for (int k = 0; k < count; k++)
+        difference = fmax(difference, fabs((double)reference[k] - (double)values[k]) * (n - k) / n);
+    return difference / fmax(fabs((double)reference[0]), 1e-30);
+}
+
+template <typename S, typename Acc>
+static double method_error(S &sp, int max_lag, bool normalize)
+{
+    std::vector<Acc> direct(max_lag + 1), fft(max_lag + 1);
+    int a = sp.Autocorrelation(max_lag, direct.data(), normalize, CORRELATION_DIRECT);
+    int b = sp.Autocorrelation(max_lag, fft.data(), normalize, CORRELATION_FFT);
+    if (a != b || a < 1)
+        return 1.0;
+    return sum_error(direct.data(), fft.data(), a, sp.GetIndex());
+}
+
+void test_against_direct()
+{
+    printf("=== Test 1: FFT autocorrelation against the direct sums ===\n");
+
+    const int sizes[6] = {2, 3, 97, 1000, 1024, 4099};
+    double worst = 0.0, worst_float = 0.0, worst_i16 = 0.0;
+    for (int s = 0; s < 6; s++)
+    {
+        int n = sizes[s];
+        SignalProcessing sp(n);
+        SignalProcessingF sf(n);
+        SignalProcessingI16 si(n);
+        for (int i = 0; i < n; i++)
+        {
+            sp.AddValue(test_value(i));
+            sf.AddValue((float)test_value(i));
+            si.AddValue((int16_t)(3000.0 * test_value(i)));
+        }
+        // a few lags, about half the window, every lag
+        const int lags[3] = {1, n / 2, n - 1};
+        for (int l = 0; l < 3; l++)
+            for (int normalize = 0; normalize < 2; normalize++)
+            {
+                worst = fmax(worst, method_error<SignalProcessing, double>(sp, lags[l], normalize != 0));
+                worst_float = fmax(worst_float, method_error<SignalProcessingF, float>(sf, lags[l], normalize != 0));
+                worst_i16 = fmax(worst_i16, method_error<SignalProcessingI16, float>(si, lags[l], normalize != 0));
+            }
+    }
+    printf("Worst sum difference relative to lag 0: double %.2e, float %.2e, int16_t %.2e\n", worst, worst_float,
+           worst_i16);
+    check(worst < 1e-12, "double");
+    check(worst_float < 1e-4, "float");
+    check(worst_i16 < 1e-4, "int16_t (float arithmetic)");
+
+    // lags beyond the window are clipped the same way
+    SignalProcessing sp(300);
+    for (int i = 0; i < 300; i++)
+        sp.AddValue(test_value(i));
+    std::vector<double> direct(1000), fft(1000);
+    int a = sp.Autocorrelation(999, direct.data(), true, CORRELATION_DIRECT);
+    int b = sp.Autocorrelation(999, fft.data(), true, CORRELATION_FFT);
+    check(a == 300 && b == 300 && relative_error(direct.data(), fft.data(), 300) < 1e-12, "max_lag clipped to n - 1");
+    check(sp.Autocorrelation(10, fft.data(), true, 3) == 0, "unknown method rejected");
+    printf("\n");
+}
+
+void test_normalization()
+{
+    printf("=== Test 2: Normalization and the AUTO switch ===\n");
+
+    const int n = 4096;
+    SignalProcessing sp(n);
+    for (int i = 0; i < n; i++)
+        sp.AddValue(test_value(i));
+    std::vector<double> raw(n), normalized(n), automatic(n);
+    sp.Autocorrelation(2000, raw.data(), false, CORRELATION_FFT);
+    sp.Autocorrelation(2000, normalized.data(), true, CORRELATION_FFT);
+    check(fabs(raw[0] - sp.GetVariance()) < 1e-9 * sp.GetVariance() || fabs(raw[0] * n / (n - 1) - sp.GetVariance()) <
+              1e-9 * sp.GetVariance(),
+          "lag 0 unnormalized: variance");
+    check(normalized[0] == 1.0 && fabs(normalized[1500] - raw[1500] / raw[0]) < 1e-12, "normalized by lag 0");
+
+    // the cost model: few lags direct, many lags FFT
+    check(SignalCorrelationMethod(n, 5) == CORRELATION_DIRECT, "5 lags of 4096 samples: direct");
+    check(SignalCorrelationMethod(n, 2000) == CORRELATION_FFT, "2000 lags of 4096 samples: FFT");
+    check(SignalCorrelationMethod(100, 2) == CORRELATION_DIRECT && SignalCorrelationMethod(1, 0) == CORRELATION_DIRECT,
+          "short signals: direct");
+    int size = SignalCorrelationLength(n, 2000);
+    check(size >= n + 2000 && size % 2 == 0 && size < (n + 2000) * 11 / 10, "transform length: even, no wrap");
+    sp.Autocorrelation(2000, automatic.data());
+    check(relative_error(normalized.data(), automatic.data(), 2001) < 1e-12, "default is CORRELATION_AUTO");
+    printf("\n");
+}
+
+void test_windows_and_views()
+{
+    printf("=== Test 3: Analysis windows, wraparound and views ===\n");
+
+    // wrapped ring buffer restricted to the newest 1500 samples
+    SignalProcessing sp(2000);
+    for (int i = 0; i < 5000; i++)
+        sp.AddValue(test_value(i));
+    sp.SetAnalysisWindow(1500);
+    std::vector<double> data(1500);
+    for (int i = 0; i < 1500; i++)
+        data[i] = test_value(3500 + i);
+    SignalView view(data.data(), 1500);
+    std::vector<double> a(700), b(700), c(700);
+    sp.Autocorrelation(699, a.data(), true, CORRELATION_FFT);
+    view.Autocorrelation(699, b.data(), true, CORRELATION_DIRECT);
+    view.Autocorrelation(699, c.data(), true, CORRELATION_FFT);
+    check(relative_error(b.data(), a.data(), 700) < 1e-12, "window of a wrapped buffer");
+    check(relative_error(b.data(), c.data(), 700) < 1e-12, "SignalView");
+    printf("\n");
+}
+
+void test_ml_feature()
+{
+    printf("=== Test 4: Autocorrelation peak of ExtractMLFeatures() ===\n");
+
+    const int sizes[4] = {10, 150, 1000, 20000};
+    bool same = true;
+    for (int s = 0; s < 4; s++)
+    {
+        int n = sizes[s];
+        SignalProcessing sp(n);
+        std::vector<double> x(n);
+        for (int i = 0; i < n; i++)
+        {
+            x[i] = ((i % 37) < 3 ? 1.0 : 0.0) + 0.3 * sin(2.1 * i);
+            sp.AddValue(x[i]);
+        }
+        // the previous direct loop: raw products, lags 1 to 99
+        int max_lag = (n > 100) ? 100 : n / 2;
+        double best = 0.0, peak = 0.0;
+        for (int lag = 1; lag < max_lag; lag++)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < n - lag; i++)
+                sum += x[i] * x[i + lag];
+            sum /= (n - lag);
+            if (sum > best)
+            {
+                best = sum;
+                peak = lag / 1000.0;
+            }
+        }
+        MLFeatureVector features;
+        sp.ExtractMLFeatures(1000.0, &features);
+        printf("%5d samples: peak at %.3f s (direct loop %.3f s)\n", n, features.autocorr_peak, peak);
+        same = same && features.autocorr_peak == peak;
+    }
+    check(same, "same lag as the direct loop, for direct and FFT sums");
+    printf("\n");
+}
+
+// the cross-correlation before the FFT method: every lag summed over the overlapping pairs
+static void reference_cross(const std::vector<double> &x, const std::vector<double> &y, int max_lag, bool normalize,
+                            std::vector<double> &out)
+{
+    int n1 = (int)x.size(), n2 = (int)y.size();
+    double m1 = 0.0, m2 = 0.0, v1 = 0.0, v2 = 0.0;
+    for (int i = 0; i < n1; i++)
+        m1 += x[i] / n1;
+    for (int i = 0; i < n2; i++)
+        m2 += y[i] / n2;
+    for (int i = 0; i < n1; i++)
+        v1 += (x[i] - m1) * (x[i] - m1) / n1;
+    for (int i = 0; i < n2; i++)
+        v2 += (y[i] - m2) * (y[i] - m2) / n2;
+    out.assign(2 * max_lag + 1, 0.0);
+    for (int lag = -max_lag; lag <= max_lag; lag++)
+    {
+        double sum = 0.0;
+        int count = 0;
+        for (int i = 0; i < n1; i++)
+            if (i + lag >= 0 && i + lag < n2)
+            {
+                sum += (x[i] - m1) * (y[i + lag] - m2);
+                count++;
+            }
+        out[max_lag + lag] = (count > 0) ? sum / count : 0.0;
+        if (normalize)
+            out[max_lag + lag] /= sqrt(v1 * v2);
+    }
+}
+
+void test_cross_correlation()
+{
+    printf("=== Test 5: FFT cross-correlation against the direct sums ===\n");
+
+    // equal lengths, a longer and a shorter second signal, lags beyond both
+    const int sizes[5][3] = {{1, 1, 0}, {100, 100, 30}, {1000, 1300, 999}, {1021, 77, 200}, {64, 64, 500}};
+    double worst_direct = 0.0, worst_fft = 0.0, worst_float = 0.0;
+    for (int c = 0; c < 5; c++)
+    {
+        int n1 = sizes[c][0], n2 = sizes[c][1], max_lag = sizes[c][2];
+        SignalProcessing sp(n1);
+        SignalProcessingF sf(n1);
+        std::vector<double> x(n1), y(n2);
+        std::vector<float> yf(n2);
+        for (int i = 0; i < n1; i++)
+        {
+            x[i] = test_value(i);
+            sp.AddValue(x[i]);
+            sf.AddValue((float)x[i]);
+        }
+        for (int i = 0; i < n2; i++)
+        {
+            y[i] = test_value(i + 11) * 0.5 + 0.1 * sin(0.7 * i);
+            yf[i] = (float)y[i];
+        }
+        for (int normalize = 0; normalize < 2; normalize++)
+        {
+            std::vector<double> reference, direct(2 * max_lag + 1), fft(2 * max_lag + 1);
+            std::vector<float> direct_f(2 * max_lag + 1), fft_f(2 * max_lag + 1);
+            reference_cross(x, y, max_lag, normalize != 0, reference);
+            int a = sp.CrossCorrelation(y.data(), n2, max_lag, direct.data(), normalize != 0, CORRELATION_DIRECT);
+            int b = sp.CrossCorrelation(y.data(), n2, max_lag, fft.data(), normalize != 0, CORRELATION_FFT);
+            sf.CrossCorrelation(yf.data(), n2, max_lag, direct_f.data(), normalize != 0, CORRELATION_DIRECT);
+            sf.CrossCorrelation(yf.data(), n2, max_lag, fft_f.data(), normalize != 0, CORRELATION_FFT);
+            double largest = 1e-30, d1 = 0.0, d2 = 0.0, d3 = 0.0;
+            for (int k = 0; k <= 2 * max_lag; k++)
+            {
+                // the sums, before the division by the pairs of each lag
+                int lag = k - max_lag;
+                int pairs = (n1 < n2 - lag ? n1 : n2 - lag) - (lag < 0 ? -lag : 0);
+                double w = (pairs > 0) ? (double)pairs / n1 : 0.0;
+                largest = fmax(largest, fabs(reference[k]));
+                d1 = fmax(d1, fabs(direct[k] - reference[k]));
+                d2 = fmax(d2, fabs(fft[k] - reference[k]) * w);
+                d3 = fmax(d3, fabs(fft_f[k] - direct_f[k]) * w);
+            }
+            if (a != 2 * max_lag + 1 || b != a)
+                d1 = largest;
+            worst_direct = fmax(worst_direct, d1 / largest);
+            worst_fft = fmax(worst_fft, d2 / largest);
+            worst_float = fmax(worst_float, d3 / largest);
+        }
+    }
+    printf("Worst difference relative to the largest value: direct %.2e, FFT %.2e, float FFT %.2e\n", worst_direct,
+           worst_fft, worst_float);
+    check(worst_direct < 1e-12, "direct sums unchanged");
+    check(worst_fft < 1e-12, "FFT sums, lags without overlap 0");
+    check(worst_float < 1e-4, "float");
+
+    check(SignalCorrelationMethod(8192, 8192, 5) == CORRELATION_DIRECT, "5 lags of 8192 samples: direct");
+    check(SignalCorrelationMethod(8192, 8192, 1000) == CORRELATION_FFT, "1000 lags of 8192 samples: FFT");
+    check(SignalCorrelationMethod(8192, 3, 5000) == CORRELATION_DIRECT, "3-sample template: direct");
+    SignalProcessing sp(10);
+    double out[3];
+    check(sp.CrossCorrelation(out, 1, 1, out, true, 5) == 0, "unknown method rejected");
+    printf("\n");
+}
+
+// broadband noise through a resonance, deterministic
+static std::vector<double> resonant_noise(int n, unsigned seed)
+{
+    std::vector<double> x(n);
+    double y1 = 0.0, y2 = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        double white = ((seed >> 8) & 0xFFFF) / 32768.0 - 1.0;
+        // two-pole resonance at 0.05 of the sampling rate, r = 0.98
+        double y = white + 2.0 * 0.98 * cos(2.0 * M_PI * 0.05) * y1 - 0.98 * 0.98 * y2;
+        y2 = y1;
+        y1 = y;
+        x[i] = y;
+    }
+    return x;
+}
+
+void test_gcc_phat()
+{
+    printf("=== Test 6: GCC-PHAT time delay between two sensors ===\n");
+
+    // the same resonant source seen 37 samples later, plus sensor noise
+    const int n = 8192, delay = 37, max_lag = 200;
+    std::vector<double> source = resonant_noise(n + delay, 7);
+    std::vector<double> noise = resonant_noise(n, 99);
+    SignalProcessing sensor1(n);
+    std::vector<double> sensor2(n);
+    for (int i = 0; i < n; i++)
+    {
+        sensor1.AddValue(source[i + delay]);
+        sensor2[i] = source[i] + 0.5 * noise[i];
+    }
+    std::vector<double> plain(2 * max_lag + 1), phat(2 * max_lag + 1);
+    sensor1.CrossCorrelation(sensor2.data(), n, max_lag, plain.data());
+    int count = sensor1.GCCPHAT(sensor2.data(), n, max_lag, phat.data());
+    double plain_peak = 0.0, phat_peak = 0.0;
+    int plain_lag = sensor1.FindCorrelationPeak(plain.data(), 2 * max_lag + 1, &plain_peak) - max_lag;
+    int phat_lag = sensor1.FindCorrelationPeak(phat.data(), 2 * max_lag + 1, &phat_peak) - max_lag;
+
+    // peak sharpness: width at half the peak value
+    int plain_width = 0, phat_width = 0;
+    for (int k = 0; k <= 2 * max_lag; k++)
+    {
+        plain_width += (plain[k] > plain_peak / 2) ? 1 : 0;
+        phat_width += (phat[k] > phat_peak / 2) ? 1 : 0;
+    }
+    printf("Sensor 2 lags by %d samples: GCC-PHAT %d (peak %.3f, %d lags above half), plain %d (%d lags above half)\n",
+           delay, phat_lag, phat_peak, phat_width, plain_lag, plain_width);
+    check(count == 2 * max_lag + 1 && phat_lag == delay, "GCC-PHAT delay");
+    check(phat_width < plain_width && phat_width <= 3, "sharper peak than the plain correlation of the resonance");
+
+    // the signal itself: about 1 at lag 0; an exact copy shifted by 5 samples
+    SignalProcessing copy(1000);
+    std::vector<double> same(1000), shifted(1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        copy.AddValue(source[i + 5]);
+        same[i] = source[i + 5];
+        shifted[i] = source[i];
+    }
+    copy.GCCPHAT(same.data(), 1000, 20, phat.data());
+    int lag = copy.FindCorrelationPeak(phat.data(), 41, &phat_peak) - 20;
+    check(lag == 0 && phat_peak > 0.95 && phat_peak < 1.01, "same signal: about 1 at lag 0");
+    copy.GCCPHAT(shifted.data(), 1000, 20, phat.data());
+    lag = copy.FindCorrelationPeak(phat.data(), 41, &phat_peak) - 20;
+    check(lag == 5 && phat_peak > 0.5, "shifted copy");
+    check(copy.GCCPHAT(nullptr, 10, 5, phat.data()) == 0, "no second signal rejected");
+    printf("\n");
+}
+
+void test_sub_sample_peak()
+{
+    printf("=== Test 7: Sub-sample peak position ===\n");
+
+    SignalProcessing sp(10);
+    // samples of a parabola peaking at 4.3
+    double parabola[9];
+    for (int i = 0; i < 9; i++)
+        parabola[i] = 10.0 - (i - 4.3) * (i - 4.3);
+    double value = 0.0, position = 0.0;
+    int index = sp.FindCorrelationPeak(parabola, 9, &value, &position);
+    check(index == 4 && fabs(position - 4.3) < 1e-12, "exact for a parabola");
+    double rising[4] = {0.0, 1.0, 2.0, 3.0};
+    index = sp.FindCorrelationPeak(rising, 4, &value, &position);
+    check(index == 3 && position == 3.0, "index itself at the end of the array");
+    check(sp.FindCorrelationPeak(rising, 4, &value) == 3, "position optional");
+
+    // band-limited signal delayed by 12.3 samples: exact fractional delay of each tone
+    const int n = 4096, max_lag = 40;
+    const double delay = 12.3;
+    SignalProcessing sensor1(n);
+    std::vector<double> sensor2(n);
+    for (int i = 0; i < n; i++)
+    {
+        double a = 0.0, b = 0.0;
+        for (int t = 1; t <= 20; t++)
+        {
+            double f = 0.004 * t, phase = 1.7 * t * t;
+            a += sin(2.0 * M_PI * f * i + phase);
+            b += sin(2.0 * M_PI * f * (i - delay) + phase);
+        }
+        sensor1.AddValue(a);
+        sensor2[i] = b;
+    }
+    std::vector<double> correlation(2 * max_lag + 1);
+    sensor1.CrossCorrelation(sensor2.data(), n, max_lag, correlation.data());
+    index = sensor1.FindCorrelationPeak(correlation.data(), 2 * max_lag + 1, &value, &position);
+    printf("Delay 12.3 samples: peak index %d, interpolated %.3f\n", index - max_lag, position - max_lag);
+    check(index - max_lag == 12 && fabs(position - max_lag - delay) < 0.05, "fractional delay within 0.05 sample");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     FFT Correlation Test Suite             ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_against_direct();
+    test_normalization();
+    test_windows_and_views();
+    test_ml_feature();
+    test_cross_correlation();
+    test_gcc_phat();
+    test_sub_sample_peak();
+
+    if (failures == 0)
+        printf("All FFT correlation tests passed.\n");
+    else
+        printf("%d FFT correlation check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
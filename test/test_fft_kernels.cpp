@@ -0,0 +1,182 @@
+/*
+ * Test file for the vectorized FFT kernels
+ * Compares every kernel available on this CPU with the scalar kernel and a
+ * direct DFT
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const int KERNELS[] = {FFT_KERNEL_SCALAR, FFT_KERNEL_SSE2, FFT_KERNEL_NEON, FFT_KERNEL_AVX2, FFT_KERNEL_AVX512};
+static const int NUM_KERNELS = 5;
+
+static double test_value(int n, int channel)
+{
+    return sin(0.37 * n + channel) + 0.5 * cos(0.011 * n * n) + ((n * 7919 + channel) % 13) * 0.01;
+}
+
+// largest difference between the outputs, relative to the largest magnitude
+template <typename T>
+static double transform_error(int kernel, int size, int direction)
+{
+    std::vector<T> real(size), imag(size), ref_real(size), ref_imag(size);
+    for (int i = 0; i < size; i++)
+    {
+        real[i] = ref_real[i] = (T)test_value(i, 0);
+        imag[i] = ref_imag[i] = (T)test_value(i, 1);
+    }
+    const FFTPlan *plan = FFTPlan::Get(size, direction);
+    FFTPlan::SetKernel(FFT_KERNEL_SCALAR);
+    plan->Execute(ref_real.data(), ref_imag.data());
+    FFTPlan::SetKernel(kernel);
+    plan->Execute(real.data(), imag.data());
+
+    double diff = 0.0, magnitude = 0.0;
+    for (int i = 0; i < size; i++)
+    {
+        diff = fmax(diff, fabs((double)real[i] - (double)ref_real[i]));
+        diff = fmax(diff, fabs((double)imag[i] - (double)ref_imag[i]));
+        magnitude = fmax(magnitude, sqrt((double)ref_real[i] * ref_real[i] + (double)ref_imag[i] * ref_imag[i]));
+    }
+    return diff / magnitude;
+}
+
+void test_detection()
+{
+    printf("=== Test 1: Kernel detection ===\n");
+
+    int detected = FFTPlan::GetKernel();
+    printf("Detected kernel: %s; available:", FFTPlan::GetKernelName(detected));
+    int widest = FFT_KERNEL_SCALAR;
+    for (int k = 0; k < NUM_KERNELS; k++)
+    {
+        if (FFTPlan::IsKernelSupported(KERNELS[k]))
+        {
+            printf(" %s", FFTPlan::GetKernelName(KERNELS[k]));
+            widest = KERNELS[k];
+        }
+    }
+    printf("\n");
+    check(detected == widest, "widest available kernel selected");
+    check(FFTPlan::IsKernelSupported(FFT_KERNEL_SCALAR), "scalar kernel always available");
+    check(!FFTPlan::SetKernel(99) && FFTPlan::GetKernel() == detected, "unknown kernel rejected");
+    check(!(FFTPlan::IsKernelSupported(FFT_KERNEL_SSE2) && FFTPlan::IsKernelSupported(FFT_KERNEL_NEON)),
+          "SSE2 and NEON exclusive");
+    printf("\n");
+}
+
+void test_against_dft()
+{
+    printf("=== Test 2: Scalar radix-4 kernel against a direct DFT ===\n");
+
+    FFTPlan::SetKernel(FFT_KERNEL_SCALAR);
+    double worst = 0.0;
+    for (int size = 2; size <= 1024; size *= 2)
+    {
+        for (int direction = 1; direction >= -1; direction -= 2)
+        {
+            std::vector<double> real(size), imag(size);
+            for (int i = 0; i < size; i++)
+            {
+                real[i] = test_value(i, 0);
+                imag[i] = test_value(i, 1);
+            }
+            std::vector<double> in_real(real), in_imag(imag);
+            FFTPlan::Get(size, direction)->Execute(real.data(), imag.data());
+            for (int k = 0; k < size; k++)
+            {
+                double sum_real = 0.0, sum_imag = 0.0;
+                for (int n = 0; n < size; n++)
+                {
+                    double theta = direction * 2.0 * M_PI * (double)((long long)k * n % size) / size;
+                    sum_real += in_real[n] * cos(theta) - in_imag[n] * sin(theta);
+                    sum_imag += in_real[n] * sin(theta) + in_imag[n] * cos(theta);
+                }
+                if (direction < 0)
+                {
+                    sum_real /= size;
+                    sum_imag /= size;
+                }
+                double scale = (direction < 0) ? 1.0 : sqrt((double)size);
+                worst = fmax(worst, fabs(real[k] - sum_real) / scale);
+                worst = fmax(worst, fabs(imag[k] - sum_imag) / scale);
+            }
+        }
+    }
+    printf("Worst difference to the DFT (sizes 2 to 1024, both directions): %.2e\n", worst);
+    check(worst < 1e-12, "radix-4 passes match the DFT");
+    printf("\n");
+}
+
+void test_kernels_match()
+{
+    printf("=== Test 3: Vector kernels against the scalar kernel ===\n");
+
+    int detected = -1;
+    for (int k = 0; k < NUM_KERNELS; k++)
+        if (FFTPlan::IsKernelSupported(KERNELS[k]))
+            detected = KERNELS[k];
+
+    for (int k = 1; k < NUM_KERNELS; k++)
+    {
+        int kernel = KERNELS[k];
+        if (!FFTPlan::IsKernelSupported(kernel))
+            continue;
+        double worst_double = 0.0, worst_float = 0.0;
+        for (int size = 2; size <= 65536; size *= 2)
+        {
+            for (int direction = 1; direction >= -1; direction -= 2)
+            {
+                worst_double = fmax(worst_double, transform_error<double>(kernel, size, direction));
+                worst_float = fmax(worst_float, transform_error<float>(kernel, size, direction));
+            }
+        }
+        printf("%-8s worst relative difference: double %.2e, float %.2e\n", FFTPlan::GetKernelName(kernel),
+               worst_double, worst_float);
+        char message[96];
+        snprintf(message, sizeof(message), "%s within the documented tolerance", FFTPlan::GetKernelName(kernel));
+        check(worst_double < 1e-12 && worst_float < 1e-5, message);
+    }
+
+    // the real-input path runs on the same kernels
+    const int size = 4096;
+    std::vector<double> samples(size), real(size / 2 + 1), imag(size / 2 + 1), ref_real(size / 2 + 1),
+        ref_imag(size / 2 + 1);
+    for (int i = 0; i < size; i++)
+        samples[i] = test_value(i, 2);
+    FFTPlan::SetKernel(FFT_KERNEL_SCALAR);
+    FFTPlan::Get(size, 1)->ExecuteReal(samples.data(), ref_real.data(), ref_imag.data());
+    FFTPlan::SetKernel(detected);
+    FFTPlan::Get(size, 1)->ExecuteReal(samples.data(), real.data(), imag.data());
+    double diff = 0.0;
+    for (int i = 0; i <= size / 2; i++)
+        diff = fmax(diff, fmax(fabs(real[i] - ref_real[i]), fabs(imag[i] - ref_imag[i])));
+    check(diff < 1e-12 * size, "real-input transform on the detected kernel");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     FFT Kernels Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_detection();
+    test_against_dft();
+    test_kernels_match();
+
+    if (failures == 0)
+        printf("All FFT kernel tests passed.\n");
+    else
+        printf("%d FFT kernel check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+/*
+ * Test file for FFTs of any length
+ * Checks the mixed-radix (2, 3, 5) and Bluestein plans against a direct DFT
+ * and the spectra of the analysis methods at the natural window length
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <thread>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double test_value(int n, int channel)
+{
+    return sin(0.31 * n + channel) + 0.4 * cos(0.013 * n * n) + (((long long)n * 7919 + channel) % 11) * 0.02;
+}
+
+// largest difference to a direct DFT, relative to sqrt(size) for the forward transform
+static double dft_error(int size, int direction, bool real_input)
+{
+    std::vector<double> in_real(size), in_imag(size), real(size), imag(size);
+    for (int i = 0; i < size; i++)
+    {
+        in_real[i] = real[i] = test_value(i, 0);
+        in_imag[i] = imag[i] = real_input ? 0.0 : test_value(i, 1);
+    }
+    const FFTPlan *plan = FFTPlan::Get(size, direction);
+    if (plan == nullptr)
+        return 1.0;
+    if (real_input)
+        plan->ExecuteReal(real.data(), real.data(), imag.data());
+    else
+        plan->Execute(real.data(), imag.data());
+
+    std::vector<double> cosine(size), sine(size);
+    for (int i = 0; i < size; i++)
+    {
+        cosine[i] = cos(2.0 * M_PI * i / size);
+        sine[i] = direction * sin(2.0 * M_PI * i / size);
+    }
+    int bins = real_input ? size / 2 + 1 : size;
+    double worst = 0.0;
+    for (int k = 0; k < bins; k++)
+    {
+        double sum_real = 0.0, sum_imag = 0.0;
+        for (int n = 0, index = 0; n < size; n++, index = (index + k) % size)
+        {
+            sum_real += in_real[n] * cosine[index] - in_imag[n] * sine[index];
+            sum_imag += in_real[n] * sine[index] + in_imag[n] * cosine[index];
+        }
+        double scale = sqrt((double)size);
+        if (direction < 0)
+        {
+            sum_real /= size;
+            sum_imag /= size;
+            scale = 1.0;
+        }
+        worst = fmax(worst, fmax(fabs(real[k] - sum_real), fabs(imag[k] - sum_imag)) / scale);
+    }
+    return worst;
+}
+
+void test_against_dft()
+{
+    printf("=== Test 1: Every length from 2 to 512 against a direct DFT ===\n");
+
+    double smooth = 0.0, bluestein = 0.0, real_input = 0.0;
+    for (int size = 2; size <= 512; size++)
+    {
+        double e = fmax(dft_error(size, 1, false), dft_error(size, -1, false));
+        if (SignalFFTSmooth(size))
+            smooth = fmax(smooth, e);
+        else
+            bluestein = fmax(bluestein, e);
+        real_input = fmax(real_input, dft_error(size, 1, true));
+    }
+    printf("Worst difference: mixed radix %.2e, Bluestein %.2e, real input %.2e\n", smooth, bluestein, real_input);
+    check(smooth < 1e-12, "mixed-radix lengths (2, 3, 5)");
+    check(bluestein < 1e-12, "other lengths through Bluestein");
+    check(real_input < 1e-12, "real-input transform of even and odd lengths");
+
+    // large lengths, round trip
+    const int sizes[3] = {3 * 5 * 5 * 4096, 65537, 999983};
+    for (int s = 0; s < 3; s++)
+    {
+        int size = sizes[s];
+        std::vector<float> real(size), imag(size);
+        for (int i = 0; i < size; i++)
+        {
+            real[i] = (float)test_value(i, 0);
+            imag[i] = (float)test_value(i, 1);
+        }
+        FFTPlan::Get(size, 1)->Execute(real.data(), imag.data());
+        FFTPlan::Get(size, -1)->Execute(real.data(), imag.data());
+        double e = 0.0;
+        for (int i = 0; i < size; i++)
+            e = fmax(e, fmax(fabs(real[i] - test_value(i, 0)), fabs(imag[i] - test_value(i, 1))));
+        printf("float round trip of %d points: %.2e\n", size, e);
+        check(e < 1e-4, "forward then inverse gives the samples back");
+    }
+    printf("\n");
+}
+
+void test_plans()
+{
+    printf("=== Test 2: Plans and scratch ===\n");
+
+    const FFTPlan *smooth = FFTPlan::Get(1000, 1);
+    const FFTPlan *prime = FFTPlan::Get(1009, 1);
+    check(smooth != nullptr && smooth == FFTPlan::Get(1000, 1) && smooth != FFTPlan::Get(1000, -1),
+          "cached per length and direction");
+    check(smooth->GetScratchSize() == 0 && FFTPlan::Get(45, 1)->GetScratchSize() == 90,
+          "no scratch for smooth lengths except a copy for odd real input");
+    static_assert(SignalFFTSmoothLength(2017) == 2025 && SignalFFTSmoothLength(1000) == 1000 &&
+                      SignalFFTSmoothLength(1025) == 1080 && SignalFFTSmoothLength((1 << 30) - 1) == (1 << 30),
+                  "smallest 2, 3, 5-smooth length");
+    check(prime->GetScratchSize() == SignalFFTScratch(1009) && SignalFFTScratch(1009) == 2 * 1009 + 2 * 2025,
+          "Bluestein scratch at the smooth convolution length");
+
+    // caller scratch: same result as the internal allocation
+    std::vector<double> a_real(1009), a_imag(1009), b_real(1009), b_imag(1009), scratch(prime->GetScratchSize());
+    for (int i = 0; i < 1009; i++)
+    {
+        a_real[i] = b_real[i] = test_value(i, 0);
+        a_imag[i] = b_imag[i] = test_value(i, 1);
+    }
+    prime->Execute(a_real.data(), a_imag.data());
+    prime->Execute(b_real.data(), b_imag.data(), scratch.data());
+    check(a_real == b_real && a_imag == b_imag, "caller scratch");
+
+    const FFTPlan *seen[8];
+    std::thread threads[8];
+    for (int t = 0; t < 8; t++)
+        threads[t] = std::thread([&seen, t]() {
+            for (int size = 3000; size < 3100; size++)
+                FFTPlan::Get(size, 1);
+            seen[t] = FFTPlan::Get(3001, 1);
+        });
+    for (int t = 0; t < 8; t++)
+        threads[t].join();
+    bool same = seen[0] != nullptr && seen[0]->GetSize() == 3001;
+    for (int t = 1; t < 8; t++)
+        same = same && seen[t] == seen[0];
+    check(same, "threads racing on new lengths share one plan");
+    printf("\n");
+}
+
+void test_natural_length()
+{
+    printf("=== Test 3: Spectra at the window length ===\n");
+
+    const double rate = 1000.0;
+    SignalProcessing sp(1000);
+    for (int i = 0; i < 1000; i++)
+        sp.AddValue(sin(2.0 * M_PI * 123.0 * i / rate));
+
+    FrequencySpectrum spectrum;
+    bool ok = sp.FFTAnalysis(rate, &spectrum);
+    printf("1000 samples: %d bins, resolution %.3f Hz, dominant %.3f Hz\n", ok ? spectrum.num_bins : 0,
+           ok ? spectrum.frequency_resolution : 0.0, ok ? spectrum.dominant_frequency : 0.0);
+    check(ok && spectrum.num_bins == 501 && spectrum.frequency_resolution == 1.0, "no zero padding");
+    check(ok && spectrum.dominant_frequency == 123.0 && spectrum.bins[122].magnitude < 0.6 * spectrum.bins[123].magnitude,
+          "tone on an exact bin");
+    if (ok)
+        sp.FreeSpectrum(&spectrum);
+
+    // blade-synchronous segments of different lengths
+    SignalProcessing blades(4000);
+    for (int i = 0; i < 4000; i++)
+        blades.AddValue(sin(2.0 * M_PI * 50.0 * i / rate) + 0.5 * sin(2.0 * M_PI * 200.0 * i / rate));
+    int markers[3] = {0, 997, 2197};
+    FrequencySpectrum spectra[3];
+    int n = blades.CompareSegmentSpectra(markers, 3, rate, spectra);
+    check(n == 3 && spectra[0].num_bins == 997 / 2 + 1 && spectra[1].num_bins == 601 && spectra[2].num_bins == 902,
+          "segments transformed at their own lengths");
+    check(n == 3 && fabs(spectra[1].frequency_resolution - rate / 1200.0) < 1e-12 &&
+          spectra[1].dominant_frequency == 50.0 && fabs(spectra[0].dominant_frequency - 50.0) < 0.6,
+          "frequency resolution rate / length");
+    for (int i = 0; i < n; i++)
+        blades.FreeSpectrum(&spectra[i]);
+    printf("\n");
+}
+
+void test_fixed_bluestein()
+{
+    printf("=== Test 4: Fixed capacity with a prime length ===\n");
+
+    static SignalProcessingFixed<4999> sp;
+    for (int i = 0; i < 4999; i++)
+        sp.AddValue(sin(2.0 * M_PI * 60.0 * i / 1000.0));
+    FFTPlan::Get(4999, 1);
+
+    long long before = sp.GetWorkspace()->GetHeapAllocationCount();
+    MLFeatureVector features;
+    sp.ExtractMLFeatures(1000.0, &features);
+    static FrequencyBin bins[SignalProcessingFixed<4999>::SPECTRUM_BINS];
+    FrequencySpectrum spectrum;
+    bool ok = sp.FFTAnalysis(1000.0, &spectrum, bins, SignalProcessingFixed<4999>::SPECTRUM_BINS);
+    printf("Workspace %zu bytes, peak usage %zu bytes\n", sp.GetWorkspace()->GetSize(), sp.GetWorkspace()->GetPeakUsage());
+    check(ok && fabs(spectrum.dominant_frequency - 60.0) < 0.2 && features.dominant_frequency == spectrum.dominant_frequency,
+          "spectrum of 4999 samples");
+    check(sp.GetWorkspace()->GetHeapAllocationCount() == before, "Bluestein scratch fits the fixed workspace");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     FFT Lengths Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_against_dft();
+    test_plans();
+    test_natural_length();
+    test_fixed_bluestein();
+
+    if (failures == 0)
+        printf("All FFT length tests passed.\n");
+    else
+        printf("%d FFT length check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+/*
+ * Test file for FFTPlan
+ * Precomputed twiddles and bit-reversal tables, shared through the plan cache
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <thread>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// the previous transform: bit reversal on every call, twiddles by recurrence
+static void recurrence_fft(double *real, double *imag, int size, int direction)
+{
+    int j = 0;
+    for (int i = 0; i < size - 1; ++i)
+    {
+        if (i < j)
+        {
+            double t = real[i]; real[i] = real[j]; real[j] = t;
+            t = imag[i]; imag[i] = imag[j]; imag[j] = t;
+        }
+        int k = size / 2;
+        while (k <= j)
+        {
+            j -= k;
+            k /= 2;
+        }
+        j += k;
+    }
+    for (int step = 2; step <= size; step *= 2)
+    {
+        double theta = direction * 2.0 * M_PI / step;
+        double w_real = cos(theta);
+        double w_imag = sin(theta);
+        for (int start = 0; start < size; start += step)
+        {
+            double wr = 1.0, wi = 0.0;
+            for (int k = 0; k < step / 2; ++k)
+            {
+                int a = start + k, b = a + step / 2;
+                double tr = wr * real[b] - wi * imag[b];
+                double ti = wr * imag[b] + wi * real[b];
+                real[b] = real[a] - tr;
+                imag[b] = imag[a] - ti;
+                real[a] += tr;
+                imag[a] += ti;
+                double t = wr * w_real - wi * w_imag;
+                wi = wr * w_imag + wi * w_real;
+                wr = t;
+            }
+        }
+    }
+}
+
+// largest error on the transform of exp(i * 2 pi * k0 * n / size): size at bin peak, 0 elsewhere
+template <typename F>
+static double tone_error(int size, int k0, int peak, F transform)
+{
+    double *real = (double *)malloc(size * sizeof(double));
+    double *imag = (double *)malloc(size * sizeof(double));
+    for (int n = 0; n < size; n++)
+    {
+        real[n] = cos(2.0 * M_PI * (double)k0 * n / size);
+        imag[n] = sin(2.0 * M_PI * (double)k0 * n / size);
+    }
+    transform(real, imag);
+    double error = 0.0;
+    for (int k = 0; k < size; k++)
+    {
+        double expected = (k == peak) ? size : 0.0;
+        double e = hypot(real[k] - expected, imag[k]);
+        if (e > error)
+            error = e;
+    }
+    free(real);
+    free(imag);
+    return error / size;
+}
+
+void test_accuracy()
+{
+    printf("=== Test 1: Accuracy against the recurrence ===\n");
+
+    const int size = 1 << 20;
+    const int k0 = 12345;
+    // the forward transform uses exp(+i...) twiddles: the tone lands on bin size - k0
+    double plan_error = tone_error(size, k0, size - k0, [](double *re, double *im) {
+        FFTPlan::Get(1 << 20, 1)->Execute(re, im);
+    });
+    double recurrence_error = tone_error(size, k0, size - k0, [](double *re, double *im) {
+        recurrence_fft(re, im, 1 << 20, 1);
+    });
+    printf("Relative error, 2^20 points: plan %.2e, recurrence %.2e\n", plan_error, recurrence_error);
+    check(plan_error < 0.5 * recurrence_error, "direct twiddles are more accurate");
+
+    static double real[4096], imag[4096], re2[4096], im2[4096];
+    for (int i = 0; i < 4096; i++)
+    {
+        real[i] = re2[i] = sin(i * 0.37) + 0.1 * (i % 7);
+        imag[i] = im2[i] = 0.0;
+    }
+    FFTPlan::Get(4096, 1)->Execute(real, imag);
+    FFTPlan::Get(4096, -1)->Execute(real, imag);
+    double round_trip = 0.0;
+    for (int i = 0; i < 4096; i++)
+        round_trip = fmax(round_trip, fabs(real[i] - re2[i]) + fabs(imag[i]));
+    check(round_trip < 1e-12, "forward then inverse restores the input");
+
+    static float real_f[4096], imag_f[4096];
+    for (int i = 0; i < 4096; i++)
+    {
+        real_f[i] = (float)re2[i];
+        imag_f[i] = 0.0f;
+    }
+    FFTPlan::Get(4096, 1)->Execute(real, imag);
+    FFTPlan::Get(4096, 1)->Execute(real_f, imag_f);
+    double float_error = 0.0;
+    for (int i = 0; i < 4096; i++)
+        float_error = fmax(float_error, fabs(real_f[i] - real[i]) + fabs(imag_f[i] - imag[i]));
+    printf("float against double transform: %.2e\n", float_error);
+    check(float_error < 1e-2, "float plan");
+    printf("\n");
+}
+
+void test_cache()
+{
+    printf("=== Test 2: Process-wide plan cache ===\n");
+
+    const FFTPlan *a = FFTPlan::Get(4096, 1);
+    const FFTPlan *b = FFTPlan::Get(4096, 1);
+    const FFTPlan *inverse = FFTPlan::Get(4096, -1);
+    check(a != nullptr && a == b && a->GetSize() == 4096, "same plan for the same size");
+    check(inverse != a && inverse->GetDirection() == -1, "direction is part of the key");
+    check(FFTPlan::Get(1, 1) == nullptr && FFTPlan::Get(-8, 1) == nullptr, "invalid sizes rejected");
+
+    const FFTPlan *seen[8];
+    std::thread threads[8];
+    for (int t = 0; t < 8; t++)
+        threads[t] = std::thread([&seen, t]() { seen[t] = FFTPlan::Get(1 << 16, 1); });
+    for (int t = 0; t < 8; t++)
+        threads[t].join();
+    bool same = seen[0] != nullptr;
+    for (int t = 1; t < 8; t++)
+        same = same && seen[t] == seen[0];
+    check(same, "threads racing on the first use share one plan");
+
+    FFTPlan own(256, 1);
+    check(own.IsValid() && own.GetSize() == 256, "plans can also be built directly");
+    printf("\n");
+}
+
+void test_analysis()
+{
+    printf("=== Test 3: FFTAnalysis on the shared plans ===\n");
+
+    SignalProcessing sp(4096);
+    for (int i = 0; i < 4096; i++)
+        sp.AddValue(sin(2.0 * M_PI * 440.0 * i / 8000.0));
+    FrequencySpectrum spectrum;
+    static FrequencyBin bins[2049];
+    bool ok = sp.FFTAnalysis(8000.0, &spectrum, bins, 2049);
+    printf("Dominant frequency: %.2f Hz\n", ok ? spectrum.dominant_frequency : 0.0);
+    check(ok && fabs(spectrum.dominant_frequency - 440.0) < 2.0, "FFTAnalysis runs on the shared plans");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     FFT Plan Test Suite                    ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_accuracy();
+    test_cache();
+    test_analysis();
+
+    if (failures == 0)
+        printf("All FFT plan tests passed.\n");
+    else
+        printf("%d FFT plan check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
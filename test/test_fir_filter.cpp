@@ -0,0 +1,243 @@
+/*
+ * Test file for FIRFilterT
+ * Checks the direct and overlap-save FFT methods against a reference
+ * convolution for every sample type, block-size independence, Reset(),
+ * the FIR_AUTO switch and SignalDesignFIR() responses
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double test_value(int n)
+{
+    return sin(2.0 * M_PI * 0.0317 * n) + 0.5 * cos(0.0013 * n * n) + ((n * 7919) % 17) * 0.02 - 0.16;
+}
+
+static std::vector<double> test_coefficients(int taps)
+{
+    std::vector<double> h(taps);
+    for (int k = 0; k < taps; k++)
+        h[k] = cos(0.37 * k) * exp(-3.0 * k / taps) / taps;
+    return h;
+}
+
+// y[n] = sum of h[k] * x[n - k], with x = 0 before the first sample
+static std::vector<double> reference_filter(const std::vector<double> &x, const std::vector<double> &h)
+{
+    std::vector<double> y(x.size(), 0.0);
+    for (size_t n = 0; n < x.size(); n++)
+        for (size_t k = 0; k < h.size() && k <= n; k++)
+            y[n] += h[k] * x[n - k];
+    return y;
+}
+
+// largest difference relative to the largest reference output
+template <typename Acc>
+static double relative_error(const std::vector<double> &reference, const std::vector<Acc> &output)
+{
+    double largest = 1e-30, difference = 0.0;
+    for (size_t n = 0; n < reference.size(); n++)
+    {
+        largest = fmax(largest, fabs(reference[n]));
+        difference = fmax(difference, fabs(reference[n] - (double)output[n]));
+    }
+    return difference / largest;
+}
+
+template <typename T, typename Acc>
+static double method_error(int taps, int method, double scale, int *used)
+{
+    const int length = 3000;
+    std::vector<double> h = test_coefficients(taps);
+    std::vector<T> x(length);
+    std::vector<double> xd(length);
+    for (int n = 0; n < length; n++)
+    {
+        x[n] = (T)(scale * test_value(n));
+        xd[n] = (double)x[n];
+    }
+    FIRFilterT<T, Acc> filter(h.data(), taps, method);
+    if (!filter.IsValid())
+        return 1.0;
+    *used = filter.GetMethod();
+    std::vector<Acc> y(length);
+    filter.Filter(x.data(), y.data(), length);
+    return relative_error(reference_filter(xd, h), y);
+}
+
+void test_against_reference()
+{
+    printf("=== Test 1: Direct and FFT methods against the reference convolution ===\n");
+
+    const int taps[6] = {1, 7, 33, 48, 129, 700};
+    double worst_direct = 0.0, worst_fft = 0.0, worst_float = 0.0, worst_i16 = 0.0;
+    bool methods = true;
+    for (int t = 0; t < 6; t++)
+    {
+        int used = 0;
+        worst_direct = fmax(worst_direct, method_error<double, double>(taps[t], FIR_DIRECT, 1.0, &used));
+        methods = methods && used == FIR_DIRECT;
+        worst_fft = fmax(worst_fft, method_error<double, double>(taps[t], FIR_FFT, 1.0, &used));
+        methods = methods && used == FIR_FFT;
+        for (int m = FIR_DIRECT; m <= FIR_FFT; m++)
+        {
+            worst_float = fmax(worst_float, method_error<float, float>(taps[t], m, 1.0, &used));
+            worst_float = fmax(worst_float, method_error<float, double>(taps[t], m, 1.0, &used));
+            worst_i16 = fmax(worst_i16, method_error<int16_t, float>(taps[t], m, 9000.0, &used));
+            worst_i16 = fmax(worst_i16, method_error<int16_t, double>(taps[t], m, 9000.0, &used));
+        }
+    }
+    printf("Worst relative error: direct %.2e, FFT %.2e, float %.2e, int16_t %.2e\n", worst_direct, worst_fft,
+           worst_float, worst_i16);
+    check(worst_direct < 1e-12, "FIR_DIRECT matches in double");
+    check(worst_fft < 1e-12, "FIR_FFT matches in double");
+    check(worst_float < 1e-5, "float samples and arithmetic");
+    check(worst_i16 < 1e-5, "int16_t samples");
+    check(methods, "requested method used");
+    printf("\n");
+}
+
+void test_streaming()
+{
+    printf("=== Test 2: Streaming in blocks of any size ===\n");
+
+    const int length = 5000, taps = 200;
+    std::vector<double> h = test_coefficients(taps);
+    std::vector<double> x(length);
+    for (int n = 0; n < length; n++)
+        x[n] = test_value(n);
+    std::vector<double> reference = reference_filter(x, h);
+
+    for (int method = FIR_DIRECT; method <= FIR_FFT; method++)
+    {
+        FIRFilter filter(h.data(), taps, method);
+        // sizes straddle both FFT blocks and the direct block
+        const int blocks[7] = {1, 3, 1000, 17, 2500, 255, 224};
+        std::vector<double> y(length);
+        int done = 0;
+        for (int b = 0; done < length; b = (b + 1) % 7)
+        {
+            int count = (length - done < blocks[b]) ? length - done : blocks[b];
+            done += filter.Filter(x.data() + done, y.data() + done, count);
+        }
+        check(relative_error(reference, y) < 1e-12 && filter.GetSampleCount() == length,
+              method == FIR_DIRECT ? "FIR_DIRECT in varying blocks" : "FIR_FFT in varying blocks");
+
+        // one sample at a time, then Reset() and in place
+        filter.Reset();
+        for (int n = 0; n < length; n++)
+            y[n] = filter.Filter(x[n]);
+        check(relative_error(reference, y) < 1e-12, "Filter(T) sample by sample after Reset()");
+        filter.Reset();
+        y = x;
+        filter.Filter(y.data(), y.data(), length);
+        check(relative_error(reference, y) < 1e-12 && filter.GetSampleCount() == length, "in place");
+    }
+
+    FIRFilter invalid(nullptr, 10);
+    double out = 0.0;
+    check(!invalid.IsValid() && invalid.Filter(&out, &out, 1) == 0, "no coefficients rejected");
+    check(!FIRFilter(h.data(), 0).IsValid() && !FIRFilter(h.data(), 5, 7).IsValid(), "bad taps or method rejected");
+    printf("\n");
+}
+
+void test_auto()
+{
+    printf("=== Test 3: FIR_AUTO ===\n");
+
+    std::vector<double> h = test_coefficients(1000);
+    FIRFilter short_filter(h.data(), FIR_FFT_MIN_TAPS - 1);
+    FIRFilter long_filter(h.data(), FIR_FFT_MIN_TAPS);
+    FIRFilter longer_filter(h.data(), 1000);
+    printf("%d taps: FFT size %d, %d taps: FFT size %d\n", FIR_FFT_MIN_TAPS, long_filter.GetFFTSize(), 1000,
+           longer_filter.GetFFTSize());
+    check(short_filter.GetMethod() == FIR_DIRECT && short_filter.GetFFTSize() == 0, "short filter: direct");
+    check(long_filter.GetMethod() == FIR_FFT && longer_filter.GetMethod() == FIR_FFT, "long filter: FFT");
+    check(longer_filter.GetFFTSize() >= 2048 && (longer_filter.GetFFTSize() & (longer_filter.GetFFTSize() - 1)) == 0,
+          "power-of-two transform at least twice the taps");
+    check(longer_filter.GetGroupDelay() == 499.5, "group delay");
+    printf("\n");
+}
+
+// gain of the coefficients at frequency hz
+static double gain_at(const std::vector<double> &h, double hz, double rate)
+{
+    double re = 0.0, im = 0.0;
+    for (size_t k = 0; k < h.size(); k++)
+    {
+        re += h[k] * cos(2.0 * M_PI * hz / rate * k);
+        im -= h[k] * sin(2.0 * M_PI * hz / rate * k);
+    }
+    return sqrt(re * re + im * im);
+}
+
+void test_design()
+{
+    printf("=== Test 4: SignalDesignFIR() ===\n");
+
+    const double rate = 48000.0;
+    std::vector<double> h(201);
+    bool ok = SignalDesignFIR(0.0, 4000.0, rate, 201, h.data());
+    printf("Low-pass 4 kHz: %.4f at 1 kHz, %.1f dB at 8 kHz\n", gain_at(h, 1000.0, rate),
+           20.0 * log10(gain_at(h, 8000.0, rate)));
+    check(ok && fabs(gain_at(h, 0.0, rate) - 1.0) < 1e-12, "low-pass: unit gain at 0 Hz");
+    check(fabs(gain_at(h, 1000.0, rate) - 1.0) < 0.01 && gain_at(h, 8000.0, rate) < 0.003, "low-pass response");
+    bool symmetric = true;
+    for (int k = 0; k < 201; k++)
+        symmetric = symmetric && h[k] == h[200 - k];
+    check(symmetric, "linear phase");
+
+    ok = SignalDesignFIR(6000.0, 10000.0, rate, 201, h.data(), SIGNAL_WINDOW_BLACKMAN);
+    check(ok && fabs(gain_at(h, 8000.0, rate) - 1.0) < 1e-12 && gain_at(h, 2000.0, rate) < 0.001 &&
+              gain_at(h, 15000.0, rate) < 0.001,
+          "band-pass response");
+    ok = SignalDesignFIR(12000.0, rate / 2.0, rate, 201, h.data());
+    check(ok && fabs(gain_at(h, rate / 2.0, rate) - 1.0) < 1e-12 && gain_at(h, 6000.0, rate) < 0.003,
+          "high-pass response");
+
+    check(!SignalDesignFIR(12000.0, rate / 2.0, rate, 200, h.data()), "even high-pass rejected");
+    check(!SignalDesignFIR(5000.0, 4000.0, rate, 201, h.data()) && !SignalDesignFIR(0.0, rate, rate, 201, h.data()),
+          "invalid cutoffs rejected");
+
+    // a 1 kHz tone through the designed filter, 15 kHz removed
+    FIRFilterF filter(h.data(), 201);
+    SignalDesignFIR(0.0, 4000.0, rate, 201, h.data());
+    FIRFilterF lowpass(h.data(), 201);
+    std::vector<float> x(4800), y(4800);
+    for (int n = 0; n < 4800; n++)
+        x[n] = (float)(sin(2.0 * M_PI * 1000.0 * n / rate) + sin(2.0 * M_PI * 15000.0 * n / rate));
+    lowpass.Filter(x.data(), y.data(), 4800);
+    double worst = 0.0;
+    // compared with the 1 kHz tone delayed by the group delay
+    for (int n = 400; n < 4800; n++)
+        worst = fmax(worst, fabs(y[n] - sin(2.0 * M_PI * 1000.0 * (n - lowpass.GetGroupDelay()) / rate)));
+    check(filter.IsValid() && worst < 0.01, "15 kHz removed from a 1 kHz tone, delayed by GetGroupDelay()");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     FIR Filter Test Suite                  ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_against_reference();
+    test_streaming();
+    test_auto();
+    test_design();
+
+    if (failures == 0)
+        printf("All FIR filter tests passed.\n");
+    else
+        printf("%d FIR filter check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
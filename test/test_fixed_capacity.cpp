@@ -0,0 +1,155 @@
+/*
+ * Test file for SignalProcessingFixed
+ * Compile-time capacities: same results as the heap version, no heap allocation
+ */
+
+#define TEST_COUNT_HEAP_CALLS
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// compile-time sizes
+typedef SignalProcessingFixed<256> Tachometer;
+typedef SignalProcessingFixed<65536, float> Vibration;
+static_assert(Tachometer::FFT_SIZE == 256 && Tachometer::SPECTRUM_BINS == 129, "FFT size of a power of two");
+static_assert(SignalProcessingFixed<1000>::FFT_SIZE == 1000, "FFT at the natural length");
+static_assert(sizeof(Tachometer) < sizeof(Vibration) / 100, "memory follows the capacity");
+
+static double sample(int n, double frequency, double rate)
+{
+    double v = sin(2.0 * M_PI * frequency * n / rate);
+    if (n % 173 == 0)
+        v += 3.0;
+    return v;
+}
+
+template <typename S>
+static void feed(S &sp, int n, int offset, double frequency, double rate)
+{
+    for (int i = 0; i < n; i++)
+        sp.AddValue(sample(offset + i, frequency, rate));
+}
+
+// one iteration of a real-time analysis loop
+template <typename S, typename A>
+static double hot_path(S &sp, double rate, FrequencyBin *bins, int max_bins, A *out)
+{
+    double checksum = sp.GetMean() + sp.GetStandardDeviation() + sp.GetMax();
+    int indices[64];
+    checksum += sp.DetectAnomaliesIQR(1.5, indices, 64);
+    checksum += sp.DetectAnomaliesZScore(3.0, indices, 64);
+    checksum += sp.DetectPeaksWithDistance(10, indices, 64);
+    FrequencySpectrum spectrum;
+    if (sp.FFTAnalysis(rate, &spectrum, bins, max_bins))
+        checksum += spectrum.dominant_frequency;
+    MLFeatureVector features;
+    sp.ExtractMLFeatures(rate, &features);
+    checksum += features.spectral_centroid;
+    sp.WaveletDenoise(0.1, out, 3);
+    checksum += sp.Decimate(4, out, true);
+    return checksum;
+}
+
+void test_same_results()
+{
+    printf("=== Test 1: Same results as the heap ring buffer ===\n");
+
+    static SignalProcessingFixed<1000> fixed;
+    SignalProcessing heap(1000);
+    feed(fixed, 2500, 0, 50.0, 1000.0);
+    feed(heap, 2500, 0, 50.0, 1000.0);
+    check(fixed.GetIndex() == 1000 && fixed.GetValue(0) == heap.GetValue(0) &&
+          fixed.GetLastValue() == heap.GetLastValue(), "wraparound keeps the newest N samples");
+    check(fixed.GetMean() == heap.GetMean() && fixed.GetVariance() == heap.GetVariance() &&
+          fixed.GetMax() == heap.GetMax(), "statistics");
+
+    int a_f[64], a_h[64];
+    int n_f = fixed.DetectAnomaliesIQR(1.5, a_f, 64);
+    int n_h = heap.DetectAnomaliesIQR(1.5, a_h, 64);
+    check(n_f == n_h && n_f > 0 && a_f[0] == a_h[0], "IQR anomalies");
+
+    static FrequencyBin bins[SignalProcessingFixed<1000>::SPECTRUM_BINS];
+    FrequencySpectrum s_f, s_h;
+    bool ok = fixed.FFTAnalysis(1000.0, &s_f, bins, SignalProcessingFixed<1000>::SPECTRUM_BINS) &&
+              heap.FFTAnalysis(1000.0, &s_h);
+    printf("Dominant frequency: %.2f Hz\n", ok ? s_f.dominant_frequency : 0.0);
+    check(ok && s_f.dominant_frequency == s_h.dominant_frequency && s_f.total_power == s_h.total_power,
+          "FFT into bins sized at compile time");
+    if (ok)
+        heap.FreeSpectrum(&s_h);
+
+    struct timespec ts = {10, 0};
+    fixed.AddValueWithTimestamp(1.0, ts);
+    check(fixed.GetTimestamp(fixed.GetIndex() - 1).tv_sec == 10, "explicit timestamps");
+    check(!fixed.SetTimestampMode(TIMESTAMP_DELTA) && fixed.GetTimestampMode() == TIMESTAMP_EXPLICIT,
+          "TIMESTAMP_DELTA refused");
+    ok = fixed.SetTimestampMode(TIMESTAMP_UNIFORM);
+    ok = ok && fixed.SetTimestampMode(TIMESTAMP_EXPLICIT);
+    fixed.AddValueWithTimestamp(2.0, ts);
+    check(ok && fixed.GetIndex() == 1 && fixed.GetTimestamp(0).tv_sec == 10, "back to explicit timestamps");
+    printf("\n");
+}
+
+void test_no_heap()
+{
+    printf("=== Test 2: Two capacities in one binary, no heap ===\n");
+
+    static FrequencyBin tacho_bins[Tachometer::SPECTRUM_BINS];
+    static FrequencyBin vib_bins[Vibration::SPECTRUM_BINS];
+    static double tacho_out[256];
+    static float vib_out[65536];
+
+    // FFT plans and window tables are process-wide, built once per size at start-up
+    // (real-input spectra also use the half-size plan)
+    FFTPlan::Get(Tachometer::FFT_SIZE, 1);
+    FFTPlan::Get(Tachometer::FFT_SIZE / 2, 1);
+    FFTPlan::Get(Vibration::FFT_SIZE, 1);
+    FFTPlan::Get(Vibration::FFT_SIZE / 2, 1);
+    SignalWindow::Get(SIGNAL_WINDOW_HANN, Tachometer::FFT_SIZE);
+    SignalWindow::Get(SIGNAL_WINDOW_HANN, Vibration::FFT_SIZE);
+    // and the plans of the autocorrelation feature
+    FFTPlan::Get(Tachometer::CORRELATION_FFT_SIZE, 1);
+    FFTPlan::Get(Tachometer::CORRELATION_FFT_SIZE / 2, 1);
+    FFTPlan::Get(Vibration::CORRELATION_FFT_SIZE, 1);
+    FFTPlan::Get(Vibration::CORRELATION_FFT_SIZE / 2, 1);
+
+    long long before = HEAP_CALLS;
+    static Tachometer tacho;
+    static Vibration vibration;
+    feed(tacho, 600, 0, 30.0, 1000.0);
+    feed(vibration, 70000, 0, 1200.0, 25000.0);
+    double checksum = hot_path(tacho, 1000.0, tacho_bins, Tachometer::SPECTRUM_BINS, tacho_out);
+    checksum += hot_path(vibration, 25000.0, vib_bins, Vibration::SPECTRUM_BINS, vib_out);
+    long long calls = HEAP_CALLS - before;
+
+    printf("sizeof: %zu bytes (256 samples), %zu bytes (65536 float samples)\n", sizeof(tacho), sizeof(vibration));
+    printf("Heap calls for construction, ingest and analysis: %lld (checksum %.3f)\n", calls, checksum);
+    check(calls == 0, "no malloc/calloc/realloc");
+    check(tacho.GetWorkspace()->GetHeapAllocationCount() == 0 &&
+          vibration.GetWorkspace()->GetHeapAllocationCount() == 0 &&
+          vibration.GetWorkspace()->GetPeakUsage() <= Vibration::WORKSPACE_BYTES, "workspace sized from N");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Fixed Capacity Test Suite              ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_same_results();
+    test_no_heap();
+
+    if (failures == 0)
+        printf("All fixed capacity tests passed.\n");
+    else
+        printf("%d fixed capacity check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
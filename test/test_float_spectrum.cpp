@@ -0,0 +1,198 @@
+/*
+ * Test file for the single-precision spectrum path
+ * Checks FFTAnalysis() into FrequencySpectrumF against the double spectrum
+ * for every length class and window, caller bins and the cached spectrum,
+ * and the SignalBank float spectra
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double test_value(int n, int channel)
+{
+    return sin(2.0 * M_PI * 0.0517 * (channel + 1) * n) + 0.3 * cos(0.0021 * n * n) + ((n * 7919 + channel) % 13) * 0.01;
+}
+
+// largest magnitude difference relative to the largest magnitude
+static double spectrum_error(const FrequencySpectrum &reference, const FrequencySpectrumF &spectrum)
+{
+    double largest = 1e-30, difference = 0.0;
+    for (int k = 0; k < reference.num_bins; k++)
+    {
+        largest = fmax(largest, reference.bins[k].magnitude);
+        difference = fmax(difference, fabs(reference.bins[k].magnitude - spectrum.bins[k].magnitude));
+    }
+    return difference / largest;
+}
+
+// largest phase difference over the bins above 1e-3 of the largest magnitude
+static double phase_error(const FrequencySpectrum &reference, const FrequencySpectrumF &spectrum)
+{
+    double largest = 0.0, difference = 0.0;
+    for (int k = 0; k < reference.num_bins; k++)
+        largest = fmax(largest, reference.bins[k].magnitude);
+    for (int k = 0; k < reference.num_bins; k++)
+    {
+        if (reference.bins[k].magnitude < 1e-3 * largest)
+            continue;
+        double d = fabs(reference.bins[k].phase - spectrum.bins[k].phase);
+        difference = fmax(difference, fmin(d, 2.0 * M_PI - d));
+    }
+    return difference;
+}
+
+void test_against_double()
+{
+    printf("=== Test 1: Float spectra against double spectra ===\n");
+
+    const int sizes[6] = {2, 45, 64, 1000, 1009, 4096};
+    const int windows[4] = {SIGNAL_WINDOW_RECTANGULAR, SIGNAL_WINDOW_HANN, SIGNAL_WINDOW_FLATTOP, SIGNAL_WINDOW_KAISER};
+    double worst = 0.0, worst_phase = 0.0;
+    bool same_layout = true, same_peak = true;
+    for (int s = 0; s < 6; s++)
+        for (int w = 0; w < 4; w++)
+        {
+            SignalProcessing sp(sizes[s] + 1);
+            for (int n = 0; n <= sizes[s]; n++)
+                sp.AddValue(test_value(n, w));
+            sp.SetSpectrumWindow(windows[w]);
+            // from index 1: not the cached whole window
+            FrequencySpectrum reference;
+            FrequencySpectrumF spectrum;
+            if (!sp.FFTAnalysis(1, sizes[s], 1000.0, &reference) || !sp.FFTAnalysis(1, sizes[s], 1000.0, &spectrum))
+            {
+                worst = 1.0;
+                continue;
+            }
+            worst = fmax(worst, spectrum_error(reference, spectrum));
+            worst_phase = fmax(worst_phase, phase_error(reference, spectrum));
+            same_layout = same_layout && spectrum.num_bins == reference.num_bins &&
+                          spectrum.window_size == reference.window_size &&
+                          spectrum.frequency_resolution == reference.frequency_resolution &&
+                          spectrum.bins[spectrum.num_bins - 1].frequency ==
+                              (float)reference.bins[reference.num_bins - 1].frequency;
+            same_peak = same_peak && (sizes[s] < 64 || spectrum.dominant_frequency == reference.dominant_frequency);
+            same_peak = same_peak && fabs(spectrum.total_power - reference.total_power) <= 1e-5 * reference.total_power;
+            sp.FreeSpectrum(&reference);
+            sp.FreeSpectrum(&spectrum);
+        }
+    printf("Worst relative magnitude difference: %.2e, phase difference %.2e rad\n", worst, worst_phase);
+    check(worst < 1e-5, "magnitudes within 1e-5 of the largest one");
+    check(worst_phase < 1e-4, "phases within 1e-4 rad");
+    check(same_layout, "same bins, resolution and window size");
+    check(same_peak, "same dominant frequency and total power");
+
+    // float samples: the float path is the float buffer's own arithmetic
+    SignalProcessingF sf(2048);
+    for (int n = 0; n < 2048; n++)
+        sf.AddValue((float)test_value(n, 3));
+    FrequencySpectrum reference;
+    FrequencySpectrumF spectrum;
+    bool ok = sf.FFTAnalysis(1, 2047, 48000.0, &reference) && sf.FFTAnalysis(1, 2047, 48000.0, &spectrum);
+    check(ok && spectrum_error(reference, spectrum) < 1e-6, "float buffer: same transform in both types");
+    sf.FreeSpectrum(&reference);
+    sf.FreeSpectrum(&spectrum);
+    check(sizeof(FrequencyBinF) * 2 == sizeof(FrequencyBin), "half the memory per bin");
+    printf("\n");
+}
+
+void test_caller_bins_and_cache()
+{
+    printf("=== Test 2: Caller bins and the cached spectrum ===\n");
+
+    SignalProcessing sp(1000);
+    for (int n = 0; n < 1000; n++)
+        sp.AddValue(test_value(n, 1));
+
+    // computed in float when no double spectrum is cached
+    static FrequencyBinF bins[501];
+    FrequencySpectrumF spectrum;
+    check(!sp.FFTAnalysis(1000.0, &spectrum, bins, 500), "too few bins rejected");
+    check(sp.FFTAnalysis(1000.0, &spectrum, bins, 501) && spectrum.bins == bins && spectrum.num_bins == 501,
+          "caller bins");
+
+    // converted from the double spectrum when it is cached
+    FrequencySpectrum reference;
+    sp.FFTAnalysis(1000.0, &reference);
+    FrequencySpectrumF converted;
+    bool ok = sp.FFTAnalysis(1000.0, &converted);
+    bool exact = ok;
+    for (int k = 0; exact && k < 501; k++)
+        exact = converted.bins[k].magnitude == (float)reference.bins[k].magnitude &&
+                converted.bins[k].phase == (float)reference.bins[k].phase;
+    check(exact && converted.dominant_frequency == reference.dominant_frequency, "cached double spectrum converted");
+    sp.FreeSpectrum(&reference);
+    sp.FreeSpectrum(&converted);
+    check(converted.bins == nullptr && converted.num_bins == 0, "FreeSpectrum() clears the bins");
+
+    // fixed capacity: workspace sized for the double path holds the float one
+    static SignalProcessingFixed<1000> fixed;
+    for (int n = 0; n < 1000; n++)
+        fixed.AddValue(test_value(n, 1));
+    FrequencySpectrumF fixed_spectrum;
+    ok = fixed.FFTAnalysis(1000.0, &fixed_spectrum, bins, SignalProcessingFixed<1000>::SPECTRUM_BINS);
+    check(ok && fixed_spectrum.dominant_frequency == spectrum.dominant_frequency, "SignalProcessingFixed");
+    printf("\n");
+}
+
+void test_signal_bank()
+{
+    printf("=== Test 3: SignalBank float spectra ===\n");
+
+    const int channels = 21;
+    SignalBankI16 bank(channels, 4096);
+    std::vector<int16_t> frame(channels);
+    for (int n = 0; n < 3000; n++)
+    {
+        for (int c = 0; c < channels; c++)
+            frame[c] = (int16_t)(8000.0 * test_value(n, c));
+        bank.AddFrame(frame.data());
+    }
+    bank.SetAnalysisWindow(2000);
+
+    std::vector<FrequencySpectrumF> spectra(channels);
+    bool ok = bank.FFTAnalysis(25000.0, spectra.data());
+    double worst = 0.0;
+    for (int c = 0; ok && c < channels; c++)
+    {
+        FrequencySpectrum single;
+        if (!bank.Channel(c).FFTAnalysis(25000.0, &single))
+        {
+            worst = 1.0;
+            continue;
+        }
+        worst = fmax(worst, spectrum_error(single, spectra[c]));
+        bank.Channel(c).FreeSpectrum(&single);
+    }
+    printf("%d channels of 2000 samples: worst relative difference %.2e\n", channels, worst);
+    check(ok && spectra[0].num_bins == 1001 && worst < 1e-5, "same spectra as FFTAnalysis() per channel");
+    bank.FreeSpectra(spectra.data());
+    check(spectra[channels - 1].bins == nullptr, "FreeSpectra() releases the float bins");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Float Spectrum Test Suite              ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_against_double();
+    test_caller_bins_and_cache();
+    test_signal_bank();
+
+    if (failures == 0)
+        printf("All float spectrum tests passed.\n");
+    else
+        printf("%d float spectrum check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
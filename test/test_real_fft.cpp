@@ -0,0 +1,139 @@
+/*
+ * Test file for the real-input FFT
+ * Compares FFTPlan::ExecuteReal with a complex transform of the same samples
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double sample(int n)
+{
+    return sin(n * 0.013) + 0.5 * cos(n * 0.71) + 0.01 * (n % 17);
+}
+
+// largest difference between the real path and the complex transform, relative to the largest bin
+template <typename F>
+static double real_vs_complex(int size, int direction, bool in_place)
+{
+    F *input = (F *)malloc(size * sizeof(F));
+    F *real = (F *)malloc((size + 2) * sizeof(F));
+    F *imag = (F *)malloc((size / 2 + 1) * sizeof(F));
+    F *c_real = (F *)malloc(size * sizeof(F));
+    F *c_imag = (F *)malloc(size * sizeof(F));
+    for (int i = 0; i < size; i++)
+    {
+        input[i] = (F)sample(i);
+        real[i] = input[i];
+        c_real[i] = input[i];
+        c_imag[i] = 0;
+    }
+    FFTPlan::Get(size, direction)->Execute(c_real, c_imag);
+    FFTPlan::Get(size, direction)->ExecuteReal(in_place ? real : input, real, imag);
+    double error = 0.0;
+    double largest = 0.0;
+    for (int k = 0; k <= size / 2; k++)
+    {
+        error = fmax(error, fabs(real[k] - c_real[k]) + fabs(imag[k] - c_imag[k]));
+        largest = fmax(largest, fabs(c_real[k]) + fabs(c_imag[k]));
+    }
+    free(input);
+    free(real);
+    free(imag);
+    free(c_real);
+    free(c_imag);
+    return error / largest;
+}
+
+void test_same_bins()
+{
+    printf("=== Test 1: Same bins as the complex transform ===\n");
+
+    bool ok = true;
+    double worst = 0.0;
+    for (int size = 2; size <= (1 << 16); size *= 2)
+    {
+        double e = real_vs_complex<double>(size, 1, false);
+        worst = fmax(worst, e);
+        ok = ok && e < 1e-13;
+    }
+    printf("Worst relative difference, sizes 2 to 65536: %.2e\n", worst);
+    check(ok, "forward, double");
+    check(real_vs_complex<double>(4096, 1, true) < 1e-13, "in place (input == real)");
+    check(real_vs_complex<double>(1024, -1, false) < 1e-13, "inverse direction, normalized by 1/size");
+    double e = real_vs_complex<float>(8192, 1, false);
+    printf("float, 8192 points: %.2e\n", e);
+    check(e < 1e-5, "forward, float");
+    printf("\n");
+}
+
+void test_analysis()
+{
+    printf("=== Test 2: Spectra of the analysis methods ===\n");
+
+    const double rate = 10000.0;
+    SignalProcessing sp(5000);
+    for (int i = 0; i < 5000; i++)
+        sp.AddValue(sin(2.0 * M_PI * 1234.0 * i / rate) + 0.25 * sin(2.0 * M_PI * 310.0 * i / rate));
+
+    FrequencySpectrum spectrum;
+    static FrequencyBin bins[2501];
+    bool ok = sp.FFTAnalysis(rate, &spectrum, bins, 2501);
+    printf("Dominant frequency: %.2f Hz, total power %.3f\n", ok ? spectrum.dominant_frequency : 0.0,
+           ok ? spectrum.total_power : 0.0);
+    check(ok && fabs(spectrum.dominant_frequency - 1234.0) < 1.5, "FFTAnalysis");
+
+    // reference: Hann window and complex transform of the same samples
+    static double real[5000], imag[5000];
+    for (int i = 0; i < 5000; i++)
+    {
+        real[i] = sp.GetValue(i) * 0.5 * (1.0 - cos(2.0 * M_PI * i / 4999));
+        imag[i] = 0.0;
+    }
+    FFTPlan::Get(5000, 1)->Execute(real, imag);
+    double power = 0.0;
+    double phase_error = 0.0;
+    for (int k = 0; k <= 2500; k++)
+    {
+        power += real[k] * real[k] + imag[k] * imag[k];
+        if (hypot(real[k], imag[k]) > 100.0)
+            phase_error = fmax(phase_error, fabs(atan2(imag[k], real[k]) - bins[k].phase));
+    }
+    check(ok && fabs(power - spectrum.total_power) < 1e-9 * power && phase_error < 1e-9,
+          "same power and phases as the complex transform");
+
+    MLFeatureVector features;
+    sp.ExtractMLFeatures(rate, &features);
+    check(fabs(features.dominant_frequency - 1234.0) < 1.5, "ExtractMLFeatures");
+
+    int markers[3] = {0, 2000, 4000};
+    FrequencySpectrum segments[3];
+    int n = sp.CompareSegmentSpectra(markers, 3, rate, segments);
+    check(n == 3 && fabs(segments[1].dominant_frequency - 1234.0) < 12.0, "CompareSegmentSpectra");
+    for (int i = 0; i < n; i++)
+        sp.FreeSpectrum(&segments[i]);
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Real-Input FFT Test Suite              ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_same_bins();
+    test_analysis();
+
+    if (failures == 0)
+        printf("All real-input FFT tests passed.\n");
+    else
+        printf("%d real-input FFT check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
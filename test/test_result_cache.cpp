@@ -0,0 +1,198 @@
+/*
+ * Test file for the result cache
+ * Derived results are computed once per generation of the analysis window
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double sample(int n)
+{
+    double v = sin(2.0 * M_PI * 60.0 * n / 1000.0) + 0.2 * sin(2.0 * M_PI * 180.0 * n / 1000.0);
+    if (n % 211 == 7)
+        v += 2.5;
+    return v;
+}
+
+static void fill(SignalProcessing &sp, int n, int offset)
+{
+    for (int i = 0; i < n; i++)
+        sp.AddValue(sample(offset + i));
+}
+
+// results of a fresh object holding the same window
+static bool same_as_fresh(SignalProcessing &sp)
+{
+    int n = sp.GetAnalysisWindow();
+    double *values = (double *)malloc(n * sizeof(double));
+    sp.GetVector(values);
+    SignalProcessing fresh(n);
+    fresh.AddValues(values, n);
+    free(values);
+
+    MLFeatureVector f_c, f_f;
+    sp.ExtractMLFeatures(1000.0, &f_c);
+    fresh.ExtractMLFeatures(1000.0, &f_f);
+    int a_c[64], a_f[64];
+    int n_c = sp.DetectAnomaliesIQR(1.5, a_c, 64);
+    int n_f = fresh.DetectAnomaliesIQR(1.5, a_f, 64);
+    return f_c.spectral_centroid == f_f.spectral_centroid && f_c.dominant_frequency == f_f.dominant_frequency &&
+           f_c.rms == f_f.rms && n_c == n_f && (n_c == 0 || a_c[n_c - 1] == a_f[n_f - 1]) &&
+           sp.CalculateAnomalyScore(1) == fresh.CalculateAnomalyScore(1) &&
+           sp.EstimateNoiseLevel() == fresh.EstimateNoiseLevel();
+}
+
+void test_generation()
+{
+    printf("=== Test 1: Generation counter ===\n");
+
+    SignalProcessing sp(4096);
+    long long g = sp.GetGeneration();
+    sp.AddValue(1.0);
+    check(sp.GetGeneration() > g, "AddValue");
+    g = sp.GetGeneration();
+    double block[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    sp.AddValues(block, 8);
+    check(sp.GetGeneration() > g, "AddValues");
+    g = sp.GetGeneration();
+    sp.MultiplyWithValue(2.0, 9);
+    check(sp.GetGeneration() > g, "MultiplyWithValue");
+    g = sp.GetGeneration();
+    sp.NormalizeVector();
+    check(sp.GetGeneration() > g, "NormalizeVector");
+    g = sp.GetGeneration();
+    sp.SetAnalysisWindow(4);
+    check(sp.GetGeneration() > g, "SetAnalysisWindow");
+    g = sp.GetGeneration();
+    sp.GetMean();
+    MLFeatureVector features;
+    sp.ExtractMLFeatures(1000.0, &features);
+    check(sp.GetGeneration() == g, "queries leave the generation unchanged");
+    sp.ClearVector();
+    check(sp.GetGeneration() > g, "ClearVector");
+    printf("\n");
+}
+
+void test_invalidation()
+{
+    printf("=== Test 2: Cached results follow the data ===\n");
+
+    SignalProcessing sp(2000);
+    fill(sp, 2000, 0);
+    check(same_as_fresh(sp), "initial window");
+    check(same_as_fresh(sp), "repeated queries");
+    fill(sp, 37, 2000);
+    check(same_as_fresh(sp), "after AddValue");
+    sp.MultiplyWithValue(3.0, 2000);
+    check(same_as_fresh(sp), "after MultiplyWithValue");
+    sp.NormalizeVector();
+    check(same_as_fresh(sp), "after NormalizeVector");
+    sp.SetAnalysisWindow(700);
+    check(same_as_fresh(sp), "after SetAnalysisWindow");
+
+    FrequencySpectrum s1, s2;
+    static FrequencyBin bins[1025];
+    bool ok = sp.FFTAnalysis(1000.0, &s1, bins, 1025);
+    bins[5].magnitude = -1.0;   // caller copies are independent of the cache
+    ok = ok && sp.FFTAnalysis(1000.0, &s2);
+    check(ok && s2.bins != bins && s2.bins[5].magnitude >= 0.0 && s2.dominant_frequency == s1.dominant_frequency,
+          "spectrum copies");
+    if (ok)
+        sp.FreeSpectrum(&s2);
+    ok = sp.FFTAnalysis(500.0, &s2, bins, 1025);
+    check(ok && s2.dominant_frequency == s1.dominant_frequency / 2.0, "sampling rate is part of the key");
+    printf("\n");
+}
+
+void test_views()
+{
+    printf("=== Test 3: Views are not cached ===\n");
+
+    static double data[1024];
+    for (int i = 0; i < 1024; i++)
+        data[i] = sample(i);
+    SignalView view(data, 1024);
+    FrequencySpectrum before, after;
+    static FrequencyBin bins[513];
+    view.FFTAnalysis(1000.0, &before, bins, 513);
+    double dominant = before.dominant_frequency;
+    for (int i = 0; i < 1024; i++)
+        data[i] = sin(2.0 * M_PI * 250.0 * i / 1000.0);
+    view.FFTAnalysis(1000.0, &after, bins, 513);
+    printf("Dominant frequency: %.1f Hz, then %.1f Hz\n", dominant, after.dominant_frequency);
+    check(fabs(dominant - 60.0) < 1.0 && fabs(after.dominant_frequency - 250.0) < 1.0,
+          "view sees the external buffer change");
+    printf("\n");
+}
+
+void test_control_cycle()
+{
+    printf("=== Test 4: Queries of one control cycle (8192 samples) ===\n");
+
+    SignalProcessing sp(8192);
+    fill(sp, 8192, 0);
+    static FrequencyBin bins[4097];
+    const int cycles = 5;
+    bool computed = true, reused = true, same = true;
+    long long per_cycle = 0;
+
+    for (int c = 0; c < cycles; c++)
+    {
+        sp.AddValue(sample(8192 + c));
+        long long before = sp.GetResultComputations();
+        double first = 0.0;
+        for (int q = 0; q < 5; q++)
+        {
+            MLFeatureVector features;
+            FrequencySpectrum spectrum;
+            sp.ExtractMLFeatures(1000.0, &features);
+            sp.FFTAnalysis(1000.0, &spectrum, bins, 4097);
+            double result = features.spectral_centroid + spectrum.dominant_frequency + sp.CalculateAnomalyScore(1) +
+                            sp.GetMean() + sp.GetStandardDeviation();
+            if (q == 0)
+            {
+                per_cycle = sp.GetResultComputations() - before;
+                computed = computed && per_cycle > 0;
+                before = sp.GetResultComputations();
+                first = result;
+            }
+            else
+            {
+                reused = reused && sp.GetResultComputations() == before;
+                same = same && result == first;
+            }
+        }
+    }
+
+    printf("Results computed by the first round of a cycle: %lld\n", per_cycle);
+    check(computed, "first round of a cycle computes the results");
+    check(reused, "repeated rounds return the stored results");
+    check(same, "stored results equal the first round");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Result Cache Test Suite                ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_generation();
+    test_invalidation();
+    test_views();
+    test_control_cycle();
+
+    if (failures == 0)
+        printf("All result cache tests passed.\n");
+    else
+        printf("%d result cache check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/*
+ * Test file for the runtime-sized ring buffer
+ * Tests capacity selection, wraparound, analysis windows, timestamps and
+ * failed allocations
+ */
+
+#define TEST_COUNT_HEAP_CALLS
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void test_capacity()
+{
+    printf("=== Test 1: Capacity chosen at construction ===\n");
+
+    SignalProcessing sp_default;
+    SignalProcessing sp_large(65536);
+
+    printf("Default capacity: %d\n", sp_default.GetMaxCapacity());
+    printf("Large capacity: %d\n", sp_large.GetMaxCapacity());
+    check(sp_default.GetMaxCapacity() == NB_MAX_VALUES, "default capacity is NB_MAX_VALUES");
+    check(sp_large.GetMaxCapacity() == 65536, "capacity of 65536 samples");
+
+    for (int i = 0; i < 65536; i++)
+        sp_large.AddValue((double)i);
+    check(sp_large.GetIndex() == 65536, "65536 samples stored");
+    check(sp_large.GetValue(0) == 0.0 && sp_large.GetValue(65535) == 65535.0, "first and last sample kept");
+    check(sp_default.IsValid() && sp_large.IsValid(), "buffers allocated");
+    printf("\n");
+}
+
+void test_wraparound()
+{
+    printf("=== Test 2: Wraparound keeps the newest samples ===\n");
+
+    SignalProcessing sp(8);
+    for (int i = 1; i <= 20; i++)
+        sp.AddValue((double)i);
+
+    double values[8];
+    sp.GetVector(values);
+    printf("Buffer after 20 values (capacity 8): ");
+    for (int i = 0; i < sp.GetIndex(); i++)
+        printf("%.0f ", values[i]);
+    printf("\n");
+
+    bool ordered = true;
+    for (int i = 0; i < 8; i++)
+        ordered = ordered && (values[i] == 13.0 + i);
+    check(sp.GetIndex() == 8, "stored count saturates at capacity");
+    check(sp.GetTotalCount() == 20, "total count keeps growing");
+    check(ordered, "values ordered oldest to newest (13..20)");
+    check(sp.GetLastValue() == 20.0, "last value is the newest sample");
+    check(fabs(sp.GetMean() - 16.5) < 1e-12, "mean computed over the stored samples");
+
+    sp.MultiplyWithValue(2.0, 8);
+    check(sp.GetValue(0) == 26.0 && sp.GetLastValue() == 40.0, "in-place operations follow the wraparound");
+
+    sp.ClearVector();
+    check(sp.GetIndex() == 0 && sp.GetTotalCount() == 0, "ClearVector resets the ring buffer");
+    printf("\n");
+}
+
+void test_analysis_window()
+{
+    printf("=== Test 3: Analysis on the last N samples ===\n");
+
+    double sampling_rate = 1000.0;
+    SignalProcessing sp(4096);
+
+    // 3000 samples of 50 Hz followed by 1024 samples of 200 Hz
+    for (int i = 0; i < 3000; i++)
+        sp.AddValue(sin(2.0 * M_PI * 50.0 * i / sampling_rate));
+    for (int i = 0; i < 1024; i++)
+        sp.AddValue(sin(2.0 * M_PI * 200.0 * i / sampling_rate));
+
+    sp.SetAnalysisWindow(1024);
+    printf("Analysis window: %d of %d samples\n", sp.GetAnalysisWindow(), sp.GetIndex());
+    check(sp.GetAnalysisWindow() == 1024, "analysis window of 1024 samples");
+
+    FrequencySpectrum spectrum;
+    bool ok = sp.FFTAnalysis(0, 1024, sampling_rate, &spectrum);
+    printf("Dominant frequency of the window: %.2f Hz\n", spectrum.dominant_frequency);
+    check(ok && fabs(spectrum.dominant_frequency - 200.0) < 2.0, "FFT sees only the newest 200 Hz block");
+    if (ok)
+        sp.FreeSpectrum(&spectrum);
+
+    int peaks[256];
+    int num_peaks = sp.DetectPeaksWithThreshold(0.5, peaks, 256);
+    printf("Peaks in window: %d\n", num_peaks);
+    check(num_peaks >= 200 && num_peaks <= 206, "peak detection restricted to the window");
+
+    sp.SetAnalysisWindow(0);
+    check(sp.GetAnalysisWindow() == 4024, "window reset to all stored samples");
+    printf("\n");
+}
+
+void test_timestamps()
+{
+    printf("=== Test 4: Timestamps follow the ring buffer ===\n");
+
+    SignalProcessing sp(4);
+    for (int i = 0; i < 6; i++)
+    {
+        struct timespec ts;
+        ts.tv_sec = 100 + i;
+        ts.tv_nsec = i * 1000;
+        sp.AddValueWithTimestamp((double)i, ts);
+    }
+
+    struct timespec first = sp.GetTimestamp(0);
+    struct timespec last = sp.GetTimestamp(sp.GetIndex() - 1);
+    printf("Oldest timestamp: %ld.%09ld, newest: %ld.%09ld\n",
+           (long)first.tv_sec, first.tv_nsec, (long)last.tv_sec, last.tv_nsec);
+    check(first.tv_sec == 102 && last.tv_sec == 105, "timestamps of the oldest and newest samples");
+
+    sp.SetAnalysisWindow(2);
+    check(sp.GetTimestamp(0).tv_sec == 104 && sp.GetValue(0) == 4.0, "timestamps are window relative");
+    printf("\n");
+}
+
+#if CALLOC_CAN_FAIL
+void test_allocation_failure()
+{
+    printf("=== Test 5: Failed ring buffer allocation ===\n");
+
+    // the ring buffer and timestamps are the only calloc() of the constructor
+    fail_calloc = true;
+    SignalProcessing sp(4096);
+    fail_calloc = false;
+
+    double block[4] = {1.0, 2.0, 3.0, 4.0};
+    sp.AddValue(5.0);
+    sp.AddValues(block, 4);
+    printf("Capacity after the failed allocation: %d\n", sp.GetMaxCapacity());
+    check(!sp.IsValid(), "IsValid() reports the failure");
+    check(sp.GetMaxCapacity() == 0, "capacity 0");
+    check(sp.GetIndex() == 0 && sp.GetTotalCount() == 0, "AddValue and AddValues ignored");
+    check(sp.GetMean() == 0.0, "GetMean of the empty object");
+    printf("\n");
+}
+#endif
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Ring Buffer Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_capacity();
+    test_wraparound();
+    test_analysis_window();
+    test_timestamps();
+#if CALLOC_CAN_FAIL
+    test_allocation_failure();
+#endif
+
+    if (failures == 0)
+        printf("All ring buffer tests passed.\n");
+    else
+        printf("%d ring buffer check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
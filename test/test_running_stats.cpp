@@ -0,0 +1,169 @@
+/*
+ * Test file for the running statistics
+ * Compares the O(1) mean, variance, min and max with a rescan of the window
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// two-pass reference over the analysis window
+static void reference_stats(SignalProcessing &sp, double *mean, double *variance, double *min, double *max)
+{
+    int n = sp.GetAnalysisWindow();
+    double *values = (double *)malloc((n > 0 ? n : 1) * sizeof(double));
+    sp.GetVector(values);
+    double sum = 0.0;
+    *min = values[0];
+    *max = values[0];
+    for (int i = 0; i < n; i++)
+    {
+        sum += values[i];
+        *min = fmin(*min, values[i]);
+        *max = fmax(*max, values[i]);
+    }
+    *mean = sum / n;
+    double sq = 0.0;
+    for (int i = 0; i < n; i++)
+        sq += (values[i] - *mean) * (values[i] - *mean);
+    *variance = sq / n;
+    free(values);
+}
+
+static bool matches(SignalProcessing &sp)
+{
+    double mean, variance, min, max;
+    reference_stats(sp, &mean, &variance, &min, &max);
+    return fabs(sp.GetMean() - mean) <= 1e-9 * fabs(mean) + 1e-12 &&
+           fabs(sp.GetVariance() - variance) <= 1e-6 * variance + 1e-12 &&
+           sp.GetMin() == min && sp.GetMax() == max;
+}
+
+// slow sensor drift around a large offset, with noise and rare spikes
+static double sensor_sample(long long n)
+{
+    double v = 1.0e6 + 50.0 * sin(n * 1e-4) + (rand() % 1000) * 1e-3;
+    if (n % 7919 == 0)
+        v += 25.0;
+    return v;
+}
+
+void test_wraparound()
+{
+    printf("=== Test 1: Running statistics through wraparound ===\n");
+
+    srand(1);
+    SignalProcessing sp(1000);
+    bool ok = true;
+    long long n = 0;
+    double block[300];
+    for (int round = 0; round < 2000; round++)
+    {
+        // mix single samples and blocks of different sizes
+        for (int i = 0; i < 37; i++)
+            sp.AddValue(sensor_sample(n++));
+        int size = 1 + (round * 53) % 300;
+        for (int i = 0; i < size; i++)
+            block[i] = sensor_sample(n++);
+        sp.AddValues(block, size);
+        if (round % 100 == 99)
+            ok = ok && matches(sp);
+    }
+    printf("%lld samples, mean %.6f, std %.6f\n", n, sp.GetMean(), sp.GetStandardDeviation());
+    check(ok, "mean, variance, min and max match a rescan");
+
+    sp.SetAnalysisWindow(100);
+    ok = matches(sp);
+    for (int i = 0; i < 5000; i++)
+    {
+        sp.AddValue(sensor_sample(n++));
+        if (i % 250 == 0)
+            ok = ok && matches(sp);
+    }
+    check(ok, "statistics of the analysis window");
+    printf("\n");
+}
+
+void test_extrema()
+{
+    printf("=== Test 2: Extrema leaving the window ===\n");
+
+    SignalProcessing sp(10);
+    for (int i = 0; i < 10; i++)
+        sp.AddValue(i == 3 ? 100.0 : 1.0);
+    check(sp.GetMax() == 100.0 && sp.GetMin() == 1.0, "spike is the maximum");
+    for (int i = 0; i < 4; i++)
+        sp.AddValue(2.0);
+    check(sp.GetMax() == 2.0 && sp.GetMin() == 1.0, "maximum updated when the spike leaves");
+    for (int i = 0; i < 6; i++)
+        sp.AddValue(2.0);
+    check(sp.GetMin() == 2.0 && sp.GetVariance() == 0.0 && sp.GetMean() == 2.0, "constant window");
+
+    sp.MultiplyWithValue(3.0, 10);
+    check(sp.GetMean() == 6.0 && sp.GetMax() == 6.0, "in-place operations update the statistics");
+    sp.ClearVector();
+    check(sp.GetMean() == 0.0 && sp.GetMin() == 0.0, "empty vector");
+    printf("\n");
+}
+
+void test_float_samples()
+{
+    printf("=== Test 3: Long float stream ===\n");
+
+    SignalProcessingF sp_f(4096);
+    SignalProcessing sp_d(4096);
+    for (int i = 0; i < 2000000; i++)
+    {
+        float v = 1000.0f + (float)((i * 7) % 13);
+        sp_f.AddValue(v);
+        sp_d.AddValue(v);
+    }
+    printf("Mean: float samples %.9f, double samples %.9f\n", sp_f.GetMean(), sp_d.GetMean());
+    check(sp_f.GetMean() == sp_d.GetMean() && sp_f.GetVariance() == sp_d.GetVariance(),
+          "float storage keeps double statistics");
+    printf("\n");
+}
+
+void test_long_run()
+{
+    printf("=== Test 4: 20000 more samples in a 65536-sample window ===\n");
+
+    const int capacity = 65536;
+    const int samples = 20000;
+    SignalProcessing sp(capacity);
+    for (int i = 0; i < capacity; i++)
+        sp.AddValue(sin(i * 0.01));
+
+    // a read after every sample, as a control loop does
+    double sink = 0.0;
+    for (int i = 0; i < samples; i++)
+    {
+        sp.AddValue(sin(i * 0.01));
+        sink += sp.GetMean() + sp.GetStandardDeviation();
+    }
+
+    printf("Checksum of the reads: %.3f\n", sink);
+    check(matches(sp), "statistics still match after one read per sample");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Running Statistics Test Suite          ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_wraparound();
+    test_extrema();
+    test_float_samples();
+    test_long_run();
+
+    if (failures == 0)
+        printf("All running statistics tests passed.\n");
+    else
+        printf("%d running statistics check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/*
+ * Test file for the templated sample types
+ * Compares float and int16 pipelines with the double reference
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// 16-bit ADC reading of a 50 Hz tone plus a 120 Hz harmonic sampled at 1 kHz
+static int16_t adc_sample(int n)
+{
+    double t = n / 1000.0;
+    double v = 12000.0 * sin(2.0 * M_PI * 50.0 * t) + 3000.0 * sin(2.0 * M_PI * 120.0 * t) + 500.0;
+    return (int16_t)lrint(v);
+}
+
+void test_statistics()
+{
+    printf("=== Test 1: Statistics on double, float and int16 storage ===\n");
+
+    const int n = 4096;
+    SignalProcessing sp_d(n);
+    SignalProcessingF sp_f(n);
+    SignalProcessingI16 sp_i(n);
+    for (int i = 0; i < n; i++)
+    {
+        int16_t v = adc_sample(i);
+        sp_d.AddValue((double)v);
+        sp_f.AddValue((float)v);
+        sp_i.AddValue(v);
+    }
+
+    printf("Mean:     double %.4f, float %.4f, int16 %.4f\n", sp_d.GetMean(), sp_f.GetMean(), sp_i.GetMean());
+    printf("Std dev:  double %.4f, float %.4f, int16 %.4f\n",
+           sp_d.GetStandardDeviation(), sp_f.GetStandardDeviation(), sp_i.GetStandardDeviation());
+    check(fabs(sp_f.GetMean() - sp_d.GetMean()) < 0.05 && fabs(sp_i.GetMean() - sp_d.GetMean()) < 0.05,
+          "mean matches the double reference");
+    check(fabs(sp_f.GetStandardDeviation() / sp_d.GetStandardDeviation() - 1.0) < 1e-5 &&
+          fabs(sp_i.GetStandardDeviation() / sp_d.GetStandardDeviation() - 1.0) < 1e-5,
+          "standard deviation matches the double reference");
+    check(sp_i.GetValue(10) == adc_sample(10) && sp_i.GetLastValue() == adc_sample(n - 1),
+          "int16 samples stored unchanged");
+
+    SignalProcessingT<int16_t, double> sp_id(n);
+    for (int i = 0; i < n; i++)
+        sp_id.AddValue(adc_sample(i));
+    check(sp_id.GetMean() == sp_d.GetMean(), "int16 samples with a double accumulator");
+    printf("\n");
+}
+
+void test_filters()
+{
+    printf("=== Test 2: Filters write accumulator-typed outputs ===\n");
+
+    const int n = 2048;
+    SignalProcessing sp_d(n);
+    SignalProcessingI16 sp_i(n);
+    for (int i = 0; i < n; i++)
+    {
+        sp_d.AddValue((double)adc_sample(i));
+        sp_i.AddValue(adc_sample(i));
+    }
+
+    static double out_d[2048];
+    static float out_f[2048];
+    double worst;
+
+    sp_d.GetMovingAverageVector(out_d, 16);
+    sp_i.GetMovingAverageVector(out_f, 16);
+    worst = 0.0;
+    for (int i = 0; i < n; i++)
+        worst = fmax(worst, fabs(out_f[i] - out_d[i]));
+    printf("Moving average max difference: %.6f\n", worst);
+    check(worst < 0.01, "moving average");
+
+    sp_d.ExponentialSmoothing(0.2, out_d);
+    sp_i.ExponentialSmoothing(0.2, out_f);
+    worst = 0.0;
+    for (int i = 0; i < n; i++)
+        worst = fmax(worst, fabs(out_f[i] - out_d[i]));
+    printf("Exponential smoothing max difference: %.6f\n", worst);
+    check(worst < 0.05, "exponential smoothing");
+
+    sp_d.KalmanFilter(1.0, 100.0, out_d);
+    sp_i.KalmanFilter(1.0, 100.0, out_f);
+    worst = 0.0;
+    for (int i = 0; i < n; i++)
+        worst = fmax(worst, fabs(out_f[i] - out_d[i]));
+    printf("Kalman filter max difference: %.6f\n", worst);
+    check(worst < 0.05, "Kalman filter");
+
+    sp_d.MedianFilter(5, out_d);
+    sp_i.MedianFilter(5, out_f);
+    bool same = true;
+    for (int i = 0; i < n; i++)
+        same = same && (out_f[i] == (float)out_d[i]);
+    check(same, "median filter");
+    printf("\n");
+}
+
+void test_fft()
+{
+    printf("=== Test 3: FFT on float and int16 storage ===\n");
+
+    const int n = 1024;
+    SignalProcessing sp_d(n);
+    SignalProcessingF sp_f(n);
+    SignalProcessingI16 sp_i(n);
+    for (int i = 0; i < n; i++)
+    {
+        sp_d.AddValue((double)adc_sample(i));
+        sp_f.AddValue((float)adc_sample(i));
+        sp_i.AddValue(adc_sample(i));
+    }
+
+    FrequencySpectrum s_d, s_f, s_i;
+    bool ok = sp_d.FFTAnalysis(1000.0, &s_d);
+    ok = sp_f.FFTAnalysis(1000.0, &s_f) && ok;
+    ok = sp_i.FFTAnalysis(1000.0, &s_i) && ok;
+    check(ok, "FFT analysis succeeded");
+    if (!ok)
+        return;
+
+    printf("Dominant frequency: double %.2f Hz, float %.2f Hz, int16 %.2f Hz\n",
+           s_d.dominant_frequency, s_f.dominant_frequency, s_i.dominant_frequency);
+    check(s_f.dominant_frequency == s_d.dominant_frequency && s_i.dominant_frequency == s_d.dominant_frequency,
+          "same dominant frequency");
+
+    double worst = 0.0;
+    double peak = 0.0;
+    for (int k = 0; k < s_d.num_bins; k++)
+    {
+        worst = fmax(worst, fabs(s_i.bins[k].magnitude - s_d.bins[k].magnitude));
+        peak = fmax(peak, s_d.bins[k].magnitude);
+    }
+    printf("Largest magnitude error: %.3e of the peak\n", worst / peak);
+    check(worst / peak < 1e-5, "float spectrum matches the double spectrum");
+
+    sp_d.FreeSpectrum(&s_d);
+    sp_f.FreeSpectrum(&s_f);
+    sp_i.FreeSpectrum(&s_i);
+    printf("\n");
+}
+
+void test_int16_writes()
+{
+    printf("=== Test 4: In-place operations on int16 samples ===\n");
+
+    SignalProcessingI16 sp(8);
+    int16_t values[4] = {-20000, -3, 3, 20000};
+    sp.AddValues(values, 4);
+
+    sp.MultiplyWithValue(2.0, 4);
+    int16_t out[4];
+    sp.GetVector(out);
+    printf("x2: %d %d %d %d\n", out[0], out[1], out[2], out[3]);
+    check(out[0] == -32768 && out[1] == -6 && out[2] == 6 && out[3] == 32767, "results saturate to 16 bits");
+
+    sp.DivideWithValue(4.0, 4);
+    sp.GetVector(out);
+    printf("/4: %d %d %d %d\n", out[0], out[1], out[2], out[3]);
+    check(out[1] == -2 && out[2] == 2, "results are rounded");
+
+    sp.ScaleVector(-1000.0, 1000.0);
+    sp.GetVector(out);
+    check(out[0] == -1000 && out[3] == 1000 && sp.GetLastValue() == 1000, "ScaleVector to an integer range");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Sample Type Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    printf("Bytes per sample: double %d, float %d, int16 %d\n\n",
+           (int)sizeof(double), (int)sizeof(float), (int)sizeof(int16_t));
+
+    test_statistics();
+    test_filters();
+    test_fft();
+    test_int16_writes();
+
+    if (failures == 0)
+        printf("All sample type tests passed.\n");
+    else
+        printf("%d sample type check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+/*
+ * Test file for the multi-channel SignalBank
+ * Tests planar storage, shared timestamps, batch and cross-channel methods
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// channel c: sine at (5 + c) Hz sampled at 1 kHz, offset 0.01 * c
+static double channel_sample(int c, int n)
+{
+    return sin(2.0 * M_PI * (5.0 + c) * n / 1000.0) + 0.01 * c;
+}
+
+void test_ingest()
+{
+    printf("=== Test 1: Interleaved and planar ingest ===\n");
+
+    const int channels = 4;
+    SignalBank bank(channels, 100);
+    SignalProcessing *reference[channels];
+    for (int c = 0; c < channels; c++)
+        reference[c] = new SignalProcessing(100);
+
+    // 70 frames one at a time, then interleaved blocks, then one planar block
+    double frame[channels];
+    int n = 0;
+    for (; n < 70; n++)
+    {
+        for (int c = 0; c < channels; c++)
+        {
+            frame[c] = channel_sample(c, n);
+            reference[c]->AddValue(frame[c]);
+        }
+        bank.AddFrame(frame);
+    }
+    static double interleaved[60 * channels];
+    for (int i = 0; i < 60; i++, n++)
+        for (int c = 0; c < channels; c++)
+        {
+            interleaved[i * channels + c] = channel_sample(c, n);
+            reference[c]->AddValue(channel_sample(c, n));
+        }
+    bank.AddFrames(interleaved, 60);
+    static double planar[channels * 150];
+    for (int c = 0; c < channels; c++)
+        for (int i = 0; i < 150; i++)
+        {
+            planar[c * 150 + i] = channel_sample(c, n + i);
+            reference[c]->AddValue(channel_sample(c, n + i));
+        }
+    bank.AddPlanarFrames(planar, 150);
+
+    bool same = true;
+    for (int c = 0; c < channels; c++)
+        for (int i = 0; i < bank.GetIndex(); i++)
+            same = same && (bank.GetValue(c, i) == reference[c]->GetValue(i));
+    check(bank.GetIndex() == 100 && bank.GetTotalCount() == 280, "frame counts after wraparound");
+    check(same, "every channel matches a SignalProcessing fed the same samples");
+
+    bool aligned = true;
+    for (int c = 1; c < channels; c++)
+        aligned = aligned && ((uintptr_t)bank.GetChannelData(c) - (uintptr_t)bank.GetChannelData(0)) % SIGNALBANK_ALIGNMENT == 0;
+    check(aligned, "channels start on aligned boundaries");
+    check(bank.GetChannelData(channels) == nullptr, "invalid channel rejected");
+    for (int c = 0; c < channels; c++)
+        delete reference[c];
+    printf("\n");
+}
+
+void test_shared_timestamps()
+{
+    printf("=== Test 2: Shared timestamps ===\n");
+
+    SignalBank bank(3, 8);
+    double frame[3] = {1.0, 2.0, 3.0};
+    for (int i = 0; i < 10; i++)
+    {
+        struct timespec ts;
+        ts.tv_sec = 100 + i;
+        ts.tv_nsec = 250;
+        bank.AddFrameWithTimestamp(frame, ts);
+    }
+    struct timespec first = bank.GetTimestamp(0);
+    struct timespec last = bank.GetTimestamp(7);
+    printf("Oldest frame at %ld.%09ld, newest at %ld.%09ld\n",
+           (long)first.tv_sec, first.tv_nsec, (long)last.tv_sec, last.tv_nsec);
+    check(first.tv_sec == 102 && last.tv_sec == 109 && last.tv_nsec == 250, "one timestamp per frame");
+    check(bank.Channel(2).GetTimestamp(7).tv_sec == 109, "channel views see the shared timestamps");
+
+    bank.AddFrame(frame);
+    check(bank.GetTimestamp(7).tv_sec == 0, "untimed frame has no timestamp");
+    printf("\n");
+}
+
+void test_batch_methods()
+{
+    printf("=== Test 3: Batch statistics, filters and FFT ===\n");
+
+    const int channels = 16;
+    const int frames = 1024;
+    SignalBank bank(channels, frames);
+    static double block[frames * channels];
+    for (int n = 0; n < frames; n++)
+        for (int c = 0; c < channels; c++)
+            block[n * channels + c] = channel_sample(c, n);
+    bank.AddFrames(block, frames);
+
+    double means[channels];
+    double stds[channels];
+    bank.GetMeans(means);
+    bank.GetStandardDeviations(stds);
+
+    SignalProcessing single(frames);
+    bool stats_ok = true;
+    bool filters_ok = true;
+    static double smoothed[frames * channels];
+    static double kalman[frames * channels];
+    static double expected[frames];
+    bank.ExponentialSmoothing(0.3, smoothed);
+    bank.KalmanFilter(0.01, 0.1, kalman);
+    for (int c = 0; c < channels; c++)
+    {
+        single.ClearVector();
+        for (int n = 0; n < frames; n++)
+            single.AddValue(channel_sample(c, n));
+        stats_ok = stats_ok && means[c] == single.GetMean() && stds[c] == single.GetStandardDeviation();
+        single.ExponentialSmoothing(0.3, expected);
+        for (int n = 0; n < frames; n++)
+            filters_ok = filters_ok && smoothed[c * frames + n] == expected[n];
+        single.KalmanFilter(0.01, 0.1, expected);
+        for (int n = 0; n < frames; n++)
+            filters_ok = filters_ok && kalman[c * frames + n] == expected[n];
+    }
+    printf("Channel 7: mean %.4f, std %.4f\n", means[7], stds[7]);
+    check(stats_ok, "per-channel statistics");
+    check(filters_ok, "planar filter outputs");
+
+    FrequencySpectrum spectra[channels];
+    bool ok = bank.FFTAnalysis(1000.0, spectra);
+    bool peaks_ok = ok;
+    for (int c = 0; ok && c < channels; c++)
+        peaks_ok = peaks_ok && fabs(spectra[c].dominant_frequency - (5.0 + c)) < 1.0;
+    if (ok)
+    {
+        printf("Dominant frequencies: channel 0 %.2f Hz, channel 15 %.2f Hz\n",
+               spectra[0].dominant_frequency, spectra[15].dominant_frequency);
+        bank.FreeSpectra(spectra);
+    }
+    check(peaks_ok, "one spectrum per channel");
+
+    int peaks[64];
+    int num_peaks = bank.Channel(3).DetectPeaksWithThreshold(0.9, peaks, 64);
+    printf("Channel 3 peaks above 0.9: %d\n", num_peaks);
+    check(num_peaks == 8, "any analysis method through Channel()");
+    check(bank.Channel(3).AddValue(0.0) == frames && bank.GetTotalCount() == frames, "channel views are read-only");
+    printf("\n");
+}
+
+void test_cross_channel()
+{
+    printf("=== Test 4: Cross-channel analysis ===\n");
+
+    const int frames = 500;
+    SignalBankF bank(3, frames);
+    float frame[3];
+    for (int n = 0; n < frames; n++)
+    {
+        float s = (float)sin(2.0 * M_PI * 12.0 * n / 1000.0);
+        frame[0] = s;
+        frame[1] = 2.0f * s + 1.0f;
+        frame[2] = -s;
+        bank.AddFrame(frame);
+    }
+
+    static float common[frames];
+    bank.GetCrossChannelMean(common);
+    bool mean_ok = true;
+    for (int n = 0; n < frames; n++)
+        mean_ok = mean_ok && fabs(common[n] - (2.0f * bank.GetValue(0, n) + 1.0f) / 3.0f) < 1e-5;
+    check(mean_ok, "common-mode signal");
+
+    double matrix[9];
+    bank.GetCorrelationMatrix(matrix);
+    printf("Correlation: r01 = %.4f, r02 = %.4f, r12 = %.4f\n", matrix[1], matrix[2], matrix[5]);
+    check(fabs(matrix[1] - 1.0) < 1e-4 && fabs(matrix[2] + 1.0) < 1e-4 && fabs(matrix[5] + 1.0) < 1e-4,
+          "correlation matrix");
+    check(matrix[0] == 1.0 && matrix[3] == matrix[1], "symmetric with unit diagonal");
+    printf("\n");
+}
+
+void test_many_channels()
+{
+    printf("=== Test 5: 800 channels ===\n");
+
+    const int channels = 800;
+    const int frames = 4096;
+    SignalBankI16 bank(channels, frames);
+    int16_t *block = (int16_t *)malloc((size_t)channels * 256 * sizeof(int16_t));
+    for (int b = 0; b < frames / 256; b++)
+    {
+        for (int i = 0; i < 256; i++)
+            for (int c = 0; c < channels; c++)
+                block[i * channels + c] = (int16_t)((b * 256 + i + c) % 1000);
+        bank.AddFrames(block, 256);
+    }
+    free(block);
+
+    static double means[channels];
+    bank.GetMeans(means);
+    printf("Means of %d channels x %d frames, channel 799: %.3f\n", channels, frames, means[799]);
+    check(bank.GetValue(799, 10) == (10 + 799) % 1000, "interleaved 16-bit frames");
+    double expected = 0.0;
+    for (int n = 0; n < frames; n++)
+        expected += (n + 799) % 1000;
+    expected /= frames;
+    check(fabs(means[799] - expected) < 1e-3, "batch mean of 800 channels");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Signal Bank Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_ingest();
+    test_shared_timestamps();
+    test_batch_methods();
+    test_cross_channel();
+    test_many_channels();
+
+    if (failures == 0)
+        printf("All signal bank tests passed.\n");
+    else
+        printf("%d signal bank check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/*
+ * Test file for the memory-mapped SignalFile
+ * Writes a recording block by block, maps it and analyses ranges of it
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const char *FILE_PATH = "test_signal_file.sig";
+static const double RATE = 25000.0;
+static const long long TOTAL = 10000000; // 400 s at 25 kHz, 40 MB of float
+
+// 60 Hz tone, switching to 180 Hz in the second half, with one spike per second
+static float recorded_sample(long long n)
+{
+    double f = (n < TOTAL / 2) ? 60.0 : 180.0;
+    double v = sin(2.0 * M_PI * f * (double)n / RATE);
+    if (n % 25000 == 12345)
+        v += 8.0;
+    return (float)v;
+}
+
+void test_write()
+{
+    printf("=== Test 1: Writing a recording block by block ===\n");
+
+    struct timespec t0 = {1700000000, 500000000};
+    bool ok = SignalFileF::WriteFile(FILE_PATH, nullptr, 0, RATE, t0);
+
+    const int block_size = 65536;
+    float *block = (float *)malloc(block_size * sizeof(float));
+    for (long long n = 0; ok && n < TOTAL; n += block_size)
+    {
+        int count = (int)((TOTAL - n < block_size) ? TOTAL - n : block_size);
+        for (int i = 0; i < count; i++)
+            block[i] = recorded_sample(n + i);
+        ok = SignalFileF::AppendToFile(FILE_PATH, block, count);
+    }
+    free(block);
+    printf("Wrote %lld samples\n", TOTAL);
+    check(ok, "file written with AppendToFile");
+    printf("\n");
+}
+
+void test_open()
+{
+    printf("=== Test 2: Mapping the recording ===\n");
+
+    SignalFileF file(FILE_PATH);
+    check(file.IsOpen() && file.GetFileSampleCount() == TOTAL, "all samples mapped");
+    check(file.GetSampleRate() == RATE && file.GetStartTime().tv_sec == 1700000000 &&
+          file.GetStartTime().tv_nsec == 500000000, "header fields");
+    check(file.GetIndex() == TOTAL && file.GetValue(123456) == recorded_sample(123456) &&
+          file.GetLastValue() == recorded_sample(TOTAL - 1), "whole file selected");
+
+    struct timespec ts = file.GetTimestamp(25000 * 10 + 2);
+    check(ts.tv_sec == 1700000010 && ts.tv_nsec == 500080000, "uniform timestamps from the header");
+
+    static int anomalies[1000];
+    int found = file.DetectAnomaliesZScore(5.0, anomalies, 1000);
+    printf("Z-score anomalies over %lld samples: %d\n", TOTAL, found);
+    check(found == (int)(TOTAL / 25000) && anomalies[3] == 3 * 25000 + 12345, "anomalies over the whole recording");
+
+    SignalFileI16 wrong_type(FILE_PATH);
+    check(!wrong_type.IsOpen() && wrong_type.GetIndex() == 0, "sample type checked");
+    SignalFileF missing("does_not_exist.sig");
+    check(!missing.IsOpen(), "missing file rejected");
+    printf("\n");
+}
+
+void test_ranges()
+{
+    printf("=== Test 3: Analysing ranges ===\n");
+
+    SignalFileF file;
+    check(file.Open(FILE_PATH), "Open");
+
+    FrequencySpectrum spectrum;
+    bool ok = file.SelectRange(1000000, 8192) && file.FFTAnalysis(RATE, &spectrum);
+    double first = ok ? spectrum.dominant_frequency : 0.0;
+    if (ok)
+        file.FreeSpectrum(&spectrum);
+    ok = ok && file.SelectRange(TOTAL - 8192, 8192) && file.FFTAnalysis(RATE, &spectrum);
+    double last = ok ? spectrum.dominant_frequency : 0.0;
+    if (ok)
+        file.FreeSpectrum(&spectrum);
+    printf("Dominant frequency: %.1f Hz at 40 s, %.1f Hz at the end\n", first, last);
+    check(ok && fabs(first - 60.0) < 4.0 && fabs(last - 180.0) < 4.0, "FFT on two ranges");
+    check(file.GetRangeStart() == TOTAL - 8192 && file.GetValue(0) == recorded_sample(TOTAL - 8192), "range start");
+
+    struct timespec ts = file.GetTimestamp(0);
+    long long expected_ns = 500000000LL + (TOTAL - 8192) * 40000LL;
+    check(ts.tv_sec == 1700000000 + expected_ns / NS_PER_SECOND && ts.tv_nsec == expected_ns % NS_PER_SECOND,
+          "timestamps follow the range");
+
+    file.SelectRange(0, 25000 * 4);
+    MLDataset dataset;
+    SignalProcessingF::CreateMLDataset(16, false, &dataset);
+    int windows = file.ExtractMLFeaturesRollingWindow(25000, 25000, RATE, &dataset);
+    printf("Rolling-window features: %d windows\n", windows);
+    check(windows == 4 && dataset.samples[2].peak_to_peak > 8.0, "rolling-window features on a range");
+    SignalProcessingF::FreeMLDataset(&dataset);
+
+    check(!file.SelectRange(TOTAL - 10, 11), "range past the end rejected");
+    file.Close();
+    check(!file.IsOpen() && file.GetIndex() == 0, "Close");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Signal File Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_write();
+    test_open();
+    test_ranges();
+    remove(FILE_PATH);
+
+    if (failures == 0)
+        printf("All signal file tests passed.\n");
+    else
+        printf("%d signal file check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
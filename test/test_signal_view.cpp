@@ -0,0 +1,182 @@
+/*
+ * Test file for the non-owning SignalView
+ * Runs the analysis methods directly on external buffers and compares them
+ * with a SignalProcessing holding a copy of the same samples
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double test_sample(int n)
+{
+    double v = sin(2.0 * M_PI * 50.0 * n / 1000.0) + 0.3 * sin(2.0 * M_PI * 120.0 * n / 1000.0);
+    if (n % 97 == 13)
+        v += 4.0; // spikes for the anomaly detectors
+    return v;
+}
+
+void test_same_results()
+{
+    printf("=== Test 1: View and copy give the same results ===\n");
+
+    const int n = 2048;
+    std::vector<double> data(n);
+    for (int i = 0; i < n; i++)
+        data[i] = test_sample(i);
+
+    SignalView view(data.data(), n);
+    SignalProcessing copy(n);
+    copy.AddValues(data.data(), n);
+
+    check(view.GetIndex() == n && view.GetLastValue() == data[n - 1], "view covers the external buffer");
+    check(view.GetMean() == copy.GetMean() && view.GetStandardDeviation() == copy.GetStandardDeviation(),
+          "statistics");
+
+    int peaks_v[512], peaks_c[512];
+    int np_v = view.DetectPeaksWithThreshold(0.5, peaks_v, 512);
+    int np_c = copy.DetectPeaksWithThreshold(0.5, peaks_c, 512);
+    bool same = (np_v == np_c);
+    for (int i = 0; same && i < np_v; i++)
+        same = (peaks_v[i] == peaks_c[i]);
+    check(same && np_v > 0, "peak detection");
+
+    int anomalies_v[256], anomalies_c[256];
+    int na_v = view.DetectAnomaliesZScore(3.0, anomalies_v, 256);
+    int na_c = copy.DetectAnomaliesZScore(3.0, anomalies_c, 256);
+    printf("Z-score anomalies: %d\n", na_v);
+    check(na_v == na_c && na_v > 0 && anomalies_v[0] == anomalies_c[0], "anomaly detection");
+
+    FrequencySpectrum s_v, s_c;
+    bool ok = view.FFTAnalysis(1000.0, &s_v) && copy.FFTAnalysis(1000.0, &s_c);
+    check(ok && s_v.dominant_frequency == s_c.dominant_frequency && s_v.total_power == s_c.total_power, "FFT analysis");
+    if (ok)
+    {
+        view.FreeSpectrum(&s_v);
+        copy.FreeSpectrum(&s_c);
+    }
+
+    static double ac_v[101], ac_c[101];
+    view.Autocorrelation(100, ac_v);
+    copy.Autocorrelation(100, ac_c);
+    check(ac_v[20] == ac_c[20] && ac_v[100] == ac_c[100], "autocorrelation");
+
+    MLFeatureVector f_v, f_c;
+    view.ExtractMLFeatures(1000.0, &f_v);
+    copy.ExtractMLFeatures(1000.0, &f_c);
+    check(f_v.spectral_centroid == f_c.spectral_centroid && f_v.zero_crossing_rate == f_c.zero_crossing_rate,
+          "ML features");
+    printf("\n");
+}
+
+void test_zero_copy()
+{
+    printf("=== Test 2: No copy, read-only access ===\n");
+
+    double data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    SignalView view(data, 8);
+
+    data[3] = 40.0;
+    check(view.GetValue(3) == 40.0, "view reads the caller's buffer");
+
+    view.NormalizeVector();
+    view.MultiplyWithValue(2.0, 8);
+    check(data[0] == 1.0 && data[7] == 8.0, "in-place operations leave the buffer untouched");
+    check(view.AddValue(9.0) == 8 && view.GetIndex() == 8, "adding values is ignored");
+
+    view.SetAnalysisWindow(4);
+    check(view.GetMean() == 6.5, "analysis window on the newest samples");
+
+    struct timespec t0 = {100, 0};
+    view.SetUniformSampling(t0, 1000000);
+    check(view.GetTimestamp(3).tv_sec == 100 && view.GetTimestamp(3).tv_nsec == 7000000,
+          "uniform timestamps on a view");
+
+    view.Reset(data + 2, 3);
+    check(view.GetIndex() == 3 && view.GetValue(0) == 3.0 && view.GetLastValue() == 5.0, "Reset to another buffer");
+    printf("\n");
+}
+
+void test_strided()
+{
+    printf("=== Test 3: Strided view of interleaved channels ===\n");
+
+    const int frames = 1000;
+    static float interleaved[frames * 3];
+    for (int i = 0; i < frames; i++)
+    {
+        interleaved[i * 3 + 0] = (float)i;
+        interleaved[i * 3 + 1] = (float)sin(2.0 * M_PI * 25.0 * i / 1000.0);
+        interleaved[i * 3 + 2] = -1.0f;
+    }
+
+    SignalViewF channel(interleaved + 1, frames, 3);
+    FrequencySpectrum spectrum;
+    bool ok = channel.FFTAnalysis(1000.0, &spectrum);
+    printf("Channel 1 dominant frequency: %.2f Hz\n", ok ? spectrum.dominant_frequency : 0.0);
+    check(ok && fabs(spectrum.dominant_frequency - 25.0) < 1.0, "FFT on one interleaved channel");
+    if (ok)
+        channel.FreeSpectrum(&spectrum);
+
+    channel.Reset(interleaved, frames, 3);
+    check(channel.GetMean() == 499.5, "Reset to another channel");
+    printf("\n");
+}
+
+void test_segment_features()
+{
+    printf("=== Test 4: Segment features without copy ===\n");
+
+    const int n = 20000;
+    const int window = 1000;
+    std::vector<double> data(n);
+    for (int i = 0; i < n; i++)
+        data[i] = test_sample(i);
+
+    const int offset = 199 * 97 % (n - window);
+    MLFeatureVector copy_features, view_features;
+    SignalProcessing copy(window);
+    copy.AddValues(data.data() + offset, window);
+    copy.ExtractMLFeatures(1000.0, &copy_features);
+    SignalView view(data.data() + offset, window);
+    view.ExtractMLFeatures(1000.0, &view_features);
+
+    printf("Segment at %d: mean %.6f, RMS %.6f\n", offset, view_features.mean, view_features.rms);
+    check(view_features.mean == copy_features.mean && view_features.rms == copy_features.rms &&
+          view_features.spectral_centroid == copy_features.spectral_centroid, "same features from the view");
+
+    double *signals[2] = {data.data(), data.data() + 5000};
+    int sizes[2] = {5000, 15000};
+    MLDataset dataset;
+    SignalProcessing::CreateMLDataset(2, false, &dataset);
+    int processed = SignalProcessing::BatchExtractFeatures(signals, sizes, 2, 1000.0, &dataset);
+    SignalView whole(data.data() + 5000, 15000);
+    check(processed == 2 && dataset.samples[1].mean == whole.GetMean(), "BatchExtractFeatures uses whole signals");
+    SignalProcessing::FreeMLDataset(&dataset);
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Signal View Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_same_results();
+    test_zero_copy();
+    test_strided();
+    test_segment_features();
+
+    if (failures == 0)
+        printf("All signal view tests passed.\n");
+    else
+        printf("%d signal view check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
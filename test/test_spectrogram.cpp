@@ -0,0 +1,199 @@
+/*
+ * Test file for the streaming spectrogram
+ * Checks frames against FFTAnalysis(), block-size independence, hop and
+ * overlap, the frame ring, reading from a signal ring buffer and the absence
+ * of heap allocation while streaming
+ */
+
+#define TEST_COUNT_HEAP_CALLS
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double test_value(int n)
+{
+    return sin(2.0 * M_PI * 50.0 * n / 1000.0) + 0.5 * sin(2.0 * M_PI * (120.0 + 0.01 * n) * n / 1000.0) +
+           ((n * 7919) % 13) * 0.01;
+}
+
+void test_against_fft_analysis()
+{
+    printf("=== Test 1: Frames against FFTAnalysis() ===\n");
+
+    const int window = 500, hop = 125, n = 4000;
+    SignalProcessing sp(n);
+    Spectrogram spectrogram(window, hop, 64);
+    check(spectrogram.IsValid() && spectrogram.GetNumBins() == 251, "configured");
+    for (int i = 0; i < n; i++)
+    {
+        sp.AddValue(test_value(i));
+        spectrogram.AddValue(test_value(i));
+    }
+    int expected = (n - window) / hop + 1;
+    printf("%d samples, window %d, hop %d: %lld frames\n", n, window, hop, spectrogram.GetTotalFrames());
+    check(spectrogram.GetFrameCount() == expected && spectrogram.GetTotalFrames() == expected, "one frame per hop");
+
+    double worst = 0.0;
+    bool starts = true;
+    for (int f = 0; f < spectrogram.GetFrameCount(); f++)
+    {
+        starts = starts && spectrogram.GetFrameStart(f) == (long long)f * hop;
+        FrequencySpectrum spectrum;
+        if (!sp.FFTAnalysis(f * hop, window, 1000.0, &spectrum))
+        {
+            worst = 1.0;
+            continue;
+        }
+        const double *frame = spectrogram.GetFrame(f);
+        for (int k = 0; k < spectrum.num_bins; k++)
+            worst = fmax(worst, fabs(frame[k] - spectrum.bins[k].magnitude));
+        sp.FreeSpectrum(&spectrum);
+    }
+    printf("Worst difference to FFTAnalysis: %.2e\n", worst);
+    check(starts, "frame starts at multiples of the hop");
+    check(worst < 1e-9, "same magnitudes as FFTAnalysis over the same samples");
+
+    Spectrogram power(window, hop, 4, SIGNAL_WINDOW_HANN, SPECTROGRAM_POWER);
+    Spectrogram db(window, hop, 4, SIGNAL_WINDOW_HANN, SPECTROGRAM_DB);
+    std::vector<double> samples(window);
+    for (int i = 0; i < window; i++)
+        samples[i] = test_value(i);
+    power.AddValues(samples.data(), window);
+    db.AddValues(samples.data(), window);
+    const double *m = spectrogram.GetFrame(0);
+    check(fabs(power.GetFrame(0)[50] - m[50] * m[50]) < 1e-9 * m[50] * m[50] &&
+          fabs(db.GetFrame(0)[50] - 20.0 * log10(m[50])) < 1e-9, "power and dB output");
+    check(!Spectrogram(1, 1, 1).IsValid() && !Spectrogram(256, 0, 1).IsValid() && !Spectrogram(256, 64, 0).IsValid(),
+          "invalid parameters rejected");
+    printf("\n");
+}
+
+void test_streaming()
+{
+    printf("=== Test 2: Blocks, hop and frame ring ===\n");
+
+    const int n = 20000;
+    std::vector<float> samples(n);
+    for (int i = 0; i < n; i++)
+        samples[i] = (float)test_value(i);
+
+    // any split of the input gives the same frames
+    SpectrogramF one(1024, 256, 200), blocks(1024, 256, 200);
+    for (int i = 0; i < n; i++)
+        one.AddValue(samples[i]);
+    int emitted = 0;
+    for (int i = 0, b = 1; i < n; i += b, b = (b * 7 + 3) % 1500 + 1)
+        emitted += blocks.AddValues(samples.data() + i, (i + b <= n) ? b : n - i);
+    bool same = one.GetFrameCount() == blocks.GetFrameCount() && emitted == blocks.GetTotalFrames();
+    for (int f = 0; same && f < one.GetFrameCount(); f++)
+        for (int k = 0; k < one.GetNumBins(); k++)
+            same = same && one.GetFrame(f)[k] == blocks.GetFrame(f)[k];
+    check(same, "sample by sample and random blocks give identical frames");
+
+    // hop longer than the window: samples between frames are skipped
+    SpectrogramF sparse(256, 1000, 100);
+    sparse.AddValues(samples.data(), n);
+    check(sparse.GetTotalFrames() == (n - 256) / 1000 + 1 && sparse.GetFrameStart(3) == 3 * 1000 + 0,
+          "hop longer than the window");
+
+    // frame ring: the newest max_frames frames, oldest first
+    SpectrogramF ring(512, 128, 10);
+    ring.AddValues(samples.data(), n);
+    long long total = ring.GetTotalFrames();
+    check(ring.GetFrameCount() == 10 && ring.GetFrameStart(9) == (total - 1) * 128 &&
+          ring.GetFrameStart(0) == (total - 10) * 128 && ring.GetFrame(10) == nullptr, "newest frames kept");
+    static float copy[4][257];
+    int rows = ring.CopyFrames(&copy[0][0], 4);
+    check(rows == 4 && copy[0][7] == ring.GetFrame(6)[7] && copy[3][200] == ring.GetFrame(9)[200],
+          "frames copied in time order");
+
+    // caller matrix, e.g. a waterfall texture
+    static float texture[16 * 129];
+    SpectrogramF waterfall(256, 64, 16, SIGNAL_WINDOW_HAMMING, SPECTROGRAM_DB, texture);
+    waterfall.AddValues(samples.data(), 4096);
+    check(waterfall.IsValid() && waterfall.GetFrame(0) >= texture && waterfall.GetFrame(15) < texture + 16 * 129,
+          "frames written to the caller matrix");
+    ring.Reset();
+    check(ring.GetFrameCount() == 0 && ring.GetSampleCount() == 0 && ring.AddValues(samples.data(), 511) == 0,
+          "reset");
+    printf("\n");
+}
+
+void test_signal_update()
+{
+    printf("=== Test 3: Reading a signal ring buffer ===\n");
+
+    SignalProcessing sp(2048);
+    Spectrogram live(256, 64, 500), reference(256, 64, 500);
+    int frames = 0;
+    for (int block = 0; block < 100; block++)
+    {
+        for (int i = 0; i < 100; i++)
+        {
+            sp.AddValue(test_value(block * 100 + i));
+            reference.AddValue(test_value(block * 100 + i));
+        }
+        frames += live.Update(&sp);
+    }
+    bool same = live.GetTotalFrames() == reference.GetTotalFrames() && frames == live.GetTotalFrames();
+    for (int f = 0; same && f < live.GetFrameCount(); f++)
+        same = same && live.GetFrameStart(f) == reference.GetFrameStart(f) &&
+               live.GetFrame(f)[40] == reference.GetFrame(f)[40];
+    check(same, "new samples read incrementally");
+    check(live.Update(&sp) == 0 && live.GetSampleCount() == sp.GetTotalCount(), "nothing new, nothing computed");
+
+    // more samples than the ring buffer holds between two updates
+    for (int i = 0; i < 5000; i++)
+        sp.AddValue(test_value(i));
+    live.Update(&sp);
+    long long gap_end = sp.GetTotalCount() - 2048;
+    check(live.GetSampleCount() == sp.GetTotalCount() && live.GetFrameStart(live.GetFrameCount() - 1) >= gap_end &&
+          (live.GetFrameStart(live.GetFrameCount() - 1) - gap_end) % 64 == 0, "overwritten samples skipped");
+    printf("\n");
+}
+
+void test_no_allocation()
+{
+    printf("=== Test 4: Streaming without allocation ===\n");
+
+    Spectrogram spectrogram(1000, 250, 100);
+    std::vector<double> block(480);
+    long long before = HEAP_CALLS;
+    int frames = 0;
+    for (int b = 0; b < 200; b++)
+    {
+        for (int i = 0; i < 480; i++)
+            block[i] = test_value(b * 480 + i);
+        frames += spectrogram.AddValues(block.data(), 480);
+    }
+    long long calls = HEAP_CALLS - before;
+    printf("%d frames, %lld heap calls\n", frames, calls);
+    check(frames > 300 && calls == 0, "no heap allocation per frame");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Spectrogram Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_against_fft_analysis();
+    test_streaming();
+    test_signal_update();
+    test_no_allocation();
+
+    if (failures == 0)
+        printf("All spectrogram tests passed.\n");
+    else
+        printf("%d spectrogram check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
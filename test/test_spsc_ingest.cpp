@@ -0,0 +1,132 @@
+/*
+ * Test file for the single-producer/single-consumer ingest mode
+ * One thread adds timestamped samples while another analyzes snapshots
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <math.h>
+#include <thread>
+#include <atomic>
+
+void test_snapshot_single_thread()
+{
+    printf("=== Test 1: Snapshot semantics ===\n");
+
+    SignalProcessing sp(64);
+    sp.SetConcurrentIngest(true);
+
+    for (int i = 0; i < 10; i++)
+        sp.AddValue((double)i);
+    check(sp.GetIndex() == 0, "samples are invisible before AcquireSnapshot()");
+
+    int stored = sp.AcquireSnapshot();
+    check(stored == 10 && sp.GetIndex() == 10, "snapshot contains the published samples");
+    check(fabs(sp.GetMean() - 4.5) < 1e-12, "analysis runs on the snapshot");
+
+    sp.AddValue(100.0);
+    check(sp.GetIndex() == 10 && sp.GetLastValue() == 9.0, "newer samples stay out of the snapshot");
+    check(sp.IsSnapshotValid(), "snapshot still valid after one new sample");
+
+    sp.SetAnalysisWindow(16);
+    sp.AcquireSnapshot();
+    for (int i = 0; i < 64; i++)
+        sp.AddValue(-1.0);
+    check(!sp.IsSnapshotValid(), "snapshot invalid once the producer laps the window");
+    printf("\n");
+}
+
+void test_concurrent_ingest()
+{
+    printf("=== Test 2: Producer and analysis threads ===\n");
+
+    const int capacity = 65536;
+    const int window = 4096;
+    const long long num_samples = 2000000;
+
+    SignalProcessing sp(capacity);
+    sp.SetConcurrentIngest(true);
+    sp.SetAnalysisWindow(window);
+
+    std::atomic<bool> done(false);
+
+    // Producer: sample n has value n and timestamp n microseconds
+    std::thread producer([&]() {
+        for (long long n = 0; n < num_samples; n++)
+        {
+            struct timespec ts;
+            ts.tv_sec = (time_t)(n / 1000000);
+            ts.tv_nsec = (long)(n % 1000000) * 1000;
+            sp.AddValueWithTimestamp((double)n, ts);
+        }
+        done.store(true);
+    });
+
+    int snapshots = 0;
+    int valid_snapshots = 0;
+    int torn_snapshots = 0;
+
+    while (!done.load())
+    {
+        int stored = sp.AcquireSnapshot();
+        int length = sp.GetAnalysisWindow();
+        if (stored < 2)
+            continue;
+
+        // every sample of a consistent snapshot follows the previous one
+        bool consistent = true;
+        double first = sp.GetValue(0);
+        for (int i = 1; i < length; i++)
+        {
+            if (sp.GetValue(i) != first + i)
+            {
+                consistent = false;
+                break;
+            }
+        }
+        struct timespec ts = sp.GetTimestamp(length - 1);
+        long long expected = (long long)(first + length - 1);
+        if (ts.tv_sec != (time_t)(expected / 1000000) || ts.tv_nsec != (long)(expected % 1000000) * 1000)
+            consistent = false;
+        double mean = sp.GetMean();
+        if (fabs(mean - (first + (length - 1) / 2.0)) > 1e-6 * (first + length))
+            consistent = false;
+
+        snapshots++;
+        if (sp.IsSnapshotValid())
+        {
+            valid_snapshots++;
+            if (!consistent)
+                torn_snapshots++;
+        }
+    }
+    producer.join();
+
+    sp.AcquireSnapshot();
+    printf("Snapshots analyzed: %d (valid: %d, torn but reported valid: %d)\n",
+           snapshots, valid_snapshots, torn_snapshots);
+    printf("Samples published: %lld\n", sp.GetTotalCount());
+
+    check(sp.GetTotalCount() == num_samples, "all samples published");
+    check(sp.GetLastValue() == (double)(num_samples - 1), "last sample visible after the final snapshot");
+    check(torn_snapshots == 0, "no valid snapshot contained torn data");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     SPSC Ingest Test Suite                 ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_snapshot_single_thread();
+    test_concurrent_ingest();
+
+    if (failures == 0)
+        printf("All SPSC ingest tests passed.\n");
+    else
+        printf("%d SPSC ingest check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
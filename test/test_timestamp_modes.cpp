@@ -0,0 +1,134 @@
+/*
+ * Test file for the compact timestamp storage modes
+ * Tests explicit, delta and uniform timestamps and time-range search
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static struct timespec make_ts(long long ns)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / NS_PER_SECOND);
+    ts.tv_nsec = (long)(ns % NS_PER_SECOND);
+    return ts;
+}
+
+static long long to_ns(struct timespec ts)
+{
+    return (long long)ts.tv_sec * NS_PER_SECOND + ts.tv_nsec;
+}
+
+// Jittery 25 kHz channel: 40 us period +/- 3 us
+static long long jittery_time(int n)
+{
+    static const long long t0 = 1700000000LL * NS_PER_SECOND + 123456789LL;
+    return t0 + (long long)n * 40000 + ((n * 7919) % 7 - 3) * 1000;
+}
+
+void test_mode(int mode, const char *name)
+{
+    printf("=== %s mode: jittery channel with wraparound ===\n", name);
+
+    SignalProcessing sp(1000);
+    check(sp.SetTimestampMode(mode), "mode selected");
+
+    // 2500 samples through a 1000-sample buffer, single and block ingest mixed
+    int n = 0;
+    for (; n < 1200; n++)
+        sp.AddValueWithTimestamp((double)n, make_ts(jittery_time(n)));
+    double values[1300];
+    struct timespec ts[1300];
+    for (int i = 0; i < 1300; i++, n++)
+    {
+        values[i] = (double)n;
+        ts[i] = make_ts(jittery_time(n));
+    }
+    sp.AddValuesWithTimestamps(values, ts, 1300);
+
+    bool exact = true;
+    for (int i = 0; i < sp.GetIndex(); i++)
+    {
+        int sample = (int)sp.GetValue(i);
+        struct timespec t;
+        sp.GetTimespec(&t, i);
+        if (to_ns(t) != jittery_time(sample) || to_ns(sp.GetTimestamp(i)) != jittery_time(sample))
+            exact = false;
+    }
+    check(exact, "timestamps reconstructed exactly");
+    check(sp.GetTimestampOverflowCount() == 0, "no clamped timestamp");
+
+    int index = sp.FindTimestampIndex(make_ts(jittery_time(2000)));
+    printf("Sample 2000 found at window index %d\n", index);
+    check(index == 500 && (int)sp.GetValue(index) == 2000, "time-range search");
+    printf("\n");
+}
+
+void test_uniform_mode()
+{
+    printf("=== Uniform mode: t0 + sample number * period ===\n");
+
+    SignalProcessing sp(4096);
+    sp.SetTimestampMode(TIMESTAMP_UNIFORM);
+    struct timespec t0 = make_ts(5LL * NS_PER_SECOND + 999990000LL);
+    sp.SetUniformSampling(t0, 40000);
+
+    static double block[10000];
+    for (int i = 0; i < 10000; i++)
+        block[i] = (double)i;
+    sp.AddValues(block, 10000);
+
+    struct timespec first = sp.GetTimestamp(0);
+    printf("Oldest stored sample %.0f at %ld.%09ld\n", sp.GetValue(0), (long)first.tv_sec, first.tv_nsec);
+    check(to_ns(first) == to_ns(t0) + 5904LL * 40000, "timestamp of the oldest stored sample");
+
+    sp.SetAnalysisWindow(100);
+    check(to_ns(sp.GetTimestamp(99)) == to_ns(t0) + 9999LL * 40000, "timestamp of the newest sample");
+    int index = sp.FindTimestampIndex(make_ts(to_ns(t0) + 9950LL * 40000 - 1));
+    check(index == 50, "time-range search in O(1)");
+    printf("\n");
+}
+
+void test_delta_limits()
+{
+    printf("=== Delta mode: untimed samples and slow channels ===\n");
+
+    SignalProcessing sp(64);
+    sp.SetTimestampMode(TIMESTAMP_DELTA);
+    sp.AddValue(1.0);
+    sp.AddValueWithTimestamp(2.0, make_ts(10LL * NS_PER_SECOND));
+    check(to_ns(sp.GetTimestamp(0)) == 0, "sample without timestamp reads as 0");
+    check(to_ns(sp.GetTimestamp(1)) == 10LL * NS_PER_SECOND, "timestamped sample after an untimed one");
+
+    // 1 Hz channel: more than 4.29 s inside one group of TIMESTAMP_BLOCK samples
+    for (int i = 0; i < TIMESTAMP_BLOCK; i++)
+        sp.AddValueWithTimestamp(0.0, make_ts((20LL + i) * NS_PER_SECOND));
+    printf("Clamped timestamps: %lld\n", sp.GetTimestampOverflowCount());
+    check(sp.GetTimestampOverflowCount() > 0, "offsets beyond 32 bits are reported");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Timestamp Storage Test Suite           ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    printf("Bytes per sample: explicit %d, delta %.1f, uniform 0 (timespec: %d)\n\n",
+           (int)sizeof(long long), sizeof(unsigned int) + 2.0 * sizeof(long long) / TIMESTAMP_BLOCK,
+           (int)sizeof(struct timespec));
+
+    test_mode(TIMESTAMP_EXPLICIT, "Explicit");
+    test_mode(TIMESTAMP_DELTA, "Delta");
+    test_uniform_mode();
+    test_delta_limits();
+
+    if (failures == 0)
+        printf("All timestamp storage tests passed.\n");
+    else
+        printf("%d timestamp storage check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
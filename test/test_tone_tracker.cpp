@@ -0,0 +1,222 @@
+/*
+ * Test file for the tone tracker
+ * Checks the sliding DFT against a direct windowed DFT, amplitude and phase,
+ * retuning to a new shaft speed, harmonic distortion, long-run stability
+ * and reading from a signal ring buffer
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static double test_value(int n)
+{
+    return sin(2.0 * M_PI * 50.0 * n / 1000.0) + 0.5 * cos(2.0 * M_PI * 137.3 * n / 1000.0 + 0.4) +
+           ((n * 7919) % 13) * 0.01;
+}
+
+// magnitude of a direct DFT over the newest size samples
+static double direct_magnitude(const std::vector<double> &x, int end, int size, double nu, bool hann)
+{
+    double real = 0.0, imag = 0.0;
+    for (int m = 0; m < size; m++)
+    {
+        double w = hann ? 0.5 * (1.0 - cos(2.0 * M_PI * m / size)) : 1.0;
+        real += w * x[end - size + m] * cos(nu * m);
+        imag -= w * x[end - size + m] * sin(nu * m);
+    }
+    return sqrt(real * real + imag * imag);
+}
+
+void test_against_dft()
+{
+    printf("=== Test 1: Sliding DFT against a direct windowed DFT ===\n");
+
+    const double rate = 1000.0;
+    const int window = 400, n = 5000;
+    const double tones[3] = {50.0, 137.3, 311.0};
+    std::vector<double> x(n);
+    for (int i = 0; i < n; i++)
+        x[i] = test_value(i);
+
+    for (int hann = 0; hann <= 1; hann++)
+    {
+        ToneTracker tracker(rate, window, 3, hann ? SIGNAL_WINDOW_HANN : SIGNAL_WINDOW_RECTANGULAR);
+        for (int t = 0; t < 3; t++)
+            tracker.AddTone(tones[t]);
+        double worst = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            tracker.AddValue(x[i]);
+            // after every sample, across many resyncs
+            if (i + 1 >= window && (i % 97 == 0 || i == n - 1))
+                for (int t = 0; t < 3; t++)
+                    worst = fmax(worst, fabs(tracker.GetMagnitude(t) -
+                                             direct_magnitude(x, i + 1, window, 2.0 * M_PI * tones[t] / rate, hann)));
+        }
+        char message[80];
+        snprintf(message, sizeof(message), "%s window: worst difference %.2e", hann ? "Hann" : "rectangular", worst);
+        check(worst < 1e-9, message);
+    }
+
+    // same as FFTAnalysis() on a bin frequency
+    SignalProcessing sp(window);
+    ToneTracker tracker(rate, window, 1);
+    tracker.AddTone(50.0);
+    for (int i = 0; i < n; i++)
+    {
+        sp.AddValue(x[i]);
+        tracker.AddValue(x[i]);
+    }
+    FrequencySpectrum spectrum;
+    bool ok = sp.FFTAnalysis(rate, &spectrum);
+    // FFTAnalysis() uses the symmetric Hann window, the tracker the periodic one
+    check(ok && fabs(tracker.GetMagnitude(0) / spectrum.bins[20].magnitude - 1.0) < 0.01, "scale of the FFT bin");
+    if (ok)
+        sp.FreeSpectrum(&spectrum);
+
+    check(!ToneTracker(0.0, 400, 1).IsValid() && !ToneTracker(rate, 1, 1).IsValid() &&
+          !ToneTracker(rate, 400, 0).IsValid() && !ToneTracker(rate, 400, 1, SIGNAL_WINDOW_BLACKMAN).IsValid(),
+          "invalid parameters rejected");
+    check(tracker.AddTone(100.0) == -1 && ToneTracker(rate, 400, 2).AddTone(600.0) == -1, "tone limits");
+    printf("\n");
+}
+
+void test_amplitude_phase()
+{
+    printf("=== Test 2: Amplitude and phase ===\n");
+
+    const double rate = 8000.0;
+    ToneTrackerF tracker(rate, 800, 2);
+    tracker.AddTone(1000.0);
+    tracker.AddTone(1234.5);
+    double worst_amplitude = 0.0, worst_phase = 0.0;
+    for (int i = 0; i < 8000; i++)
+    {
+        double t = i / rate;
+        tracker.AddValue((float)(0.8 * cos(2.0 * M_PI * 1000.0 * t + 1.0) + 0.3 * cos(2.0 * M_PI * 1234.5 * t - 2.0)));
+        if (i >= 800 && i % 50 == 0)
+        {
+            double phase = remainder(2.0 * M_PI * 1000.0 * t + 1.0, 2.0 * M_PI);
+            worst_amplitude = fmax(worst_amplitude, fabs(tracker.GetAmplitude(0) - 0.8));
+            worst_phase = fmax(worst_phase, fabs(remainder(tracker.GetPhase(0) - phase, 2.0 * M_PI)));
+        }
+    }
+    printf("1000 Hz (amplitude 0.8): worst amplitude error %.2e, worst phase error %.2e rad\n", worst_amplitude,
+           worst_phase);
+    printf("1234.5 Hz, between FFT bins (amplitude 0.3): %.6f\n", tracker.GetAmplitude(1));
+    check(worst_amplitude < 1e-4 && worst_phase < 1e-4, "amplitude and phase at the newest sample");
+    check(fabs(tracker.GetAmplitude(1) - 0.3) < 1e-4, "tuned off the FFT bin grid without scalloping loss");
+    printf("\n");
+}
+
+void test_harmonics()
+{
+    printf("=== Test 3: Shaft orders, retuning and distortion ===\n");
+
+    const double rate = 10000.0;
+    ToneTracker tracker(rate, 2000, 8);
+    double rpm = 1500.0;
+    check(tracker.SetHarmonics(rpm / 60.0, 3) == 3 && tracker.GetFrequency(2) == 75.0, "1x, 2x, 3x orders");
+
+    // run up from 1500 to 2400 rpm, retuned every block
+    double phase = 0.0;
+    for (int block = 0; block < 100; block++)
+    {
+        rpm = 1500.0 + 9.0 * block;
+        double f = rpm / 60.0;
+        for (int i = 0; i < 500; i++)
+        {
+            tracker.AddValue(sin(phase) + 0.1 * sin(2.0 * phase) + 0.05 * sin(3.0 * phase));
+            phase += 2.0 * M_PI * f / rate;
+        }
+        tracker.SetHarmonics(f, 3);
+    }
+    // hold the last speed for a full window
+    for (int i = 0; i < 2000; i++)
+    {
+        tracker.AddValue(sin(phase) + 0.1 * sin(2.0 * phase) + 0.05 * sin(3.0 * phase));
+        phase += 2.0 * M_PI * rpm / 60.0 / rate;
+    }
+    double thd = tracker.GetHarmonicDistortion();
+    printf("At %.0f rpm: 1x %.4f, 2x %.4f, 3x %.4f, THD %.4f (expected %.4f)\n", rpm, tracker.GetAmplitude(0),
+           tracker.GetAmplitude(1), tracker.GetAmplitude(2), thd, sqrt(0.1 * 0.1 + 0.05 * 0.05));
+    check(fabs(tracker.GetAmplitude(0) - 1.0) < 0.02 && fabs(tracker.GetAmplitude(1) - 0.1) < 0.005,
+          "order amplitudes after the run-up");
+    check(fabs(thd - sqrt(0.0125)) < 0.005, "harmonic distortion");
+    check(tracker.SetHarmonics(2000.0, 5) == 2 && tracker.GetNumTones() == 2, "harmonics stop at the Nyquist frequency");
+    check(tracker.SetFrequency(1, 1234.0) && !tracker.SetFrequency(2, 100.0) && tracker.GetFrequency(1) == 1234.0,
+          "single tone retuned");
+    printf("\n");
+}
+
+void test_stability()
+{
+    printf("=== Test 4: Long runs and the ring buffer ===\n");
+
+    // 10 million samples: periodic resyncs keep the error at rounding level
+    const double rate = 48000.0;
+    ToneTrackerF tracker(rate, 4800, 1);
+    tracker.AddTone(1000.0);
+    std::vector<float> block(4800);
+    double phase = 0.0;
+    for (int b = 0; b < 2084; b++)
+    {
+        for (int i = 0; i < 4800; i++)
+        {
+            block[i] = (float)(0.5 * sin(phase) + 1000.0);
+            phase = fmod(phase + 2.0 * M_PI * 1000.0 / rate, 2.0 * M_PI);
+        }
+        tracker.AddValues(block.data(), 4800 - b % 7);
+    }
+    printf("%lld samples with a large offset: amplitude %.6f (expected 0.5)\n", tracker.GetSampleCount(),
+           tracker.GetAmplitude(0));
+    check(fabs(tracker.GetAmplitude(0) - 0.5) < 1e-3, "no drift");
+    tracker.Reset();
+    check(tracker.GetSampleCount() == 0 && tracker.GetAmplitude(0) == 0.0 && tracker.GetNumTones() == 1,
+          "reset keeps the tones");
+
+    SignalProcessing sp(1024);
+    ToneTracker live(1000.0, 500, 2), reference(1000.0, 500, 2);
+    live.SetHarmonics(50.0, 2);
+    reference.SetHarmonics(50.0, 2);
+    int added = 0;
+    for (int b = 0; b < 50; b++)
+    {
+        for (int i = 0; i < 77; i++)
+        {
+            sp.AddValue(test_value(b * 77 + i));
+            reference.AddValue(test_value(b * 77 + i));
+        }
+        added += live.Update(&sp);
+    }
+    check(added == 50 * 77 && live.Update(&sp) == 0 && live.GetMagnitude(1) == reference.GetMagnitude(1) &&
+          live.GetPhase(0) == reference.GetPhase(0), "new samples read incrementally");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Tone Tracker Test Suite                ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_against_dft();
+    test_amplitude_phase();
+    test_harmonics();
+    test_stability();
+
+    if (failures == 0)
+        printf("All tone tracker tests passed.\n");
+    else
+        printf("%d tone tracker check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+/*
+ * Test file for the Welch power spectral density
+ * Checks the scaling in units^2/Hz against known signals and a direct
+ * periodogram average, the variance reduction that avoids false frequency
+ * anomalies, band power, and the multi-threaded path of long inputs
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// reproducible Gaussian noise
+static unsigned long long rng_state = 12345;
+static double uniform()
+{
+    rng_state = rng_state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return ((rng_state >> 11) + 0.5) / 9007199254740992.0;
+}
+static double gaussian()
+{
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+void test_scaling()
+{
+    printf("=== Test 1: Density in units^2/Hz ===\n");
+
+    const double rate = 1000.0, sigma = 0.5, amplitude = 2.0;
+    const int n = 100000;
+    SignalProcessing noise(n), tone(n);
+    for (int i = 0; i < n; i++)
+    {
+        noise.AddValue(sigma * gaussian());
+        tone.AddValue(amplitude * sin(2.0 * M_PI * 125.0 * i / rate) + 3.0);
+    }
+
+    PowerSpectralDensity psd;
+    bool ok = noise.WelchPSD(1000, 500, SIGNAL_WINDOW_HANN, rate, &psd);
+    double level = 0.0;
+    for (int k = 1; ok && k < psd.num_bins - 1; k++)
+        level += psd.psd[k];
+    level /= 499.0;
+    printf("White noise sigma %.1f: %d segments, mean density %.6f (expected %.6f), total power %.4f (expected %.4f)\n",
+           sigma, ok ? psd.num_segments : 0, level, 2.0 * sigma * sigma / rate, ok ? psd.total_power : 0.0,
+           sigma * sigma);
+    check(ok && psd.num_bins == 501 && psd.num_segments == 199 && psd.frequency_resolution == 1.0, "segments and bins");
+    check(ok && fabs(level / (2.0 * sigma * sigma / rate) - 1.0) < 0.02, "noise density 2 sigma^2 / rate");
+    check(ok && fabs(psd.total_power / (sigma * sigma) - 1.0) < 0.02, "total power equals the variance");
+    if (ok)
+        noise.FreePSD(&psd);
+
+    for (int window = SIGNAL_WINDOW_RECTANGULAR; window <= SIGNAL_WINDOW_BLACKMAN; window++)
+    {
+        ok = tone.WelchPSD(1000, 250, window, rate, &psd);
+        double band = ok ? tone.GetPowerInBand(&psd, 115.0, 135.0) : 0.0;
+        char message[96];
+        snprintf(message, sizeof(message), "window %d: tone power A^2/2 = %.1f in its band (%.4f), mean removed",
+                 window, amplitude * amplitude / 2.0, band);
+        check(ok && psd.dominant_frequency == 125.0 && fabs(band / 2.0 - 1.0) < 1e-3 &&
+              psd.psd[0] < 1e-6 * psd.psd[125], message);
+        if (ok)
+            tone.FreePSD(&psd);
+    }
+
+    static double values[501];
+    ok = tone.WelchPSD(1000, 500, SIGNAL_WINDOW_HANN, rate, &psd, values, 501);
+    check(ok && psd.psd == values, "density written to the caller array");
+    check(!tone.WelchPSD(1000, 500, SIGNAL_WINDOW_HANN, rate, &psd, values, 500) &&
+          !tone.WelchPSD(1000, 1000, SIGNAL_WINDOW_HANN, rate, &psd) &&
+          !tone.WelchPSD(200000, 0, SIGNAL_WINDOW_HANN, rate, &psd), "invalid arguments rejected");
+    printf("\n");
+}
+
+void test_against_periodograms()
+{
+    printf("=== Test 2: Against a direct average of periodograms ===\n");
+
+    const int n = 700, segment = 63, overlap = 20, step = segment - overlap;
+    const double rate = 250.0;
+    std::vector<double> x(n);
+    SignalProcessing sp(n);
+    for (int i = 0; i < n; i++)
+    {
+        x[i] = sin(0.3 * i) + 0.3 * gaussian();
+        sp.AddValue(x[i]);
+    }
+    PowerSpectralDensity psd;
+    bool ok = sp.WelchPSD(segment, overlap, SIGNAL_WINDOW_HAMMING, rate, &psd);
+
+    int segments = (n - segment) / step + 1;
+    double worst = 0.0;
+    double window_power = 0.0;
+    std::vector<double> w(segment);
+    for (int i = 0; i < segment; i++)
+    {
+        w[i] = 0.54 - 0.46 * cos(2.0 * M_PI * i / (segment - 1));
+        window_power += w[i] * w[i];
+    }
+    for (int k = 0; ok && k <= segment / 2; k++)
+    {
+        double sum = 0.0;
+        for (int s = 0; s < segments; s++)
+        {
+            double mean = 0.0;
+            for (int i = 0; i < segment; i++)
+                mean += x[s * step + i] / segment;
+            double re = 0.0, im = 0.0;
+            for (int i = 0; i < segment; i++)
+            {
+                re += (x[s * step + i] - mean) * w[i] * cos(2.0 * M_PI * k * i / segment);
+                im += (x[s * step + i] - mean) * w[i] * sin(2.0 * M_PI * k * i / segment);
+            }
+            sum += re * re + im * im;
+        }
+        double expected = sum / segments / (rate * window_power) * ((k > 0) ? 2.0 : 1.0);
+        worst = fmax(worst, fabs(psd.psd[k] - expected) / (expected + 1e-12));
+    }
+    printf("Odd segment length %d, %d segments: worst relative difference %.2e\n", segment, segments, worst);
+    check(ok && psd.num_segments == segments && worst < 1e-9, "same density as the definition");
+    if (ok)
+        sp.FreePSD(&psd);
+    printf("\n");
+}
+
+void test_false_alarms()
+{
+    printf("=== Test 3: Baseline comparison without false alarms ===\n");
+
+    const double rate = 2000.0;
+    const int n = 32768;
+    SignalProcessing baseline(n), healthy(n), faulty(n);
+    for (int i = 0; i < n; i++)
+    {
+        double t = i / rate;
+        baseline.AddValue(sin(2.0 * M_PI * 60.0 * t) + 0.5 * gaussian());
+        healthy.AddValue(sin(2.0 * M_PI * 60.0 * t) + 0.5 * gaussian());
+        faulty.AddValue(sin(2.0 * M_PI * 60.0 * t) + 0.5 * gaussian() + 0.3 * sin(2.0 * M_PI * 437.0 * t));
+    }
+
+    // single spectra of 2048 samples, compared bin by bin
+    FrequencySpectrum base_spectrum, healthy_spectrum;
+    baseline.FFTAnalysis(0, 2048, rate, &base_spectrum);
+    healthy.FFTAnalysis(0, 2048, rate, &healthy_spectrum);
+    double spectrum_score = healthy.DetectFrequencyAnomalies(&healthy_spectrum, &base_spectrum, 2.0);
+    baseline.FreeSpectrum(&base_spectrum);
+    healthy.FreeSpectrum(&healthy_spectrum);
+
+    PowerSpectralDensity base_psd, healthy_psd, faulty_psd;
+    baseline.WelchPSD(2048, 1024, SIGNAL_WINDOW_HANN, rate, &base_psd);
+    healthy.WelchPSD(2048, 1024, SIGNAL_WINDOW_HANN, rate, &healthy_psd);
+    faulty.WelchPSD(2048, 1024, SIGNAL_WINDOW_HANN, rate, &faulty_psd);
+    double healthy_score = healthy.DetectFrequencyAnomalies(&healthy_psd, &base_psd, 2.0);
+    double faulty_score = faulty.DetectFrequencyAnomalies(&faulty_psd, &base_psd, 2.0);
+    printf("Healthy against baseline: single spectrum score %.3f, Welch score %.3f (%d segments)\n", spectrum_score,
+           healthy_score, base_psd.num_segments);
+    printf("Faulty (437 Hz component): Welch score %.3f\n", faulty_score);
+    check(spectrum_score > 0.0 && healthy_score == 0.0, "no false alarm on a healthy signal");
+    check(faulty_score > 1.0, "new component detected");
+    double extra = faulty.GetPowerInBand(&faulty_psd, 430.0, 444.0) - baseline.GetPowerInBand(&base_psd, 430.0, 444.0);
+    printf("Extra band power at 437 Hz: %.4f (expected %.4f)\n", extra, 0.3 * 0.3 / 2.0);
+    check(fabs(extra - 0.045) < 0.005, "band power of the new component");
+    baseline.FreePSD(&base_psd);
+    healthy.FreePSD(&healthy_psd);
+    faulty.FreePSD(&faulty_psd);
+    printf("\n");
+}
+
+void test_parallel()
+{
+    printf("=== Test 4: Long inputs on several threads ===\n");
+
+    const int n = 1 << 22, segment = 4096, overlap = 2048, step = segment - overlap;
+    SignalProcessingF sp(n);
+    std::vector<float> x(n);
+    for (int i = 0; i < n; i++)
+        x[i] = (float)(sin(0.05 * i) + gaussian());
+    sp.AddValues(x.data(), n);
+
+    PowerSpectralDensity psd;
+    sp.ReserveWorkspace();
+    bool ok = sp.WelchPSD(segment, overlap, SIGNAL_WINDOW_HANN, 48000.0, &psd);
+
+    // serial reference through the plan
+    const FFTPlan *plan = FFTPlan::Get(segment, 1);
+    std::vector<float> w(segment), real(segment), imag(segment / 2 + 1);
+    std::vector<double> sum(segment / 2 + 1, 0.0);
+    double window_power = 0.0;
+    for (int i = 0; i < segment; i++)
+    {
+        w[i] = (float)(0.5 * (1.0 - cos(2.0 * M_PI * i / (segment - 1))));
+        window_power += (double)w[i] * w[i];
+    }
+    int segments = (n - segment) / step + 1;
+    for (int s = 0; s < segments; s++)
+    {
+        double mean = 0.0;
+        for (int i = 0; i < segment; i++)
+            mean += x[(size_t)s * step + i];
+        float offset = (float)(mean / segment);
+        for (int i = 0; i < segment; i++)
+            real[i] = (x[(size_t)s * step + i] - offset) * w[i];
+        plan->ExecuteReal(real.data(), real.data(), imag.data());
+        for (int k = 0; k <= segment / 2; k++)
+            sum[k] += (double)real[k] * real[k] + (double)imag[k] * imag[k];
+    }
+    double worst = 0.0;
+    for (int k = 0; ok && k <= segment / 2; k++)
+    {
+        double expected = sum[k] / segments / (48000.0 * window_power) * ((k > 0 && k < segment / 2) ? 2.0 : 1.0);
+        worst = fmax(worst, fabs(psd.psd[k] - expected) / expected);
+    }
+    printf("%d segments of %d: worst relative difference to a serial loop %.2e\n", segments, segment, worst);
+    check(ok && psd.num_segments == segments && worst < 1e-10, "same density as a serial loop");
+    if (ok)
+        sp.FreePSD(&psd);
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Welch PSD Test Suite                   ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_scaling();
+    test_against_periodograms();
+    test_false_alarms();
+    test_parallel();
+
+    if (failures == 0)
+        printf("All Welch PSD tests passed.\n");
+    else
+        printf("%d Welch PSD check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+/*
+ * Test file for the cached window-function tables
+ * Checks the coefficients of every window type, the process-wide cache, the
+ * vector multiply of each kernel and the window choice of FFTAnalysis()
+ */
+
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <thread>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const int KERNELS[5] = {FFT_KERNEL_SCALAR, FFT_KERNEL_SSE2, FFT_KERNEL_NEON, FFT_KERNEL_AVX2, FFT_KERNEL_AVX512};
+
+// I0 by its power series, for the Kaiser reference
+static double bessel_i0(double x)
+{
+    double sum = 0.0, factorial = 1.0;
+    for (int k = 0; k < 60; k++)
+    {
+        if (k > 0)
+            factorial *= k;
+        sum += pow(x / 2.0, 2.0 * k) / (factorial * factorial);
+    }
+    return sum;
+}
+
+// peak amplitude read from the spectrum of a tone halfway between two bins
+static double scalloped_amplitude(int window_type)
+{
+    const int n = 1024;
+    const double rate = 1024.0;
+    SignalProcessing sp(n);
+    for (int i = 0; i < n; i++)
+        sp.AddValue(cos(2.0 * M_PI * 100.5 * i / rate));
+    sp.SetSpectrumWindow(window_type);
+    FrequencySpectrum spectrum;
+    if (!sp.FFTAnalysis(rate, &spectrum))
+        return 0.0;
+    double peak = 0.0;
+    for (int k = 0; k < spectrum.num_bins; k++)
+        peak = fmax(peak, spectrum.bins[k].magnitude);
+    sp.FreeSpectrum(&spectrum);
+    return 2.0 * peak / SignalWindow::Get(window_type, n)->GetSum();
+}
+
+void test_coefficients()
+{
+    printf("=== Test 1: Coefficients of every window ===\n");
+
+    const int n = 101;
+    bool symmetric = true, direct = true;
+    for (int type = SIGNAL_WINDOW_RECTANGULAR; type <= SIGNAL_WINDOW_TUKEY; type++)
+    {
+        const SignalWindow *window = SignalWindow::Get(type, n);
+        if (window == nullptr)
+        {
+            symmetric = direct = false;
+            continue;
+        }
+        const double *w = window->GetValues();
+        double sum = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            symmetric = symmetric && w[i] == w[n - 1 - i] && window->GetValuesF()[i] == (float)w[i];
+            direct = direct && fabs(w[i] - SignalWindow::Value(type, i, n)) < 1e-14;
+            sum += w[i];
+        }
+        direct = direct && fabs(window->GetSum() - sum) < 1e-12;
+    }
+    check(symmetric && direct, "symmetric tables equal to the direct values, in double and float");
+
+    const double *hann = SignalWindow::Get(SIGNAL_WINDOW_HANN, n)->GetValues();
+    const SignalWindow *blackman = SignalWindow::Get(SIGNAL_WINDOW_BLACKMAN, n);
+    check(hann[0] == 0.0 && hann[50] == 1.0 && fabs(hann[25] - 0.5) < 1e-15 &&
+          fabs(blackman->GetValues()[50] - 1.0) < 1e-15, "Hann and Blackman unchanged");
+    check(fabs(SignalWindow::Get(SIGNAL_WINDOW_HANN, n)->GetSumOfSquares() - 3.0 / 8.0 * (n - 1)) < 1e-12,
+          "sum of squares (Hann: 3 (n - 1) / 8)");
+
+    double kaiser = 0.0;
+    const double *k = SignalWindow::Get(SIGNAL_WINDOW_KAISER, n, 5.0)->GetValues();
+    for (int i = 0; i < n; i++)
+    {
+        double r = 2.0 * i / (n - 1) - 1.0;
+        kaiser = fmax(kaiser, fabs(k[i] - bessel_i0(5.0 * sqrt(1.0 - r * r)) / bessel_i0(5.0)));
+    }
+    printf("Kaiser beta 5 against the series of I0: %.2e\n", kaiser);
+    check(kaiser < 1e-14, "Kaiser window");
+
+    const double *tukey_hann = SignalWindow::Get(SIGNAL_WINDOW_TUKEY, n, 1.0)->GetValues();
+    const double *tukey = SignalWindow::Get(SIGNAL_WINDOW_TUKEY, n, 0.2)->GetValues();
+    bool same = true;
+    for (int i = 0; i < n; i++)
+        same = same && fabs(tukey_hann[i] - hann[i]) < 1e-15;
+    check(same && tukey[0] == 0.0 && tukey[10] == 1.0 && tukey[90] == 1.0 && tukey[5] > 0.4 && tukey[5] < 0.6,
+          "Tukey: alpha 1 is Hann, alpha 0.2 flat over 80%");
+
+    double hann_amplitude = scalloped_amplitude(SIGNAL_WINDOW_HANN);
+    double flattop_amplitude = scalloped_amplitude(SIGNAL_WINDOW_FLATTOP);
+    printf("Unit tone halfway between bins: Hann %.4f (%.2f dB), flat top %.5f (%.3f dB)\n", hann_amplitude,
+           20.0 * log10(hann_amplitude), flattop_amplitude, 20.0 * log10(flattop_amplitude));
+    check(fabs(20.0 * log10(flattop_amplitude)) < 0.02 && hann_amplitude < 0.86, "flat top reads amplitudes between bins");
+    printf("\n");
+}
+
+void test_cache()
+{
+    printf("=== Test 2: Shared tables ===\n");
+
+    const SignalWindow *a = SignalWindow::Get(SIGNAL_WINDOW_HAMMING, 777);
+    check(a != nullptr && a == SignalWindow::Get(SIGNAL_WINDOW_HAMMING, 777) &&
+          a != SignalWindow::Get(SIGNAL_WINDOW_HAMMING, 778) && a != SignalWindow::Get(SIGNAL_WINDOW_HANN, 777),
+          "one table per type and size");
+    check(SignalWindow::Get(SIGNAL_WINDOW_KAISER, 64) == SignalWindow::Get(SIGNAL_WINDOW_KAISER, 64, SIGNAL_WINDOW_KAISER_BETA) &&
+          SignalWindow::Get(SIGNAL_WINDOW_KAISER, 64, 3.0) != SignalWindow::Get(SIGNAL_WINDOW_KAISER, 64) &&
+          SignalWindow::Get(SIGNAL_WINDOW_TUKEY, 64, 7.0)->GetParameter() == 1.0 &&
+          SignalWindow::Get(SIGNAL_WINDOW_HANN, 64, 3.0) == SignalWindow::Get(SIGNAL_WINDOW_HANN, 64),
+          "parameters: defaults, keys and limits");
+    check(SignalWindow::Get(7, 64) == nullptr && SignalWindow::Get(SIGNAL_WINDOW_HANN, 0) == nullptr &&
+          SignalWindow::Get(SIGNAL_WINDOW_HANN, 1)->GetValues()[0] == 1.0, "invalid types and sizes");
+
+    const SignalWindow *seen[8];
+    std::thread threads[8];
+    for (int t = 0; t < 8; t++)
+        threads[t] = std::thread([&seen, t]() {
+            for (int size = 2000; size < 2100; size++)
+                SignalWindow::Get(SIGNAL_WINDOW_BLACKMAN, size);
+            seen[t] = SignalWindow::Get(SIGNAL_WINDOW_BLACKMAN, 2050);
+        });
+    for (int t = 0; t < 8; t++)
+        threads[t].join();
+    bool same = seen[0] != nullptr && seen[0]->GetSize() == 2050;
+    for (int t = 1; t < 8; t++)
+        same = same && seen[t] == seen[0];
+    check(same, "threads racing on new sizes share one table");
+    printf("\n");
+}
+
+void test_kernels()
+{
+    printf("=== Test 3: Vector multiply on every kernel ===\n");
+
+    int detected = FFTPlan::GetKernel();
+    bool exact = true;
+    int tested = 0;
+    for (int k = 0; k < 5; k++)
+    {
+        if (!FFTPlan::SetKernel(KERNELS[k]))
+            continue;
+        tested++;
+        // lengths with and without a scalar tail
+        for (int size = 1; size <= 67; size += 3)
+        {
+            const SignalWindow *window = SignalWindow::Get(SIGNAL_WINDOW_FLATTOP, size);
+            std::vector<double> data(size);
+            std::vector<float> data_f(size);
+            for (int i = 0; i < size; i++)
+            {
+                data[i] = sin(0.7 * i) + 2.0;
+                data_f[i] = (float)data[i];
+            }
+            window->Apply(data.data());
+            window->Apply(data_f.data());
+            for (int i = 0; i < size; i++)
+                exact = exact && data[i] == (sin(0.7 * i) + 2.0) * window->GetValues()[i] &&
+                        data_f[i] == (float)(sin(0.7 * i) + 2.0) * window->GetValuesF()[i];
+        }
+    }
+    FFTPlan::SetKernel(detected);
+    printf("%d kernels (%s used by default)\n", tested, FFTPlan::GetKernelName(detected));
+    check(exact, "same products as a scalar loop");
+    printf("\n");
+}
+
+void test_spectrum_window()
+{
+    printf("=== Test 4: Window choice of FFTAnalysis() ===\n");
+
+    const double rate = 1000.0;
+    SignalProcessing sp(500);
+    for (int i = 0; i < 500; i++)
+        sp.AddValue(sin(2.0 * M_PI * 50.0 * i / rate) + 0.01 * sin(2.0 * M_PI * 180.0 * i / rate));
+
+    FrequencySpectrum hann, kaiser;
+    check(sp.GetSpectrumWindow() == SIGNAL_WINDOW_HANN, "Hann by default");
+    bool ok = sp.FFTAnalysis(rate, &hann);
+    check(sp.SetSpectrumWindow(SIGNAL_WINDOW_KAISER, 12.0) && sp.GetSpectrumWindow() == SIGNAL_WINDOW_KAISER &&
+          !sp.SetSpectrumWindow(42) && sp.GetSpectrumWindow() == SIGNAL_WINDOW_KAISER, "window selected");
+    ok = sp.FFTAnalysis(rate, &kaiser) && ok;
+    // leakage of the strong tone (bin 25) 8 to 20 bins away
+    double floor_hann = 0.0, floor_kaiser = 0.0;
+    for (int k = 33; k <= 45; k++)
+    {
+        floor_hann = fmax(floor_hann, ok ? hann.bins[k].magnitude : 1.0);
+        floor_kaiser = fmax(floor_kaiser, ok ? kaiser.bins[k].magnitude : 1.0);
+    }
+    printf("Leakage 8 to 20 bins from a tone: Hann %.2e, Kaiser beta 12 %.2e\n", floor_hann / hann.bins[25].magnitude,
+           floor_kaiser / kaiser.bins[25].magnitude);
+    check(ok && floor_kaiser / kaiser.bins[25].magnitude < 0.2 * floor_hann / hann.bins[25].magnitude,
+          "cached spectrum recomputed with the new window");
+    if (ok)
+    {
+        sp.FreeSpectrum(&hann);
+        sp.FreeSpectrum(&kaiser);
+    }
+
+    // same frames as a spectrogram with that window
+    sp.SetSpectrumWindow(SIGNAL_WINDOW_TUKEY);
+    Spectrogram spectrogram(500, 500, 1, SIGNAL_WINDOW_TUKEY);
+    for (int i = 0; i < 500; i++)
+        spectrogram.AddValue(sin(2.0 * M_PI * 50.0 * i / rate) + 0.01 * sin(2.0 * M_PI * 180.0 * i / rate));
+    FrequencySpectrum tukey;
+    ok = sp.FFTAnalysis(rate, &tukey);
+    double worst = 0.0;
+    for (int k = 0; ok && k < tukey.num_bins; k++)
+        worst = fmax(worst, fabs(tukey.bins[k].magnitude - spectrogram.GetFrame(0)[k]));
+    check(ok && worst < 1e-9, "Spectrogram and FFTAnalysis() share the tables");
+    if (ok)
+        sp.FreeSpectrum(&tukey);
+    check(!Spectrogram(500, 100, 4, 9).IsValid(), "unknown window rejected by the spectrogram");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Window Functions Test Suite            ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_coefficients();
+    test_cache();
+    test_kernels();
+    test_spectrum_window();
+
+    if (failures == 0)
+        printf("All window function tests passed.\n");
+    else
+        printf("%d window function check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
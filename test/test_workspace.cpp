@@ -0,0 +1,160 @@
+/*
+ * Test file for the scratch workspace
+ * Checks that the steady-state analysis loop makes no heap allocation
+ */
+
+#define TEST_COUNT_HEAP_CALLS
+#include "../source/SignalProcessing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void fill(SignalProcessing &sp, int n, int offset)
+{
+    double block[256];
+    for (int i = 0; i < n; i += 256)
+    {
+        for (int j = 0; j < 256; j++)
+        {
+            int k = offset + i + j;
+            block[j] = sin(2.0 * M_PI * 50.0 * k / 1000.0) + ((k % 311 == 0) ? 3.0 : 0.0);
+        }
+        sp.AddValues(block, 256);
+    }
+}
+
+// one iteration of a real-time analysis loop
+static double hot_path(SignalProcessing &sp, FrequencyBin *bins, int max_bins, double *out)
+{
+    double checksum = 0.0;
+    MLFeatureVector features;
+    sp.ExtractMLFeatures(1000.0, &features);
+    checksum += features.spectral_centroid;
+
+    FrequencySpectrum spectrum;
+    if (sp.FFTAnalysis(1000.0, &spectrum, bins, max_bins))
+        checksum += spectrum.dominant_frequency;
+
+    int indices[64];
+    checksum += sp.DetectAnomaliesIQR(1.5, indices, 64);
+    checksum += sp.DetectAnomaliesZScore(3.0, indices, 64);
+    checksum += sp.DetectPeaksWithDistance(10, indices, 64);
+    checksum += sp.DetectPeriodicAnomalies(20, 3.0, indices, 64);
+    checksum += sp.CalculateAnomalyScore(1);
+    sp.WaveletDenoise(0.1, out, 3);
+    checksum += out[100];
+    checksum += sp.Decimate(4, out, true);
+    sp.ExtractMLFeaturesFromSegment(512, 1024, 1000.0, &features);
+    checksum += features.rms;
+    sp.NormalDistributionRun();
+    return checksum;
+}
+
+void test_steady_state()
+{
+    printf("=== Test 1: Steady-state loop without allocation ===\n");
+
+    const int n = 4096;
+    SignalProcessing sp(n);
+    fill(sp, n, 0);
+    static FrequencyBin bins[n / 2 + 1];
+    static double out[n];
+
+    // warm-up: sizes the workspace and the distribution table
+    double checksum = hot_path(sp, bins, n / 2 + 1, out);
+    printf("Workspace: %zu bytes, peak usage %zu bytes\n", sp.GetWorkspace()->GetSize(), sp.GetWorkspace()->GetPeakUsage());
+
+    sp.GetWorkspace()->SetAllocationGuard(true);
+    long long before = HEAP_CALLS;
+    long long workspace_before = sp.GetWorkspace()->GetHeapAllocationCount();
+    for (int i = 0; i < 50; i++)
+    {
+        fill(sp, 256, n + i * 256);
+        checksum += hot_path(sp, bins, n / 2 + 1, out);
+    }
+    long long calls = HEAP_CALLS - before;
+    sp.GetWorkspace()->SetAllocationGuard(false);
+
+    printf("Heap calls during 50 iterations: %lld (checksum %.3f)\n", calls, checksum);
+    check(calls == 0, "no malloc/calloc/realloc in the hot path");
+    check(sp.GetWorkspace()->GetHeapAllocationCount() == workspace_before, "no workspace fallback");
+    printf("\n");
+}
+
+void test_spectrum_overloads()
+{
+    printf("=== Test 2: Spectrum into caller bins ===\n");
+
+    SignalProcessing sp(3000);
+    fill(sp, 3072, 0);
+    FrequencySpectrum allocated, provided;
+    static FrequencyBin bins[2049];
+    bool ok = sp.FFTAnalysis(1000.0, &allocated);
+    ok = ok && sp.FFTAnalysis(1000.0, &provided, bins, 2049);
+    check(ok && provided.bins == bins && provided.num_bins == allocated.num_bins, "bins written to the caller array");
+    check(ok && provided.dominant_frequency == allocated.dominant_frequency &&
+          provided.bins[150].magnitude == allocated.bins[150].magnitude, "same spectrum");
+    check(!sp.FFTAnalysis(1000.0, &provided, bins, 100), "too few bins rejected");
+    if (ok)
+        sp.FreeSpectrum(&allocated);
+    printf("\n");
+}
+
+void test_workspace_growth()
+{
+    printf("=== Test 3: Workspace fallback and growth ===\n");
+
+    SignalWorkspace ws(256);
+    size_t mark = ws.Mark();
+    char *a = (char *)ws.Alloc(100);
+    char *b = (char *)ws.Alloc(1000);
+    check(a != nullptr && b != nullptr && ((size_t)b % 64) == 0, "aligned blocks, fallback when full");
+    check(ws.GetHeapAllocationCount() == 1 && ws.GetPeakUsage() == 128 + 1024, "fallback counted");
+    ws.Release(mark);
+    check(ws.GetSize() >= ws.GetPeakUsage(), "buffer grown to the peak demand after release");
+    long long count = ws.GetHeapAllocationCount();
+    ws.Alloc(100);
+    ws.Alloc(1000);
+    ws.Release(mark);
+    check(ws.GetHeapAllocationCount() == count, "same demand served from the buffer");
+
+    // one workspace shared by the objects of a thread
+    SignalWorkspace shared;
+    SignalProcessing a_sp(2048), b_sp(2048), own(2048);
+    fill(a_sp, 2048, 0);
+    fill(b_sp, 2048, 100);
+    fill(own, 2048, 100);
+    a_sp.SetWorkspace(&shared);
+    b_sp.SetWorkspace(&shared);
+    MLFeatureVector fa, fb, fo;
+    a_sp.ExtractMLFeatures(1000.0, &fa);
+    b_sp.ExtractMLFeatures(1000.0, &fb);
+    own.ExtractMLFeatures(1000.0, &fo);
+    check(b_sp.GetWorkspace() == &shared && fb.spectral_centroid == fo.spectral_centroid, "shared workspace");
+    a_sp.SetWorkspace(nullptr);
+    check(a_sp.GetWorkspace() != &shared, "back to the object's own workspace");
+    printf("\n");
+}
+
+int main()
+{
+    printf("╔════════════════════════════════════════════╗\n");
+    printf("║     Scratch Workspace Test Suite           ║\n");
+    printf("╚════════════════════════════════════════════╝\n\n");
+
+    test_steady_state();
+    test_spectrum_overloads();
+    test_workspace_growth();
+
+    if (failures == 0)
+        printf("All workspace tests passed.\n");
+    else
+        printf("%d workspace check(s) failed.\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}